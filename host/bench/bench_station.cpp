@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+// The sketch as the IDE builds it, setup() and loop() run against the simulated board
+#include "arduino_smart_weather_station.ino"
+#include "src/input/sensors/sensor_library/dht11/dht11.h"
+#include "src/output/output_format/output_format.h"
+#include "hal_sim.h"
+
+// Host timings only rank alternatives, the ATmega328 is orders of magnitude slower.
+// station_bench_fixed runs the same benchmarks with fixed-point sensor values, on the host the
+// float unit hides most of what the ATmega328 saves without one.
+// Work per simulated second (wakeups, I2C transactions) is reported as counters and does carry over.
+
+/**
+ * @brief Fills the falling edge times of a DHT11 frame as the sensor sends it.
+ */
+static void fillDht11Edges(const uint8_t *frame, uint16_t *edges_us)
+{
+  uint16_t time_us = 0u;
+  edges_us[0] = time_us;
+  time_us = (uint16_t)(time_us + 160u);
+  edges_us[1] = time_us;
+  for (uint8_t bit = 0u; bit < DHT11_FRAME_BITS; bit++)
+  {
+    bool is_one = (0u != (frame[bit / 8u] & (0x80u >> (bit % 8u))));
+    time_us = (uint16_t)(time_us + (is_one ? 120u : 77u));
+    edges_us[DHT11_RESPONSE_EDGES + bit] = time_us;
+  }
+}
+
+static void BM_Dht11DecodeFrame(benchmark::State &state)
+{
+  const uint8_t frame[DHT11_FRAME_BYTES] = {45u, 0u, 21u, 3u, 69u};
+  uint16_t edges_us[DHT11_FRAME_EDGES];
+  fillDht11Edges(frame, edges_us);
+  dht11_snapshot_ts snapshot;
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(dht11_decodeFrame(edges_us, DHT11_FRAME_EDGES, &snapshot));
+  }
+}
+BENCHMARK(BM_Dht11DecodeFrame);
+
+static void BM_OutputFormatSensorValue(benchmark::State &state)
+{
+  char text[OUTPUT_FORMAT_FLOAT_BUFFER_SIZE];
+  sensors_value_t value = sensors_toValue(-1013.25f);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(output_format_sensorValue(value, (uint8_t)state.range(0), text, sizeof(text)));
+  }
+}
+BENCHMARK(BM_OutputFormatSensorValue)->Arg(0)->Arg(1)->Arg(4);
+
+static void BM_AnalogSensorValuePath(benchmark::State &state)
+{
+  // The ADC sampler has oversampled values of every analog pin after the first second
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+  uint32_t start_ms = millis();
+  while(TIME_SECS(1) > millis() - start_ms)
+  {
+    loop();
+  }
+
+  // Table lookup (MQ7, as MQ135) or linear mapping (GY-ML8511), range check and text, as every reading is reported
+  const uint8_t sensor_ids[] = {MQ7_COPPM, GYML8511_UV};
+  char text[OUTPUT_FORMAT_FLOAT_BUFFER_SIZE];
+  for (uint8_t sensor_id : sensor_ids)
+  {
+    sensor_reading_ts reading;
+    if(ERROR_CODE_NO_ERROR != sensors_getReading(sensor_id, &reading))
+    {
+      state.SkipWithError("Analog reading out of range");
+      return;
+    }
+  }
+
+  for (auto _ : state)
+  {
+    for (uint8_t sensor_id : sensor_ids)
+    {
+      sensor_reading_ts reading;
+      benchmark::DoNotOptimize(sensors_getReading(sensor_id, &reading));
+      benchmark::DoNotOptimize(output_format_sensorValue(reading.value, 1u, text, sizeof(text)));
+    }
+  }
+}
+BENCHMARK(BM_AnalogSensorValuePath);
+
+static void BM_StationSimulatedSecond(benchmark::State &state)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+  uint32_t wakeups = 0u;
+  uint32_t start_transactions = hal_sim_i2cGetTransactions();
+
+  for (auto _ : state)
+  {
+    uint32_t start_ms = millis();
+    while(TIME_SECS(1) > millis() - start_ms)
+    {
+      loop();
+      wakeups++;
+    }
+    hal_sim_serialClearOutput();
+  }
+
+  state.counters["wakeups_per_s"] = benchmark::Counter((double)wakeups / (double)state.iterations());
+  state.counters["i2c_per_s"] = benchmark::Counter((double)(hal_sim_i2cGetTransactions() - start_transactions) / (double)state.iterations());
+}
+BENCHMARK(BM_StationSimulatedSecond)->Unit(benchmark::kMicrosecond);
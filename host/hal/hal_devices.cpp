@@ -0,0 +1,595 @@
+#include "hal_sim_internal.h"
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+#include <BH1750.h>
+#include <Adafruit_BMP280.h>
+#include <RTClib.h>
+
+/* HD44780 display RAM, 4 rows of 40 characters cover every supported LCD size */
+#define HAL_SIM_LCD_MAX_ROWS            (uint8_t)(4u)
+#define HAL_SIM_LCD_RAM_COLUMNS         (uint8_t)(40u)
+/* PCF8574 bits of the LCD backpack */
+#define HAL_SIM_LCD_RS_BIT              (uint8_t)(0x01u)
+#define HAL_SIM_LCD_EN_BIT              (uint8_t)(0x04u)
+#define HAL_SIM_LCD_BACKLIGHT_BIT       (uint8_t)(0x08u)
+/* Execution times of the HD44780 */
+#define HAL_SIM_LCD_COMMAND_TIME_US     (uint16_t)(50u)
+#define HAL_SIM_LCD_CLEAR_TIME_US       (uint16_t)(2000u)
+/* HD44780 commands */
+#define HAL_SIM_LCD_CLEAR_DISPLAY       (uint8_t)(0x01u)
+#define HAL_SIM_LCD_RETURN_HOME         (uint8_t)(0x02u)
+#define HAL_SIM_LCD_ENTRY_MODE_LEFT     (uint8_t)(0x06u)
+#define HAL_SIM_LCD_DISPLAY_ON          (uint8_t)(0x0Cu)
+#define HAL_SIM_LCD_DISPLAY_ON_CURSOR   (uint8_t)(0x0Eu)
+#define HAL_SIM_LCD_FUNCTION_SET_2_LINE (uint8_t)(0x28u)
+#define HAL_SIM_LCD_SET_DDRAM_ADDRESS   (uint8_t)(0x80u)
+
+/* Simplified BMP280 result registers, see hal_sim_setBarometer() */
+#define HAL_SIM_BMP280_PRESSURE_REG     (uint8_t)(0xF7u)
+#define HAL_SIM_BMP280_TEMPERATURE_REG  (uint8_t)(0xFAu)
+#define HAL_SIM_BMP280_CTRL_MEAS_REG    (uint8_t)(0xF4u)
+#define HAL_SIM_BMP280_CONFIG_REG       (uint8_t)(0xF5u)
+#define HAL_SIM_BMP280_PRESSURE_SCALE   (float)(16.0f)   // 1/16 Pa per bit
+#define HAL_SIM_BMP280_TEMPERATURE_SCALE (float)(100.0f) // 1/100 C per bit
+
+/* BH1750 counts per lux in high resolution mode */
+#define HAL_SIM_BH1750_COUNTS_PER_LUX   (float)(1.2f)
+
+/* DS3231 registers */
+#define HAL_SIM_RTC_TIME_REG            (uint8_t)(0x00u)
+#define HAL_SIM_RTC_TIME_LEN            (uint8_t)(7u)
+#define HAL_SIM_RTC_STATUS_REG          (uint8_t)(0x0Fu)
+#define HAL_SIM_RTC_OSF_BIT             (uint8_t)(0x80u)
+#define HAL_SIM_SECONDS_PER_DAY         (uint32_t)(86400u)
+/* Unix time of 2000-01-01 */
+#define HAL_SIM_UNIX_TIME_2000          (uint32_t)(946684800u)
+
+/* DHT11 timing, the sensor answers a start signal of at least 18 ms */
+#define HAL_SIM_DHT11_START_SIGNAL_US   (uint64_t)(18000u)
+#define HAL_SIM_DHT11_RESPONSE_DELAY_US (uint64_t)(30u)
+#define HAL_SIM_DHT11_RESPONSE_US       (uint64_t)(160u)  // 80 us low, 80 us high
+#define HAL_SIM_DHT11_BIT_LOW_US        (uint64_t)(50u)
+#define HAL_SIM_DHT11_ZERO_HIGH_US      (uint64_t)(27u)
+#define HAL_SIM_DHT11_ONE_HIGH_US       (uint64_t)(70u)
+#define HAL_SIM_DHT11_FRAME_BYTES       (uint8_t)(5u)
+#define HAL_SIM_DHT11_NEGATIVE_BIT      (uint8_t)(0x80u)
+
+/* STATIC GLOBAL VARIABLES */
+/* What the LCD shows, written by the characters it acknowledged */
+static char hal_sim_lcd_ram[HAL_SIM_LCD_MAX_ROWS][HAL_SIM_LCD_RAM_COLUMNS];
+static uint8_t hal_sim_lcd_row = 0u;
+static uint8_t hal_sim_lcd_column = 0u;
+static uint8_t hal_sim_lcd_visible_columns = 16u;
+static char hal_sim_lcd_row_text[HAL_SIM_LCD_RAM_COLUMNS + 1u];
+static uint32_t hal_sim_lcd_writes = 0u;
+
+/* DHT11 on the data pin */
+static bool hal_sim_dht11_attached = false;
+static uint8_t hal_sim_dht11_frame[HAL_SIM_DHT11_FRAME_BYTES];
+static bool hal_sim_dht11_line_low = false;
+static uint64_t hal_sim_dht11_low_since_us = 0u;
+
+static const uint8_t hal_sim_days_in_month[12] = {31u, 28u, 31u, 30u, 31u, 30u, 31u, 31u, 30u, 31u, 30u, 31u};
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Executes a command received by the simulated HD44780.
+ */
+static void lcdCommand(uint8_t command);
+
+/**
+ * @brief Schedules the falling edges of a DHT11 frame after the start signal was released.
+ */
+static void sendDht11Frame();
+
+/**
+ * @brief Converts a value to the BCD format of the DS3231 registers.
+ */
+static uint8_t toBcd(uint8_t value);
+
+/**
+ * @brief Converts a DS3231 register from BCD.
+ */
+static uint8_t fromBcd(uint8_t value);
+
+/**
+ * @brief Parses two decimal digits of __DATE__ or __TIME__, a leading space counts as 0.
+ */
+static uint8_t parseTwoDigits(const char *text);
+/* *************************************** */
+
+/* SIMULATOR */
+void hal_sim_resetDevices()
+{
+  memset(hal_sim_lcd_ram, ' ', sizeof(hal_sim_lcd_ram));
+  hal_sim_lcd_row = 0u;
+  hal_sim_lcd_column = 0u;
+  hal_sim_lcd_visible_columns = 16u;
+  hal_sim_lcd_writes = 0u;
+  hal_sim_dht11_attached = false;
+  hal_sim_dht11_line_low = false;
+}
+
+void hal_sim_onPinChanged(uint8_t pin)
+{
+  if(HAL_SIM_DHT11_PIN != pin)
+  {
+    return;
+  }
+
+  bool line_low = (OUTPUT == hal_sim_getPinMode(pin) && LOW == hal_sim_getDigitalOutput(pin));
+  if(line_low && !hal_sim_dht11_line_low)
+  {
+    // The start signal is a falling edge on the interrupt pin of the data line
+    hal_sim_latchInterrupt(pin);
+    hal_sim_dht11_low_since_us = hal_sim_getTime();
+  }
+  else if(!line_low && hal_sim_dht11_line_low && hal_sim_dht11_attached &&
+          hal_sim_getTime() - hal_sim_dht11_low_since_us >= HAL_SIM_DHT11_START_SIGNAL_US)
+  {
+    sendDht11Frame();
+  }
+  hal_sim_dht11_line_low = line_low;
+}
+
+void hal_sim_attachStation()
+{
+  (void)hal_sim_i2cAttach(HAL_SIM_LCD_ADDRESS);
+  (void)hal_sim_i2cAttach(HAL_SIM_BMP280_ADDRESS);
+  (void)hal_sim_i2cAttach(HAL_SIM_BH1750_ADDRESS);
+  (void)hal_sim_i2cAttach(HAL_SIM_RTC_ADDRESS);
+
+  const uint8_t chip_id = BMP280_CHIPID;
+  hal_sim_i2cSetRegisters(HAL_SIM_BMP280_ADDRESS, BMP280_REGISTER_CHIPID, &chip_id, 1u);
+  hal_sim_setBarometer(21.5f, 101325.0f);
+  hal_sim_setLightLevel(300.0f);
+  hal_sim_setRtcTime(2024u, 6u, 1u, 12u, 0u, 0u);
+
+  hal_sim_attachDht11(21.0f, 45.0f);
+  hal_sim_setAnalogInput(A0, 180u);   // MQ135, clean air
+  hal_sim_setAnalogInput(A1, 500u);   // MQ7
+  hal_sim_setAnalogInput(A2, 310u);   // GY-ML8511, about 1 V at low UV
+  hal_sim_setAnalogInput(A4, 1000u);  // Rain sensor, dry
+}
+
+void hal_sim_attachDht11(float temperature_c, float humidity_percent)
+{
+  uint8_t temperature_integral;
+  uint8_t temperature_decimal;
+  if(0.0f <= temperature_c)
+  {
+    temperature_integral = (uint8_t)temperature_c;
+    temperature_decimal = (uint8_t)lroundf((temperature_c - temperature_integral) * 10.0f);
+  }
+  else
+  {
+    // Negative values count down from -1: -1 - integral + decimal / 10
+    temperature_integral = (uint8_t)(ceilf(-temperature_c) - 1.0f);
+    temperature_decimal = (uint8_t)(lroundf((temperature_c + 1.0f + temperature_integral) * 10.0f) | HAL_SIM_DHT11_NEGATIVE_BIT);
+  }
+
+  hal_sim_dht11_frame[0] = (uint8_t)humidity_percent;
+  hal_sim_dht11_frame[1] = (uint8_t)lroundf((humidity_percent - hal_sim_dht11_frame[0]) * 10.0f);
+  hal_sim_dht11_frame[2] = temperature_integral;
+  hal_sim_dht11_frame[3] = temperature_decimal;
+  hal_sim_dht11_frame[4] = (uint8_t)(hal_sim_dht11_frame[0] + hal_sim_dht11_frame[1] +
+                                     hal_sim_dht11_frame[2] + hal_sim_dht11_frame[3]);
+  hal_sim_dht11_attached = true;
+}
+
+void hal_sim_detachDht11()
+{
+  hal_sim_dht11_attached = false;
+}
+
+void hal_sim_setBarometer(float temperature_c, float pressure_pa)
+{
+  int32_t temperature = (int32_t)lroundf(temperature_c * HAL_SIM_BMP280_TEMPERATURE_SCALE);
+  uint32_t pressure = (uint32_t)lroundf(pressure_pa * HAL_SIM_BMP280_PRESSURE_SCALE);
+  // Big endian 24-bit values like the result registers of the sensor
+  const uint8_t registers[6] = {(uint8_t)(pressure >> 16u), (uint8_t)(pressure >> 8u), (uint8_t)pressure,
+                                (uint8_t)(temperature >> 16u), (uint8_t)(temperature >> 8u), (uint8_t)temperature};
+  hal_sim_i2cSetRegisters(HAL_SIM_BMP280_ADDRESS, HAL_SIM_BMP280_PRESSURE_REG, registers, sizeof(registers));
+}
+
+void hal_sim_setLightLevel(float lux)
+{
+  uint16_t counts = (uint16_t)lroundf(lux * HAL_SIM_BH1750_COUNTS_PER_LUX);
+  const uint8_t registers[2] = {(uint8_t)(counts >> 8u), (uint8_t)counts};
+  hal_sim_i2cSetRegisters(HAL_SIM_BH1750_ADDRESS, BH1750::CONTINUOUS_HIGH_RES_MODE, registers, sizeof(registers));
+}
+
+void hal_sim_setRtcTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
+  const uint8_t registers[HAL_SIM_RTC_TIME_LEN] = {toBcd(second), toBcd(minute), toBcd(hour), 1u,
+                                                   toBcd(day), toBcd(month), toBcd((uint8_t)(year - 2000u))};
+  const uint8_t status = 0u; // Oscillator kept running
+  hal_sim_i2cSetRegisters(HAL_SIM_RTC_ADDRESS, HAL_SIM_RTC_TIME_REG, registers, sizeof(registers));
+  hal_sim_i2cSetRegisters(HAL_SIM_RTC_ADDRESS, HAL_SIM_RTC_STATUS_REG, &status, 1u);
+}
+
+const char *hal_sim_lcdGetRow(uint8_t row)
+{
+  memcpy(hal_sim_lcd_row_text, hal_sim_lcd_ram[row % HAL_SIM_LCD_MAX_ROWS], hal_sim_lcd_visible_columns);
+  hal_sim_lcd_row_text[hal_sim_lcd_visible_columns] = '\0';
+  return hal_sim_lcd_row_text;
+}
+
+uint32_t hal_sim_lcdGetWrites()
+{
+  return hal_sim_lcd_writes;
+}
+/* *************************************** */
+
+/* LIQUIDCRYSTAL_I2C */
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows)
+  : address(address), columns(columns), rows(rows), backlight_bit(0u)
+{
+}
+
+void LiquidCrystal_I2C::begin(uint8_t columns, uint8_t rows)
+{
+  this->columns = columns;
+  this->rows = rows;
+  init();
+}
+
+void LiquidCrystal_I2C::init()
+{
+  hal_sim_lcd_visible_columns = min(columns, HAL_SIM_LCD_RAM_COLUMNS);
+  delay(50u); // Power up time of the controller
+  (void)send(HAL_SIM_LCD_FUNCTION_SET_2_LINE, false);
+  (void)send(HAL_SIM_LCD_DISPLAY_ON, false);
+  clear();
+  (void)send(HAL_SIM_LCD_ENTRY_MODE_LEFT, false);
+  home();
+}
+
+void LiquidCrystal_I2C::clear()
+{
+  (void)send(HAL_SIM_LCD_CLEAR_DISPLAY, false);
+  delayMicroseconds(HAL_SIM_LCD_CLEAR_TIME_US);
+}
+
+void LiquidCrystal_I2C::home()
+{
+  (void)send(HAL_SIM_LCD_RETURN_HOME, false);
+  delayMicroseconds(HAL_SIM_LCD_CLEAR_TIME_US);
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t column, uint8_t row)
+{
+  static const uint8_t row_offsets[HAL_SIM_LCD_MAX_ROWS] = {0x00u, 0x40u, 0x14u, 0x54u};
+  row = (row < rows) ? row : (uint8_t)(rows - 1u);
+  (void)send((uint8_t)(HAL_SIM_LCD_SET_DDRAM_ADDRESS | (row_offsets[row % HAL_SIM_LCD_MAX_ROWS] + column)), false);
+}
+
+void LiquidCrystal_I2C::backlight()
+{
+  backlight_bit = HAL_SIM_LCD_BACKLIGHT_BIT;
+  Wire.beginTransmission(address);
+  (void)Wire.write(backlight_bit);
+  (void)Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::noBacklight()
+{
+  backlight_bit = 0u;
+  Wire.beginTransmission(address);
+  (void)Wire.write(backlight_bit);
+  (void)Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::cursor()
+{
+  (void)send(HAL_SIM_LCD_DISPLAY_ON_CURSOR, false);
+}
+
+void LiquidCrystal_I2C::noCursor()
+{
+  (void)send(HAL_SIM_LCD_DISPLAY_ON, false);
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t character)
+{
+  return send(character, true) ? 1u : 0u;
+}
+
+bool LiquidCrystal_I2C::send(uint8_t value, bool is_character)
+{
+  uint8_t mode = (uint8_t)((is_character ? HAL_SIM_LCD_RS_BIT : 0u) | backlight_bit);
+
+  // 4-bit mode, every nibble is latched with a pulse of the enable line
+  Wire.beginTransmission(address);
+  for (uint8_t shift = 8u; 0u != shift; shift -= 4u)
+  {
+    uint8_t nibble = (uint8_t)(((value << (8u - shift)) & 0xF0u) | mode);
+    (void)Wire.write(nibble);
+    (void)Wire.write((uint8_t)(nibble | HAL_SIM_LCD_EN_BIT));
+    (void)Wire.write(nibble);
+  }
+  bool acknowledged = (0u == Wire.endTransmission());
+  delayMicroseconds(HAL_SIM_LCD_COMMAND_TIME_US);
+
+  if(acknowledged)
+  {
+    if(is_character)
+    {
+      hal_sim_lcd_ram[hal_sim_lcd_row][hal_sim_lcd_column] = (char)value;
+      hal_sim_lcd_column = (uint8_t)((hal_sim_lcd_column + 1u) % HAL_SIM_LCD_RAM_COLUMNS);
+      hal_sim_lcd_writes++;
+    }
+    else
+    {
+      lcdCommand(value);
+    }
+  }
+  return acknowledged;
+}
+/* *************************************** */
+
+/* BH1750 */
+BH1750::BH1750(uint8_t address) : address(address), mode(UNCONFIGURED)
+{
+}
+
+bool BH1750::begin(Mode mode, uint8_t address)
+{
+  if(0u != address)
+  {
+    this->address = address;
+  }
+  return configure(mode);
+}
+
+bool BH1750::configure(Mode mode)
+{
+  Wire.beginTransmission(address);
+  (void)Wire.write((uint8_t)mode);
+  bool acknowledged = (0u == Wire.endTransmission());
+  this->mode = acknowledged ? mode : UNCONFIGURED;
+  return acknowledged;
+}
+
+float BH1750::readLightLevel()
+{
+  if(UNCONFIGURED == mode)
+  {
+    return -2.0f;
+  }
+  if(2u != Wire.requestFrom(address, (uint8_t)2u))
+  {
+    return -1.0f;
+  }
+  uint16_t counts = (uint16_t)((uint8_t)Wire.read() << 8u);
+  counts |= (uint8_t)Wire.read();
+  return counts / HAL_SIM_BH1750_COUNTS_PER_LUX;
+}
+/* *************************************** */
+
+/* ADAFRUIT_BMP280 */
+bool Adafruit_BMP280::begin(uint8_t address, uint8_t chip_id)
+{
+  this->address = address;
+  uint8_t read_chip_id = 0u;
+  return readRegisters(BMP280_REGISTER_CHIPID, &read_chip_id, 1u) && chip_id == read_chip_id;
+}
+
+void Adafruit_BMP280::setSampling(sensor_mode mode, sensor_sampling temperature_sampling,
+                                  sensor_sampling pressure_sampling, sensor_filter filter,
+                                  standby_duration duration)
+{
+  Wire.beginTransmission(address);
+  (void)Wire.write(HAL_SIM_BMP280_CTRL_MEAS_REG);
+  (void)Wire.write((uint8_t)((temperature_sampling << 5u) | (pressure_sampling << 2u) | mode));
+  (void)Wire.write((uint8_t)((duration << 5u) | (filter << 2u)));
+  (void)Wire.endTransmission();
+}
+
+float Adafruit_BMP280::readTemperature()
+{
+  uint8_t data[3];
+  if(!readRegisters(HAL_SIM_BMP280_TEMPERATURE_REG, data, sizeof(data)))
+  {
+    return NAN;
+  }
+  // Sign extension of the 24-bit value
+  int32_t temperature = (int32_t)(((uint32_t)data[0] << 24u) | ((uint32_t)data[1] << 16u) | ((uint32_t)data[2] << 8u)) >> 8;
+  return temperature / HAL_SIM_BMP280_TEMPERATURE_SCALE;
+}
+
+float Adafruit_BMP280::readPressure()
+{
+  uint8_t data[3];
+  if(!readRegisters(HAL_SIM_BMP280_PRESSURE_REG, data, sizeof(data)))
+  {
+    return NAN;
+  }
+  uint32_t pressure = ((uint32_t)data[0] << 16u) | ((uint32_t)data[1] << 8u) | data[2];
+  return pressure / HAL_SIM_BMP280_PRESSURE_SCALE;
+}
+
+float Adafruit_BMP280::readAltitude(float sea_level_hpa)
+{
+  float pressure_hpa = readPressure() / 100.0f;
+  return 44330.0f * (1.0f - powf(pressure_hpa / sea_level_hpa, 0.1903f));
+}
+
+bool Adafruit_BMP280::readRegisters(uint8_t first_register, uint8_t *data, uint8_t length)
+{
+  Wire.beginTransmission(address);
+  (void)Wire.write(first_register);
+  if(0u != Wire.endTransmission() || length != Wire.requestFrom(address, length))
+  {
+    return false;
+  }
+  for (uint8_t index = 0u; index < length; index++)
+  {
+    data[index] = (uint8_t)Wire.read();
+  }
+  return true;
+}
+/* *************************************** */
+
+/* RTCLIB */
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+  : yOff((uint8_t)((year >= 2000u) ? (year - 2000u) : year)), m(month), d(day), hh(hour), mm(minute), ss(second)
+{
+}
+
+DateTime::DateTime(const __FlashStringHelper *date, const __FlashStringHelper *time)
+{
+  // __DATE__ "Jun  1 2024" and __TIME__ "12:00:00", like RTClib
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  const char *date_text = reinterpret_cast<const char *>(date);
+  const char *time_text = reinterpret_cast<const char *>(time);
+
+  m = 1u;
+  for (uint8_t month = 0u; month < 12u; month++)
+  {
+    if(0 == strncmp(&months[month * 3u], date_text, 3u))
+    {
+      m = (uint8_t)(month + 1u);
+    }
+  }
+  d = (uint8_t)((' ' == date_text[4]) ? (date_text[5] - '0') : parseTwoDigits(&date_text[4]));
+  yOff = parseTwoDigits(&date_text[9]);
+  hh = parseTwoDigits(&time_text[0]);
+  mm = parseTwoDigits(&time_text[3]);
+  ss = parseTwoDigits(&time_text[6]);
+}
+
+uint32_t DateTime::unixtime() const
+{
+  uint32_t days = (uint32_t)yOff * 365u + (yOff + 3u) / 4u;
+  for (uint8_t month = 1u; month < m; month++)
+  {
+    days += hal_sim_days_in_month[month - 1u];
+  }
+  if(m > 2u && 0u == yOff % 4u)
+  {
+    days++;
+  }
+  days += d - 1u;
+  return HAL_SIM_UNIX_TIME_2000 + days * HAL_SIM_SECONDS_PER_DAY + hh * 3600u + mm * 60u + ss;
+}
+
+bool RTC_DS3231::begin()
+{
+  Wire.beginTransmission(DS3231_ADDRESS);
+  return 0u == Wire.endTransmission();
+}
+
+bool RTC_DS3231::lostPower()
+{
+  Wire.beginTransmission(DS3231_ADDRESS);
+  (void)Wire.write(HAL_SIM_RTC_STATUS_REG);
+  if(0u != Wire.endTransmission() || 1u != Wire.requestFrom((uint8_t)DS3231_ADDRESS, (uint8_t)1u))
+  {
+    return true;
+  }
+  return 0u != ((uint8_t)Wire.read() & HAL_SIM_RTC_OSF_BIT);
+}
+
+void RTC_DS3231::adjust(const DateTime &date_time)
+{
+  Wire.beginTransmission(DS3231_ADDRESS);
+  (void)Wire.write(HAL_SIM_RTC_TIME_REG);
+  (void)Wire.write(toBcd(date_time.second()));
+  (void)Wire.write(toBcd(date_time.minute()));
+  (void)Wire.write(toBcd(date_time.hour()));
+  (void)Wire.write(1u);
+  (void)Wire.write(toBcd(date_time.day()));
+  (void)Wire.write(toBcd(date_time.month()));
+  (void)Wire.write(toBcd((uint8_t)(date_time.year() - 2000u)));
+  (void)Wire.endTransmission();
+
+  // Oscillator stop flag is cleared once the time is set
+  Wire.beginTransmission(DS3231_ADDRESS);
+  (void)Wire.write(HAL_SIM_RTC_STATUS_REG);
+  (void)Wire.write(0u);
+  (void)Wire.endTransmission();
+}
+
+DateTime RTC_DS3231::now()
+{
+  uint8_t registers[HAL_SIM_RTC_TIME_LEN] = {0u};
+
+  Wire.beginTransmission(DS3231_ADDRESS);
+  (void)Wire.write(HAL_SIM_RTC_TIME_REG);
+  if(0u == Wire.endTransmission() && HAL_SIM_RTC_TIME_LEN == Wire.requestFrom((uint8_t)DS3231_ADDRESS, HAL_SIM_RTC_TIME_LEN))
+  {
+    for (uint8_t index = 0u; index < HAL_SIM_RTC_TIME_LEN; index++)
+    {
+      registers[index] = (uint8_t)Wire.read();
+    }
+  }
+  // A failed read gives an invalid date (month 0) like the library, the station checks the ranges
+  return DateTime((uint16_t)(2000u + fromBcd(registers[6])), fromBcd(registers[5] & 0x7Fu), fromBcd(registers[4]),
+                  fromBcd(registers[2] & 0x3Fu), fromBcd(registers[1]), fromBcd(registers[0] & 0x7Fu));
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void sendDht11Frame()
+{
+  // Falling edges: start of the response, start of every bit and the end of the last bit
+  uint64_t edge_us = hal_sim_getTime() + HAL_SIM_DHT11_RESPONSE_DELAY_US;
+  (void)hal_sim_scheduleInterrupt(HAL_SIM_DHT11_PIN, edge_us);
+  edge_us += HAL_SIM_DHT11_RESPONSE_US;
+  (void)hal_sim_scheduleInterrupt(HAL_SIM_DHT11_PIN, edge_us);
+
+  for (uint8_t bit = 0u; bit < 8u * HAL_SIM_DHT11_FRAME_BYTES; bit++)
+  {
+    bool one = 0u != (hal_sim_dht11_frame[bit / 8u] & (0x80u >> (bit % 8u)));
+    edge_us += HAL_SIM_DHT11_BIT_LOW_US + (one ? HAL_SIM_DHT11_ONE_HIGH_US : HAL_SIM_DHT11_ZERO_HIGH_US);
+    (void)hal_sim_scheduleInterrupt(HAL_SIM_DHT11_PIN, edge_us);
+  }
+}
+
+static void lcdCommand(uint8_t command)
+{
+  if(0u != (command & HAL_SIM_LCD_SET_DDRAM_ADDRESS))
+  {
+    uint8_t address = (uint8_t)(command & 0x7Fu);
+    // Rows 0 and 1 start at 0x00 and 0x40, rows 2 and 3 continue them at column 20
+    uint8_t row = (address >= 0x40u) ? 1u : 0u;
+    uint8_t column = (uint8_t)(address - row * 0x40u);
+    if(column >= 20u && hal_sim_lcd_visible_columns <= 20u)
+    {
+      row = (uint8_t)(row + 2u);
+      column = (uint8_t)(column - 20u);
+    }
+    hal_sim_lcd_row = row;
+    hal_sim_lcd_column = (uint8_t)(column % HAL_SIM_LCD_RAM_COLUMNS);
+  }
+  else if(HAL_SIM_LCD_CLEAR_DISPLAY == command)
+  {
+    memset(hal_sim_lcd_ram, ' ', sizeof(hal_sim_lcd_ram));
+    hal_sim_lcd_row = 0u;
+    hal_sim_lcd_column = 0u;
+  }
+  else if(HAL_SIM_LCD_RETURN_HOME == command)
+  {
+    hal_sim_lcd_row = 0u;
+    hal_sim_lcd_column = 0u;
+  }
+}
+
+static uint8_t toBcd(uint8_t value)
+{
+  return (uint8_t)(((value / 10u) << 4u) | (value % 10u));
+}
+
+static uint8_t fromBcd(uint8_t value)
+{
+  return (uint8_t)((value >> 4u) * 10u + (value & 0x0Fu));
+}
+
+static uint8_t parseTwoDigits(const char *text)
+{
+  uint8_t value = ('0' <= text[0] && '9' >= text[0]) ? (uint8_t)(text[0] - '0') : 0u;
+  return (uint8_t)(value * 10u + (uint8_t)(text[1] - '0'));
+}
+/* *************************************** */
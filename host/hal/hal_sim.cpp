@@ -0,0 +1,1201 @@
+#include <string>
+#include <stdarg.h>
+
+#include "hal_sim_internal.h"
+#include <Wire.h>
+#include <avr/eeprom.h>
+
+/* Conversion complete handler of the station, only linked when the ADC sampler is part of the build */
+extern "C" void ADC_vect() __attribute__((weak));
+
+/* Scripted levels or values of one pin */
+#define HAL_SIM_SCRIPT_LEN              (uint8_t)(32u)
+/* Analog inputs A0 to A7 */
+#define HAL_SIM_NUM_OF_ANALOG_PINS      (uint8_t)(8u)
+/* Pins 2 and 3 */
+#define HAL_SIM_NUM_OF_INTERRUPTS       (uint8_t)(2u)
+/* AVR core: SERIAL_TX_BUFFER_SIZE - 1 characters fit into the transmit buffer */
+#define HAL_SIM_SERIAL_TX_BUFFER_SIZE   (size_t)(63u)
+#define HAL_SIM_SERIAL_RX_BUFFER_SIZE   (size_t)(63u)
+/* 1 start, 8 data and 1 stop bit per character */
+#define HAL_SIM_SERIAL_BITS_PER_CHAR    (uint64_t)(10u)
+#define HAL_SIM_EEPROM_SIZE             (size_t)(E2END + 1)
+#define HAL_SIM_EEPROM_ERASED           (uint8_t)(0xFFu)
+/* Wire results of the AVR library */
+#define HAL_SIM_WIRE_SUCCESS            (uint8_t)(0u)
+#define HAL_SIM_WIRE_ADDRESS_NACK       (uint8_t)(2u)
+#define HAL_SIM_WIRE_OTHER_ERROR        (uint8_t)(4u)
+#define HAL_SIM_WIRE_TIMEOUT            (uint8_t)(5u)
+#define HAL_SIM_NO_DEVICE               (uint8_t)(0xFFu)
+/* Pending pin interrupts of the simulated devices, e.g. the 42 edges of a DHT11 frame */
+#define HAL_SIM_MAX_EVENTS              (uint8_t)(48u)
+/* 13 ADC clocks per conversion, the ADC clock is the 16 MHz CPU clock divided by the prescaler */
+#define HAL_SIM_ADC_CLOCKS_PER_CONVERSION (uint32_t)(13u)
+#define HAL_SIM_CPU_CLOCKS_PER_US       (uint32_t)(16u)
+
+typedef struct
+{
+  uint8_t mode;
+  uint8_t output;
+  uint8_t external;
+  uint8_t script[HAL_SIM_SCRIPT_LEN];
+  uint8_t script_len;
+  uint8_t script_pos;
+} hal_sim_pin_ts;
+
+typedef struct
+{
+  uint16_t value;
+  uint16_t script[HAL_SIM_SCRIPT_LEN];
+  uint8_t script_len;
+  uint8_t script_pos;
+} hal_sim_analog_pin_ts;
+
+typedef struct
+{
+  uint64_t at_us;
+  uint8_t pin;
+} hal_sim_event_ts;
+
+typedef struct
+{
+  bool attached;
+  uint8_t address;
+  uint8_t pointer;
+  uint8_t registers[256];
+} hal_sim_i2c_device_ts;
+
+/* STATIC GLOBAL VARIABLES */
+/* Clock, the ADC and the pin events follow it */
+static uint64_t hal_sim_time_us = 0u;
+static uint64_t hal_sim_adc_time_us = 0u;
+static hal_sim_event_ts hal_sim_events[HAL_SIM_MAX_EVENTS];  // Ordered by time
+static uint8_t hal_sim_num_of_events = 0u;
+
+/* Pins and interrupts */
+static hal_sim_pin_ts hal_sim_pins[NUM_DIGITAL_PINS];
+static hal_sim_analog_pin_ts hal_sim_analog_pins[HAL_SIM_NUM_OF_ANALOG_PINS];
+static void (*hal_sim_interrupt_handlers[HAL_SIM_NUM_OF_INTERRUPTS])();
+/* Like EICRA the mode outlives detachInterrupt(), LOW (the reset value) never latches a flag */
+static int hal_sim_interrupt_modes[HAL_SIM_NUM_OF_INTERRUPTS];
+static uint8_t hal_sim_interrupt_flags = 0u;
+static bool hal_sim_interrupts_enabled = true;
+static uint32_t hal_sim_random_state = 1u;
+
+/* I2C bus */
+static hal_sim_i2c_device_ts hal_sim_i2c_devices[HAL_SIM_I2C_MAX_DEVICES];
+static uint32_t hal_sim_i2c_byte_time_us = HAL_SIM_I2C_BYTE_TIME_US;
+static uint8_t hal_sim_sda_hold_clocks = 0u;  // 0 while SDA is released
+static bool hal_sim_scl_held = false;
+static uint32_t hal_sim_i2c_transactions = 0u;
+static uint32_t hal_sim_i2c_recovery_clocks = 0u;
+
+/* Wire */
+static bool hal_sim_wire_enabled = false;
+static uint32_t hal_sim_wire_timeout_us = 0u;
+static bool hal_sim_wire_timeout_flag = false;
+static uint8_t hal_sim_wire_tx_address = 0u;
+static uint8_t hal_sim_wire_tx_buffer[BUFFER_LENGTH];
+static uint8_t hal_sim_wire_tx_len = 0u;
+static uint8_t hal_sim_wire_rx_buffer[BUFFER_LENGTH];
+static uint8_t hal_sim_wire_rx_len = 0u;
+static uint8_t hal_sim_wire_rx_pos = 0u;
+
+/* Serial */
+static uint64_t hal_sim_serial_char_time_ns = 0u;   // 0 while the port is not started
+static uint64_t hal_sim_serial_sent_until_ns = 0u;  // End of the character on the wire
+static std::string hal_sim_serial_tx_pending;
+static std::string hal_sim_serial_output;
+static std::string hal_sim_serial_input;
+
+/* EEPROM */
+static uint8_t hal_sim_eeprom[HAL_SIM_EEPROM_SIZE];
+static bool hal_sim_eeprom_initialized = false;
+static FILE *hal_sim_eeprom_file = NULL;
+static uint64_t hal_sim_eeprom_busy_until_us = 0u;
+static int32_t hal_sim_eeprom_write_budget = HAL_SIM_EEPROM_UNLIMITED;
+static bool hal_sim_eeprom_power_lost = false;
+static bool hal_sim_eeprom_torn_write = false;
+static uint32_t hal_sim_eeprom_writes = 0u;
+/* *************************************** */
+
+/* AVR registers */
+volatile uint8_t ADMUX = 0u;
+volatile uint8_t ADCSRA = 0u;
+volatile uint8_t DIDR0 = 0u;
+volatile uint16_t ADC = 0u;
+volatile uint8_t SREG = 0u;
+HalSimInterruptFlags EIFR;
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Advances the virtual clock to a point in time.
+ *
+ * Interrupts which happen on the way run at their time: pin events of the simulated
+ * devices and the conversions of a running ADC. Nothing runs while interrupts are disabled,
+ * it is delivered by the next advance after they are enabled again.
+ *
+ * @param at_us The new time, a time in the past leaves the clock as it is.
+ */
+static void advanceTimeTo(uint64_t at_us);
+
+/**
+ * @brief Runs the ADC conversions which complete by the current time.
+ */
+static void runDueConversions();
+
+/**
+ * @brief Returns the level of an I2C line, low if a device or the station pulls it low.
+ */
+static uint8_t busLineLevel(uint8_t pin);
+
+/**
+ * @brief Counts an SCL clock driven by the station, a device holding SDA may let go.
+ */
+static void countRecoveryClock();
+
+/**
+ * @brief Returns the attached device with an address or HAL_SIM_NO_DEVICE.
+ */
+static uint8_t findDevice(uint8_t address);
+
+/**
+ * @brief Checks if a transaction can run, otherwise it times out on the virtual clock.
+ */
+static bool startTransaction();
+
+/**
+ * @brief Returns the next value of an analog pin, scripted or fixed.
+ */
+static uint16_t nextAnalogValue(uint8_t channel);
+
+/**
+ * @brief Moves the characters sent by now from the serial transmit buffer to the captured output.
+ */
+static void drainSerial();
+
+/**
+ * @brief Loads the EEPROM as erased on first use.
+ */
+static void ensureEeprom();
+
+/**
+ * @brief Waits on the virtual clock until the EEPROM write in progress is done.
+ */
+static void waitForEeprom();
+
+/**
+ * @brief Writes one EEPROM byte unless the power is lost.
+ */
+static void writeEeprom(size_t address, uint8_t value);
+/* *************************************** */
+
+/* SIMULATOR */
+void hal_sim_reset()
+{
+  hal_sim_time_us = 0u;
+  hal_sim_adc_time_us = 0u;
+  hal_sim_num_of_events = 0u;
+
+  memset(hal_sim_pins, 0, sizeof(hal_sim_pins));
+  for (uint8_t pin = 0u; pin < NUM_DIGITAL_PINS; pin++)
+  {
+    hal_sim_pins[pin].external = HAL_SIM_PIN_FLOATING;
+  }
+  memset(hal_sim_analog_pins, 0, sizeof(hal_sim_analog_pins));
+  memset(hal_sim_interrupt_handlers, 0, sizeof(hal_sim_interrupt_handlers));
+  memset(hal_sim_interrupt_modes, 0, sizeof(hal_sim_interrupt_modes));
+  hal_sim_interrupt_flags = 0u;
+  hal_sim_interrupts_enabled = true;
+  hal_sim_random_state = 1u;
+  ADMUX = 0u;
+  ADCSRA = 0u;
+  DIDR0 = 0u;
+  ADC = 0u;
+
+  memset(hal_sim_i2c_devices, 0, sizeof(hal_sim_i2c_devices));
+  hal_sim_i2c_byte_time_us = HAL_SIM_I2C_BYTE_TIME_US;
+  hal_sim_sda_hold_clocks = 0u;
+  hal_sim_scl_held = false;
+  hal_sim_i2c_transactions = 0u;
+  hal_sim_i2c_recovery_clocks = 0u;
+  hal_sim_wire_enabled = false;
+  hal_sim_wire_timeout_us = 0u;
+  hal_sim_wire_timeout_flag = false;
+  hal_sim_wire_tx_len = 0u;
+  hal_sim_wire_rx_len = 0u;
+  hal_sim_wire_rx_pos = 0u;
+
+  hal_sim_serial_char_time_ns = 0u;
+  hal_sim_serial_sent_until_ns = 0u;
+  hal_sim_serial_tx_pending.clear();
+  hal_sim_serial_output.clear();
+  hal_sim_serial_input.clear();
+
+  hal_sim_eeprom_busy_until_us = 0u;
+  hal_sim_eeprom_write_budget = HAL_SIM_EEPROM_UNLIMITED;
+  hal_sim_eeprom_power_lost = false;
+  hal_sim_eeprom_torn_write = false;
+  hal_sim_eeprom_writes = 0u;
+
+  hal_sim_resetDevices();
+}
+/* *************************************** */
+
+/* CLOCK */
+void hal_sim_setMillis(uint32_t ms)
+{
+  hal_sim_time_us = (uint64_t)ms * 1000u;
+  hal_sim_adc_time_us = hal_sim_time_us;
+  hal_sim_num_of_events = 0u;
+  hal_sim_serial_sent_until_ns = hal_sim_time_us * 1000u;
+  hal_sim_eeprom_busy_until_us = 0u;
+}
+
+void hal_sim_advanceMicros(uint32_t us)
+{
+  advanceTimeTo(hal_sim_time_us + us);
+}
+
+void hal_sim_advanceMillis(uint32_t ms)
+{
+  advanceTimeTo(hal_sim_time_us + (uint64_t)ms * 1000u);
+}
+
+unsigned long millis()
+{
+  // 32 bits like the AVR core, note that unsigned long itself is 64 bits wide on the host
+  return (uint32_t)(hal_sim_time_us / 1000u);
+}
+
+unsigned long micros()
+{
+  return (uint32_t)hal_sim_time_us;
+}
+
+void delay(unsigned long ms)
+{
+  hal_sim_advanceMillis((uint32_t)ms);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  hal_sim_advanceMicros(us);
+}
+/* *************************************** */
+
+/* PINS AND INTERRUPTS */
+void hal_sim_setDigitalInput(uint8_t pin, uint8_t level)
+{
+  hal_sim_pins[pin].external = level;
+  hal_sim_pins[pin].script_len = 0u;
+}
+
+void hal_sim_scriptDigitalInput(uint8_t pin, const uint8_t *levels, uint8_t num_of_levels)
+{
+  hal_sim_pin_ts *sim_pin = &hal_sim_pins[pin];
+  sim_pin->script_len = min(num_of_levels, HAL_SIM_SCRIPT_LEN);
+  sim_pin->script_pos = 0u;
+  memcpy(sim_pin->script, levels, sim_pin->script_len);
+}
+
+void hal_sim_setAnalogInput(uint8_t pin, uint16_t value)
+{
+  hal_sim_analog_pin_ts *sim_pin = &hal_sim_analog_pins[(pin - A0) % HAL_SIM_NUM_OF_ANALOG_PINS];
+  sim_pin->value = value;
+  sim_pin->script_len = 0u;
+}
+
+void hal_sim_scriptAnalogInput(uint8_t pin, const uint16_t *values, uint8_t num_of_values)
+{
+  hal_sim_analog_pin_ts *sim_pin = &hal_sim_analog_pins[(pin - A0) % HAL_SIM_NUM_OF_ANALOG_PINS];
+  sim_pin->script_len = min(num_of_values, HAL_SIM_SCRIPT_LEN);
+  sim_pin->script_pos = 0u;
+  memcpy(sim_pin->script, values, sim_pin->script_len * sizeof(uint16_t));
+}
+
+uint8_t hal_sim_getPinMode(uint8_t pin)
+{
+  return hal_sim_pins[pin].mode;
+}
+
+uint8_t hal_sim_getDigitalOutput(uint8_t pin)
+{
+  return hal_sim_pins[pin].output;
+}
+
+bool hal_sim_fireInterrupt(uint8_t pin)
+{
+  int interrupt_number = digitalPinToInterrupt(pin);
+  if(NOT_AN_INTERRUPT == interrupt_number)
+  {
+    return false;
+  }
+  if(!hal_sim_interrupts_enabled || NULL == hal_sim_interrupt_handlers[interrupt_number])
+  {
+    hal_sim_latchInterrupt(pin);
+    return false;
+  }
+  hal_sim_interrupt_handlers[interrupt_number]();
+  return true;
+}
+
+void hal_sim_runAdc(uint16_t num_of_conversions)
+{
+  for (uint16_t conversion = 0u; conversion < num_of_conversions; conversion++)
+  {
+    if(0u == (ADCSRA & _BV(ADEN)) || 0u == (ADCSRA & _BV(ADSC)))
+    {
+      return; // No conversion started
+    }
+    ADC = nextAnalogValue((uint8_t)(ADMUX & 0x0Fu));
+    ADCSRA &= (uint8_t)~_BV(ADSC);
+    if(0u != (ADCSRA & _BV(ADIE)) && hal_sim_interrupts_enabled && NULL != ADC_vect)
+    {
+      ADC_vect();
+    }
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  bool scl_was_high = (SCL == pin) && (HIGH == busLineLevel(SCL));
+  hal_sim_pins[pin].mode = mode;
+  if(scl_was_high && LOW == busLineLevel(SCL))
+  {
+    countRecoveryClock();
+  }
+  hal_sim_onPinChanged(pin);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  bool scl_was_high = (SCL == pin) && (HIGH == busLineLevel(SCL));
+  hal_sim_pins[pin].output = (LOW == value) ? LOW : HIGH;
+  if(scl_was_high && LOW == busLineLevel(SCL))
+  {
+    countRecoveryClock();
+  }
+  hal_sim_onPinChanged(pin);
+}
+
+int digitalRead(uint8_t pin)
+{
+  hal_sim_pin_ts *sim_pin = &hal_sim_pins[pin];
+
+  if(SDA == pin || SCL == pin)
+  {
+    return busLineLevel(pin);
+  }
+  if(sim_pin->script_pos < sim_pin->script_len)
+  {
+    sim_pin->external = sim_pin->script[sim_pin->script_pos++];
+    return sim_pin->external;
+  }
+  if(OUTPUT == sim_pin->mode)
+  {
+    return sim_pin->output;
+  }
+  if(HAL_SIM_PIN_FLOATING != sim_pin->external)
+  {
+    return sim_pin->external;
+  }
+  return (INPUT_PULLUP == sim_pin->mode) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  // Like the core, both A0 and 0 select the first analog channel
+  return nextAnalogValue((uint8_t)((pin >= A0) ? (pin - A0) : pin));
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, (0 == value) ? LOW : HIGH);
+}
+
+void attachInterrupt(uint8_t interrupt_number, void (*handler)(), int mode)
+{
+  if(interrupt_number < HAL_SIM_NUM_OF_INTERRUPTS)
+  {
+    hal_sim_interrupt_handlers[interrupt_number] = handler;
+    hal_sim_interrupt_modes[interrupt_number] = mode;
+
+    // A flag latched before runs the handler as soon as the interrupt is enabled
+    uint8_t flag = (uint8_t)_BV(INTF0 + interrupt_number);
+    if(hal_sim_interrupts_enabled && 0u != (hal_sim_interrupt_flags & flag))
+    {
+      hal_sim_interrupt_flags &= (uint8_t)~flag;
+      handler();
+    }
+  }
+}
+
+void detachInterrupt(uint8_t interrupt_number)
+{
+  if(interrupt_number < HAL_SIM_NUM_OF_INTERRUPTS)
+  {
+    hal_sim_interrupt_handlers[interrupt_number] = NULL;
+  }
+}
+
+HalSimInterruptFlags::operator uint8_t() const
+{
+  return hal_sim_interrupt_flags;
+}
+
+HalSimInterruptFlags &HalSimInterruptFlags::operator=(uint8_t cleared_flags)
+{
+  hal_sim_interrupt_flags &= (uint8_t)~cleared_flags;
+  return *this;
+}
+
+void noInterrupts()
+{
+  hal_sim_interrupts_enabled = false;
+}
+
+void interrupts()
+{
+  hal_sim_interrupts_enabled = true;
+}
+
+void hal_sim_latchInterrupt(uint8_t pin)
+{
+  int interrupt_number = digitalPinToInterrupt(pin);
+  if(NOT_AN_INTERRUPT != interrupt_number &&
+     (FALLING == hal_sim_interrupt_modes[interrupt_number] || CHANGE == hal_sim_interrupt_modes[interrupt_number]))
+  {
+    hal_sim_interrupt_flags |= (uint8_t)_BV(INTF0 + interrupt_number);
+  }
+}
+
+uint64_t hal_sim_getTime()
+{
+  return hal_sim_time_us;
+}
+
+bool hal_sim_scheduleInterrupt(uint8_t pin, uint64_t at_us)
+{
+  if(HAL_SIM_MAX_EVENTS <= hal_sim_num_of_events)
+  {
+    return false;
+  }
+  // Insertion keeps the events ordered by time
+  uint8_t index = hal_sim_num_of_events;
+  while(0u != index && hal_sim_events[index - 1u].at_us > at_us)
+  {
+    hal_sim_events[index] = hal_sim_events[index - 1u];
+    index--;
+  }
+  hal_sim_events[index].at_us = at_us;
+  hal_sim_events[index].pin = pin;
+  hal_sim_num_of_events++;
+  return true;
+}
+/* *************************************** */
+
+/* MATH HELPERS */
+long map(long value, long from_low, long from_high, long to_low, long to_high)
+{
+  return (value - from_low) * (to_high - to_low) / (from_high - from_low) + to_low;
+}
+
+long random(long max_value)
+{
+  if(0 >= max_value)
+  {
+    return 0;
+  }
+  // Deterministic, every reset starts the same sequence
+  hal_sim_random_state = hal_sim_random_state * 1103515245u + 12345u;
+  return (long)((hal_sim_random_state >> 1u) % (uint32_t)max_value);
+}
+
+long random(long min_value, long max_value)
+{
+  return (min_value >= max_value) ? min_value : min_value + random(max_value - min_value);
+}
+
+void randomSeed(unsigned long seed)
+{
+  if(0u != seed)
+  {
+    hal_sim_random_state = (uint32_t)seed;
+  }
+}
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer)
+{
+  sprintf(buffer, "%*.*f", width, precision, value);
+  return buffer;
+}
+
+int snprintf_P(char *buffer, size_t size, const char *format, ...)
+{
+  // avr-libc takes %S as a string in program memory, it is a wide string for the C library
+  char host_format[256];
+  size_t out = 0u;
+  bool in_conversion = false;
+
+  for (size_t in = 0u; '\0' != format[in] && out < sizeof(host_format) - 1u; in++)
+  {
+    char character = format[in];
+    if(in_conversion && 'S' == character)
+    {
+      character = 's';
+    }
+    if(in_conversion && NULL != strchr("diouxXeEfFgGaAcsSpn%", format[in]))
+    {
+      in_conversion = false;
+    }
+    else if(!in_conversion && '%' == character)
+    {
+      in_conversion = true;
+    }
+    host_format[out++] = character;
+  }
+  host_format[out] = '\0';
+
+  va_list arguments;
+  va_start(arguments, format);
+  int length = vsnprintf(buffer, size, host_format, arguments);
+  va_end(arguments);
+  return length;
+}
+
+int sprintf_P(char *buffer, const char *format, ...)
+{
+  char formatted[256];
+  va_list arguments;
+  va_start(arguments, format);
+  int length = vsnprintf(formatted, sizeof(formatted), format, arguments);
+  va_end(arguments);
+  strcpy(buffer, formatted);
+  return length;
+}
+/* *************************************** */
+
+/* PRINT AND SERIAL */
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t written = 0u;
+  while(written < size && 0u != write(buffer[written]))
+  {
+    written++;
+  }
+  return written;
+}
+
+size_t Print::print(const __FlashStringHelper *text)
+{
+  return write(reinterpret_cast<const char *>(text));
+}
+
+size_t Print::print(long value, int base)
+{
+  if(10 == base && 0 > value)
+  {
+    return print('-') + print((unsigned long)(-value), base);
+  }
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+  char digits[8 * sizeof(unsigned long) + 1u];
+  char *digit = &digits[sizeof(digits) - 1u];
+  *digit = '\0';
+  base = (2 > base) ? 10 : base;
+  do
+  {
+    unsigned long remainder = value % (unsigned long)base;
+    *--digit = (char)((remainder < 10u) ? ('0' + remainder) : ('A' + remainder - 10u));
+    value /= (unsigned long)base;
+  } while(0u != value);
+  return write(digit);
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+  hal_sim_serial_char_time_ns = (1000000000ull * HAL_SIM_SERIAL_BITS_PER_CHAR) / baud;
+  hal_sim_serial_sent_until_ns = hal_sim_time_us * 1000u;
+}
+
+void HardwareSerial::end()
+{
+  flush();
+  hal_sim_serial_char_time_ns = 0u;
+}
+
+int HardwareSerial::available()
+{
+  return (int)min(hal_sim_serial_input.size(), HAL_SIM_SERIAL_RX_BUFFER_SIZE);
+}
+
+int HardwareSerial::read()
+{
+  if(hal_sim_serial_input.empty())
+  {
+    return -1;
+  }
+  int character = (uint8_t)hal_sim_serial_input[0];
+  hal_sim_serial_input.erase(0u, 1u);
+  return character;
+}
+
+int HardwareSerial::peek()
+{
+  return hal_sim_serial_input.empty() ? -1 : (uint8_t)hal_sim_serial_input[0];
+}
+
+void HardwareSerial::flush()
+{
+  drainSerial();
+  if(!hal_sim_serial_tx_pending.empty())
+  {
+    // Blocks until the last character left the transmitter
+    advanceTimeTo(hal_sim_serial_sent_until_ns / 1000u + 1u);
+    drainSerial();
+  }
+}
+
+int HardwareSerial::availableForWrite()
+{
+  drainSerial();
+  return (int)(HAL_SIM_SERIAL_TX_BUFFER_SIZE - hal_sim_serial_tx_pending.size());
+}
+
+size_t HardwareSerial::write(uint8_t character)
+{
+  if(0u == hal_sim_serial_char_time_ns)
+  {
+    return 0u; // Port not started
+  }
+
+  drainSerial();
+  if(HAL_SIM_SERIAL_TX_BUFFER_SIZE <= hal_sim_serial_tx_pending.size())
+  {
+    // Full buffer, the core busy waits until the oldest character is sent
+    uint64_t oldest_sent_ns = hal_sim_serial_sent_until_ns -
+                              (hal_sim_serial_tx_pending.size() - 1u) * hal_sim_serial_char_time_ns;
+    advanceTimeTo(oldest_sent_ns / 1000u + 1u);
+    drainSerial();
+  }
+  if(hal_sim_serial_tx_pending.empty())
+  {
+    hal_sim_serial_sent_until_ns = hal_sim_time_us * 1000u; // Transmitter was idle
+  }
+  hal_sim_serial_tx_pending.push_back((char)character);
+  hal_sim_serial_sent_until_ns += hal_sim_serial_char_time_ns;
+  return 1u;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  return Print::write(buffer, size);
+}
+
+const char *hal_sim_serialGetOutput()
+{
+  drainSerial();
+  return hal_sim_serial_output.c_str();
+}
+
+void hal_sim_serialClearOutput()
+{
+  drainSerial();
+  hal_sim_serial_output.clear();
+}
+
+void hal_sim_serialInput(const char *text)
+{
+  hal_sim_serial_input.append(text);
+}
+/* *************************************** */
+
+/* I2C BUS */
+bool hal_sim_i2cAttach(uint8_t address)
+{
+  if(HAL_SIM_NO_DEVICE != findDevice(address))
+  {
+    return true;
+  }
+  for (uint8_t index = 0u; index < HAL_SIM_I2C_MAX_DEVICES; index++)
+  {
+    if(!hal_sim_i2c_devices[index].attached)
+    {
+      memset(&hal_sim_i2c_devices[index], 0, sizeof(hal_sim_i2c_device_ts));
+      hal_sim_i2c_devices[index].attached = true;
+      hal_sim_i2c_devices[index].address = address;
+      return true;
+    }
+  }
+  return false;
+}
+
+void hal_sim_i2cDetach(uint8_t address)
+{
+  uint8_t index = findDevice(address);
+  if(HAL_SIM_NO_DEVICE != index)
+  {
+    hal_sim_i2c_devices[index].attached = false;
+  }
+}
+
+void hal_sim_i2cSetRegisters(uint8_t address, uint8_t first_register, const uint8_t *data, uint8_t length)
+{
+  uint8_t index = findDevice(address);
+  for (uint8_t offset = 0u; HAL_SIM_NO_DEVICE != index && offset < length; offset++)
+  {
+    hal_sim_i2c_devices[index].registers[(uint8_t)(first_register + offset)] = data[offset];
+  }
+}
+
+uint8_t hal_sim_i2cGetRegister(uint8_t address, uint8_t register_address)
+{
+  uint8_t index = findDevice(address);
+  return (HAL_SIM_NO_DEVICE != index) ? hal_sim_i2c_devices[index].registers[register_address] : 0u;
+}
+
+void hal_sim_i2cSetByteTime(uint32_t us)
+{
+  hal_sim_i2c_byte_time_us = us;
+}
+
+void hal_sim_i2cHoldSda(uint8_t release_after_clocks)
+{
+  hal_sim_sda_hold_clocks = release_after_clocks;
+}
+
+void hal_sim_i2cHoldScl(bool hold)
+{
+  hal_sim_scl_held = hold;
+}
+
+uint32_t hal_sim_i2cGetTransactions()
+{
+  return hal_sim_i2c_transactions;
+}
+
+uint32_t hal_sim_i2cGetRecoveryClocks()
+{
+  return hal_sim_i2c_recovery_clocks;
+}
+
+void TwoWire::begin()
+{
+  hal_sim_wire_enabled = true;
+  hal_sim_pins[SDA].mode = INPUT_PULLUP;
+  hal_sim_pins[SCL].mode = INPUT_PULLUP;
+}
+
+void TwoWire::end()
+{
+  hal_sim_wire_enabled = false;
+}
+
+void TwoWire::setClock(uint32_t clock_hz)
+{
+  // 9 clocks per byte incl. acknowledge
+  hal_sim_i2c_byte_time_us = (uint32_t)(9000000u / clock_hz);
+}
+
+void TwoWire::setWireTimeout(uint32_t timeout_us, bool reset_with_timeout)
+{
+  (void)reset_with_timeout;
+  hal_sim_wire_timeout_us = timeout_us;
+  hal_sim_wire_timeout_flag = false;
+}
+
+bool TwoWire::getWireTimeoutFlag()
+{
+  return hal_sim_wire_timeout_flag;
+}
+
+void TwoWire::clearWireTimeoutFlag()
+{
+  hal_sim_wire_timeout_flag = false;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  hal_sim_wire_tx_address = address;
+  hal_sim_wire_tx_len = 0u;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t send_stop)
+{
+  (void)send_stop;
+  if(!hal_sim_wire_enabled)
+  {
+    return HAL_SIM_WIRE_OTHER_ERROR;
+  }
+  if(!startTransaction())
+  {
+    return HAL_SIM_WIRE_TIMEOUT;
+  }
+
+  uint8_t index = findDevice(hal_sim_wire_tx_address);
+  if(HAL_SIM_NO_DEVICE == index)
+  {
+    advanceTimeTo(hal_sim_time_us + hal_sim_i2c_byte_time_us); // Only the address byte
+    return HAL_SIM_WIRE_ADDRESS_NACK;
+  }
+
+  advanceTimeTo(hal_sim_time_us + (uint64_t)(1u + hal_sim_wire_tx_len) * hal_sim_i2c_byte_time_us);
+  hal_sim_i2c_device_ts *device = &hal_sim_i2c_devices[index];
+  for (uint8_t byte_index = 0u; byte_index < hal_sim_wire_tx_len; byte_index++)
+  {
+    if(0u == byte_index)
+    {
+      device->pointer = hal_sim_wire_tx_buffer[0];
+    }
+    else
+    {
+      device->registers[device->pointer++] = hal_sim_wire_tx_buffer[byte_index];
+    }
+  }
+  return HAL_SIM_WIRE_SUCCESS;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t send_stop)
+{
+  (void)send_stop;
+  hal_sim_wire_rx_len = 0u;
+  hal_sim_wire_rx_pos = 0u;
+  quantity = min(quantity, (uint8_t)BUFFER_LENGTH);
+  if(!hal_sim_wire_enabled || !startTransaction())
+  {
+    return 0u;
+  }
+
+  uint8_t index = findDevice(address);
+  if(HAL_SIM_NO_DEVICE == index)
+  {
+    advanceTimeTo(hal_sim_time_us + hal_sim_i2c_byte_time_us);
+    return 0u;
+  }
+
+  advanceTimeTo(hal_sim_time_us + (uint64_t)(1u + quantity) * hal_sim_i2c_byte_time_us);
+  hal_sim_i2c_device_ts *device = &hal_sim_i2c_devices[index];
+  uint8_t pointer = device->pointer;
+  for (uint8_t byte_index = 0u; byte_index < quantity; byte_index++)
+  {
+    hal_sim_wire_rx_buffer[byte_index] = device->registers[pointer++];
+  }
+  hal_sim_wire_rx_len = quantity;
+  return quantity;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if(BUFFER_LENGTH <= hal_sim_wire_tx_len)
+  {
+    return 0u;
+  }
+  hal_sim_wire_tx_buffer[hal_sim_wire_tx_len++] = data;
+  return 1u;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  size_t written = 0u;
+  while(written < quantity && 0u != write(data[written]))
+  {
+    written++;
+  }
+  return written;
+}
+
+int TwoWire::available()
+{
+  return hal_sim_wire_rx_len - hal_sim_wire_rx_pos;
+}
+
+int TwoWire::read()
+{
+  return (hal_sim_wire_rx_pos < hal_sim_wire_rx_len) ? hal_sim_wire_rx_buffer[hal_sim_wire_rx_pos++] : -1;
+}
+
+int TwoWire::peek()
+{
+  return (hal_sim_wire_rx_pos < hal_sim_wire_rx_len) ? hal_sim_wire_rx_buffer[hal_sim_wire_rx_pos] : -1;
+}
+/* *************************************** */
+
+/* EEPROM */
+bool hal_sim_eepromOpen(const char *path)
+{
+  hal_sim_eepromClose();
+  ensureEeprom();
+
+  hal_sim_eeprom_file = fopen(path, "r+b");
+  if(NULL == hal_sim_eeprom_file)
+  {
+    hal_sim_eeprom_file = fopen(path, "w+b");
+  }
+  if(NULL == hal_sim_eeprom_file)
+  {
+    return false;
+  }
+
+  memset(hal_sim_eeprom, HAL_SIM_EEPROM_ERASED, sizeof(hal_sim_eeprom));
+  size_t loaded = fread(hal_sim_eeprom, 1u, sizeof(hal_sim_eeprom), hal_sim_eeprom_file);
+  // Extend a short file, so every address can be written through
+  fseek(hal_sim_eeprom_file, (long)loaded, SEEK_SET);
+  fwrite(&hal_sim_eeprom[loaded], 1u, sizeof(hal_sim_eeprom) - loaded, hal_sim_eeprom_file);
+  fflush(hal_sim_eeprom_file);
+  return true;
+}
+
+void hal_sim_eepromClose()
+{
+  if(NULL != hal_sim_eeprom_file)
+  {
+    fclose(hal_sim_eeprom_file);
+    hal_sim_eeprom_file = NULL;
+  }
+}
+
+void hal_sim_eepromErase()
+{
+  for (size_t address = 0u; address < HAL_SIM_EEPROM_SIZE; address++)
+  {
+    hal_sim_eeprom[address] = HAL_SIM_EEPROM_ERASED;
+  }
+  hal_sim_eeprom_initialized = true;
+  if(NULL != hal_sim_eeprom_file)
+  {
+    fseek(hal_sim_eeprom_file, 0, SEEK_SET);
+    fwrite(hal_sim_eeprom, 1u, sizeof(hal_sim_eeprom), hal_sim_eeprom_file);
+    fflush(hal_sim_eeprom_file);
+  }
+}
+
+void hal_sim_eepromSetWriteBudget(int32_t writes)
+{
+  hal_sim_eeprom_write_budget = writes;
+  hal_sim_eeprom_power_lost = false;
+}
+
+void hal_sim_eepromSetTornWrite(bool torn)
+{
+  hal_sim_eeprom_torn_write = torn;
+}
+
+bool hal_sim_eepromIsPowerLost()
+{
+  return hal_sim_eeprom_power_lost;
+}
+
+uint32_t hal_sim_eepromGetWrites()
+{
+  return hal_sim_eeprom_writes;
+}
+
+int eeprom_is_ready()
+{
+  return (hal_sim_time_us >= hal_sim_eeprom_busy_until_us) ? 1 : 0;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address)
+{
+  ensureEeprom();
+  waitForEeprom();
+  return hal_sim_eeprom[(uintptr_t)address & E2END];
+}
+
+void eeprom_write_byte(uint8_t *address, uint8_t value)
+{
+  ensureEeprom();
+  waitForEeprom();
+  writeEeprom((uintptr_t)address & E2END, value);
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value)
+{
+  // Like avr-libc, an unchanged byte is not written and does not wear the cell
+  if(eeprom_read_byte(address) != value)
+  {
+    writeEeprom((uintptr_t)address & E2END, value);
+  }
+}
+
+void eeprom_read_block(void *destination, const void *source, size_t size)
+{
+  for (size_t offset = 0u; offset < size; offset++)
+  {
+    ((uint8_t *)destination)[offset] = eeprom_read_byte((const uint8_t *)source + offset);
+  }
+}
+
+void eeprom_update_block(const void *source, void *destination, size_t size)
+{
+  for (size_t offset = 0u; offset < size; offset++)
+  {
+    eeprom_update_byte((uint8_t *)destination + offset, ((const uint8_t *)source)[offset]);
+  }
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void advanceTimeTo(uint64_t at_us)
+{
+  while(hal_sim_interrupts_enabled && 0u != hal_sim_num_of_events && hal_sim_events[0].at_us <= at_us)
+  {
+    hal_sim_event_ts event = hal_sim_events[0];
+    hal_sim_num_of_events--;
+    memmove(&hal_sim_events[0], &hal_sim_events[1], hal_sim_num_of_events * sizeof(hal_sim_event_ts));
+
+    // The handler sees the time of its edge, e.g. in micros()
+    hal_sim_time_us = max(hal_sim_time_us, event.at_us);
+    runDueConversions();
+    (void)hal_sim_fireInterrupt(event.pin);
+  }
+  hal_sim_time_us = max(hal_sim_time_us, at_us);
+  runDueConversions();
+}
+
+static void runDueConversions()
+{
+  uint8_t prescaler_bits = (uint8_t)(ADCSRA & (_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0)));
+  uint32_t prescaler = (0u == prescaler_bits) ? 2u : (1u << prescaler_bits);
+  uint32_t conversion_us = max(1u, HAL_SIM_ADC_CLOCKS_PER_CONVERSION * prescaler / HAL_SIM_CPU_CLOCKS_PER_US);
+
+  if(!hal_sim_interrupts_enabled || 0u == (ADCSRA & _BV(ADEN)) || 0u == (ADCSRA & _BV(ADSC)))
+  {
+    hal_sim_adc_time_us = hal_sim_time_us; // Idle, the next conversion starts now
+    return;
+  }
+  while(hal_sim_adc_time_us + conversion_us <= hal_sim_time_us && 0u != (ADCSRA & _BV(ADSC)))
+  {
+    hal_sim_adc_time_us += conversion_us;
+    hal_sim_runAdc(1u);
+  }
+}
+
+static uint8_t busLineLevel(uint8_t pin)
+{
+  if((SDA == pin && 0u != hal_sim_sda_hold_clocks) || (SCL == pin && hal_sim_scl_held))
+  {
+    return LOW;
+  }
+  // Open drain, the station only pulls a line low while the pin is a low output
+  bool driven_low = !hal_sim_wire_enabled && OUTPUT == hal_sim_pins[pin].mode && LOW == hal_sim_pins[pin].output;
+  return driven_low ? LOW : HIGH;
+}
+
+static void countRecoveryClock()
+{
+  hal_sim_i2c_recovery_clocks++;
+  if(0u != hal_sim_sda_hold_clocks && HAL_SIM_I2C_HOLD_FOREVER != hal_sim_sda_hold_clocks)
+  {
+    hal_sim_sda_hold_clocks--;
+  }
+}
+
+static uint8_t findDevice(uint8_t address)
+{
+  for (uint8_t index = 0u; index < HAL_SIM_I2C_MAX_DEVICES; index++)
+  {
+    if(hal_sim_i2c_devices[index].attached && address == hal_sim_i2c_devices[index].address)
+    {
+      return index;
+    }
+  }
+  return HAL_SIM_NO_DEVICE;
+}
+
+static bool startTransaction()
+{
+  if(0u != hal_sim_sda_hold_clocks || hal_sim_scl_held)
+  {
+    // TWI hardware waits for the bus until the timeout resets it, without a timeout it would hang
+    advanceTimeTo(hal_sim_time_us + ((0u != hal_sim_wire_timeout_us) ? hal_sim_wire_timeout_us : 25000u));
+    hal_sim_wire_timeout_flag = true;
+    return false;
+  }
+  hal_sim_i2c_transactions++;
+  return true;
+}
+
+static uint16_t nextAnalogValue(uint8_t channel)
+{
+  hal_sim_analog_pin_ts *sim_pin = &hal_sim_analog_pins[channel % HAL_SIM_NUM_OF_ANALOG_PINS];
+  if(sim_pin->script_pos < sim_pin->script_len)
+  {
+    sim_pin->value = sim_pin->script[sim_pin->script_pos++];
+  }
+  return sim_pin->value;
+}
+
+static void drainSerial()
+{
+  if(hal_sim_serial_tx_pending.empty())
+  {
+    return;
+  }
+  uint64_t now_ns = hal_sim_time_us * 1000u;
+  // Characters still on the wire or in the buffer, the last one ends at sent_until
+  uint64_t remaining_ns = (hal_sim_serial_sent_until_ns > now_ns) ? (hal_sim_serial_sent_until_ns - now_ns) : 0u;
+  size_t remaining = (size_t)((remaining_ns + hal_sim_serial_char_time_ns - 1u) / hal_sim_serial_char_time_ns);
+  size_t sent = hal_sim_serial_tx_pending.size() - min(remaining, hal_sim_serial_tx_pending.size());
+
+  hal_sim_serial_output.append(hal_sim_serial_tx_pending, 0u, sent);
+  hal_sim_serial_tx_pending.erase(0u, sent);
+}
+
+static void ensureEeprom()
+{
+  if(!hal_sim_eeprom_initialized)
+  {
+    memset(hal_sim_eeprom, HAL_SIM_EEPROM_ERASED, sizeof(hal_sim_eeprom));
+    hal_sim_eeprom_initialized = true;
+  }
+}
+
+static void waitForEeprom()
+{
+  advanceTimeTo(hal_sim_eeprom_busy_until_us);
+}
+
+static void writeEeprom(size_t address, uint8_t value)
+{
+  if(hal_sim_eeprom_power_lost)
+  {
+    return;
+  }
+  if(0 == hal_sim_eeprom_write_budget)
+  {
+    // Only the write in flight at the power loss can be torn
+    hal_sim_eeprom_power_lost = true;
+    if(!hal_sim_eeprom_torn_write)
+    {
+      return;
+    }
+    value ^= HAL_SIM_EEPROM_TORN_PATTERN;
+  }
+  else
+  {
+    if(0 < hal_sim_eeprom_write_budget)
+    {
+      hal_sim_eeprom_write_budget--;
+    }
+    hal_sim_eeprom_writes++;
+  }
+
+  hal_sim_eeprom[address] = value;
+  hal_sim_eeprom_busy_until_us = hal_sim_time_us + HAL_SIM_EEPROM_WRITE_TIME_US;
+  if(NULL != hal_sim_eeprom_file)
+  {
+    fseek(hal_sim_eeprom_file, (long)address, SEEK_SET);
+    fputc(value, hal_sim_eeprom_file);
+    fflush(hal_sim_eeprom_file);
+  }
+}
+/* *************************************** */
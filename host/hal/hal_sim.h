@@ -0,0 +1,368 @@
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include <Arduino.h>
+
+/**
+ * @file hal_sim.h
+ * @brief Control of the simulated board behind the host stand-ins of the Arduino core and libraries.
+ *
+ * The station code runs unchanged on the host against:
+ * - a virtual clock, which only moves through hal_sim_advanceMicros(), delay() and the time
+ *   the simulated hardware takes (I2C bytes, serial characters, EEPROM writes),
+ * - scripted digital and analog inputs and external interrupts fired by the test,
+ * - an I2C bus with register based devices, a per-byte latency and lines a device can hold low,
+ * - the LCD framebuffer and the serial output captured as text,
+ * - an EEPROM which can be backed by a file and lose its power after a number of writes.
+ *
+ * Everything is reset by hal_sim_reset(), except the EEPROM content, which survives like on the board.
+ * The state of the station code itself is only reset by a new process, the tests therefore run
+ * one test per process (gtest_discover_tests()).
+ */
+
+/* Level of an input pin that no test sets, the pull-up decides */
+#define HAL_SIM_PIN_FLOATING          (uint8_t)(0xFFu)
+
+/* Bus time of one byte incl. acknowledge at 100 kHz */
+#define HAL_SIM_I2C_BYTE_TIME_US      (uint32_t)(90u)
+/* A held line is never released by clocking SCL */
+#define HAL_SIM_I2C_HOLD_FOREVER      (uint8_t)(0xFFu)
+/* Most devices on the simulated bus */
+#define HAL_SIM_I2C_MAX_DEVICES       (uint8_t)(8u)
+
+/* ATmega328P EEPROM write time of one byte */
+#define HAL_SIM_EEPROM_WRITE_TIME_US  (uint32_t)(3400u)
+/* Write budget of an EEPROM which never loses its power */
+#define HAL_SIM_EEPROM_UNLIMITED      (int32_t)(-1)
+/* Mixed into the value of a torn EEPROM write, see hal_sim_eepromSetTornWrite() */
+#define HAL_SIM_EEPROM_TORN_PATTERN   (uint8_t)(0xA5u)
+
+/* I2C addresses of the station devices, see hal_sim_attachStation() */
+#define HAL_SIM_LCD_ADDRESS           (uint8_t)(0x27u)
+#define HAL_SIM_BMP280_ADDRESS        (uint8_t)(0x76u)
+#define HAL_SIM_BH1750_ADDRESS        (uint8_t)(0x23u)
+#define HAL_SIM_RTC_ADDRESS           (uint8_t)(0x68u)
+/* Data pin of the DHT11 */
+#define HAL_SIM_DHT11_PIN             (uint8_t)(2u)
+
+/* SIMULATOR */
+/**
+ * @brief Resets the clock, pins, interrupts, bus, captures and the EEPROM power, not the EEPROM content.
+ */
+void hal_sim_reset();
+
+/**
+ * @brief Attaches the I2C devices of the station with plausible readings.
+ *
+ * LCD, BMP280 (21.5 C, 1013.25 hPa), BH1750 (300 lx) and DS3231 (2024-06-01 12:00:00) on the bus,
+ * a DHT11 (21 C, 45 %) and the analog sensors (clean air, low UV, dry).
+ */
+void hal_sim_attachStation();
+/* *************************************** */
+
+/* CLOCK */
+/**
+ * @brief Sets the virtual clock, e.g. shortly before millis() wraps around.
+ *
+ * @param ms New value of millis(), micros() follows with the same origin.
+ */
+void hal_sim_setMillis(uint32_t ms);
+
+/**
+ * @brief Advances the virtual clock.
+ *
+ * @param us Microseconds to advance.
+ */
+void hal_sim_advanceMicros(uint32_t us);
+
+/**
+ * @brief Advances the virtual clock.
+ *
+ * @param ms Milliseconds to advance.
+ */
+void hal_sim_advanceMillis(uint32_t ms);
+/* *************************************** */
+
+/* PINS AND INTERRUPTS */
+/**
+ * @brief Sets the level an external circuit drives on a digital pin.
+ *
+ * @param pin The pin.
+ * @param level LOW, HIGH or HAL_SIM_PIN_FLOATING.
+ */
+void hal_sim_setDigitalInput(uint8_t pin, uint8_t level);
+
+/**
+ * @brief Scripts the levels returned by the next digitalRead() calls of a pin.
+ *
+ * Every read takes the next level, the last one stays afterwards.
+ *
+ * @param pin The pin.
+ * @param levels The levels, copied.
+ * @param num_of_levels Number of levels, at most 32.
+ */
+void hal_sim_scriptDigitalInput(uint8_t pin, const uint8_t *levels, uint8_t num_of_levels);
+
+/**
+ * @brief Sets the value an analog pin converts to.
+ *
+ * @param pin The pin, A0 to A7.
+ * @param value 10-bit conversion result.
+ */
+void hal_sim_setAnalogInput(uint8_t pin, uint16_t value);
+
+/**
+ * @brief Scripts the values returned by the next conversions of an analog pin.
+ *
+ * Every conversion (analogRead() or hal_sim_runAdc()) takes the next value, the last one stays afterwards.
+ *
+ * @param pin The pin, A0 to A7.
+ * @param values The 10-bit values, copied.
+ * @param num_of_values Number of values, at most 32.
+ */
+void hal_sim_scriptAnalogInput(uint8_t pin, const uint16_t *values, uint8_t num_of_values);
+
+/**
+ * @brief Returns the mode set by pinMode().
+ *
+ * @param pin The pin.
+ * @return uint8_t INPUT, OUTPUT or INPUT_PULLUP.
+ */
+uint8_t hal_sim_getPinMode(uint8_t pin);
+
+/**
+ * @brief Returns the level of the output register set by digitalWrite().
+ *
+ * @param pin The pin.
+ * @return uint8_t LOW or HIGH.
+ */
+uint8_t hal_sim_getDigitalOutput(uint8_t pin);
+
+/**
+ * @brief Runs the interrupt handler attached to a pin, if any and if interrupts are enabled.
+ *
+ * Otherwise the edge latches the flag of the interrupt in EIFR, see hal_sim_latchInterrupt().
+ *
+ * @param pin The pin, 2 or 3.
+ * @return bool true if a handler ran.
+ */
+bool hal_sim_fireInterrupt(uint8_t pin);
+
+/**
+ * @brief Runs ADC conversions of the free running, interrupt driven ADC.
+ *
+ * Every conversion takes the value of the pin selected in ADMUX and calls ADC_vect
+ * if ADIE is set. Nothing happens while no conversion is started (ADSC).
+ * A started conversion also completes on its own once the virtual clock passed its
+ * conversion time, this runs conversions without advancing the clock.
+ *
+ * @param num_of_conversions Number of conversions.
+ */
+void hal_sim_runAdc(uint16_t num_of_conversions);
+/* *************************************** */
+
+/* I2C BUS */
+/**
+ * @brief Attaches a register based device.
+ *
+ * The first written byte of a transaction selects a register, further written bytes go to the
+ * following registers. Every read starts at the selected register, so a device which keeps
+ * sending its latest measurement (BH1750) needs no command before each read.
+ *
+ * @param address 7-bit address.
+ * @return bool false if HAL_SIM_I2C_MAX_DEVICES are attached already.
+ */
+bool hal_sim_i2cAttach(uint8_t address);
+
+/**
+ * @brief Removes a device from the bus, it no longer acknowledges its address.
+ *
+ * @param address 7-bit address.
+ */
+void hal_sim_i2cDetach(uint8_t address);
+
+/**
+ * @brief Writes into the registers of an attached device.
+ *
+ * @param address 7-bit address.
+ * @param first_register First register to write.
+ * @param data The bytes.
+ * @param length Number of bytes.
+ */
+void hal_sim_i2cSetRegisters(uint8_t address, uint8_t first_register, const uint8_t *data, uint8_t length);
+
+/**
+ * @brief Returns a register of an attached device, e.g. written by the station.
+ *
+ * @param address 7-bit address.
+ * @param register_address The register.
+ * @return uint8_t The value, 0 for an unknown device.
+ */
+uint8_t hal_sim_i2cGetRegister(uint8_t address, uint8_t register_address);
+
+/**
+ * @brief Sets the bus time of every byte, including the address byte.
+ *
+ * @param us Microseconds per byte, HAL_SIM_I2C_BYTE_TIME_US after a reset.
+ */
+void hal_sim_i2cSetByteTime(uint32_t us);
+
+/**
+ * @brief Lets a device hold SDA low, like one reset in the middle of a byte.
+ *
+ * Transactions time out while SDA is held. The device lets go after a number of SCL clocks
+ * driven by the station (bus recovery).
+ *
+ * @param release_after_clocks SCL clocks until SDA is released, HAL_SIM_I2C_HOLD_FOREVER, 0 releases it now.
+ */
+void hal_sim_i2cHoldSda(uint8_t release_after_clocks);
+
+/**
+ * @brief Lets a device hold SCL low, which no clocking releases.
+ *
+ * @param hold true to hold, false to release.
+ */
+void hal_sim_i2cHoldScl(bool hold);
+
+/**
+ * @brief Returns the number of transactions (address bytes) sent on the bus.
+ *
+ * @return uint32_t Transactions since the reset.
+ */
+uint32_t hal_sim_i2cGetTransactions();
+
+/**
+ * @brief Returns the number of SCL clocks driven by the station outside of Wire.
+ *
+ * @return uint32_t Clocks since the reset.
+ */
+uint32_t hal_sim_i2cGetRecoveryClocks();
+/* *************************************** */
+
+/* STATION DEVICES */
+/**
+ * @brief Connects a DHT11 to HAL_SIM_DHT11_PIN, or changes its readings.
+ *
+ * The sensor answers every start signal with the 42 falling edges of a frame, which run
+ * the interrupt handler of the pin at their time on the virtual clock.
+ *
+ * @param temperature_c Temperature in degree Celsius, resolution 0.1.
+ * @param humidity_percent Relative humidity, resolution 0.1.
+ */
+void hal_sim_attachDht11(float temperature_c, float humidity_percent);
+
+/**
+ * @brief Disconnects the DHT11, start signals stay unanswered.
+ */
+void hal_sim_detachDht11();
+
+/**
+ * @brief Sets the compensated readings of the simulated BMP280.
+ *
+ * @param temperature_c Temperature in degree Celsius.
+ * @param pressure_pa Pressure in Pascals.
+ */
+void hal_sim_setBarometer(float temperature_c, float pressure_pa);
+
+/**
+ * @brief Sets the reading of the simulated BH1750.
+ *
+ * @param lux Light level, at most 54612 lx.
+ */
+void hal_sim_setLightLevel(float lux);
+
+/**
+ * @brief Sets the time registers of the simulated DS3231.
+ */
+void hal_sim_setRtcTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+
+/**
+ * @brief Returns a row of the LCD as seen on the glass.
+ *
+ * @param row The row.
+ * @return const char* The characters of the row, null-terminated, valid until the next reset.
+ */
+const char *hal_sim_lcdGetRow(uint8_t row);
+
+/**
+ * @brief Returns the number of characters written to the LCD.
+ *
+ * @return uint32_t Characters since the reset.
+ */
+uint32_t hal_sim_lcdGetWrites();
+/* *************************************** */
+
+/* SERIAL */
+/**
+ * @brief Returns the characters which left the serial transmitter since the last clear.
+ *
+ * Characters still in the hardware buffer are not part of it yet, advance the clock to send them.
+ *
+ * @return const char* The text, valid until the next write or clear.
+ */
+const char *hal_sim_serialGetOutput();
+
+/**
+ * @brief Clears the captured serial output.
+ */
+void hal_sim_serialClearOutput();
+
+/**
+ * @brief Queues characters as received by the serial port.
+ *
+ * @param text The characters.
+ */
+void hal_sim_serialInput(const char *text);
+/* *************************************** */
+
+/* EEPROM */
+/**
+ * @brief Backs the EEPROM with a file, the content is loaded from it and every write goes through.
+ *
+ * A missing or short file reads as erased (0xFF).
+ *
+ * @param path Path of the file.
+ * @return bool false if the file cannot be opened.
+ */
+bool hal_sim_eepromOpen(const char *path);
+
+/**
+ * @brief Detaches the EEPROM from its file, the content stays.
+ */
+void hal_sim_eepromClose();
+
+/**
+ * @brief Erases the whole EEPROM to 0xFF.
+ */
+void hal_sim_eepromErase();
+
+/**
+ * @brief Cuts the power after a number of further byte writes, later writes are lost.
+ *
+ * @param writes Byte writes which still complete, HAL_SIM_EEPROM_UNLIMITED to keep the power.
+ */
+void hal_sim_eepromSetWriteBudget(int32_t writes);
+
+/**
+ * @brief Selects what the write which runs out of the budget leaves in its cell.
+ *
+ * @param torn false: the cell keeps its old value, true: it holds neither the old nor the new value.
+ */
+void hal_sim_eepromSetTornWrite(bool torn);
+
+/**
+ * @brief Checks if the write budget ran out.
+ *
+ * @return bool true if a write was lost.
+ */
+bool hal_sim_eepromIsPowerLost();
+
+/**
+ * @brief Returns the number of completed byte writes.
+ *
+ * @return uint32_t Writes since the reset.
+ */
+uint32_t hal_sim_eepromGetWrites();
+/* *************************************** */
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HAL_SIM_INTERNAL_H
+#define HAL_SIM_INTERNAL_H
+
+#include "hal_sim.h"
+
+/**
+ * @file hal_sim_internal.h
+ * @brief Functions shared between the parts of the simulator, not used by tests.
+ */
+
+/**
+ * @brief Resets the state of the simulated station devices (LCD glass, library objects).
+ */
+void hal_sim_resetDevices();
+
+/**
+ * @brief Lets the simulated devices react to a changed pin mode or output level of the station.
+ *
+ * @param pin The pin.
+ */
+void hal_sim_onPinChanged(uint8_t pin);
+
+/**
+ * @brief Latches the flag of a pin interrupt for a falling edge, if its last mode reacts to it.
+ *
+ * The flag stays set until the station clears it in EIFR or attaches a handler, which then runs at once.
+ *
+ * @param pin The pin, 2 or 3, other pins are ignored.
+ */
+void hal_sim_latchInterrupt(uint8_t pin);
+
+/**
+ * @brief Returns the virtual clock without the 32-bit wrap around of micros().
+ *
+ * @return uint64_t Microseconds since the reset.
+ */
+uint64_t hal_sim_getTime();
+
+/**
+ * @brief Runs the interrupt of a pin once the virtual clock reaches a point in time.
+ *
+ * @param pin The pin, 2 or 3.
+ * @param at_us Time of the edge, see hal_sim_getTime().
+ * @return bool false if too many events are pending.
+ */
+bool hal_sim_scheduleInterrupt(uint8_t pin, uint64_t at_us);
+
+#endif
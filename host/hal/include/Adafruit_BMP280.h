@@ -0,0 +1,76 @@
+#ifndef __BMP280_H__
+#define __BMP280_H__
+
+/**
+ * @file Adafruit_BMP280.h
+ * @brief Host stand-in of the Adafruit BMP280 library on the simulated I2C bus.
+ *
+ * begin() checks the chip ID like the library. The simulated sensor holds already compensated
+ * values, see hal_sim_setBarometer(), so the library skips the calibration math.
+ */
+
+#include <Arduino.h>
+
+/* Chip ID register and value of the BMP280 */
+#define BMP280_REGISTER_CHIPID    0xD0
+#define BMP280_CHIPID             0x58
+
+class Adafruit_BMP280
+{
+public:
+  enum sensor_mode
+  {
+    MODE_SLEEP = 0x00,
+    MODE_FORCED = 0x01,
+    MODE_NORMAL = 0x03,
+    MODE_SOFT_RESET_CODE = 0xB6
+  };
+
+  enum sensor_sampling
+  {
+    SAMPLING_NONE = 0x00,
+    SAMPLING_X1 = 0x01,
+    SAMPLING_X2 = 0x02,
+    SAMPLING_X4 = 0x03,
+    SAMPLING_X8 = 0x04,
+    SAMPLING_X16 = 0x05
+  };
+
+  enum sensor_filter
+  {
+    FILTER_OFF = 0x00,
+    FILTER_X2 = 0x01,
+    FILTER_X4 = 0x02,
+    FILTER_X8 = 0x03,
+    FILTER_X16 = 0x04
+  };
+
+  enum standby_duration
+  {
+    STANDBY_MS_0_5 = 0x00,
+    STANDBY_MS_62_5 = 0x01,
+    STANDBY_MS_125 = 0x02,
+    STANDBY_MS_250 = 0x03,
+    STANDBY_MS_500 = 0x04,
+    STANDBY_MS_1000 = 0x05,
+    STANDBY_MS_2000 = 0x06,
+    STANDBY_MS_4000 = 0x07
+  };
+
+  bool begin(uint8_t address = 0x77, uint8_t chip_id = BMP280_CHIPID);
+  void setSampling(sensor_mode mode = MODE_NORMAL,
+                   sensor_sampling temperature_sampling = SAMPLING_X16,
+                   sensor_sampling pressure_sampling = SAMPLING_X16,
+                   sensor_filter filter = FILTER_OFF,
+                   standby_duration duration = STANDBY_MS_0_5);
+  float readTemperature();
+  float readPressure();
+  float readAltitude(float sea_level_hpa = 1013.25f);
+
+private:
+  bool readRegisters(uint8_t first_register, uint8_t *data, uint8_t length);
+
+  uint8_t address;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/**
+ * @file Arduino.h
+ * @brief Host stand-in of the Arduino AVR core, backed by the simulator in hal_sim.h.
+ *
+ * Only the part of the core used by the station is declared, with the signatures and
+ * pin numbers of an ATmega328P board (Uno, Nano). Time, pins, interrupts and the ADC
+ * registers are virtual and driven by the tests through hal_sim.h.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <avr/pgmspace.h>
+
+/* Pin levels and modes */
+#define LOW                 0x0
+#define HIGH                0x1
+#define INPUT               0x0
+#define OUTPUT              0x1
+#define INPUT_PULLUP        0x2
+
+/* Interrupt modes */
+#define CHANGE              1
+#define FALLING             2
+#define RISING              3
+#define NOT_AN_INTERRUPT    -1
+
+/* ATmega328P pins, the analog pins follow the 14 digital ones */
+#define NUM_DIGITAL_PINS    22
+#define A0                  (uint8_t)(14u)
+#define A1                  (uint8_t)(15u)
+#define A2                  (uint8_t)(16u)
+#define A3                  (uint8_t)(17u)
+#define A4                  (uint8_t)(18u)
+#define A5                  (uint8_t)(19u)
+#define A6                  (uint8_t)(20u)
+#define A7                  (uint8_t)(21u)
+#define SDA                 (uint8_t)(18u)
+#define SCL                 (uint8_t)(19u)
+#define digitalPinToInterrupt(p)  ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+/* ADC registers and bits, conversions are run by hal_sim_runAdc() */
+#define REFS0               6
+#define ADEN                7
+#define ADSC                6
+#define ADIE                3
+#define ADPS2               2
+#define ADPS1               1
+#define ADPS0               0
+extern volatile uint8_t ADMUX;
+extern volatile uint8_t ADCSRA;
+extern volatile uint8_t DIDR0;
+extern volatile uint16_t ADC;
+extern volatile uint8_t SREG;
+
+/* External interrupt flags, an edge latches the flag of INT0 or INT1 even while no handler is attached */
+#define INTF0               0
+#define INTF1               1
+class HalSimInterruptFlags
+{
+public:
+  operator uint8_t() const;
+  HalSimInterruptFlags &operator=(uint8_t cleared_flags); // Like the hardware, writing a 1 clears the flag
+};
+extern HalSimInterruptFlags EIFR;
+
+#define ISR(vector)         extern "C" void vector()
+#define cli()               noInterrupts()
+#define sei()               interrupts()
+
+#define _BV(bit)            (1u << (bit))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define min(a, b)           ((a) < (b) ? (a) : (b))
+#define max(a, b)           ((a) > (b) ? (a) : (b))
+#define constrain(x, l, h)  ((x) < (l) ? (l) : ((x) > (h) ? (h) : (x)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+/* Strings in program memory, flash and RAM are the same address space on the host */
+class __FlashStringHelper;
+#define F(string_literal)   (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+/* Time, virtual and only advanced by the simulator, delay() and delayMicroseconds() */
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/* Digital and analog pins */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+/* Interrupts */
+void attachInterrupt(uint8_t interrupt_number, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interrupt_number);
+void noInterrupts();
+void interrupts();
+
+/* Math helpers */
+long map(long value, long from_low, long from_high, long to_low, long to_high);
+long random(long max_value);
+long random(long min_value, long max_value);
+void randomSeed(unsigned long seed);
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+
+/**
+ * Base of the character outputs, like the core every print ends in write(uint8_t).
+ */
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t character) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  virtual int availableForWrite() { return 0; }
+
+  size_t write(const char *text) { return (NULL == text) ? 0u : write((const uint8_t *)text, strlen(text)); }
+  size_t print(const __FlashStringHelper *text);
+  size_t print(const char *text) { return write(text); }
+  size_t print(char character) { return write((uint8_t)character); }
+  size_t print(long value, int base = 10);
+  size_t print(unsigned long value, int base = 10);
+  size_t print(int value, int base = 10) { return print((long)value, base); }
+  size_t print(unsigned int value, int base = 10) { return print((unsigned long)value, base); }
+  size_t println() { return write("\r\n"); }
+  size_t println(const char *text) { return print(text) + println(); }
+  size_t println(const __FlashStringHelper *text) { return print(text) + println(); }
+  size_t println(unsigned long value, int base = 10) { return print(value, base) + println(); }
+};
+
+/**
+ * USART0, the transmit buffer drains at the baud rate of the virtual clock.
+ */
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long baud);
+  void end();
+  int available();
+  int read();
+  int peek();
+  void flush();
+  int availableForWrite() override;
+  size_t write(uint8_t character) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
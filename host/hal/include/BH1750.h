@@ -0,0 +1,39 @@
+#ifndef BH1750_h
+#define BH1750_h
+
+/**
+ * @file BH1750.h
+ * @brief Host stand-in of the BH1750 light sensor library on the simulated I2C bus.
+ *
+ * The measurement is read as two bytes after the mode command, like the sensor sends it.
+ * hal_sim_setLightLevel() sets the value of a simulated sensor.
+ */
+
+#include <Arduino.h>
+
+/* Default address, ADDR pin low */
+#define BH1750_DEFAULT_ADDRESS    0x23
+
+class BH1750
+{
+public:
+  enum Mode
+  {
+    UNCONFIGURED = 0,
+    CONTINUOUS_HIGH_RES_MODE = 0x10,
+    CONTINUOUS_HIGH_RES_MODE_2 = 0x11,
+    CONTINUOUS_LOW_RES_MODE = 0x13,
+    ONE_TIME_HIGH_RES_MODE = 0x20
+  };
+
+  BH1750(uint8_t address = BH1750_DEFAULT_ADDRESS);
+  bool begin(Mode mode = CONTINUOUS_HIGH_RES_MODE, uint8_t address = 0u);
+  bool configure(Mode mode);
+  float readLightLevel();
+
+private:
+  uint8_t address;
+  Mode mode;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef LiquidCrystal_I2C_h
+#define LiquidCrystal_I2C_h
+
+/**
+ * @file LiquidCrystal_I2C.h
+ * @brief Host stand-in of the HD44780 LCD behind a PCF8574 expander.
+ *
+ * Every command and character is sent over the simulated I2C bus like the library does
+ * (two nibbles, each latched with an enable pulse), so it costs bus time. What the LCD
+ * acknowledges lands in the framebuffer captured by hal_sim_lcdGetRow().
+ */
+
+#include <Arduino.h>
+
+class LiquidCrystal_I2C : public Print
+{
+public:
+  LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows);
+  void begin(uint8_t columns, uint8_t rows);
+  void init();
+  void clear();
+  void home();
+  void setCursor(uint8_t column, uint8_t row);
+  void backlight();
+  void noBacklight();
+  void cursor();
+  void noCursor();
+  size_t write(uint8_t character) override;
+  using Print::write;
+
+private:
+  bool send(uint8_t value, bool is_character);
+
+  uint8_t address;
+  uint8_t columns;
+  uint8_t rows;
+  uint8_t backlight_bit;
+};
+
+#endif
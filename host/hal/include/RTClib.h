@@ -0,0 +1,48 @@
+#ifndef _RTCLIB_H_
+#define _RTCLIB_H_
+
+/**
+ * @file RTClib.h
+ * @brief Host stand-in of the RTClib DS3231 driver on the simulated I2C bus.
+ *
+ * The time is read from the BCD time registers of the simulated DS3231, see hal_sim_setRtcTime().
+ */
+
+#include <Arduino.h>
+
+/* I2C address of the DS3231 */
+#define DS3231_ADDRESS    0x68
+
+class DateTime
+{
+public:
+  DateTime(uint16_t year = 2000u, uint8_t month = 1u, uint8_t day = 1u,
+           uint8_t hour = 0u, uint8_t minute = 0u, uint8_t second = 0u);
+  DateTime(const __FlashStringHelper *date, const __FlashStringHelper *time);
+  uint16_t year() const { return (uint16_t)(2000u + yOff); }
+  uint8_t month() const { return m; }
+  uint8_t day() const { return d; }
+  uint8_t hour() const { return hh; }
+  uint8_t minute() const { return mm; }
+  uint8_t second() const { return ss; }
+  uint32_t unixtime() const;
+
+private:
+  uint8_t yOff;
+  uint8_t m;
+  uint8_t d;
+  uint8_t hh;
+  uint8_t mm;
+  uint8_t ss;
+};
+
+class RTC_DS3231
+{
+public:
+  bool begin();
+  bool lostPower();
+  void adjust(const DateTime &date_time);
+  DateTime now();
+};
+
+#endif
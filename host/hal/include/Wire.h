@@ -0,0 +1,36 @@
+#ifndef TwoWire_h
+#define TwoWire_h
+
+/**
+ * @file Wire.h
+ * @brief Host stand-in of the Arduino Wire library, connected to the simulated I2C bus of hal_sim.h.
+ */
+
+#include <Arduino.h>
+
+/* Size of the transmit and receive buffers, like the AVR library */
+#define BUFFER_LENGTH   32
+
+class TwoWire
+{
+public:
+  void begin();
+  void end();
+  void setClock(uint32_t clock_hz);
+  void setWireTimeout(uint32_t timeout_us = 25000u, bool reset_with_timeout = false);
+  bool getWireTimeoutFlag();
+  void clearWireTimeoutFlag();
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(uint8_t send_stop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t send_stop = true);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t quantity);
+  int available();
+  int read();
+  int peek();
+};
+
+extern TwoWire Wire;
+
+#endif
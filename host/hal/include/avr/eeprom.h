@@ -0,0 +1,26 @@
+#ifndef _AVR_EEPROM_H_
+#define _AVR_EEPROM_H_
+
+/**
+ * @file eeprom.h
+ * @brief Host stand-in of the avr-libc EEPROM access, backed by the simulator in hal_sim.h.
+ *
+ * Every written byte keeps the EEPROM busy for the write time of the ATmega328P, the blocking
+ * functions wait for it on the virtual clock. The content can be backed by a file and writes
+ * can be cut off to simulate a power loss.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Last EEPROM address of the ATmega328P */
+#define E2END       0x3FF
+
+int eeprom_is_ready();
+uint8_t eeprom_read_byte(const uint8_t *address);
+void eeprom_write_byte(uint8_t *address, uint8_t value);
+void eeprom_update_byte(uint8_t *address, uint8_t value);
+void eeprom_read_block(void *destination, const void *source, size_t size);
+void eeprom_update_block(const void *source, void *destination, size_t size);
+
+#endif
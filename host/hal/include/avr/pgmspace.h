@@ -0,0 +1,37 @@
+#ifndef __PGMSPACE_H_
+#define __PGMSPACE_H_
+
+/**
+ * @file pgmspace.h
+ * @brief Host stand-in of avr-libc program memory access.
+ *
+ * Flash and RAM share one address space on the host, the _P functions work on plain pointers.
+ * Unlike the C library, the formatting functions take "%S" as a string in program memory,
+ * like avr-libc does.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P                   const char *
+#define PSTR(string_literal)    (string_literal)
+
+#define pgm_read_byte(address)  (*(const uint8_t *)(address))
+#define pgm_read_word(address)  (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_float(address) (*(const float *)(address))
+#define pgm_read_ptr(address)   (*(const void * const *)(address))
+
+#define memcpy_P                memcpy
+#define strlen_P                strlen
+#define strcmp_P                strcmp
+#define strcpy_P                strcpy
+#define strncpy_P               strncpy
+#define strncat_P               strncat
+
+int snprintf_P(char *buffer, size_t size, const char *format, ...);
+int sprintf_P(char *buffer, const char *format, ...);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef PROFILE_FULL_H
+#define PROFILE_FULL_H
+
+/**
+ * @file profile_full.h
+ * @brief Settings of the "full" host build profile, on top of src/project_settings.h.
+ *
+ * Enables the features which are commented out by default to save SRAM.
+ */
+
+#define DATA_LOGGER_COMPONENT               (uint8_t)(2u)
+#define SENSOR_STATS_USED
+#define REPORT_FILTER_USED
+#define TASK_PROFILER_USED
+/* The default profile keeps the newest serial messages, this one tests the other policy */
+#define SERIAL_CONSOLE_TX_DROP_POLICY       (uint8_t)(1u)
+
+#endif
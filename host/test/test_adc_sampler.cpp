@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include "src/input/sensors/sensor_library/adc_sampler/adc_sampler.h"
+#include "hal_sim.h"
+
+/* Conversions of one value of a pin, the discarded one after the switch included */
+#define TEST_CONVERSIONS_PER_VALUE  (uint16_t)(ADC_SAMPLER_SAMPLES_PER_VALUE + ADC_SAMPLER_SETTLING_SAMPLES)
+
+/**
+ * @brief Scripts a pin: the conversion right after the switch to it, then the summed ones.
+ *
+ * The last summed value stays on the pin afterwards.
+ */
+static void scriptValue(uint8_t pin, uint16_t settling_value, const uint16_t *samples)
+{
+  uint16_t values[TEST_CONVERSIONS_PER_VALUE];
+  values[0] = settling_value;
+  for (uint8_t sample = 0u; sample < ADC_SAMPLER_SAMPLES_PER_VALUE; sample++)
+  {
+    values[ADC_SAMPLER_SETTLING_SAMPLES + sample] = samples[sample];
+  }
+  hal_sim_scriptAnalogInput(pin, values, (uint8_t)TEST_CONVERSIONS_PER_VALUE);
+}
+
+class AdcSampler : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    hal_sim_reset();
+  }
+};
+
+TEST_F(AdcSampler, DecimatesTheSumOfTheConversions)
+{
+  // 100 to 115, the sum 1720 shifted by the extra bits
+  uint16_t samples[ADC_SAMPLER_SAMPLES_PER_VALUE];
+  uint16_t sum = 0u;
+  for (uint8_t sample = 0u; sample < ADC_SAMPLER_SAMPLES_PER_VALUE; sample++)
+  {
+    samples[sample] = (uint16_t)(100u + sample);
+    sum = (uint16_t)(sum + samples[sample]);
+  }
+  scriptValue(A3, 0u, samples);
+  uint8_t channel = adc_sampler_attach(A3);
+  ASSERT_NE(ADC_SAMPLER_NO_CHANNEL, channel);
+
+  // No value before the last conversion of the first one
+  hal_sim_runAdc(TEST_CONVERSIONS_PER_VALUE - 1u);
+  EXPECT_EQ(ADC_SAMPLER_NO_VALUE, adc_sampler_read(channel));
+  hal_sim_runAdc(1u);
+  EXPECT_EQ(sum >> SENSORS_ADC_OVERSAMPLING_BITS, adc_sampler_read(channel));
+}
+
+TEST_F(AdcSampler, ExtraBitsResolveBetweenAdcSteps)
+{
+  // Half of the conversions one step higher reads as half a step
+  uint16_t samples[ADC_SAMPLER_SAMPLES_PER_VALUE];
+  for (uint8_t sample = 0u; sample < ADC_SAMPLER_SAMPLES_PER_VALUE; sample++)
+  {
+    samples[sample] = (uint16_t)(500u + sample % 2u);
+  }
+  scriptValue(A3, 500u, samples);
+  uint8_t channel = adc_sampler_attach(A3);
+  hal_sim_runAdc(TEST_CONVERSIONS_PER_VALUE);
+
+  EXPECT_EQ((500u << SENSORS_ADC_OVERSAMPLING_BITS) + (1u << SENSORS_ADC_OVERSAMPLING_BITS) / 2u, adc_sampler_read(channel));
+}
+
+TEST_F(AdcSampler, FullScaleInputReadsAsFullScale)
+{
+  hal_sim_setAnalogInput(A0, ADC_SAMPLER_ADC_MAX);
+  uint8_t channel = adc_sampler_attach(A0);
+  hal_sim_runAdc(TEST_CONVERSIONS_PER_VALUE);
+
+  EXPECT_EQ(ADC_SAMPLER_FULL_SCALE, adc_sampler_read(channel));
+}
+
+TEST_F(AdcSampler, DiscardsTheFirstConversionAfterEverySwitch)
+{
+  // The sample and hold capacitor still holds the other pin, a full scale spike is scripted there
+  const uint16_t low_samples[ADC_SAMPLER_SAMPLES_PER_VALUE] = {200u, 200u, 200u, 200u, 200u, 200u, 200u, 200u,
+                                                               200u, 200u, 200u, 200u, 200u, 200u, 200u, 200u};
+  const uint16_t high_samples[ADC_SAMPLER_SAMPLES_PER_VALUE] = {300u, 300u, 300u, 300u, 300u, 300u, 300u, 300u,
+                                                                300u, 300u, 300u, 300u, 300u, 300u, 300u, 300u};
+  static_assert(16u == ADC_SAMPLER_SAMPLES_PER_VALUE, "Samples are listed for SENSORS_ADC_OVERSAMPLING_BITS 2");
+  scriptValue(A1, ADC_SAMPLER_ADC_MAX, low_samples);
+  scriptValue(A2, ADC_SAMPLER_ADC_MAX, high_samples);
+  uint8_t low_channel = adc_sampler_attach(A1);
+  uint8_t high_channel = adc_sampler_attach(A2);
+
+  // Round-robin, one value per pin and then the first pin again
+  hal_sim_runAdc(TEST_CONVERSIONS_PER_VALUE);
+  EXPECT_EQ(200u << SENSORS_ADC_OVERSAMPLING_BITS, adc_sampler_read(low_channel));
+  EXPECT_EQ(ADC_SAMPLER_NO_VALUE, adc_sampler_read(high_channel));
+  EXPECT_EQ(ADC_SAMPLER_PIN_TO_MUX(A2), ADMUX & ADC_SAMPLER_MUX_MASK);
+
+  hal_sim_runAdc(TEST_CONVERSIONS_PER_VALUE);
+  EXPECT_EQ(300u << SENSORS_ADC_OVERSAMPLING_BITS, adc_sampler_read(high_channel));
+  EXPECT_EQ(ADC_SAMPLER_PIN_TO_MUX(A1), ADMUX & ADC_SAMPLER_MUX_MASK);
+
+  scriptValue(A1, ADC_SAMPLER_ADC_MAX, high_samples);
+  hal_sim_runAdc(TEST_CONVERSIONS_PER_VALUE);
+  EXPECT_EQ(300u << SENSORS_ADC_OVERSAMPLING_BITS, adc_sampler_read(low_channel));
+}
+
+TEST_F(AdcSampler, AttachingAPinAgainKeepsItsChannel)
+{
+  uint8_t channel = adc_sampler_attach(A2);
+  EXPECT_EQ(channel, adc_sampler_attach(A2));
+  EXPECT_EQ(channel, adc_sampler_attach(ADC_SAMPLER_PIN_TO_MUX(A2)));
+
+  // The digital input buffer of the pin is off
+  EXPECT_NE(0u, DIDR0 & (1u << ADC_SAMPLER_PIN_TO_MUX(A2)));
+}
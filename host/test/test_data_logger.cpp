@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "src/output/data_logger/data_logger.h"
+#include "hal_sim.h"
+
+/**
+ * @brief How the byte in flight at the power loss ends up in the EEPROM.
+ */
+typedef enum
+{
+  TEST_WRITE_LOST,  // The cell keeps its old value
+  TEST_WRITE_TORN   // The cell holds neither the old nor the new value
+} test_power_loss_te;
+
+/**
+ * EEPROM backed by a file, which keeps the log across simulated reboots.
+ */
+class DataLogger : public ::testing::Test
+{
+protected:
+  char path[32];
+  float next_value = 1.0f;
+
+  void SetUp() override
+  {
+    snprintf(path, sizeof(path), "/tmp/data_logger_XXXXXX");
+    int descriptor = mkstemp(path);
+    ASSERT_NE(-1, descriptor);
+    close(descriptor);
+
+    hal_sim_reset();
+    hal_sim_eepromErase();
+    ASSERT_TRUE(hal_sim_eepromOpen(path));
+    (void)data_logger_init();
+  }
+
+  void TearDown() override
+  {
+    hal_sim_eepromClose();
+    remove(path);
+  }
+
+  /**
+   * @brief Restarts the station: RAM is lost, the EEPROM is loaded again from its file.
+   */
+  void reboot()
+  {
+    hal_sim_eepromClose();
+    hal_sim_eepromErase();
+    hal_sim_eepromSetWriteBudget(HAL_SIM_EEPROM_UNLIMITED);
+    hal_sim_eepromSetTornWrite(false);
+    ASSERT_TRUE(hal_sim_eepromOpen(path));
+    (void)data_logger_init();
+  }
+
+  /**
+   * @brief Logs the readings of one page, every one with a new value, and starts its flush.
+   */
+  void fillPage()
+  {
+    // Every channel is logged once per interval
+    hal_sim_advanceMillis(DATA_LOGGER_LOG_INTERVAL_MS);
+    for (uint8_t sensor_id = 1u; sensor_id <= DATA_LOGGER_RECORDS_PER_PAGE; sensor_id++)
+    {
+      control_data_ts data = {};
+      data.input.io_component = INPUT_SENSORS;
+      data.input.device_id = sensor_id;
+      data.input_return.sensor_reading.value = sensors_toValue(next_value);
+      data.input_return.sensor_reading.measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
+      next_value += 1.0f;
+      ASSERT_EQ(ERROR_CODE_NO_ERROR, data_logger_displayData(&data));
+    }
+    ASSERT_TRUE(data_logger_isBusy());
+  }
+
+  /**
+   * @brief Runs the background loop until the page is written, one byte per EEPROM write time.
+   */
+  void flushPage()
+  {
+    while(data_logger_isBusy())
+    {
+      data_logger_loop();
+      hal_sim_advanceMicros(HAL_SIM_EEPROM_WRITE_TIME_US);
+    }
+  }
+
+  void logPages(uint8_t num_of_pages)
+  {
+    for (uint8_t page = 0u; page < num_of_pages; page++)
+    {
+      fillPage();
+      flushPage();
+    }
+  }
+
+  /**
+   * @brief Writes a page and cuts the power at one of its byte writes.
+   *
+   * @return bool true if the power was cut, false if the page needed fewer writes.
+   */
+  bool logPageCutAt(int32_t write, test_power_loss_te power_loss)
+  {
+    fillPage();
+    hal_sim_eepromSetWriteBudget(write);
+    hal_sim_eepromSetTornWrite(TEST_WRITE_TORN == power_loss);
+    flushPage();
+    return hal_sim_eepromIsPowerLost();
+  }
+
+/**
+   * @brief Returns the values of the dumped records, oldest first.
+   */
+  std::vector<float> dumpValues()
+  {
+    std::vector<float> values;
+    char line[DATA_LOGGER_DUMP_LINE_SIZE];
+    data_logger_startDump();
+    while(DATA_LOGGER_DUMP_LINE_READY == data_logger_readDumpLine(line))
+    {
+      if(0 != strncmp(line, "LOG,END", 7u))
+      {
+        values.push_back(strtof(strrchr(line, ',') + 1, nullptr));
+      }
+    }
+    return values;
+  }
+
+  static std::vector<float> valueRange(float first, float last)
+  {
+    std::vector<float> values;
+    for (float value = first; value <= last; value += 1.0f)
+    {
+      values.push_back(value);
+    }
+    return values;
+  }
+};
+
+TEST_F(DataLogger, PagesSurviveAReboot)
+{
+  logPages(2u);
+  reboot();
+  EXPECT_EQ(valueRange(1.0f, 6.0f), dumpValues());
+
+  // The next page goes after the recovered ones
+  logPages(1u);
+  reboot();
+  EXPECT_EQ(valueRange(1.0f, 9.0f), dumpValues());
+}
+
+TEST_F(DataLogger, PowerLossAtEveryWriteOfAnErasedPage)
+{
+  for (test_power_loss_te power_loss : {TEST_WRITE_LOST, TEST_WRITE_TORN})
+  {
+    bool power_cut = true;
+    for (int32_t write = 0; power_cut; write++)
+    {
+      SCOPED_TRACE(testing::Message() << "power loss " << power_loss << " at write " << write);
+      ASSERT_GE(DATA_LOGGER_PAGE_SIZE, write);
+      TearDown();
+      SetUp();
+      next_value = 1.0f;
+
+      logPages(2u);
+      power_cut = logPageCutAt(write, power_loss);
+      reboot();
+      if(!power_cut)
+      {
+        EXPECT_EQ(valueRange(1.0f, 9.0f), dumpValues());
+        break;
+      }
+
+      // The torn page is ignored
+      EXPECT_EQ(valueRange(1.0f, 6.0f), dumpValues());
+
+      // Logging goes on at it as if the page was never started
+      logPages(1u);
+      reboot();
+      std::vector<float> expected = valueRange(1.0f, 6.0f);
+      for (float value : valueRange(10.0f, 12.0f))
+      {
+        expected.push_back(value);
+      }
+      EXPECT_EQ(expected, dumpValues());
+    }
+  }
+}
+
+TEST_F(DataLogger, PowerLossAtEveryWriteOfTheOldestPage)
+{
+  for (test_power_loss_te power_loss : {TEST_WRITE_LOST, TEST_WRITE_TORN})
+  {
+    bool power_cut = true;
+    for (int32_t write = 0; power_cut; write++)
+    {
+      SCOPED_TRACE(testing::Message() << "power loss " << power_loss << " at write " << write);
+      ASSERT_GE(DATA_LOGGER_PAGE_SIZE, write);
+      TearDown();
+      SetUp();
+      next_value = 1.0f;
+
+      // The log is full, the next page overwrites page 0 with the oldest records
+      logPages(DATA_LOGGER_NUM_OF_PAGES);
+      float newest_value = next_value - 1.0f;
+      power_cut = logPageCutAt(write, power_loss);
+      reboot();
+      if(!power_cut)
+      {
+        EXPECT_EQ(valueRange(1.0f + DATA_LOGGER_RECORDS_PER_PAGE, newest_value + DATA_LOGGER_RECORDS_PER_PAGE),
+                  dumpValues());
+        break;
+      }
+
+      // Once the first byte of the oldest page is overwritten, its records are gone, never garbage
+      std::vector<float> values = dumpValues();
+      if(values.size() == (size_t)DATA_LOGGER_NUM_OF_PAGES * DATA_LOGGER_RECORDS_PER_PAGE)
+      {
+        EXPECT_EQ(valueRange(1.0f, newest_value), values);
+      }
+      else
+      {
+        EXPECT_EQ(valueRange(1.0f + DATA_LOGGER_RECORDS_PER_PAGE, newest_value), values);
+      }
+
+      // The next page goes to page 0 again and comes out as the newest
+      next_value = 1000.0f;
+      logPages(1u);
+      reboot();
+      std::vector<float> expected = valueRange(1.0f + DATA_LOGGER_RECORDS_PER_PAGE, newest_value);
+      for (float value : valueRange(1000.0f, 999.0f + DATA_LOGGER_RECORDS_PER_PAGE))
+      {
+        expected.push_back(value);
+      }
+      EXPECT_EQ(expected, dumpValues());
+    }
+  }
+}
+
+TEST_F(DataLogger, CompletedFlushIsKept)
+{
+  logPages(2u);
+  fillPage();
+  flushPage();
+  hal_sim_eepromSetWriteBudget(0);
+  reboot();
+  EXPECT_EQ(valueRange(1.0f, 9.0f), dumpValues());
+
+  // The next page goes after the kept one
+  logPages(1u);
+  reboot();
+  EXPECT_EQ(valueRange(1.0f, 12.0f), dumpValues());
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include "src/input/sensors/sensor_library/dht11/dht11.h"
+#include "hal_sim.h"
+
+/* Nominal periods between two falling edges, as sent by the sensor */
+#define TEST_RESPONSE_PERIOD_US  (uint16_t)(160u)
+#define TEST_BIT_ZERO_US         (uint16_t)(77u)
+#define TEST_BIT_ONE_US          (uint16_t)(120u)
+
+/**
+ * @brief Edge times of a frame, which the tests distort before decoding.
+ */
+typedef struct
+{
+  uint16_t edges_us[DHT11_FRAME_EDGES];
+  uint16_t periods_us[DHT11_FRAME_EDGES]; // Period ending at each edge, index 0 is unused
+} test_frame_ts;
+
+/**
+ * @brief Builds the periods of a frame with a valid checksum.
+ */
+static test_frame_ts makeFrame(uint8_t humidity, uint8_t humidity_decimal, uint8_t temperature, uint8_t temperature_decimal)
+{
+  const uint8_t bytes[DHT11_FRAME_BYTES] = {humidity, humidity_decimal, temperature, temperature_decimal,
+                                            (uint8_t)(humidity + humidity_decimal + temperature + temperature_decimal)};
+  test_frame_ts frame = {};
+  frame.periods_us[1] = TEST_RESPONSE_PERIOD_US;
+  for (uint8_t bit = 0u; bit < DHT11_FRAME_BITS; bit++)
+  {
+    bool is_one = (0u != (bytes[bit / 8u] & (0x80u >> (bit % 8u))));
+    frame.periods_us[DHT11_RESPONSE_EDGES + bit] = is_one ? TEST_BIT_ONE_US : TEST_BIT_ZERO_US;
+  }
+  return frame;
+}
+
+/**
+ * @brief Turns the periods into the micros() values the pin interrupt captures.
+ */
+static bool decode(test_frame_ts *frame, dht11_snapshot_ts *snapshot, uint16_t start_us = 1000u, uint8_t num_of_edges = DHT11_FRAME_EDGES)
+{
+  frame->edges_us[0] = start_us;
+  for (uint8_t edge = 1u; edge < DHT11_FRAME_EDGES; edge++)
+  {
+    frame->edges_us[edge] = (uint16_t)(frame->edges_us[edge - 1u] + frame->periods_us[edge]);
+  }
+  return dht11_decodeFrame(frame->edges_us, num_of_edges, snapshot);
+}
+
+/**
+ * @brief Runs dht11_loop() on the virtual clock until the acquisition is finished.
+ */
+static void runAcquisition()
+{
+  unsigned long start_ms = millis();
+  while(DHT11_READING_READY != dht11_isReadingReady() && millis() - start_ms < DHT11_POWER_UP_DELAY_MS + DHT11_MIN_READ_INTERVAL_MS)
+  {
+    dht11_loop(millis());
+    delay(1u);
+  }
+}
+
+static void expectValue(float expected, sensors_value_t actual)
+{
+  EXPECT_NEAR((double)sensors_toValue(expected), (double)actual, (double)SENSORS_VALUE_ONE / 1000.0);
+}
+
+TEST(Dht11, DecodesANominalFrame)
+{
+  test_frame_ts frame = makeFrame(45u, 0u, 21u, 3u);
+  dht11_snapshot_ts snapshot;
+
+  ASSERT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot));
+  expectValue(45.0f, snapshot.humidity);
+  expectValue(21.3f, snapshot.temperature);
+}
+
+TEST(Dht11, DecodesNegativeTemperatures)
+{
+  // -2.3 C is sent as -1 - 2 + 0.7 with the sign bit in the decimal byte
+  test_frame_ts frame = makeFrame(80u, 0u, 2u, (uint8_t)(DHT11_TEMPERATURE_NEGATIVE_MASK | 7u));
+  dht11_snapshot_ts snapshot;
+
+  ASSERT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot));
+  expectValue(-2.3f, snapshot.temperature);
+}
+
+TEST(Dht11, SplitsBitsAtTheThreshold)
+{
+  dht11_snapshot_ts snapshot;
+
+  // The first humidity bit is a 0, still a 0 at the threshold and a 1 just above it
+  test_frame_ts frame = makeFrame(45u, 0u, 21u, 0u);
+  frame.periods_us[DHT11_RESPONSE_EDGES] = DHT11_BIT_ONE_THRESHOLD_US;
+  ASSERT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot));
+  expectValue(45.0f, snapshot.humidity);
+
+  frame.periods_us[DHT11_RESPONSE_EDGES] = DHT11_BIT_ONE_THRESHOLD_US + 1u;
+  // 45 + 128 makes the checksum wrong, the flipped bit is detected
+  EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot));
+}
+
+TEST(Dht11, AcceptsBitPeriodsWithinTheLimits)
+{
+  dht11_snapshot_ts snapshot;
+  test_frame_ts frame = makeFrame(45u, 0u, 21u, 0u);
+
+  for (uint8_t bit = 0u; bit < DHT11_FRAME_BITS; bit++)
+  {
+    uint16_t *period = &frame.periods_us[DHT11_RESPONSE_EDGES + bit];
+    *period = (TEST_BIT_ONE_US == *period) ? DHT11_BIT_PERIOD_MAX_US : DHT11_BIT_PERIOD_MIN_US;
+  }
+  ASSERT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot));
+  expectValue(45.0f, snapshot.humidity);
+  expectValue(21.0f, snapshot.temperature);
+}
+
+TEST(Dht11, RejectsGlitchesAndMissedEdges)
+{
+  dht11_snapshot_ts snapshot;
+  const uint8_t edges[] = {DHT11_RESPONSE_EDGES, 20u, DHT11_FRAME_EDGES - 1u};
+
+  for (uint8_t edge : edges)
+  {
+    // A glitch adds a short period, a missed edge merges two periods
+    test_frame_ts frame = makeFrame(45u, 0u, 21u, 0u);
+    frame.periods_us[edge] = DHT11_BIT_PERIOD_MIN_US - 1u;
+    EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot)) << "glitch at edge " << (int)edge;
+
+    frame.periods_us[edge] = DHT11_BIT_PERIOD_MAX_US + 1u;
+    EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot)) << "missed edge at " << (int)edge;
+  }
+}
+
+TEST(Dht11, ChecksTheResponsePeriod)
+{
+  dht11_snapshot_ts snapshot;
+  test_frame_ts frame = makeFrame(45u, 0u, 21u, 0u);
+
+  frame.periods_us[1] = DHT11_RESPONSE_PERIOD_MIN_US;
+  EXPECT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot));
+  frame.periods_us[1] = DHT11_RESPONSE_PERIOD_MAX_US;
+  EXPECT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot));
+
+  frame.periods_us[1] = DHT11_RESPONSE_PERIOD_MIN_US - 1u;
+  EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot));
+  frame.periods_us[1] = DHT11_RESPONSE_PERIOD_MAX_US + 1u;
+  EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot));
+}
+
+TEST(Dht11, DecodesAcrossTheMicrosWrap)
+{
+  dht11_snapshot_ts snapshot;
+  test_frame_ts frame = makeFrame(45u, 0u, 21u, 3u);
+
+  // Only the low 16 bits of micros() are captured, they wrap in the middle of the frame
+  ASSERT_EQ(DHT11_FRAME_VALID, decode(&frame, &snapshot, (uint16_t)(0xFFFFu - 1500u)));
+  expectValue(21.3f, snapshot.temperature);
+}
+
+TEST(Dht11, RejectsIncompleteFramesAndBadChecksums)
+{
+  dht11_snapshot_ts snapshot;
+  test_frame_ts frame = makeFrame(45u, 0u, 21u, 0u);
+
+  EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot, 1000u, DHT11_FRAME_EDGES - 1u));
+
+  // Flipping the last checksum bit from 0 to 1
+  frame = makeFrame(45u, 0u, 21u, 0u);
+  frame.periods_us[DHT11_FRAME_EDGES - 1u] = TEST_BIT_ONE_US;
+  EXPECT_EQ(DHT11_FRAME_INVALID, decode(&frame, &snapshot));
+}
+
+TEST(Dht11, TakesAcquisitionsBackToBack)
+{
+  hal_sim_reset();
+  hal_sim_attachDht11(21.0f, 45.0f);
+  ASSERT_TRUE(dht11_init());
+
+  runAcquisition();
+  ASSERT_EQ(DHT11_READING_READY, dht11_isReadingReady());
+  expectValue(21.0f, dht11_readTemperature());
+  expectValue(45.0f, dht11_readHumidity());
+
+  // The start signal of the next acquisition must not be captured as the first edge of its frame
+  hal_sim_attachDht11(23.0f, 60.0f);
+  dht11_startReading();
+  runAcquisition();
+  ASSERT_EQ(DHT11_READING_READY, dht11_isReadingReady());
+  expectValue(23.0f, dht11_readTemperature());
+  expectValue(60.0f, dht11_readHumidity());
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+
+#include "hal_sim.h"
+#include <Wire.h>
+#include <avr/eeprom.h>
+
+// The simulated board must behave like the real one, otherwise the station tests prove nothing
+
+static uint8_t hal_sim_test_edges = 0u;
+static uint32_t hal_sim_test_edge_us[48];
+
+static void countEdge()
+{
+  hal_sim_test_edge_us[hal_sim_test_edges % 48u] = micros();
+  hal_sim_test_edges++;
+}
+
+TEST(HalSim, ClockWrapsLikeThe32BitCore)
+{
+  hal_sim_reset();
+  hal_sim_setMillis(0xFFFFFFF0u);
+  EXPECT_EQ(0xFFFFFFF0ul, millis());
+
+  delay(0x20u);
+  EXPECT_EQ(0x10ul, millis());
+
+  delayMicroseconds(1500u);
+  EXPECT_EQ(0x11ul, millis());
+}
+
+TEST(HalSim, SerialSendsAtTheBaudRate)
+{
+  hal_sim_reset();
+  Serial.begin(9600u);
+  EXPECT_EQ(63, Serial.availableForWrite());
+
+  Serial.print("0123456789");
+  EXPECT_EQ(53, Serial.availableForWrite());
+  EXPECT_STREQ("", hal_sim_serialGetOutput());
+
+  // 10 bits per character, about 1.04 ms each at 9600 baud
+  hal_sim_advanceMicros(5300u);
+  EXPECT_STREQ("01234", hal_sim_serialGetOutput());
+  hal_sim_advanceMicros(5300u);
+  EXPECT_STREQ("0123456789", hal_sim_serialGetOutput());
+}
+
+TEST(HalSim, SerialBlocksOnAFullBuffer)
+{
+  hal_sim_reset();
+  Serial.begin(9600u);
+  std::string text(100u, 'x');
+
+  Serial.print(text.c_str());
+
+  // The last 63 characters fit into the buffer, the writer waited for the first 37
+  EXPECT_GE(micros(), 37u * 1041u);
+  EXPECT_LT(micros(), 38u * 1042u);
+  Serial.flush();
+  EXPECT_EQ(text, hal_sim_serialGetOutput());
+}
+
+TEST(HalSim, I2cRegistersAndLatency)
+{
+  hal_sim_reset();
+  ASSERT_TRUE(hal_sim_i2cAttach(0x50u));
+  Wire.begin();
+
+  Wire.beginTransmission(0x50u);
+  (void)Wire.write(0x10u);
+  (void)Wire.write(0xABu);
+  (void)Wire.write(0xCDu);
+  EXPECT_EQ(0u, Wire.endTransmission());
+  EXPECT_EQ(0xABu, hal_sim_i2cGetRegister(0x50u, 0x10u));
+  EXPECT_EQ(0xCDu, hal_sim_i2cGetRegister(0x50u, 0x11u));
+  // Address and 3 data bytes
+  EXPECT_EQ(4u * HAL_SIM_I2C_BYTE_TIME_US, micros());
+
+  // The register pointer advanced past the written bytes, set it back before reading
+  Wire.beginTransmission(0x50u);
+  (void)Wire.write(0x10u);
+  EXPECT_EQ(0u, Wire.endTransmission(false));
+  EXPECT_EQ(2u, Wire.requestFrom((uint8_t)0x50u, (uint8_t)2u));
+  EXPECT_EQ(0xAB, Wire.read());
+  EXPECT_EQ(0xCD, Wire.read());
+  EXPECT_EQ(-1, Wire.read());
+  EXPECT_EQ(3u, hal_sim_i2cGetTransactions());
+
+  Wire.beginTransmission(0x51u);
+  EXPECT_EQ(2u, Wire.endTransmission()); // Address not acknowledged
+}
+
+TEST(HalSim, HeldSdaTimesOutUntilClockedFree)
+{
+  hal_sim_reset();
+  ASSERT_TRUE(hal_sim_i2cAttach(0x50u));
+  Wire.begin();
+  Wire.setWireTimeout(25000u, true);
+  hal_sim_i2cHoldSda(3u);
+
+  Wire.beginTransmission(0x50u);
+  EXPECT_EQ(5u, Wire.endTransmission());
+  EXPECT_TRUE(Wire.getWireTimeoutFlag());
+  EXPECT_EQ(25u, millis());
+  EXPECT_EQ(LOW, digitalRead(SDA));
+
+  // Recovery clocks SCL as open drain after taking the pins from Wire
+  Wire.end();
+  for (uint8_t clock = 0u; clock < 3u; clock++)
+  {
+    digitalWrite(SCL, LOW);
+    pinMode(SCL, OUTPUT);
+    pinMode(SCL, INPUT_PULLUP);
+  }
+  EXPECT_EQ(3u, hal_sim_i2cGetRecoveryClocks());
+  EXPECT_EQ(HIGH, digitalRead(SDA));
+}
+
+TEST(HalSim, EepromSurvivesInItsFile)
+{
+  char path[] = "/tmp/hal_sim_eeprom_XXXXXX";
+  int descriptor = mkstemp(path);
+  ASSERT_NE(-1, descriptor);
+  close(descriptor);
+
+  hal_sim_reset();
+  ASSERT_TRUE(hal_sim_eepromOpen(path));
+  EXPECT_EQ(0xFFu, eeprom_read_byte((const uint8_t *)10));
+  eeprom_update_byte((uint8_t *)10, 0x42u);
+  EXPECT_FALSE(eeprom_is_ready());
+  hal_sim_advanceMicros(HAL_SIM_EEPROM_WRITE_TIME_US);
+  EXPECT_TRUE(eeprom_is_ready());
+
+  // Unchanged bytes are not written again
+  eeprom_update_byte((uint8_t *)10, 0x42u);
+  EXPECT_EQ(1u, hal_sim_eepromGetWrites());
+
+  hal_sim_eepromErase();
+  hal_sim_eepromClose();
+  ASSERT_TRUE(hal_sim_eepromOpen(path));
+  EXPECT_EQ(0xFFu, eeprom_read_byte((const uint8_t *)10));
+  eeprom_write_byte((uint8_t *)11, 0x24u);
+  hal_sim_eepromClose();
+  hal_sim_eepromErase();
+
+  ASSERT_TRUE(hal_sim_eepromOpen(path));
+  EXPECT_EQ(0x24u, eeprom_read_byte((const uint8_t *)11));
+  hal_sim_eepromClose();
+  remove(path);
+}
+
+TEST(HalSim, EepromLosesWritesAfterThePowerIsCut)
+{
+  hal_sim_reset();
+  hal_sim_eepromErase();
+  hal_sim_eepromSetWriteBudget(2);
+
+  for (uint8_t address = 0u; address < 4u; address++)
+  {
+    eeprom_write_byte((uint8_t *)(uintptr_t)address, address);
+  }
+
+  EXPECT_TRUE(hal_sim_eepromIsPowerLost());
+  EXPECT_EQ(2u, hal_sim_eepromGetWrites());
+  EXPECT_EQ(1u, eeprom_read_byte((const uint8_t *)1));
+  EXPECT_EQ(0xFFu, eeprom_read_byte((const uint8_t *)2));
+}
+
+TEST(HalSim, Dht11AnswersTheStartSignal)
+{
+  hal_sim_reset();
+  hal_sim_attachDht11(-2.3f, 45.0f);
+  hal_sim_test_edges = 0u;
+
+  digitalWrite(HAL_SIM_DHT11_PIN, LOW);
+  pinMode(HAL_SIM_DHT11_PIN, OUTPUT);
+  delay(20u);
+  attachInterrupt(digitalPinToInterrupt(HAL_SIM_DHT11_PIN), countEdge, FALLING);
+  pinMode(HAL_SIM_DHT11_PIN, INPUT_PULLUP);
+  delay(10u);
+
+  ASSERT_EQ(42u, hal_sim_test_edges);
+  EXPECT_EQ(160u, hal_sim_test_edge_us[1] - hal_sim_test_edge_us[0]);
+  // Humidity 45 = 0b00101101, the first bit is a 0 and the third a 1
+  EXPECT_EQ(77u, hal_sim_test_edge_us[2] - hal_sim_test_edge_us[1]);
+  EXPECT_EQ(120u, hal_sim_test_edge_us[4] - hal_sim_test_edge_us[3]);
+}
+
+TEST(HalSim, AdcConvertsWhileTheClockRuns)
+{
+  hal_sim_reset();
+  hal_sim_setAnalogInput(A3, 700u);
+  ADMUX = 3u;
+  // Prescaler 128, 104 us per conversion, no interrupt
+  ADCSRA = (uint8_t)(_BV(ADEN) | _BV(ADSC) | 0x07u);
+
+  hal_sim_advanceMicros(100u);
+  EXPECT_EQ(0u, ADC);
+  hal_sim_advanceMicros(10u);
+  EXPECT_EQ(700u, ADC);
+  EXPECT_EQ(0u, ADCSRA & _BV(ADSC));
+  EXPECT_EQ(700, analogRead(A3));
+}
+
+TEST(HalSim, FormatsProgramMemoryStringsLikeAvrLibc)
+{
+  char text[32];
+  snprintf_P(text, sizeof(text), PSTR("%S: %s %d%%"), PSTR("CO"), "12", 5);
+  EXPECT_STREQ("CO: 12 5%", text);
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include "src/i2c_bus/i2c_bus.h"
+#include "hal_sim.h"
+
+/* Device on the simulated bus, a register device like most sensors */
+#define TEST_DEVICE_ADDRESS  (uint8_t)(0x40u)
+#define TEST_ABSENT_ADDRESS  (uint8_t)(0x41u)
+
+/* Completed jobs in completion order */
+static i2c_bus_job_ts test_completed_jobs[16];
+static uint8_t test_num_of_completed = 0u;
+
+static void recordCompletion(const i2c_bus_job_ts *job)
+{
+  test_completed_jobs[test_num_of_completed++ % 16u] = *job;
+}
+
+/**
+ * @brief Chains a register read to a completed pointer write, as drivers do.
+ */
+static void readAfterWrite(const i2c_bus_job_ts *job)
+{
+  recordCompletion(job);
+  i2c_bus_job_ts read_job = {job->address, 0u, 2u, {0u}, 0u, (uint8_t)(job->tag + 1u), recordCompletion};
+  (void)i2c_bus_submit(&read_job);
+}
+
+static i2c_bus_job_ts makeJob(uint8_t address, uint8_t write_len, uint8_t read_len, uint8_t tag)
+{
+  i2c_bus_job_ts job = {address, write_len, read_len, {0u}, 0xFFu, tag, recordCompletion};
+  return job;
+}
+
+class I2cBus : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    hal_sim_reset();
+    ASSERT_TRUE(hal_sim_i2cAttach(TEST_DEVICE_ADDRESS));
+    const uint8_t registers[] = {0x11u, 0x22u, 0x33u, 0x44u};
+    hal_sim_i2cSetRegisters(TEST_DEVICE_ADDRESS, 0x10u, registers, sizeof(registers));
+    i2c_bus_init();
+    test_num_of_completed = 0u;
+  }
+};
+
+TEST_F(I2cBus, RunsJobsInOrderWithinTheBudget)
+{
+  for (uint8_t tag = 0u; tag < I2C_BUS_QUEUE_SIZE; tag++)
+  {
+    i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 0u, 0u, tag);
+    ASSERT_EQ(I2C_BUS_JOB_SUBMITTED, i2c_bus_submit(&job));
+  }
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 0u, 0u, 0xEEu);
+  EXPECT_EQ(I2C_BUS_QUEUE_FULL, i2c_bus_submit(&job));
+
+  EXPECT_EQ(3u, i2c_bus_process(3u));
+  EXPECT_EQ(1u, i2c_bus_getPendingJobs());
+  EXPECT_EQ(1u, i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS));
+  EXPECT_EQ(0u, i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS));
+
+  ASSERT_EQ(I2C_BUS_QUEUE_SIZE, test_num_of_completed);
+  for (uint8_t tag = 0u; tag < I2C_BUS_QUEUE_SIZE; tag++)
+  {
+    EXPECT_EQ(tag, test_completed_jobs[tag].tag);
+    EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, test_completed_jobs[tag].result);
+  }
+}
+
+TEST_F(I2cBus, ProbesReportAbsentDevices)
+{
+  i2c_bus_job_ts present = makeJob(TEST_DEVICE_ADDRESS, 0u, 0u, 0u);
+  i2c_bus_job_ts absent = makeJob(TEST_ABSENT_ADDRESS, 0u, 0u, 1u);
+  (void)i2c_bus_submit(&present);
+  (void)i2c_bus_submit(&absent);
+
+  (void)i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS);
+  ASSERT_EQ(2u, test_num_of_completed);
+  EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, test_completed_jobs[0].result);
+  EXPECT_EQ(I2C_BUS_RESULT_NACKADR, test_completed_jobs[1].result);
+}
+
+TEST_F(I2cBus, CallbacksChainTransactions)
+{
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 1u, 0u, 10u);
+  job.buffer[0] = 0x12u;
+  job.callback = readAfterWrite;
+  (void)i2c_bus_submit(&job);
+
+  // The chained read is queued behind the write and runs in the same call
+  EXPECT_EQ(2u, i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS));
+  ASSERT_EQ(2u, test_num_of_completed);
+  EXPECT_EQ(11u, test_completed_jobs[1].tag);
+  EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, test_completed_jobs[1].result);
+  EXPECT_EQ(0x33u, test_completed_jobs[1].buffer[0]);
+  EXPECT_EQ(0x44u, test_completed_jobs[1].buffer[1]);
+}
+
+TEST_F(I2cBus, WriteThenReadReadsTheAddressedRegisters)
+{
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 1u, 3u, 0u);
+  job.buffer[0] = 0x11u;
+
+  EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, i2c_bus_transfer(&job));
+  EXPECT_EQ(0x22u, job.buffer[0]);
+  EXPECT_EQ(0x33u, job.buffer[1]);
+  EXPECT_EQ(0x44u, job.buffer[2]);
+}
+
+TEST_F(I2cBus, JobTimeFollowsTheBytesOnTheBus)
+{
+  hal_sim_i2cSetByteTime(200u);
+  uint32_t start_us = micros();
+
+  // Address and pointer, then address and 4 data bytes
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 1u, 4u, 0u);
+  job.buffer[0] = 0x10u;
+  (void)i2c_bus_submit(&job);
+  (void)i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS);
+
+  EXPECT_EQ(7u * 200u, micros() - start_us);
+  EXPECT_EQ(0x11u, test_completed_jobs[0].buffer[0]);
+}
+
+TEST_F(I2cBus, BudgetBoundsTheTimeOfOneProcessCall)
+{
+  // A bus scan probes many addresses, one call must not run the whole queue on a slow bus
+  hal_sim_i2cSetByteTime(1000u);
+  for (uint8_t tag = 0u; tag < I2C_BUS_QUEUE_SIZE; tag++)
+  {
+    i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 0u, 0u, tag);
+    (void)i2c_bus_submit(&job);
+  }
+
+  uint32_t start_us = micros();
+  EXPECT_EQ(1u, i2c_bus_process(1u));
+  EXPECT_EQ(1000u, micros() - start_us);
+  EXPECT_EQ(I2C_BUS_QUEUE_SIZE - 1u, i2c_bus_getPendingJobs());
+}
+
+TEST_F(I2cBus, ReadsAreLimitedToTheJobBuffer)
+{
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 0u, I2C_BUS_JOB_BUFFER_SIZE + 4u, 0u);
+  EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, i2c_bus_transfer(&job));
+
+  // Address and a full job buffer, not more
+  EXPECT_EQ((1u + I2C_BUS_JOB_BUFFER_SIZE) * HAL_SIM_I2C_BYTE_TIME_US, micros());
+}
+
+TEST_F(I2cBus, MissingReadBytesAreReported)
+{
+  i2c_bus_job_ts job = makeJob(TEST_ABSENT_ADDRESS, 0u, 2u, 0u);
+  EXPECT_EQ(I2C_BUS_RESULT_READ_INCOMPLETE, i2c_bus_transfer(&job));
+}
+
+TEST_F(I2cBus, RecoversADeviceHoldingSdaMidByte)
+{
+  hal_sim_i2cHoldSda(3u);
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 0u, 0u, 0u);
+  EXPECT_EQ(I2C_BUS_RESULT_TIMEOUT, i2c_bus_transfer(&job));
+
+  EXPECT_EQ(I2C_BUS_RECOVERED, i2c_bus_checkHealth());
+  EXPECT_EQ(3u, hal_sim_i2cGetRecoveryClocks());
+  i2c_bus_health_ts health = i2c_bus_getHealth();
+  EXPECT_EQ(1u, health.timeouts);
+  EXPECT_EQ(1u, health.stuck_lines);
+  EXPECT_EQ(1u, health.recoveries);
+  EXPECT_FALSE(i2c_bus_isStuck());
+
+  EXPECT_EQ(I2C_BUS_HEALTHY, i2c_bus_checkHealth());
+  EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, i2c_bus_transfer(&job));
+}
+
+TEST_F(I2cBus, LatchesABusTheRecoveryCannotFree)
+{
+  hal_sim_i2cHoldSda(HAL_SIM_I2C_HOLD_FOREVER);
+
+  EXPECT_EQ(I2C_BUS_STUCK, i2c_bus_checkHealth());
+  EXPECT_TRUE(i2c_bus_isStuck());
+  EXPECT_EQ(I2C_BUS_RECOVERY_CLOCKS, hal_sim_i2cGetRecoveryClocks());
+
+  // Further checks do not clock the bus again
+  EXPECT_EQ(I2C_BUS_STUCK, i2c_bus_checkHealth());
+  EXPECT_EQ(I2C_BUS_RECOVERY_CLOCKS, hal_sim_i2cGetRecoveryClocks());
+  EXPECT_EQ(1u, i2c_bus_getHealth().failed_recoveries);
+
+  // Jobs fail right away instead of waiting for the Wire timeout
+  uint32_t start_us = micros();
+  uint32_t start_transactions = hal_sim_i2cGetTransactions();
+  i2c_bus_job_ts job = makeJob(TEST_DEVICE_ADDRESS, 1u, 2u, 0u);
+  (void)i2c_bus_submit(&job);
+  EXPECT_EQ(1u, i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS));
+  EXPECT_EQ(I2C_BUS_RESULT_BUS_STUCK, test_completed_jobs[0].result);
+  EXPECT_EQ(start_us, micros());
+  EXPECT_EQ(start_transactions, hal_sim_i2cGetTransactions());
+
+  EXPECT_EQ(I2C_BUS_STUCK, i2c_bus_retryRecovery());
+  EXPECT_EQ(2u * I2C_BUS_RECOVERY_CLOCKS, hal_sim_i2cGetRecoveryClocks());
+  EXPECT_EQ(2u, i2c_bus_getHealth().failed_recoveries);
+
+  // The device let go in the meantime
+  hal_sim_i2cHoldSda(0u);
+  EXPECT_EQ(I2C_BUS_RECOVERED, i2c_bus_retryRecovery());
+  EXPECT_FALSE(i2c_bus_isStuck());
+  EXPECT_EQ(1u, i2c_bus_getHealth().recoveries);
+  EXPECT_EQ(I2C_BUS_RESULT_SUCCESS, i2c_bus_transfer(&job));
+}
+
+TEST_F(I2cBus, HeldSclIsNotFreedByClocking)
+{
+  hal_sim_i2cHoldScl(true);
+  EXPECT_EQ(I2C_BUS_STUCK, i2c_bus_checkHealth());
+  EXPECT_TRUE(i2c_bus_isStuck());
+
+  hal_sim_i2cHoldScl(false);
+  EXPECT_EQ(I2C_BUS_RECOVERED, i2c_bus_retryRecovery());
+}
+
+TEST_F(I2cBus, RetryOfAFreeBusDoesNothing)
+{
+  EXPECT_EQ(I2C_BUS_RECOVERED, i2c_bus_retryRecovery());
+  EXPECT_EQ(0u, hal_sim_i2cGetRecoveryClocks());
+  EXPECT_EQ(0u, i2c_bus_getHealth().recoveries);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "src/input/sensors/sensor_library/mq7/mq7.h"
+#include "src/input/sensors/sensor_library/mq135/mq135.h"
+#include "hal_sim.h"
+
+/* Worst relative error of a table reading, about 0.25 % are reached with SENSORS_MQ_TABLE_STEP 8 */
+#define TEST_MAX_RELATIVE_ERROR      (double)(0.005)
+/* Conversions after which every attached pin has a value of its new input, settling included */
+#define TEST_CONVERSIONS_PER_UPDATE  (uint16_t)(3u * ADC_SAMPLER_MAX_CHANNELS * (ADC_SAMPLER_SAMPLES_PER_VALUE + ADC_SAMPLER_SETTLING_SAMPLES))
+
+/**
+ * @brief MQ7 curve as the driver calculated it before the lookup table, with pow() and log10().
+ */
+static double mq7ReferencePpm(uint16_t raw_adc)
+{
+  double resistance_ratio = (double)(MQ7_ANALOG_INPUT_MAX - raw_adc) / raw_adc * MQ7_LOAD_RESISTANCE_VAL / SENSORS_MQ7_R_ZERO;
+  return pow(10.0, (log10(resistance_ratio) - SENSORS_MQ7_CALCULATION_CONSTANT_1) / SENSORS_MQ7_CALCULATION_CONSTANT_2);
+}
+
+/**
+ * @brief MQ135 curve as the driver calculated it before the lookup table, with pow().
+ */
+static double mq135ReferencePpm(uint16_t raw_adc)
+{
+  return SENSORS_MQ135_PARAMETER_A * pow((double)raw_adc / SENSORS_MQ135_R_ZERO, -SENSORS_MQ135_PARAMETER_B);
+}
+
+static double toUnits(sensors_value_t value)
+{
+  return (double)value / SENSORS_VALUE_ONE;
+}
+
+/**
+ * Both MQ sensors attached to the ADC sampler, their pins driven with constant inputs.
+ */
+class MqTable : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    hal_sim_reset();
+    mq135_init();
+    mq7_init();
+  }
+
+  void setInputs(uint16_t raw_adc)
+  {
+    hal_sim_setAnalogInput(SENSORS_MQ135_PIN_ANALOG, raw_adc);
+    hal_sim_setAnalogInput(SENSORS_MQ7_PIN_ANALOG, raw_adc);
+    hal_sim_runAdc(TEST_CONVERSIONS_PER_UPDATE);
+  }
+
+  /**
+   * @brief Returns the worst relative error of a driver against its reference curve.
+   *
+   * Only ADC values whose reference lies between min_ppm and max_ppm are compared.
+   */
+  double worstRelativeError(sensors_value_t (*read_ppm)(), double (*reference_ppm)(uint16_t), double min_ppm, double max_ppm)
+  {
+    double worst_error = 0.0;
+    uint16_t compared = 0u;
+    for (uint16_t raw_adc = MQ7_ANALOG_INPUT_MIN_VALID; raw_adc < MQ7_ANALOG_INPUT_MAX; raw_adc++)
+    {
+      double reference = reference_ppm(raw_adc);
+      if(reference < min_ppm || reference > max_ppm)
+      {
+        continue;
+      }
+      setInputs(raw_adc);
+      sensors_value_t value = read_ppm();
+      EXPECT_TRUE(sensors_isValueValid(value)) << "ADC " << raw_adc;
+      worst_error = fmax(worst_error, fabs(toUnits(value) - reference) / reference);
+      compared++;
+    }
+    EXPECT_LT(100u, compared);
+    return worst_error;
+  }
+};
+
+TEST_F(MqTable, Mq7FollowsTheCurveInItsRange)
+{
+  double worst_error = worstRelativeError(mq7_readPPM, mq7ReferencePpm, SENSORS_MQ7_PPM_MIN, SENSORS_MQ7_PPM_MAX);
+  EXPECT_GT(TEST_MAX_RELATIVE_ERROR, worst_error);
+}
+
+TEST_F(MqTable, Mq135FollowsTheCurveBelowTheSaturation)
+{
+  // The shipped calibration puts every ADC value above SENSORS_MQ135_PPM_MAX, the table entries are compared instead
+  double worst_error = worstRelativeError(mq135_readPPM, mq135ReferencePpm, SENSORS_MQ135_PPM_MIN, MQ_TABLE_VALUE_MAX);
+  EXPECT_GT(TEST_MAX_RELATIVE_ERROR, worst_error);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include "src/input/sensor_stats/sensor_stats.h"
+#include "hal_sim.h"
+
+/* Tracked channel of the full profile, DHT11 temperature */
+#define TEST_SENSOR_ID  (uint8_t)(1u)
+
+static void addReading(float value)
+{
+  sensor_reading_ts reading = {};
+  reading.value = sensors_toValue(value);
+  reading.measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
+  sensor_stats_addReading(TEST_SENSOR_ID, &reading);
+}
+
+static void expectValue(float expected, sensors_value_t actual)
+{
+  EXPECT_NEAR((double)sensors_toValue(expected), (double)actual, (double)SENSORS_VALUE_ONE / 1000.0);
+}
+
+/**
+ * Statistics of one channel, the clock starts at the beginning of its first bucket.
+ */
+class SensorStats : public ::testing::Test
+{
+protected:
+  uint32_t bucket_ms;
+
+  void SetUp() override
+  {
+    hal_sim_reset();
+    ASSERT_EQ(SENSOR_STATS_CHANNEL_TRACKED, sensor_stats_isTracked(TEST_SENSOR_ID));
+    bucket_ms = (uint32_t)sensor_stats_getWindow(TEST_SENSOR_ID) / SENSOR_STATS_WINDOW_SAMPLES * SENSOR_STATS_MS_PER_SECOND;
+  }
+};
+
+TEST_F(SensorStats, ReadingsOfOneBucketAreAllKept)
+{
+  // Read every second, far more often than one reading per bucket
+  const float values[] = {20.0f, 25.0f, 15.0f, 22.0f};
+  for (float value : values)
+  {
+    addReading(value);
+    hal_sim_advanceMillis(SENSOR_STATS_MS_PER_SECOND);
+  }
+
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  expectValue(15.0f, stats.min_value);
+  expectValue(25.0f, stats.max_value);
+  expectValue(20.5f, stats.mean);
+  EXPECT_EQ(4u, stats.num_of_samples);
+  EXPECT_EQ(4u, stats.covered_seconds);
+}
+
+TEST_F(SensorStats, SpikeBetweenTwoReadingsIsTheMaximum)
+{
+  addReading(20.0f);
+  hal_sim_advanceMillis(SENSOR_STATS_MS_PER_SECOND);
+  addReading(40.0f);
+  hal_sim_advanceMillis(bucket_ms);
+  addReading(20.0f);
+
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  expectValue(40.0f, stats.max_value);
+  EXPECT_EQ(3u, stats.num_of_samples);
+}
+
+TEST_F(SensorStats, DeviationIsTheSpreadOfAllReadings)
+{
+  // Two buckets with the means 10 and 20, the first one also spreads within
+  addReading(9.0f);
+  addReading(11.0f);
+  hal_sim_advanceMillis(bucket_ms);
+  addReading(20.0f);
+  addReading(20.0f);
+
+  // Squared deviations from 15: 36 + 16 + 25 + 25
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  expectValue(15.0f, stats.mean);
+  expectValue(sqrtf(102.0f / 3.0f), stats.std_deviation);
+}
+
+TEST_F(SensorStats, DeviationOfANoisyInputIsTheSampleDeviation)
+{
+  // Noise of +-2 on a large offset and a slow drift, read every 3 seconds over the whole window
+  const uint32_t period_ms = 3u * SENSOR_STATS_MS_PER_SECOND;
+  const uint16_t num_of_readings = (uint16_t)(SENSOR_STATS_WINDOW_SAMPLES * bucket_ms / period_ms);
+  uint32_t noise_state = 12345u;
+  double sum = 0.0;
+  double sum_sq = 0.0;
+  for (uint16_t index = 0u; index < num_of_readings; index++)
+  {
+    noise_state = noise_state * 1103515245u + 12345u;
+    float value = 1013.25f + 0.01f * index + 4.0f * (float)(noise_state >> 16) / 65535.0f - 2.0f;
+    addReading(value);
+    // The reference takes the value as it was stored
+    double stored = (double)sensors_toValue(value) / (double)SENSORS_VALUE_ONE;
+    sum += stored;
+    sum_sq += stored * stored;
+    if(index + 1u < num_of_readings)
+    {
+      hal_sim_advanceMillis(period_ms);
+    }
+  }
+  double mean = sum / num_of_readings;
+  double expected_deviation = sqrt((sum_sq - sum * mean) / (num_of_readings - 1u));
+
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  ASSERT_EQ(num_of_readings, stats.num_of_samples);
+  EXPECT_NEAR(expected_deviation, (double)stats.std_deviation / (double)SENSORS_VALUE_ONE, expected_deviation * 0.001);
+}
+
+TEST_F(SensorStats, OldestBucketLeavesTheWindowAsAWhole)
+{
+  addReading(10.0f);
+  addReading(12.0f);
+  hal_sim_advanceMillis(bucket_ms);
+  addReading(30.0f);
+
+  // The first bucket is a whole window old, the second one still in it
+  hal_sim_advanceMillis((SENSOR_STATS_WINDOW_SAMPLES - 1u) * bucket_ms);
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  expectValue(30.0f, stats.min_value);
+  expectValue(30.0f, stats.mean);
+  EXPECT_EQ(1u, stats.num_of_samples);
+  EXPECT_EQ((SENSOR_STATS_WINDOW_SAMPLES - 1u) * bucket_ms / SENSOR_STATS_MS_PER_SECOND, stats.covered_seconds);
+
+  hal_sim_advanceMillis(bucket_ms);
+  EXPECT_EQ(ERROR_CODE_SENSOR_STATS_NO_SAMPLES, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+}
+
+TEST_F(SensorStats, ChannelIsEmptiedAfterALongGap)
+{
+  addReading(10.0f);
+
+  // Readings stop for many windows, a bucket with the same ring position must not come back
+  hal_sim_advanceMillis(100u * SENSOR_STATS_WINDOW_SAMPLES * bucket_ms);
+  addReading(50.0f);
+
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  expectValue(50.0f, stats.min_value);
+  EXPECT_EQ(1u, stats.num_of_samples);
+}
+
+TEST_F(SensorStats, FullBucketKeepsItsExtremes)
+{
+  for (uint16_t reading = 0u; reading < SENSOR_STATS_BUCKET_MAX_READINGS; reading++)
+  {
+    addReading(20.0f);
+  }
+  addReading(5.0f);
+
+  sensor_stats_reading_ts stats;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, sensor_stats_getReading(TEST_SENSOR_ID, &stats));
+  expectValue(5.0f, stats.min_value);
+  expectValue(20.0f, stats.mean);
+  EXPECT_EQ(SENSOR_STATS_BUCKET_MAX_READINGS, stats.num_of_samples);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <string>
+
+// The sketch as the IDE builds it, with every optional feature of the full profile
+#include "arduino_smart_weather_station.ino"
+#include "hal_sim.h"
+
+/* Tasks in the scheduler table, one profile line each */
+#define TEST_NUM_OF_TASKS  (size_t)(5u)
+
+/**
+ * @brief Runs the main loop, which sleeps on the virtual clock until its next deadline.
+ */
+static void runStationFor(uint32_t duration_ms)
+{
+  uint32_t start_ms = millis();
+  while(millis() - start_ms < duration_ms)
+  {
+    loop();
+  }
+}
+
+static size_t countOccurrences(const std::string &text, const char *pattern)
+{
+  size_t count = 0u;
+  for (size_t position = text.find(pattern); std::string::npos != position; position = text.find(pattern, position + 1u))
+  {
+    count++;
+  }
+  return count;
+}
+
+/**
+ * Station with the serial console commands, after its I2C scan is done.
+ */
+class SerialCommands : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    hal_sim_reset();
+    hal_sim_attachStation();
+    setup();
+    runStationFor(TIME_SECS(30));
+    hal_sim_serialClearOutput();
+  }
+};
+
+TEST_F(SerialCommands, ProfileDumpDropsNoLine)
+{
+  uint16_t dropped_messages = serial_console_getTxStats().dropped_messages;
+
+  // The dump is several times the size of the transmit ring
+  hal_sim_serialInput("p");
+  runStationFor(TIME_SECS(2));
+
+  std::string serial = hal_sim_serialGetOutput();
+  EXPECT_EQ(TEST_NUM_OF_TASKS, countOccurrences(serial, "Task "));
+  EXPECT_EQ(1u, countOccurrences(serial, "Serial TX: "));
+  EXPECT_LE(1u, countOccurrences(serial, " queue: "));
+  EXPECT_EQ(1u, countOccurrences(serial, "Errors: "));
+  EXPECT_EQ(1u, countOccurrences(serial, "Supervisor: "));
+  EXPECT_EQ(dropped_messages, serial_console_getTxStats().dropped_messages);
+}
+
+TEST_F(SerialCommands, StatisticsSummaryFollowsTheStatistics)
+{
+  hal_sim_serialInput("a");
+  runStationFor(TIME_SECS(2));
+
+  // Channels with readings in their window have a line, all of them before the summary
+  std::string serial = hal_sim_serialGetOutput();
+  size_t summary = serial.find("Sensor stats: ");
+  ASSERT_NE(std::string::npos, summary);
+  EXPECT_LE(2u, countOccurrences(serial.substr(0u, summary), " samples:"));
+  EXPECT_EQ(0u, countOccurrences(serial.substr(summary), " samples:"));
+}
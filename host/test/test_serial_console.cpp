@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The transmit ring of the full profile, which drops the oldest messages
+#include "src/output/serial_console/serial_console.h"
+#include "hal_sim.h"
+
+/**
+ * @brief Returns a line of a given length, tagged with its number so every line is unique.
+ */
+static std::string makeLine(unsigned number, size_t length)
+{
+  std::string line = "line " + std::to_string(number) + " ";
+  line.resize(length, '.');
+  return line;
+}
+
+/**
+ * @brief Lets the simulated UART send until the transmit ring is empty.
+ */
+static void drainTx()
+{
+  while(SERIAL_CONSOLE_TX_BUFFER_SIZE != serial_console_getTxFree())
+  {
+    hal_sim_advanceMillis(10u);
+    serial_console_processTx();
+  }
+  hal_sim_advanceMillis(1000u);
+}
+
+/**
+ * @brief Splits the serial output into lines, without their line endings.
+ */
+static std::vector<std::string> receivedLines()
+{
+  std::vector<std::string> lines;
+  std::istringstream output(hal_sim_serialGetOutput());
+  std::string line;
+  while(std::getline(output, line))
+  {
+    EXPECT_EQ('\r', line.back()) << "cut line: " << line;
+    line.pop_back();
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+class SerialConsole : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    hal_sim_reset();
+    ASSERT_EQ(ERROR_CODE_NO_ERROR, serial_console_init());
+  }
+};
+
+TEST_F(SerialConsole, FloodingTheRingOnlyDropsWholeLines)
+{
+  const unsigned num_of_lines = 30u;
+  std::vector<std::string> sent;
+  for (unsigned number = 0u; number < num_of_lines; number++)
+  {
+    sent.push_back(makeLine(number, 20u + number % 4u * 9u));
+    serial_console_printLine(sent.back().c_str());
+    if(0u == number % 3u)
+    {
+      serial_console_processTx();
+    }
+  }
+  drainTx();
+
+  // Every received line is a whole sent line, in order, and every missing one is counted
+  std::vector<std::string> received = receivedLines();
+  size_t next_sent = 0u;
+  for (const std::string &line : received)
+  {
+    while(next_sent < sent.size() && sent[next_sent] != line)
+    {
+      next_sent++;
+    }
+    ASSERT_LT(next_sent, sent.size()) << "unexpected line: " << line;
+  }
+  serial_console_tx_stats_ts stats = serial_console_getTxStats();
+  EXPECT_LT(0u, stats.dropped_messages);
+  EXPECT_EQ(num_of_lines, received.size() + stats.dropped_messages);
+}
+
+TEST_F(SerialConsole, LineBeingSentIsNotCut)
+{
+  // A fills the hardware buffer, B is partly moved to it and then C, D and E are queued
+  serial_console_printLine(makeLine(0u, 40u).c_str());
+  serial_console_processTx();
+  serial_console_printLine(makeLine(1u, 50u).c_str());
+  serial_console_processTx();
+  serial_console_printLine(makeLine(2u, 40u).c_str());
+  serial_console_printLine(makeLine(3u, 40u).c_str());
+
+  // E only fits without C, B keeps its queued rest
+  serial_console_printLine(makeLine(4u, 40u).c_str());
+  drainTx();
+
+  std::vector<std::string> expected = {makeLine(0u, 40u), makeLine(1u, 50u), makeLine(3u, 40u), makeLine(4u, 40u)};
+  EXPECT_EQ(expected, receivedLines());
+  serial_console_tx_stats_ts stats = serial_console_getTxStats();
+  EXPECT_EQ(1u, stats.dropped_messages);
+  EXPECT_EQ(40u + SERIAL_CONSOLE_LINE_END_LEN, stats.dropped_bytes);
+}
+
+TEST_F(SerialConsole, LineLongerThanTheRingIsDropped)
+{
+  serial_console_printLine(makeLine(0u, 20u).c_str());
+  serial_console_printLine(makeLine(1u, SERIAL_CONSOLE_TX_BUFFER_SIZE).c_str());
+  drainTx();
+
+  std::vector<std::string> expected = {makeLine(0u, 20u)};
+  EXPECT_EQ(expected, receivedLines());
+  EXPECT_EQ(1u, serial_console_getTxStats().dropped_messages);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <new>
+
+// The sketch as the IDE builds it, setup() runs against the simulated board
+#include "arduino_smart_weather_station.ino"
+#include "hal_sim.h"
+
+/* Update cycles of the soak, each one formats a reading on the display and the serial console */
+#define TEST_SOAK_CYCLES          (uint32_t)(1000000u)
+/* Cycles before the baseline is taken, the simulator's own buffers reach their size */
+#define TEST_SOAK_WARM_UP_CYCLES  (uint32_t)(1000u)
+/* Captured serial output is dropped every this many cycles, so it does not grow */
+#define TEST_SOAK_CLEAR_INTERVAL  (uint32_t)(100u)
+
+/* Allocations through new, counted only while the soak runs */
+static bool test_count_allocations = false;
+static uint32_t test_num_of_allocations = 0u;
+
+void *operator new(size_t size)
+{
+  if(test_count_allocations)
+  {
+    test_num_of_allocations++;
+  }
+  void *memory = malloc(size);
+  if(nullptr == memory)
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+  free(memory);
+}
+
+void operator delete(void *memory, size_t size) noexcept
+{
+  (void)size;
+  free(memory);
+}
+
+/**
+ * @brief Formats one reading on every output, like the sensor and time tasks do.
+ */
+static void runUpdateCycle(uint32_t cycle)
+{
+  // Catalog IDs start at 1, every sensor and the clock take turns
+  uint8_t sensor_id = (uint8_t)(cycle % (SENSORS_CATALOG_LEN + 1u));
+  if(0u == sensor_id)
+  {
+    (void)app_readCurrentRtcTime(ALL_OUTPUTS);
+  }
+  else
+  {
+    (void)app_readSpecificSensor(sensor_id, ALL_OUTPUTS);
+  }
+  control_runOutputsLoop();
+  hal_sim_advanceMillis(10u);
+
+  if(0u == cycle % TEST_SOAK_CLEAR_INTERVAL)
+  {
+    hal_sim_serialClearOutput();
+  }
+}
+
+TEST(Soak, FormattingKeepsTheHeapFlat)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+
+  uint32_t cycle = 0u;
+  for (; cycle < TEST_SOAK_WARM_UP_CYCLES; cycle++)
+  {
+    runUpdateCycle(cycle);
+  }
+  ASSERT_NE(0u, hal_sim_lcdGetWrites());
+
+  struct mallinfo2 baseline = mallinfo2();
+  test_count_allocations = true;
+  for (; cycle < TEST_SOAK_WARM_UP_CYCLES + TEST_SOAK_CYCLES; cycle++)
+  {
+    runUpdateCycle(cycle);
+  }
+  test_count_allocations = false;
+  struct mallinfo2 after = mallinfo2();
+
+  EXPECT_EQ(0u, test_num_of_allocations);
+  EXPECT_EQ(baseline.uordblks, after.uordblks);
+  EXPECT_EQ(baseline.arena, after.arena);
+}
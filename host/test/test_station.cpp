@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <string>
+
+// The sketch as the IDE builds it, setup() and loop() run against the simulated board
+#include "arduino_smart_weather_station.ino"
+#include "src/i2c_bus/i2c_bus.h"
+#include "hal_sim.h"
+
+/**
+ * @brief Runs the main loop, which sleeps on the virtual clock until its next deadline.
+ */
+static void runStationFor(uint32_t duration_ms)
+{
+  uint32_t start_ms = millis();
+  while(millis() - start_ms < duration_ms)
+  {
+    loop();
+  }
+}
+
+TEST(Station, ReportsReadingsOnSerialAndLcd)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+
+  runStationFor(TIME_SECS(30));
+
+  std::string serial = hal_sim_serialGetOutput();
+  EXPECT_NE(std::string::npos, serial.find("I2C device found at address: 0x76"));
+  EXPECT_NE(std::string::npos, serial.find("Temperature: 21.0C"));
+  EXPECT_NE(std::string::npos, serial.find("Humidity: 45.0%"));
+  EXPECT_NE(std::string::npos, serial.find("Luminance: 300lx"));
+  EXPECT_NE(std::string::npos, serial.find("Raining: no"));
+  EXPECT_EQ(0, strncmp("Temperature: 21.", hal_sim_lcdGetRow(0), 16));
+}
+
+TEST(Station, LateLightSensorComesOnline)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  hal_sim_i2cDetach(HAL_SIM_BH1750_ADDRESS);
+  setup();
+
+  runStationFor(TIME_SECS(30));
+  EXPECT_EQ(std::string::npos, std::string(hal_sim_serialGetOutput()).find("Luminance: 300lx"));
+
+  // The supervisor retries the failed sensor in the background
+  hal_sim_i2cAttach(HAL_SIM_BH1750_ADDRESS);
+  hal_sim_setLightLevel(1200.0f);
+  hal_sim_serialClearOutput();
+  runStationFor(TIME_MINS(2));
+  EXPECT_NE(std::string::npos, std::string(hal_sim_serialGetOutput()).find("Luminance: 1200lx"));
+}
+
+TEST(Station, FailedReadingsAreNotReported)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  hal_sim_i2cDetach(HAL_SIM_BH1750_ADDRESS);
+  setup();
+
+  // The error manager reports the failed sensor, its channel gets no reading at all
+  runStationFor(TIME_SECS(30));
+  EXPECT_EQ(std::string::npos, std::string(hal_sim_serialGetOutput()).find("Luminance:"));
+}
+
+TEST(Station, StuckBusIsRetriedWithBackoff)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+  runStationFor(TIME_SECS(30));
+
+  // A device holds SDA low for good, e.g. after a brown out in the middle of a byte
+  hal_sim_i2cHoldSda(HAL_SIM_I2C_HOLD_FOREVER);
+  hal_sim_serialClearOutput();
+  runStationFor(TIME_MINS(10));
+
+  // Backoff of 2, 4, 8 ... seconds instead of a recovery on every loop
+  i2c_bus_health_ts health = i2c_bus_getHealth();
+  EXPECT_TRUE(i2c_bus_isStuck());
+  EXPECT_LE(5u, health.failed_recoveries);
+  EXPECT_GE(12u, health.failed_recoveries);
+
+  // Sensors off the bus keep reporting
+  EXPECT_NE(std::string::npos, std::string(hal_sim_serialGetOutput()).find("Humidity: 45.0%"));
+
+  // Once the device lets go, the next retry frees the bus and the I2C sensors come back
+  hal_sim_i2cHoldSda(0u);
+  hal_sim_serialClearOutput();
+  runStationFor(TIME_MINS(7));
+  EXPECT_FALSE(i2c_bus_isStuck());
+  EXPECT_NE(std::string::npos, std::string(hal_sim_serialGetOutput()).find("Luminance: 300lx"));
+}
+
+TEST(Station, ReadingAllSensorsAtOnceDropsNone)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+  runStationFor(TIME_SECS(30));
+
+  control_output_queue_stats_ts before;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, control_getOutputQueueStats(OUTPUT_SERIAL_CONSOLE, &before));
+  hal_sim_serialClearOutput();
+
+  // More readings than the serial console queue holds
+  ASSERT_LT(CONTROL_QUEUE_DEPTH_OUTPUT_SERIAL_CONSOLE, sensors_interface_getSensorsLen());
+  sensor_reading_context_ts context = app_createNewSensorsReadingContext();
+  EXPECT_EQ(NOT_FINISHED, app_readAllSensorsAtOnce(SERIAL_CONSOLE, &context));
+  // Continued after the outputs drained their queues, the call itself never waits
+  uint32_t start_ms = millis();
+  while(NOT_FINISHED == app_readAllSensorsAtOnce(SERIAL_CONSOLE, &context) && millis() - start_ms < TIME_SECS(5))
+  {
+    loop();
+  }
+  EXPECT_EQ(STARTING_SENSOR_INDEX, context.sensor_index);
+  runStationFor(TIME_SECS(1));
+
+  control_output_queue_stats_ts after;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, control_getOutputQueueStats(OUTPUT_SERIAL_CONSOLE, &after));
+  EXPECT_EQ(before.dropped, after.dropped);
+  std::string serial = hal_sim_serialGetOutput();
+  EXPECT_NE(std::string::npos, serial.find("Temperature: 21.0C"));
+  EXPECT_NE(std::string::npos, serial.find("Raining: no"));
+}
+
+TEST(Station, ScanningAllAddressesAtOnceDropsNone)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+  runStationFor(TIME_SECS(30));
+
+  control_output_queue_stats_ts before;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, control_getOutputQueueStats(OUTPUT_SERIAL_CONSOLE, &before));
+  hal_sim_serialClearOutput();
+
+  i2c_scan_reading_context_ts context = app_createI2CScanReadingContext();
+  uint32_t start_ms = millis();
+  // Called on the scan slice period, like the I2C address task, the probes run in the sensors loop in between
+  while(NOT_FINISHED == app_readAllI2CAddressesAtOnce(SERIAL_CONSOLE, &context) && millis() - start_ms < TIME_SECS(5))
+  {
+    delay(TASK_I2C_SCAN_SLICE_TIMER);
+    (void)app_runSensorsLoop();
+  }
+  EXPECT_EQ(I2C_SCANER_RUN, context.run_i2c_scanner);
+  runStationFor(TIME_SECS(1));
+
+  control_output_queue_stats_ts after;
+  ASSERT_EQ(ERROR_CODE_NO_ERROR, control_getOutputQueueStats(OUTPUT_SERIAL_CONSOLE, &after));
+  EXPECT_EQ(before.dropped, after.dropped);
+  std::string serial = hal_sim_serialGetOutput();
+  EXPECT_NE(std::string::npos, serial.find("I2C device found at address: 0x23"));
+  EXPECT_NE(std::string::npos, serial.find("I2C device found at address: 0x76"));
+}
+
+TEST(Station, IdleSensorsLoopSleepsUntilItsNextDeadline)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+  runStationFor(TIME_SECS(30));
+
+  // The loop only polls while the DHT11 acquisition, I2C jobs or output are pending
+  uint32_t wakeups = 0u;
+  uint32_t start_ms = millis();
+  while(millis() - start_ms < TIME_MINS(1))
+  {
+    loop();
+    wakeups++;
+  }
+  EXPECT_GT(10u * 60u, wakeups);
+
+  // A new DHT11 acquisition is still taken and reported
+  hal_sim_attachDht11(21.0f, 60.0f);
+  hal_sim_serialClearOutput();
+  runStationFor(TIME_SECS(30));
+  EXPECT_NE(std::string::npos, std::string(hal_sim_serialGetOutput()).find("Humidity: 60.0%"));
+}
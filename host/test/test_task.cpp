@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+
+// The sketch as the IDE builds it, setup() and loop() run against the simulated board
+#include "arduino_smart_weather_station.ino"
+#include "src/task/task_heap/task_heap.h"
+#include "hal_sim.h"
+
+/**
+ * @brief Returns the milliseconds since a millis() timestamp, across the millis() wrap.
+ */
+static uint32_t elapsedSince(uint32_t start_ms)
+{
+  return (uint32_t)millis() - start_ms;
+}
+
+/**
+ * Heap over a task table of its own, as task_cyclicTask() uses it.
+ */
+class TaskHeap : public ::testing::Test
+{
+protected:
+  tasks_config_ts tasks[TASK_HEAP_CAPACITY] = {};
+  task_heap_ts heap;
+
+  void SetUp() override
+  {
+    task_heap_init(&heap, tasks);
+  }
+
+  void schedule(uint8_t task_index, uint32_t deadline, uint8_t priority)
+  {
+    tasks[task_index].next_deadline = deadline;
+    tasks[task_index].priority = priority;
+    task_heap_push(&heap, task_index);
+  }
+};
+
+TEST_F(TaskHeap, PopsByDeadlineThenPriority)
+{
+  schedule(0u, 300u, TASK_PRIORITY_HIGH);
+  schedule(1u, 100u, TASK_PRIORITY_LOW);
+  schedule(2u, 200u, TASK_PRIORITY_HIGH);
+  schedule(3u, 100u, TASK_PRIORITY_HIGH);
+  schedule(4u, 50u, TASK_PRIORITY_MEDIUM);
+
+  const uint8_t expected_order[] = {4u, 3u, 1u, 2u, 0u};
+  for (uint8_t task_index : expected_order)
+  {
+    EXPECT_EQ(task_index, task_heap_pop(&heap));
+  }
+  EXPECT_EQ(TASK_NO_TASKS, heap.size);
+}
+
+TEST_F(TaskHeap, OrdersDeadlinesAcrossTheMillisWrap)
+{
+  // 0x10 comes 0x20 ms after 0xFFFFFFF0, it must not be taken for the earliest deadline
+  schedule(0u, 0x10u, TASK_PRIORITY_HIGH);
+  schedule(1u, 0xFFFFFFF0u, TASK_PRIORITY_HIGH);
+
+  EXPECT_EQ(1u, task_heap_pop(&heap));
+  EXPECT_EQ(0u, task_heap_pop(&heap));
+}
+
+TEST_F(TaskHeap, KeepsTheSlotOfTheTrackedTask)
+{
+  task_heap_track(&heap, 2u);
+  schedule(0u, 300u, TASK_PRIORITY_HIGH);
+  schedule(1u, 100u, TASK_PRIORITY_HIGH);
+  schedule(2u, 500u, TASK_PRIORITY_HIGH);
+  schedule(3u, 50u, TASK_PRIORITY_HIGH);
+  EXPECT_EQ(2u, heap.entries[heap.tracked_position]);
+
+  // Moved earlier in place, it must become the root
+  tasks[2].next_deadline = 10u;
+  task_heap_moveEarlier(&heap, heap.tracked_position);
+  EXPECT_EQ(TASK_HEAP_ROOT, heap.tracked_position);
+
+  EXPECT_EQ(2u, task_heap_pop(&heap));
+  EXPECT_EQ(TASK_HEAP_NO_POSITION, heap.tracked_position);
+  tasks[2].next_deadline = 1000u;
+  task_heap_push(&heap, 2u);
+  EXPECT_EQ(2u, heap.entries[heap.tracked_position]);
+
+  // The others still come out in order
+  const uint8_t expected_order[] = {3u, 1u, 0u};
+  for (uint8_t task_index : expected_order)
+  {
+    EXPECT_EQ(task_index, task_heap_pop(&heap));
+    EXPECT_EQ(2u, heap.entries[heap.tracked_position]);
+  }
+}
+
+TEST(Task, DeadlineReachedHandlesTheMillisWrap)
+{
+  EXPECT_EQ(DEADLINE_REACHED, task_heap_deadlineReached(100u, 100u));
+  EXPECT_EQ(DEADLINE_NOT_REACHED, task_heap_deadlineReached(101u, 100u));
+  EXPECT_EQ(DEADLINE_NOT_REACHED, task_heap_deadlineReached(0x10u, 0xFFFFFFF8u));
+  EXPECT_EQ(DEADLINE_REACHED, task_heap_deadlineReached(0x10u, 0x10u));
+  EXPECT_EQ(DEADLINE_REACHED, task_heap_deadlineReached(0xFFFFFFF8u, 0x10u));
+}
+
+TEST(Task, AdvanceDeadlineSkipsMissedPeriods)
+{
+  tasks_config_ts task = {};
+  task.next_deadline = 1000u;
+  task.task_period = 10u;
+
+  // On time, the next period follows
+  EXPECT_EQ(TASK_HEAP_ON_TIME, task_heap_advanceDeadline(&task, 1003u));
+  EXPECT_EQ(1010u, task.next_deadline);
+
+  // Overrun by 5.5 periods, the missed activations are skipped and the phase is kept
+  EXPECT_EQ(TASK_HEAP_OVERRUN, task_heap_advanceDeadline(&task, 1065u));
+  EXPECT_EQ(1070u, task.next_deadline);
+
+  // Across the millis() wrap
+  task.next_deadline = 0xFFFFFFF0u;
+  EXPECT_EQ(TASK_HEAP_OVERRUN, task_heap_advanceDeadline(&task, 0x1Cu));
+  EXPECT_EQ(0x22u, task.next_deadline);
+}
+
+TEST(Task, CyclicTaskWaitsWhenNothingIsScheduled)
+{
+  hal_sim_reset();
+  task_cyclicTask();
+  EXPECT_EQ(CYCLIC_TASK_DELAY_MS, millis());
+}
+
+TEST(Task, CyclicTaskSleepsUntilTheEarliestDeadline)
+{
+  hal_sim_reset();
+  hal_sim_attachStation();
+  setup();
+
+  // The I2C scan and the sensors loop are due right away, the supervisor after its phase
+  uint32_t start_ms = millis();
+  task_cyclicTask();
+  EXPECT_GT(TASK_SENSORS_LOOP_TIMER, elapsedSince(start_ms));
+
+  // The idle sensors loop bounds every later sleep
+  for (uint8_t wakeup = 0u; wakeup < 100u; wakeup++)
+  {
+    uint32_t wakeup_ms = millis();
+    task_cyclicTask();
+    EXPECT_GE(TASK_SENSORS_LOOP_IDLE_TIMER, elapsedSince(wakeup_ms));
+  }
+}
+
+TEST(Task, CyclicTaskKeepsTheScheduleAcrossTheMillisWrap)
+{
+  hal_sim_reset();
+  hal_sim_setMillis(0xFFFFFFFFu - TIME_SECS(5));
+  hal_sim_attachStation();
+  setup();
+
+  // No sleep of a whole millis() period and no busy loop across the wrap
+  uint32_t wakeups = 0u;
+  bool wrapped = false;
+  uint32_t start_ms = millis();
+  while(TIME_SECS(15) > elapsedSince(start_ms))
+  {
+    if(!wrapped && (uint32_t)millis() < start_ms)
+    {
+      wrapped = true;
+      hal_sim_serialClearOutput();
+    }
+    uint32_t wakeup_ms = millis();
+    task_cyclicTask();
+    EXPECT_GE(TASK_SENSORS_LOOP_IDLE_TIMER, elapsedSince(wakeup_ms));
+    wakeups++;
+  }
+  EXPECT_GT(TIME_SECS(15) / TASK_SENSORS_LOOP_TIMER, wakeups);
+
+  // Readings keep coming in on the sensor read period after the wrap
+  ASSERT_TRUE(wrapped);
+  std::string serial = hal_sim_serialGetOutput();
+  EXPECT_LE(TIME_SECS(10) / TASK_SENSOR_READ_TIMER - 1u, (uint32_t)std::count(serial.begin(), serial.end(), '\n'));
+}
@@ -1,14 +1,28 @@
 #include "app.h"
 #include "app_common.h"
 
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Translates output destinations into the set of output components of the build.
+ *
+ * @param output The output destinations (e.g., LCD_DISPLAY | SERIAL_CONSOLE).
+ * @return control_io_mask_t Set of output IDs, CONTROL_NO_IO if none is selected.
+ */
+static control_io_mask_t toControlOutputs(output_destination_t output);
+/* *************************************** */
+
 /* EXPORTED FUNCTIONS */
 void checkForErrors(const control_error_ts *error)
 {
-    // If an error occurred, handle it
+    // If an error occurred, handle it, otherwise the component works and its errors are cleared
     if(ERROR_CODE_NO_ERROR != error->error_code)
     {
         control_handleError(error);
     }
+    else
+    {
+        control_clearErrors(&error->component);
+    }
 }
 
 output_destination_t filterOutTimeDependentOutputs(output_destination_t output)
@@ -16,14 +30,52 @@ output_destination_t filterOutTimeDependentOutputs(output_destination_t output)
     return (output & ALL_TIME_INDEPENDENT_OUTPUTS);
 }
 
-void sendToOutputAndCheckForErrors(control_io_t output, const control_data_ts *data)
+void publishToOutputs(output_destination_t output, const control_data_ts *data)
 {
-    control_error_ts error;
-    // Define output component
-    control_device_ts output_component = {output, CONTROL_ID_UNUSED};
+    control_io_mask_t outputs = toControlOutputs(output);
+
+    // Data is copied once per output, every output shows it from its own queue
+    if(CONTROL_NO_IO != outputs)
+    {
+        control_publishData(data, outputs);
+    }
+}
+
+bool hasOutputRoom(output_destination_t output)
+{
+    return control_queuesHaveRoom(toControlOutputs(output)) ? OUTPUTS_HAVE_ROOM : OUTPUTS_FULL;
+}
+
+bool areOutputsDelivered(output_destination_t output)
+{
+    return control_queuesAreDelivered(toControlOutputs(output)) ? OUTPUTS_DELIVERED : OUTPUTS_PENDING;
+}
+
+task_status_te app_superviseComponents()
+{
+    control_superviseComponents();
+    return FINISHED;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static control_io_mask_t toControlOutputs(output_destination_t output)
+{
+    control_io_mask_t outputs = CONTROL_NO_IO;
+
+    if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
+    {
+        outputs |= CONTROL_IO_MASK(OUTPUT_DISPLAY);
+    }
+    if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
+    {
+        outputs |= CONTROL_IO_MASK(OUTPUT_SERIAL_CONSOLE);
+    }
+    if(IS_OUTPUT_INCLUDED(output, DATA_LOGGER))
+    {
+        outputs |= CONTROL_IO_MASK(OUTPUT_DATA_LOGGER);
+    }
 
-    error.component = output_component;
-    error.error_code = control_routeDataToOutput(output, data);
-    checkForErrors(&error);
+    return outputs;
 }
-/* *************************************** */
\ No newline at end of file
+/* *************************************** */
@@ -5,8 +5,8 @@
 #include "../control/control.h"
 
 /* Macro to check if a specific output bit is set in the output variable */
-/* It returns true if the specified bit (bit_mask) is set in the output, otherwise false */
-#define IS_OUTPUT_INCLUDED(output, bit_mask) ((output & bit_mask) != 0)
+/* It returns true if the specified bit (bit_mask) is set in the output and the output is part of the build, otherwise false */
+#define IS_OUTPUT_INCLUDED(output, bit_mask) ((output & bit_mask & APP_USED_OUTPUTS) != 0)
 
 /* Type for representing and managing output destinations (supports up to 16 different output options) */
 typedef uint16_t output_destination_t;
@@ -18,6 +18,8 @@ typedef uint16_t output_destination_t;
  */
 /* Output option for serial console(can show all at once or sequentially) */
 #define SERIAL_CONSOLE                 (output_destination_t)(1 << 0) /* 7 bytes reserved for the future outputs */
+/* Output option for the EEPROM data logger(takes all at once, logs every sensor once per interval) */
+#define DATA_LOGGER                    (output_destination_t)(1 << 1)
 /* Output option for displays(cannot show all at once) */
 #define LCD_DISPLAY                    (output_destination_t)(1 << 8) /* 7 bytes reserved for the future outputs */
 /* Outputs that can be sent independently of time constraints(all at once) */
@@ -26,8 +28,21 @@ typedef uint16_t output_destination_t;
 #define ALL_TIME_DEPENDENT_OUTPUTS     (output_destination_t)(0xFF00)
 /* Used to indicate all outputs */
 #define ALL_OUTPUTS                    (output_destination_t)(0xFFFF)
+/* Outputs which record data, they only take sensor readings and the time */
+#define ALL_RECORDING_OUTPUTS          (output_destination_t)(DATA_LOGGER)
 /* Used to indicate no outputs are set */
 #define NO_OUTPUTS                     (output_destination_t)(0x0000)
+/* Output options of the outputs in the component graph, branches to the other outputs are removed at compile time */
+#define APP_USED_OUTPUTS               (output_destination_t)((control_isComponentUsed(OUTPUT_SERIAL_CONSOLE) ? SERIAL_CONSOLE : NO_OUTPUTS) | \
+                                                              (control_isComponentUsed(OUTPUT_DATA_LOGGER) ? DATA_LOGGER : NO_OUTPUTS) | \
+                                                              (control_isComponentUsed(OUTPUT_DISPLAY) ? LCD_DISPLAY : NO_OUTPUTS))
+
+/* Results of hasOutputRoom() */
+#define OUTPUTS_HAVE_ROOM              (bool)(true)
+#define OUTPUTS_FULL                   (bool)(false)
+/* Results of areOutputsDelivered() */
+#define OUTPUTS_DELIVERED              (bool)(true)
+#define OUTPUTS_PENDING                (bool)(false)
 
 /* Enum representing the status of a task(function called) */
 typedef enum
@@ -41,7 +56,8 @@ typedef enum
  *
  * This function evaluates the provided error code and, if an error is detected,  
  * calls the error handling mechanism with the corresponding component and ID.  
- * It ensures that errors are properly processed and logged for diagnostics.
+ * Without an error the errors of the component are cleared, so the error manager
+ * can report that it works again.
  *
  * @param error Pointer to struct with error code and another struct 
  *              representing the component associated with the error.
@@ -62,16 +78,46 @@ void checkForErrors(const control_error_ts *error);
 output_destination_t filterOutTimeDependentOutputs(output_destination_t output);
 
 /**
- * @brief Routes data to the specified output component and checks for errors.
+ * @brief Publishes data to the selected outputs.
+ *
+ * Translates the output destinations into the output components of the build and publishes
+ * the data to their queues with control_publishData(). Returns without waiting for any output,
+ * errors of the outputs are handled when the data is delivered.
+ *
+ * @param output The output destinations (e.g., LCD_DISPLAY | SERIAL_CONSOLE).
+ * @param data A pointer to the data to be published, it is copied and can be reused right away.
+ */
+void publishToOutputs(output_destination_t output, const control_data_ts *data);
+
+/**
+ * @brief Checks if the selected outputs can take one more entry without dropping it.
+ *
+ * Checked before every publish of the functions which publish many entries at once, they return
+ * NOT_FINISHED while the outputs are full and continue on the next call, see control_queuesHaveRoom().
+ *
+ * @param output The output destinations (e.g., LCD_DISPLAY | SERIAL_CONSOLE).
+ * @return bool OUTPUTS_HAVE_ROOM or OUTPUTS_FULL.
+ */
+bool hasOutputRoom(output_destination_t output);
+
+/**
+ * @brief Checks if the selected outputs have delivered everything published to them.
+ *
+ * See control_queuesAreDelivered().
+ *
+ * @param output The output destinations (e.g., LCD_DISPLAY | SERIAL_CONSOLE).
+ * @return bool OUTPUTS_DELIVERED or OUTPUTS_PENDING.
+ */
+bool areOutputsDelivered(output_destination_t output);
+
+/**
+ * @brief Brings failed components online in the background.
  *
- * This function attempts to send the provided data to the specified output component (e.g., LCD display, serial console).
- * It then checks for any errors encountered during the operation by calling `checkForErrors`.
+ * Initializes at most one component which failed, once its retry backoff is over,
+ * so it never blocks the sensor cycle for longer than one initialization.
  *
- * @param output The output component to send the data to (e.g., OUTPUT_DISPLAY, OUTPUT_SERIAL_CONSOLE).
- * @param data A pointer to the data to be sent to the output component.
- * 
- * @note The `CONTROL_ID_UNUSED` is used to indicate that the device ID is not used in this operation.
+ * @return task_status_te Always returns FINISHED.
  */
-void sendToOutputAndCheckForErrors(control_io_t output, const control_data_ts *data);
+task_status_te app_superviseComponents();
 
 #endif
\ No newline at end of file
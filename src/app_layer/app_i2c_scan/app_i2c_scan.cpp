@@ -21,32 +21,30 @@ task_status_te app_readAllI2CAddressesPeriodic(output_destination_t output, i2c_
     if(I2C_SCANER_RUN == context->run_i2c_scanner)
     {
         control_device_ts i2c_scanner = {INPUT_I2C_SCAN, I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES};
-        // Fetch the I2C scan result
-        context->i2c_scan_return = control_fetchDataFromInput(&i2c_scanner);
+        // Fetch the I2C scan result into the context, it is kept there while the addresses are shown
+        context->error_code = control_fetchDataFromInput(&i2c_scanner, &context->i2c_scan_data);
+        // Scan runs in the background slice by slice, continue on the next call
+        if(ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED == context->error_code)
+        {
+            return NOT_FINISHED;
+        }
         // Handle input errors
-        control_error_ts error = {context->i2c_scan_return.error_code, i2c_scanner};
+        control_error_ts error = {context->error_code, i2c_scanner};
         checkForErrors(&error);
         // Mark scanner as stopped after fetching the data
         context->run_i2c_scanner = I2C_SCANER_DONT_RUN;
     }
 
-    i2c_scan_reading_ts current_reading = context->i2c_scan_return.data.input_return.i2c_scan_reading;
+    // Cursor is advanced in the routed reading itself, so the outputs show the address it points to
+    i2c_scan_reading_ts *current_reading = &context->i2c_scan_data.input_return.i2c_scan_reading;
     // Check if an address update function is assigned
-    if(I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION != current_reading.update_i2c_address)
+    if(I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION != current_reading->update_i2c_address)
     {
         // Try updating the I2C address (returns true if a valid address is found)
-        if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(&current_reading))
+        if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(current_reading))
         {
-            if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-            {
-                // Send I2C scan address to display output and check for errors
-                sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(context->i2c_scan_return.data));
-            }
-            if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-            {
-                // Send I2C scan address to serial console output and check for errors
-                sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(context->i2c_scan_return.data));
-            }
+            // Queued copy keeps the address, the cursor moves on with the next call
+            publishToOutputs(output & ~ALL_RECORDING_OUTPUTS, &context->i2c_scan_data);
 
             return NOT_FINISHED;
         }
@@ -56,48 +54,26 @@ task_status_te app_readAllI2CAddressesPeriodic(output_destination_t output, i2c_
     return FINISHED; // No update function assigned, just return finished
 }
 
-task_status_te app_readAllI2CAddressesAtOnce(output_destination_t output)
+task_status_te app_readAllI2CAddressesAtOnce(output_destination_t output, i2c_scan_reading_context_ts *context)
 {
     output = filterOutTimeDependentOutputs(output);
+    task_status_te status = FINISHED;
 
     if(NO_OUTPUTS != output) // Check if all outputs are filtered out
     {
-        control_device_ts i2c_scanner = {INPUT_I2C_SCAN, I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES};
-        // Fetch the I2C scan result
-        control_input_data_ts i2c_scan_reading_result = control_fetchDataFromInput(&i2c_scanner);
-        // Handle input errors
-        control_error_ts error = {i2c_scan_reading_result.error_code, i2c_scanner};
-        checkForErrors(&error);
-
-        i2c_scan_reading_ts current_reading = i2c_scan_reading_result.data.input_return.i2c_scan_reading;
-        // Check if an address update function is assigned
-        if(I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION != current_reading.update_i2c_address)
+        // Addresses are published back to back while the queues have room, the queues must not drop the later ones
+        status = NOT_FINISHED;
+        while(NOT_FINISHED == status && OUTPUTS_HAVE_ROOM == hasOutputRoom(output & ~ALL_RECORDING_OUTPUTS))
         {
-            // Initialize a loop counter or timeout check to prevent infinite loop
-            uint8_t attempt_counter = I2C_SCAN_I2C_ADDRESS_MIN;
-            // Timeout based on attempts
-            while(attempt_counter <= I2C_SCAN_I2C_ADDRESS_MAX)
+            status = app_readAllI2CAddressesPeriodic(output, context);
+            if(APP_I2C_SCAN_IN_PROGRESS == app_isI2CScanInProgress(context))
             {
-                // Try updating the I2C address (returns true if a valid address is found)
-                if(I2C_SCAN_ADDRESS_NOT_FOUND != updateI2CScanForAllAddressesUpdateNextAddress(&current_reading))
-                {
-                    if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-                    {
-                        // Send I2C scan address to serial console output and check for errors
-                        sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(i2c_scan_reading_result.data));
-                    }
-
-                    attempt_counter++; // Increment the attempt counter after a successful address update
-                }
-                else
-                {
-                    break;
-                }
+                break; // The scan runs in the background slice by slice, continue on the next call
             }
         }
     }
 
-    return FINISHED; // No update function assigned, just return finished
+    return status;
 }
 
 task_status_te app_readI2CDeviceStatus(uint8_t device_address, output_destination_t output)
@@ -106,32 +82,30 @@ task_status_te app_readI2CDeviceStatus(uint8_t device_address, output_destinatio
     {
         control_device_ts i2c_scanner = {INPUT_I2C_SCAN, device_address};
         // Fetch the I2C scan result
-        control_input_data_ts i2c_scan_reading_result = control_fetchDataFromInput(&i2c_scanner);
+        control_data_ts i2c_scan_data;
+        control_error_code_te error_code = control_fetchDataFromInput(&i2c_scanner, &i2c_scan_data);
         // Handle input errors
-        control_error_ts error = {i2c_scan_reading_result.error_code, i2c_scanner};
+        control_error_ts error = {error_code, i2c_scanner};
         checkForErrors(&error);
 
-        if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-        {
-            // Send I2C scan address to display output and check for errors
-            sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(i2c_scan_reading_result.data));
-        }
-        if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-        {
-            // Send I2C scan address to serial console output and check for errors
-            sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(i2c_scan_reading_result.data));
-        }
+        publishToOutputs(output & ~ALL_RECORDING_OUTPUTS, &i2c_scan_data);
     }
     return FINISHED; // Return value is used to notify task component
 }
 
+bool app_isI2CScanInProgress(const i2c_scan_reading_context_ts *context)
+{
+    return (I2C_SCANER_RUN == context->run_i2c_scanner &&
+            ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED == context->error_code) ? APP_I2C_SCAN_IN_PROGRESS : APP_I2C_SCAN_NOT_IN_PROGRESS;
+}
+
 i2c_scan_reading_context_ts app_createI2CScanReadingContext()
 {
     // Initialize the I2C scan reading context with zeroed-out default values
     i2c_scan_reading_context_ts new_i2c_scan_reading_context = {0};
 
     // Set the function pointer to indicate no address update functionality is available
-    new_i2c_scan_reading_context.i2c_scan_return.data.input_return.i2c_scan_reading.update_i2c_address = I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION;
+    new_i2c_scan_reading_context.i2c_scan_data.input_return.i2c_scan_reading.update_i2c_address = I2C_SCAN_NO_ADDRESS_UPDATE_FUNCTION;
 
     // Mark the scanner as active, meaning it should start scanning when triggered
     new_i2c_scan_reading_context.run_i2c_scanner = I2C_SCANER_RUN;
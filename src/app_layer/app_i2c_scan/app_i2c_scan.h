@@ -9,13 +9,29 @@
 /* Disable the I2C scanner operation, used while data is still being displayed or processed */
 #define I2C_SCANER_DONT_RUN  (bool)(false)
 
+/* Scan for all devices is still probing addresses */
+#define APP_I2C_SCAN_IN_PROGRESS      (bool)(true)
+#define APP_I2C_SCAN_NOT_IN_PROGRESS  (bool)(false)
+
 /* Context structure to manage the state of the I2C scanner operation */
 typedef struct
 {
-    control_input_data_ts i2c_scan_return; // Stores the result of the I2C scan operation
+    control_data_ts i2c_scan_data;         // Result of the I2C scan operation, partial bitmap and cursor while scanning, iterated in place
+    control_error_code_te error_code;      // Error code of the last fetch of the I2C scan
     bool run_i2c_scanner;                  // Flag indicating whether the I2C scanner should be run
 } i2c_scan_reading_context_ts;
 
+/**
+ * @brief Checks if the scan started by app_readAllI2CAddressesPeriodic() is still probing addresses.
+ *
+ * Used by the task component to call the scan in short slices while probing and at the
+ * normal rate while the found addresses are shown.
+ *
+ * @param context The I2C scan reading context.
+ * @return bool APP_I2C_SCAN_IN_PROGRESS or APP_I2C_SCAN_NOT_IN_PROGRESS.
+ */
+bool app_isI2CScanInProgress(const i2c_scan_reading_context_ts *context);
+
 /**
  * @brief Periodically scans and reads I2C addresses.
  *
@@ -31,20 +47,19 @@ task_status_te app_readAllI2CAddressesPeriodic(output_destination_t output, i2c_
 /**
  * @brief Reads all I2C addresses at once by performing a scan and routing the results to specified outputs.
  * 
- * This function scans all I2C addresses and attempts to update the addresses where applicable. 
- * It routes the scan results to the specified outputs (LCD display, serial console) if included. 
- * The scan is limited by the range of I2C addresses and the number of attempts to avoid infinite loops.
+ * Like app_readAllI2CAddressesPeriodic(), but every call routes as many found addresses as the
+ * output queues have room for (see hasOutputRoom()) instead of one.
  * 
  * @param output The destination(s) for the I2C scan results (e.g., LCD display, serial console).
  *               Time-dependent outputs are filtered out before processing.
+ * @param context The I2C scan reading context, see app_createI2CScanReadingContext().
  * 
- * @return task_status_te Returns `FINISHED` once the I2C scan process is completed.
- * 
- * @note This function includes a safeguard to prevent infinite loops by limiting the number of address attempts.
- *       If no addresses are found or the maximum attempts are reached, the loop will exit.
- *       Error messages are generated in case of issues with fetching data or routing outputs.
+ * @return task_status_te Returns:
+ *         - `FINISHED` once every found address was routed, the context is ready for the next scan.
+ *         - `NOT_FINISHED` while the scan is probing addresses in the background or the outputs are full,
+ *           call again after app_runSensorsLoop().
  */
-task_status_te app_readAllI2CAddressesAtOnce(output_destination_t output);
+task_status_te app_readAllI2CAddressesAtOnce(output_destination_t output, i2c_scan_reading_context_ts *context);
 
 /**
  * @brief Reads the status of a specific I2C device based on the provided address and routes the data to specified outputs.
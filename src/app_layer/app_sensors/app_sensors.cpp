@@ -12,28 +12,24 @@
  * @return uint8_t The updated sensor index.
  */
 static uint8_t readAllSensorsPeriodicUpdateSensorIndex(uint8_t current_index, size_t number_of_sensors);
+
+/**
+ * @brief Reads sensor data and routes it to the specified output.
+ *
+ * With APP_SENSORS_REPORT_ON_CHANGE a reading that did not change since its last report
+ * is kept off APP_SENSORS_FILTERED_OUTPUTS, see report_filter.h.
+ *
+ * @param sensor_id The ID of the sensor to be read.
+ * @param output The output destination (LCD, serial console, or both).
+ * @param report_mode APP_SENSORS_REPORT_ALWAYS or APP_SENSORS_REPORT_ON_CHANGE.
+ */
+static void readSensor(uint8_t sensor_id, output_destination_t output, bool report_mode);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 task_status_te app_readSpecificSensor(uint8_t sensor_id, output_destination_t output)
 {
-    // Define input component and fetch sensor data
-    control_device_ts sensor_to_read = {INPUT_SENSORS, sensor_id};
-    control_input_data_ts sensor_reading_result = control_fetchDataFromInput(&sensor_to_read);
-    // Handle input errors
-    control_error_ts error = {sensor_reading_result.error_code, sensor_to_read};
-    checkForErrors(&error);
-
-    if (IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
-    {
-        sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(sensor_reading_result.data));
-    }
-
-    if (IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-    {
-        sendToOutputAndCheckForErrors(OUTPUT_SERIAL_CONSOLE, &(sensor_reading_result.data));
-    }
-
+    readSensor(sensor_id, output, APP_SENSORS_REPORT_ALWAYS);
     return FINISHED;  // Notify that task is finished
 }
 
@@ -47,7 +43,7 @@ task_status_te app_readAllSensorsPeriodic(output_destination_t output, sensor_re
         // Process only valid sensor IDs
         if(INVALID_SENSOR_ID != current_sensor_id)
         {
-            (void)app_readSpecificSensor(current_sensor_id, output);
+            readSensor(current_sensor_id, output, APP_SENSORS_REPORT_ON_CHANGE);
         }
         // Update sensor index for the next iteration
         context->sensor_index = readAllSensorsPeriodicUpdateSensorIndex(context->sensor_index, context->number_of_sensors);
@@ -57,30 +53,94 @@ task_status_te app_readAllSensorsPeriodic(output_destination_t output, sensor_re
     return (STARTING_SENSOR_INDEX == context->sensor_index) ? FINISHED : NOT_FINISHED;
 }
 
-task_status_te app_readAllSensorsAtOnce(output_destination_t output)
+task_status_te app_readAllSensorsAtOnce(output_destination_t output, sensor_reading_context_ts *context)
 {
     output = filterOutTimeDependentOutputs(output);
-    if(NO_OUTPUTS != output) // Check if all outputs are filtered out
+
+    // Loop through the remaining sensor indices, only if not all outputs are filtered out
+    while(NO_OUTPUTS != output && context->sensor_index < context->number_of_sensors)
+    {
+        uint8_t current_sensor_id = sensors_interface_sensorIndexToId(context->sensor_index);
+        // Only process valid sensor IDs
+        if(INVALID_SENSOR_ID != current_sensor_id)
+        {
+            // Readings are published back to back, the queues must not drop the later ones
+            if(OUTPUTS_FULL == hasOutputRoom(output))
+            {
+                return NOT_FINISHED; // Continue with this sensor once the outputs drained their queues
+            }
+            (void)app_readSpecificSensor(current_sensor_id, output);
+        }
+        context->sensor_index++;
+    }
+
+    context->sensor_index = STARTING_SENSOR_INDEX; // Ready for the next round
+    return FINISHED;
+}
+
+#ifdef SENSOR_STATS_USED
+task_status_te app_readSensorStats(uint8_t sensor_id, output_destination_t output)
+{
+    // Define input component and fetch the statistics
+    control_device_ts stats_to_read = {INPUT_SENSOR_STATS, sensor_id};
+    control_data_ts stats_data;
+    control_error_code_te error_code = control_fetchDataFromInput(&stats_to_read, &stats_data);
+
+    if (ERROR_CODE_NO_ERROR != error_code)
     {
-        size_t number_of_sensors = sensors_interface_getSensorsLen();
+        // Nothing to show, e.g. the window is still empty
+        control_error_ts error = {error_code, stats_to_read};
+        checkForErrors(&error);
+        return FINISHED;
+    }
 
-        // If there are sensors configured, process each one
-        if(SENSORS_INTERFACE_NO_SENSORS_CONFIGURED != number_of_sensors)
+    // Statistics are not recorded, they can be calculated again from the logged readings
+    publishToOutputs(output & ~ALL_RECORDING_OUTPUTS, &stats_data);
+
+    return FINISHED;  // Notify that task is finished
+}
+
+task_status_te app_readAllSensorStatsAtOnce(output_destination_t output, sensor_reading_context_ts *context)
+{
+    output = filterOutTimeDependentOutputs(output);
+
+    // Loop through the remaining sensor indices, only tracked sensors have statistics
+    while (NO_OUTPUTS != output && context->sensor_index < context->number_of_sensors)
+    {
+        uint8_t current_sensor_id = sensors_interface_sensorIndexToId(context->sensor_index);
+        if (SENSOR_STATS_CHANNEL_TRACKED == sensor_stats_isTracked(current_sensor_id))
         {
-            // Loop through all sensor indices and process each one
-            for (uint8_t sensor_index = STARTING_SENSOR_INDEX; sensor_index < number_of_sensors; sensor_index++)
+            if (OUTPUTS_FULL == hasOutputRoom(output))
             {
-                uint8_t current_sensor_id = sensors_interface_sensorIndexToId(sensor_index);
-                // Only process valid sensor IDs
-                if(INVALID_SENSOR_ID != current_sensor_id)
-                {
-                    (void)app_readSpecificSensor(current_sensor_id, output);
-                }
+                return NOT_FINISHED; // Continue with this sensor once the outputs drained their queues
             }
-        }   
+            (void)app_readSensorStats(current_sensor_id, output);
+        }
+        context->sensor_index++;
+    }
+
+    // Whatever the caller prints next must follow the statistics
+    if (OUTPUTS_PENDING == areOutputsDelivered(output))
+    {
+        return NOT_FINISHED;
     }
 
-    return FINISHED; // Return FINISHED since all sensors are processed
+    context->sensor_index = STARTING_SENSOR_INDEX; // Ready for the next round
+    return FINISHED;
+}
+#endif
+
+task_status_te app_runSensorsLoop()
+{
+    control_runInputsLoop(millis());
+    control_runErrorsLoop();
+    control_runOutputsLoop();
+    return FINISHED;
+}
+
+unsigned long app_getSensorsLoopIdleTime()
+{
+    return control_getIdleTime(millis());
 }
 
 sensor_reading_context_ts app_createNewSensorsReadingContext()
@@ -102,4 +162,30 @@ static uint8_t readAllSensorsPeriodicUpdateSensorIndex(uint8_t current_index, si
 
     return current_index;
 }
+
+static void readSensor(uint8_t sensor_id, output_destination_t output, bool report_mode)
+{
+    // Define input component and fetch sensor data, the reading is written once and copied into the queue of every output
+    control_device_ts sensor_to_read = {INPUT_SENSORS, sensor_id};
+    control_data_ts sensor_data;
+    control_error_code_te error_code = control_fetchDataFromInput(&sensor_to_read, &sensor_data);
+    // Handle input errors
+    control_error_ts error = {error_code, sensor_to_read};
+    checkForErrors(&error);
+
+#ifdef REPORT_FILTER_USED
+    if (APP_SENSORS_REPORT_ON_CHANGE == report_mode && REPORT_FILTER_UNCHANGED == report_filter_isReportDue(&sensor_data, error_code))
+    {
+        output &= ~APP_SENSORS_FILTERED_OUTPUTS; // Unchanged reading, only the unfiltered outputs get it
+    }
+#else
+    (void)report_mode;
+#endif
+
+    // A failed fetch leaves the reading unwritten, the failure is reported by the error manager instead
+    if (ERROR_CODE_NO_ERROR == error_code)
+    {
+        publishToOutputs(output, &sensor_data);
+    }
+}
 /* *************************************** */
\ No newline at end of file
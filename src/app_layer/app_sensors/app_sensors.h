@@ -7,6 +7,15 @@
 /* Initial sensor index for cyclic display */
 #define STARTING_SENSOR_INDEX         (uint8_t)(0u)
 
+/* Report modes of a sensor reading */
+#define APP_SENSORS_REPORT_ALWAYS     (bool)(false)
+#define APP_SENSORS_REPORT_ON_CHANGE  (bool)(true)
+
+#ifdef REPORT_FILTER_USED
+/* Outputs which get periodic readings only when they changed, the display keeps cycling through every sensor */
+#define APP_SENSORS_FILTERED_OUTPUTS  (output_destination_t)(SERIAL_CONSOLE)
+#endif
+
 /* Context structure to maintain sensor reading state across function calls */
 typedef struct
 {
@@ -33,6 +42,7 @@ task_status_te app_readSpecificSensor(uint8_t sensor_id, output_destination_t ou
  * routes the data to the specified output destination. The reading process is 
  * performed cyclically, meaning that each call to this function processes the 
  * next sensor in sequence until all sensors have been read.
+ * With REPORT_FILTER_USED, unchanged readings are not routed to APP_SENSORS_FILTERED_OUTPUTS.
  *
  * @param output The destination where sensor data should be routed (e.g., LCD, Serial Console).
  * @param context Pointer to the sensor reading context, which maintains the sensor index 
@@ -52,13 +62,64 @@ task_status_te app_readAllSensorsPeriodic(output_destination_t output, sensor_re
  * 
  * The function performs the following:
  * - Checks if any sensors are configured.
- * - Iterates over all sensor indices, fetching data and routing it to the output.
+ * - Iterates over the remaining sensor indices, fetching data and routing it to the output
+ *   while the output queues have room (see hasOutputRoom()).
  * 
  * @param output The destination output where sensor data will be sent (e.g., LCD_DISPLAY, SERIAL_CONSOLE, etc.).
+ * @param context Pointer to the sensor reading context, the sensor index is where the next call continues.
  * 
- * @return task_status_te Always returns FINISHED, indicating that all sensors were processed.
+ * @return task_status_te Returns:
+ *         - `FINISHED` when all sensors were processed, the context is ready for the next round.
+ *         - `NOT_FINISHED` if the outputs are full, call again once app_runSensorsLoop() drained them.
+ */
+task_status_te app_readAllSensorsAtOnce(output_destination_t output, sensor_reading_context_ts *context);
+
+#ifdef SENSOR_STATS_USED
+/**
+ * @brief Reads the rolling statistics of a sensor and routes them to the specified output.
+ *
+ * Statistics are only routed if the sensor is tracked and has samples, otherwise the
+ * error is handled internally. The data logger takes no statistics.
+ *
+ * @param sensor_id The ID of the sensor.
+ * @param output The output destination (LCD, serial console, or both).
+ * @return task_status_te Returns FINISHED to notify the task component.
+ */
+task_status_te app_readSensorStats(uint8_t sensor_id, output_destination_t output);
+
+/**
+ * @brief Reads the rolling statistics of all tracked sensors at once and sends them to the specified output.
+ *
+ * Time dependent outputs are filtered out and the outputs are never overfilled, like for app_readAllSensorsAtOnce().
+ * Finishes once the outputs have delivered the statistics, so what the caller prints next follows them.
+ *
+ * @param output The destination output where the statistics will be sent (e.g., SERIAL_CONSOLE).
+ * @param context Pointer to the sensor reading context, the sensor index is where the next call continues.
+ * @return task_status_te `FINISHED` once the statistics are delivered, `NOT_FINISHED` otherwise.
+ */
+task_status_te app_readAllSensorStatsAtOnce(output_destination_t output, sensor_reading_context_ts *context);
+#endif
+
+/**
+ * @brief Runs the background processing of the sensors.
+ *
+ * Lets the sensors finish non-blocking acquisitions and run their time based
+ * processes, then publishes error reports and drains queued output.
+ * Must be called every few milliseconds.
+ *
+ * @return task_status_te Always returns FINISHED.
+ */
+task_status_te app_runSensorsLoop();
+
+/**
+ * @brief Returns how long app_runSensorsLoop() has nothing to do.
+ *
+ * See control_getIdleTime(), reading sensors or publishing data can end the idle time.
+ *
+ * @return unsigned long Milliseconds until the loop must run, 0 if it is busy,
+ *                       INPUT_IDLE_FOREVER if nothing is pending.
  */
-task_status_te app_readAllSensorsAtOnce(output_destination_t output);
+unsigned long app_getSensorsLoopIdleTime();
 
 /**
  * @brief Creates and initializes a new sensor reading context.
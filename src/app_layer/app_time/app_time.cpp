@@ -3,23 +3,24 @@
 /* EXPORTED FUNCTIONS */
 task_status_te app_readCurrentRtcTime(output_destination_t output)
 {
+    if (!control_isComponentUsed(INPUT_RTC))
+    {
+        return FINISHED; // No RTC in this build, nothing to read
+    }
+
     // Define input component and fetch sensor data
     control_device_ts time_component = {INPUT_RTC, RTC_DEFAULT_RTC};
-    control_input_data_ts rtc_result = control_fetchDataFromInput(&time_component);
+    control_data_ts rtc_data;
+    control_error_code_te error_code = control_fetchDataFromInput(&time_component, &rtc_data);
     // Handle input errors
-    control_error_ts error = {rtc_result.error_code, time_component};
+    control_error_ts error = {error_code, time_component};
     checkForErrors(&error);
 
-    if(IS_OUTPUT_INCLUDED(output, LCD_DISPLAY))
+    // RTC time is also the time base of the log records, a failed fetch leaves it unwritten
+    if (ERROR_CODE_NO_ERROR == error_code)
     {
-        // Send RTC data to display output and check for errors
-        sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(rtc_result.data));
+        publishToOutputs(output, &rtc_data);
     }
-    if(IS_OUTPUT_INCLUDED(output, SERIAL_CONSOLE))
-    {
-        // Send RTC data to serial console output and check for errors
-        sendToOutputAndCheckForErrors(OUTPUT_DISPLAY, &(rtc_result.data));
-    }   
     return FINISHED;
 }
 /* *************************************** */
\ No newline at end of file
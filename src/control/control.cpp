@@ -1,30 +1,219 @@
 #include "control.h"
 
+/* COMPONENT GRAPH EXPANSIONS */
+/* One case of the input dispatcher, a direct call of the fetch adapter */
+#define CONTROL_FETCH_CASE(io, fetch_function) \
+    case io: \
+        error_code = fetch_function(input_device->device_id, &data->input_return); \
+        break;
+
+/* One case of the output dispatcher, a direct call of the output */
+#define CONTROL_ROUTE_CASE(io, component, init_function, data_function) \
+    case io: \
+        error_code = data_function(data); \
+        break;
+
+/* One case of the supervised initialization of an output */
+#define CONTROL_INIT_OUTPUT_CASE(io, component, init_function, data_function) \
+    case CONTROL_SUPERVISED_##io: \
+        return recordInitResult(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status, \
+                                &components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status, \
+                                (component), init_function(), {(io), CONTROL_ID_UNUSED});
+
+/* One case of the failed component lookup of an output */
+#define CONTROL_OUTPUT_FAILED_CASE(io, component, init_function, data_function) \
+    case CONTROL_SUPERVISED_##io: \
+        return (CONTROL_COMPONENT_INITIALIZED != (uninitialized_components->outputs_status & (1 << (component))));
+
+/* Storage of the queue of an output, sized by its configured depth */
+#define CONTROL_QUEUE_STORAGE(io, component, init_function, data_function) \
+    static control_queue_entry_ts control_queue_entries_##io[CONTROL_QUEUE_DEPTH_##io];
+
+/* Initial state of the queue of an output */
+#define CONTROL_QUEUE_INIT(io, component, init_function, data_function) \
+    {control_queue_entries_##io, {0u, 0u, 0u, 0u, 0u, CONTROL_QUEUE_DEPTH_##io}, 0u, 0u},
+
+/* Publishing to an output, a copy into its queue if the output is in the set */
+#define CONTROL_PUBLISH_TO_OUTPUT(io, component, init_function, data_function) \
+    if (CONTROL_NO_IO != (outputs & CONTROL_IO_MASK(io))) \
+    { \
+        enqueueData(&control_output_queues[CONTROL_QUEUE_INDEX_##io], CONTROL_QUEUE_POLICY_##io, data, now); \
+    }
+
+/* Delivery from the queue of an output, a direct call of the output */
+#define CONTROL_DRAIN_OUTPUT(io, component, init_function, data_function) \
+    for (uint8_t drained = 0u; drained < CONTROL_DRAIN_BUDGET_##io && isOutputReady(io); drained++) \
+    { \
+        control_queue_entry_ts *entry = peekQueue(&control_output_queues[CONTROL_QUEUE_INDEX_##io]); \
+        if (nullptr == entry) \
+        { \
+            break; \
+        } \
+        control_error_code_te error_code = data_function(&entry->data); \
+        releaseQueueEntry(&control_output_queues[CONTROL_QUEUE_INDEX_##io], (io), error_code); \
+    }
+
+/* One case of the queue room lookup */
+#define CONTROL_QUEUE_ROOM_CASE(io, component, init_function, data_function) \
+    case io: \
+        return (control_output_queues[CONTROL_QUEUE_INDEX_##io].count < control_output_queues[CONTROL_QUEUE_INDEX_##io].stats.depth);
+
+/* Room check of an output in the set, only queues which drop new entries are checked */
+#define CONTROL_QUEUE_ROOM_CHECK(io, component, init_function, data_function) \
+    if (CONTROL_NO_IO != (outputs & CONTROL_IO_MASK(io)) && \
+        CONTROL_QUEUE_DROP_NEWEST == CONTROL_QUEUE_POLICY_##io && !hasQueueRoom(io)) \
+    { \
+        return false; \
+    }
+
+/* Delivery check of an output in the set, its queue is empty and the output can take more */
+#define CONTROL_QUEUE_DELIVERED_CHECK(io, component, init_function, data_function) \
+    if (CONTROL_NO_IO != (outputs & CONTROL_IO_MASK(io)) && \
+        (0u != control_output_queues[CONTROL_QUEUE_INDEX_##io].count || !isOutputReady(io))) \
+    { \
+        return false; \
+    }
+
+/* One case of the queue statistics lookup */
+#define CONTROL_QUEUE_STATS_CASE(io, component, init_function, data_function) \
+    case io: \
+        *stats = control_output_queues[CONTROL_QUEUE_INDEX_##io].stats; \
+        error_code = ERROR_CODE_NO_ERROR; \
+        break;
+
+/* One case of the supervised initialization of an input other than the sensors */
+#define CONTROL_INIT_INPUT_CASE(io, component, device_id, init_function) \
+    case CONTROL_SUPERVISED_##io: \
+        return recordInitResult(&components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].other_inputs_status, \
+                                &components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status, \
+                                (component), init_function(), {(io), (device_id)});
+
+/* One case of the failed component lookup of an input other than the sensors */
+#define CONTROL_INPUT_FAILED_CASE(io, component, device_id, init_function) \
+    case CONTROL_SUPERVISED_##io: \
+        return (CONTROL_COMPONENT_INITIALIZED != (uninitialized_components->other_inputs_status & (1 << (component))));
+/* *************************************** */
+
 /* STATIC GLOBAL VARIABLES */
 static components_status_ts components_status[CONTROL_COMPONENTS_STATUS_SIZE] = {0};
+CONTROL_OUTPUTS(CONTROL_QUEUE_STORAGE)
+static control_output_queue_ts control_output_queues[CONTROL_NUM_OF_QUEUES] =
+{
+    CONTROL_OUTPUTS(CONTROL_QUEUE_INIT)
+};
+static supervisor_entry_ts control_supervised_components[CONTROL_NUM_OF_SUPERVISED];
+static uint8_t control_next_supervised = 0u;  // Round robin position of control_superviseComponents()
+static supervisor_entry_ts control_i2c_bus_recovery;  // Backoff of the recovery of a stuck I2C bus
 /* *************************************** */
 
 /* STATIC FUNCTION PROTOTYPES */
 /**
- * @brief Initializes input return data structure.
+ * @brief Initializes a sensor and updates its status.
+ *
+ * This function marks the specified sensor as used and attempts to initialize it.
+ * If initialization is successful, the sensor is also marked as working.
+ *
+ * @param sensor The sensor ID to initialize.
+ * @return bool true if the sensor works.
+ */
+static bool initSensor(uint8_t sensor);
+
+/**
+ * @brief Records the result of an output or other input initialization in the component status.
  *
- * Sets up the return data structure with the specified input component 
- * and ID, initializing error handling fields to indicate an invalid input by default.
+ * The component is marked as used, and as working if the initialization succeeded.
+ * A failed initialization is passed to the error handler.
  *
- * @param input_device Pointer to struct with input component and unique identifier of the input component.
- * @return control_input_data_ts The initialized return data structure.
+ * @param used_status Pointer to the used bits of the component group.
+ * @param working_status Pointer to the working bits of the component group.
+ * @param component Bit of the component in the group.
+ * @param error_code Result of the init function.
+ * @param device The component, reported with the error.
+ * @return bool true if the component works.
  */
-static control_input_data_ts initializeInputReturnData(const control_device_ts *input_device);
+static bool recordInitResult(uint8_t *used_status, uint8_t *working_status, uint8_t component,
+                             control_error_code_te error_code, control_device_ts device);
 
 /**
- * @brief Initializes a sensor and updates its status.
+ * @brief Fetch adapters of the inputs, called by the input dispatcher.
  *
- * This function marks the specified sensor as used and attempts to initialize it.
- * If initialization is successful, the sensor is also marked as working.
+ * Each one lets its input write the reading directly into its member of the caller's union.
  *
- * @param sensor The sensor ID to initialize.
+ * @param device_id The specific ID within the input component (e.g., sensor ID).
+ * @param input_return Pointer to the union the reading is written to.
+ * @return control_error_code_te The error code of the input.
+ */
+static control_error_code_te fetchSensorReading(uint8_t device_id, input_return_tu *input_return);
+#ifdef RTC_COMPONENT
+static control_error_code_te fetchRtcReading(uint8_t device_id, input_return_tu *input_return);
+#endif
+static control_error_code_te fetchI2cScanReading(uint8_t device_id, input_return_tu *input_return);
+#ifdef SENSOR_STATS_USED
+static control_error_code_te fetchSensorStatsReading(uint8_t device_id, input_return_tu *input_return);
+#endif
+
+/**
+ * @brief Copies published data into the queue of an output.
+ *
+ * A full queue drops the new data (CONTROL_QUEUE_DROP_NEWEST) or its oldest entry
+ * (CONTROL_QUEUE_DROP_OLDEST), either way the drop is counted.
+ *
+ * @param queue Pointer to the queue of the output.
+ * @param drop_policy CONTROL_QUEUE_DROP_NEWEST or CONTROL_QUEUE_DROP_OLDEST.
+ * @param data Pointer to the published data.
+ * @param now Millisecond of publishing.
  */
-static void initSensor(uint8_t sensor);
+static void enqueueData(control_output_queue_ts *queue, uint8_t drop_policy, const control_data_ts *data, uint16_t now);
+
+/**
+ * @brief Returns the oldest entry of the queue of an output, which stays queued until it is released.
+ *
+ * @param queue Pointer to the queue of the output.
+ * @return control_queue_entry_ts* The oldest entry, nullptr if the queue is empty.
+ */
+static control_queue_entry_ts *peekQueue(control_output_queue_ts *queue);
+
+/**
+ * @brief Removes the oldest entry after the output is done with it.
+ *
+ * Updates the delivery statistics and passes an error of the output to the error handler.
+ *
+ * @param queue Pointer to the queue of the output.
+ * @param output The ID of the output, reported with the error.
+ * @param error_code Result of the output.
+ */
+static void releaseQueueEntry(control_output_queue_ts *queue, control_io_t output, control_error_code_te error_code);
+
+/**
+ * @brief Checks if the queue of an output can take one more entry without dropping one.
+ *
+ * @param output The ID of the output.
+ * @return bool true if the queue has room, false if it is full or the output is not part of the build.
+ */
+static bool hasQueueRoom(control_io_t output);
+
+/**
+ * @brief Checks if any output queue holds data which was not delivered yet.
+ *
+ * @return bool true if at least one queue is not empty.
+ */
+static bool hasQueuedData();
+
+/**
+ * @brief Publishes waiting reports of the error manager to CONTROL_ERROR_OUTPUT.
+ *
+ * Reports only take free room in the queue, so they never push out readings,
+ * the others wait in the error manager.
+ */
+static void publishErrorReports();
+
+/**
+ * @brief Checks if an output can take the next entry of its queue without losing it.
+ *
+ * @param output The ID of the output.
+ * @return bool true if the output is ready.
+ */
+static bool isOutputReady(control_io_t output);
 
 /**
  * @brief Selects uninitialized components by performing a bitwise XOR operation 
@@ -42,6 +231,54 @@ static void initSensor(uint8_t sensor);
  */
 static components_status_ts selectUninitialized();
 
+/**
+ * @brief Checks if a supervised component is part of the build and has to be initialized.
+ *
+ * Outputs and other inputs of the build always are, sensor components only with configured channels.
+ *
+ * @param index Index of the component, see control_supervised_index_te.
+ * @return bool true if the component is used.
+ */
+static bool isSupervisedUsed(uint8_t index);
+
+/**
+ * @brief Checks if a supervised component is used but not working.
+ *
+ * @param index Index of the component, see control_supervised_index_te.
+ * @param uninitialized_components Pointer to the result of selectUninitialized().
+ * @return bool true if the component failed.
+ */
+static bool isSupervisedFailed(uint8_t index, const components_status_ts *uninitialized_components);
+
+/**
+ * @brief Initializes a supervised component with a direct call of its init function.
+ *
+ * @param index Index of the component, see control_supervised_index_te.
+ * @return bool true if the component works.
+ */
+static bool initSupervised(uint8_t index);
+
+/**
+ * @brief Handles the result of the I2C bus health check.
+ *
+ * After a recovery the I2C components are marked as not working and their retries are made due,
+ * because a device that hung the bus may have lost its configuration. The supervisor initializes
+ * them again one per call instead of all of them at once inside the inputs loop. Recoveries and
+ * failed recoveries are reported to the error handler.
+ *
+ * A bus that stays stuck is left to the supervisor as well: the I2C components are marked as
+ * not working, so nothing waits for the Wire timeout, and the recovery is retried with the backoff
+ * of control_i2c_bus_recovery.
+ *
+ * @param health_status The result of i2c_bus_checkHealth() or i2c_bus_retryRecovery().
+ */
+static void handleI2CBusHealth(i2c_bus_health_status_te health_status);
+
+/**
+ * @brief Marks the components on the I2C bus as not working and makes their retries due.
+ */
+static void resetI2CComponents();
+
 /**
  * @brief Initializes or reinitializes system components.
  * 
@@ -71,111 +308,353 @@ bool control_reinit()
     return control_initialize(CONTROL_REINIT);
 }
 
+void control_superviseComponents()
+{
+    // Nothing on the bus can be initialized before the bus is free again
+    if (i2c_bus_isStuck())
+    {
+        if (SUPERVISOR_RETRY_DUE == supervisor_isRetryDue(&control_i2c_bus_recovery))
+        {
+            i2c_bus_health_status_te health_status = i2c_bus_retryRecovery();
+            supervisor_recordAttempt(&control_i2c_bus_recovery, I2C_BUS_RECOVERED == health_status);
+            handleI2CBusHealth(health_status);
+        }
+        return;
+    }
+
+    // Cheap while everything works, only the status bits are compared
+    components_status_ts uninitialized_components = selectUninitialized();
+    if (CONTROL_ALL_INITIALIZED == uninitialized_components.outputs_status &&
+        CONTROL_ALL_INITIALIZED == uninitialized_components.other_inputs_status &&
+        CONTROL_ALL_INITIALIZED == uninitialized_components.sensors_status)
+    {
+        return;
+    }
+
+    // Round robin from the component after the previous attempt, so every failed component gets its turn
+    for (uint8_t checked = 0u; checked < CONTROL_NUM_OF_SUPERVISED; checked++)
+    {
+        uint8_t index = control_next_supervised;
+        control_next_supervised = (CONTROL_NUM_OF_SUPERVISED > index + 1u) ? (uint8_t)(index + 1u) : 0u;
+
+        supervisor_entry_ts *entry = &control_supervised_components[index];
+        if (isSupervisedFailed(index, &uninitialized_components) && SUPERVISOR_RETRY_DUE == supervisor_isRetryDue(entry))
+        {
+            supervisor_recordAttempt(entry, initSupervised(index));
+            return; // At most one initialization per call
+        }
+    }
+}
+
 control_error_code_te control_routeDataToOutput(control_io_t output_component, const control_data_ts *data)
 {
     // Initialize error code
     control_error_code_te error_code = ERROR_CODE_INVALID_OUTPUT;
     
+    // Only the outputs of the build have a case, routing to any other output is an invalid output
     switch (output_component)
     {
-    case OUTPUT_DISPLAY:
-        // Route data to display and update error code
-        error_code = display_displayData(data);
-        break;
+    CONTROL_OUTPUTS(CONTROL_ROUTE_CASE)
 
-    case OUTPUT_SERIAL_CONSOLE:
-        // Route data to serial console and update error code
-        error_code = serial_console_displayData(data);
+    default:
         break;
     }
     // Default error code is set to ERROR_CODE_INVALID_OUTPUT so there is no need to set it in default.
     return error_code;
 }
 
-control_input_data_ts control_fetchDataFromInput(const control_device_ts *input_device)
+void control_publishData(const control_data_ts *data, control_io_mask_t outputs)
 {
-    // Initialize input return data with defaults
-    control_input_data_ts return_data = initializeInputReturnData(input_device);
+    uint16_t now = (uint16_t)millis();
 
-    switch (input_device->io_component)
+    // Only the outputs of the build have a queue, any other output in the set is ignored
+    CONTROL_OUTPUTS(CONTROL_PUBLISH_TO_OUTPUT)
+}
+
+control_error_code_te control_getOutputQueueStats(control_io_t output, control_output_queue_stats_ts *stats)
+{
+    control_error_code_te error_code = ERROR_CODE_INVALID_OUTPUT;
+
+    switch (output)
     {
-    case INPUT_SENSORS:
-        // Fetch sensor reading and update return data
-        sensor_return_ts sensor_return = sensors_getReading(input_device->device_id);
-        return_data.error_code = sensor_return.error_code;
-        return_data.data.input_return.sensor_reading = sensor_return.sensor_reading;
-        break;
+    CONTROL_OUTPUTS(CONTROL_QUEUE_STATS_CASE)
 
-    case INPUT_RTC:
-        // Fetch RTC data and update return data
-        rtc_return_ts rtc_return = rtc_getTime(input_device->device_id);
-        return_data.error_code = rtc_return.error_code;
-        return_data.data.input_return.rtc_reading = rtc_return.rtc_reading;
+    default:
         break;
+    }
+    return error_code;
+}
 
-    case INPUT_I2C_SCAN:
-        // Fetch I2C scan data and update return data
-        i2c_scan_return_ts i2c_scan_return = i2c_scan_getReading(input_device->device_id);
-        return_data.error_code = i2c_scan_return.error_code;
-        return_data.data.input_return.i2c_scan_reading = i2c_scan_return.i2c_scan_reading;
-        break;
+bool control_queuesHaveRoom(control_io_mask_t outputs)
+{
+    CONTROL_OUTPUTS(CONTROL_QUEUE_ROOM_CHECK)
+    return true;
+}
+
+bool control_queuesAreDelivered(control_io_mask_t outputs)
+{
+    CONTROL_OUTPUTS(CONTROL_QUEUE_DELIVERED_CHECK)
+    return true;
+}
+
+control_error_code_te control_fetchDataFromInput(const control_device_ts *input_device, control_data_ts *data)
+{
+    // Initialize error code and the input part of the caller's data
+    control_error_code_te error_code = ERROR_CODE_INVALID_INPUT;
+    data->input = *input_device;
+
+    // Only the inputs of the build have a case
+    switch (input_device->io_component)
+    {
+    CONTROL_INPUTS(CONTROL_FETCH_CASE)
 
     default:
         // Default error code is set to ERROR_CODE_INVALID_INPUT so no need to set it again here.
         break;
     }
-    return return_data;
+    return error_code;
 }
 
-void control_handleError(const control_error_ts *error)
+void control_runInputsLoop(unsigned long current_millis)
 {
-    control_data_ts data;
-    control_device_ts error_input = {INPUT_ERROR, CONTROL_ID_UNUSED}; // Initialize input type
+    (void)i2c_bus_process(I2C_BUS_JOBS_PER_PROCESS);
+    handleI2CBusHealth(i2c_bus_checkHealth());
+    sensors_loop(current_millis);
+}
 
-    // Initialize error data
-    data.input_return.error_msg = *error;
-    data.input = error_input;
+void control_runOutputsLoop()
+{
+    // Queued data comes first, the log dump only gets the room in the transmit ring that is left
+    CONTROL_OUTPUTS(CONTROL_DRAIN_OUTPUT)
+
+#ifdef DATA_LOGGER_COMPONENT
+    data_logger_loop();
+#endif
 
-    // Attempt to send error data to serial console; if it fails, fallback to display
-    if (ERROR_CODE_NO_ERROR != control_routeDataToOutput(OUTPUT_SERIAL_CONSOLE, &data))
+#if defined(DATA_LOGGER_COMPONENT) && defined(SERIAL_CONSOLE_COMPONENT)
+    // Dump is paced by the room in the transmit ring, so it never drops lines
+    char line[DATA_LOGGER_DUMP_LINE_SIZE];
+    while (DATA_LOGGER_DUMP_LINE_SIZE + SERIAL_CONSOLE_LINE_END_LEN <= serial_console_getTxFree() &&
+           DATA_LOGGER_DUMP_LINE_READY == data_logger_readDumpLine(line))
     {
-        (void)control_routeDataToOutput(OUTPUT_DISPLAY, &data);
+        serial_console_printLine(line);
     }
-}
-/* *************************************** */
+#endif
 
-// TODO: CHANGE THIS FUNC TO RETURN ERROR CODE ONLY
+#ifdef SERIAL_CONSOLE_COMPONENT
+    serial_console_processTx();
+#endif
+}
 
-/* STATIC FUNCTIONS IMPLEMENTATIONS */
-static control_input_data_ts initializeInputReturnData(const control_device_ts *input_device)
+unsigned long control_getIdleTime(unsigned long current_millis)
 {
-    control_input_data_ts return_data;
+    // Queued I2C jobs and undelivered data are handled on every loop
+    bool is_busy = (0u != i2c_bus_getPendingJobs()) || hasQueuedData();
+#ifdef SERIAL_CONSOLE_COMPONENT
+    is_busy = is_busy || (SERIAL_CONSOLE_TX_BUFFER_SIZE != serial_console_getTxFree());
+#endif
+#ifdef DATA_LOGGER_COMPONENT
+    is_busy = is_busy || data_logger_isBusy();
+#endif
 
-    // Initialize data part
-    return_data.data.input = *input_device;
+    return is_busy ? 0u : sensors_getIdleTime(current_millis);
+}
 
-    // Initialize error part
-    return_data.error_code = ERROR_CODE_INVALID_INPUT;
+void control_handleError(const control_error_ts *error)
+{
+    error_manager_report(error);
+}
 
-    return return_data;
+void control_clearErrors(const control_device_ts *component)
+{
+    error_manager_clear(component);
 }
 
-static void initSensor(uint8_t sensor)
+void control_runErrorsLoop()
 {
-    components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].sensors_status |= (1 << sensor);
+    error_manager_update();
+    publishErrorReports();
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool initSensor(uint8_t sensor)
+{
+    components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].sensors_status |= ((uint64_t)1u << sensor);
     control_error_code_te error_code = sensors_init(sensor);
+    control_device_ts sensor_device = {INPUT_SENSORS, sensor};
     if(ERROR_CODE_NO_ERROR == error_code)
     {
-        components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status |= (1 << sensor);
+        components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status |= ((uint64_t)1u << sensor);
+        control_clearErrors(&sensor_device);
+        return true;
+    }
+
+    control_error_ts error = {error_code, sensor_device};
+    control_handleError(&error);
+    return false;
+}
+
+static bool recordInitResult(uint8_t *used_status, uint8_t *working_status, uint8_t component,
+                             control_error_code_te error_code, control_device_ts device)
+{
+    *used_status |= (1 << component);
+    if (ERROR_CODE_NO_ERROR == error_code)
+    {
+        *working_status |= (1 << component);
+        control_clearErrors(&device);
+        return true;
+    }
+
+    control_error_ts error = {error_code, device};
+    control_handleError(&error);
+    return false;
+}
+
+static control_error_code_te fetchSensorReading(uint8_t device_id, input_return_tu *input_return)
+{
+    control_error_code_te error_code = sensors_getReading(device_id, &input_return->sensor_reading);
+#ifdef SENSOR_STATS_USED
+    if (ERROR_CODE_NO_ERROR == error_code)
+    {
+        // Statistics are fed from the readings that are fetched anyway, they never read a sensor
+        sensor_stats_addReading(device_id, &input_return->sensor_reading);
+    }
+#endif
+    return error_code;
+}
+
+#ifdef RTC_COMPONENT
+static control_error_code_te fetchRtcReading(uint8_t device_id, input_return_tu *input_return)
+{
+    return rtc_getTime(device_id, &input_return->rtc_reading);
+}
+#endif
+
+static control_error_code_te fetchI2cScanReading(uint8_t device_id, input_return_tu *input_return)
+{
+    return i2c_scan_getReading(device_id, &input_return->i2c_scan_reading);
+}
+
+#ifdef SENSOR_STATS_USED
+static control_error_code_te fetchSensorStatsReading(uint8_t device_id, input_return_tu *input_return)
+{
+    return sensor_stats_getReading(device_id, &input_return->sensor_stats_reading);
+}
+#endif
+
+static void enqueueData(control_output_queue_ts *queue, uint8_t drop_policy, const control_data_ts *data, uint16_t now)
+{
+    if (queue->stats.depth <= queue->count)
+    {
+        if (CONTROL_QUEUE_COUNTER_MAX > queue->stats.dropped)
+        {
+            queue->stats.dropped++;
+        }
+        if (CONTROL_QUEUE_DROP_NEWEST == drop_policy)
+        {
+            return;
+        }
+        // Oldest entry makes room, the new data goes to its end of the ring
+        queue->head = (queue->head + 1u < queue->stats.depth) ? (queue->head + 1u) : 0u;
+        queue->count--;
+    }
+
+    uint8_t tail = queue->head + queue->count;
+    if (tail >= queue->stats.depth)
+    {
+        tail -= queue->stats.depth;
+    }
+    queue->entries[tail].data = *data;
+    queue->entries[tail].published_at = now;
+    queue->count++;
+    queue->stats.high_water_mark = max(queue->stats.high_water_mark, queue->count);
+}
+
+static control_queue_entry_ts *peekQueue(control_output_queue_ts *queue)
+{
+    return (0u != queue->count) ? &queue->entries[queue->head] : nullptr;
+}
+
+static void releaseQueueEntry(control_output_queue_ts *queue, control_io_t output, control_error_code_te error_code)
+{
+    control_output_queue_stats_ts *stats = &queue->stats;
+    // Unsigned difference stays valid across the wrap around of the timestamps
+    stats->last_latency_ms = (uint16_t)millis() - queue->entries[queue->head].published_at;
+    stats->max_latency_ms = max(stats->max_latency_ms, stats->last_latency_ms);
+    if (CONTROL_QUEUE_COUNTER_MAX > stats->delivered)
+    {
+        stats->delivered++;
+    }
+
+    queue->head = (queue->head + 1u < stats->depth) ? (queue->head + 1u) : 0u;
+    queue->count--;
+
+    control_device_ts output_device = {output, CONTROL_ID_UNUSED};
+    if (ERROR_CODE_NO_ERROR == error_code)
+    {
+        control_clearErrors(&output_device);
     }
     else
     {
-        control_device_ts sensor_device = {INPUT_SENSORS, sensor};
-        control_error_ts error = {error_code, sensor_device};
+        control_error_ts error = {error_code, output_device};
         control_handleError(&error);
     }
 }
 
+static bool hasQueueRoom(control_io_t output)
+{
+    switch (output)
+    {
+    CONTROL_OUTPUTS(CONTROL_QUEUE_ROOM_CASE)
+
+    default:
+        return false;
+    }
+}
+
+static bool hasQueuedData()
+{
+    for (uint8_t queue_index = 0u; queue_index < CONTROL_NUM_OF_QUEUES; queue_index++)
+    {
+        if (0u != control_output_queues[queue_index].count)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void publishErrorReports()
+{
+    control_data_ts data;
+    control_device_ts error_input = {INPUT_ERROR, CONTROL_ID_UNUSED};
+    data.input = error_input;
+
+    for (uint8_t published = 0u; published < CONTROL_ERROR_REPORTS_PER_LOOP && hasQueueRoom(CONTROL_ERROR_OUTPUT); published++)
+    {
+        if (ERROR_MANAGER_NO_REPORT == error_manager_nextReport(&data.input_return.error_report))
+        {
+            break;
+        }
+        control_publishData(&data, CONTROL_IO_MASK(CONTROL_ERROR_OUTPUT));
+    }
+}
+
+static bool isOutputReady(control_io_t output)
+{
+#ifdef SERIAL_CONSOLE_COMPONENT
+    if (OUTPUT_SERIAL_CONSOLE == output)
+    {
+        // A line that does not fit would be dropped by the ring, it waits in the queue instead
+        return (CONTROL_SERIAL_CONSOLE_MIN_TX_FREE <= serial_console_getTxFree());
+    }
+#else
+    (void)output;
+#endif
+    return true;
+}
+
 static components_status_ts selectUninitialized()
 {
     // Initialize return structure with all fields set to zero
@@ -194,121 +673,111 @@ static components_status_ts selectUninitialized()
     return return_status_struct;
 }
 
-static bool control_initialize(bool reinit)
+static bool isSupervisedUsed(uint8_t index)
 {
-    control_error_code_te error_code = ERROR_CODE_INIT_FAILED;
-    control_device_ts device_to_init = {IO_UNUSED, CONTROL_ID_UNUSED};
-    control_error_ts error = {error_code, device_to_init};
-
-    // Re-check uninitialized components if reinitializing
-    components_status_ts uninitialized_components;
-    if (CONTROL_REINIT == reinit)
-    {
-        uninitialized_components = selectUninitialized();
-    }
+    return (CONTROL_SUPERVISED_SENSORS > index) ||
+           (0u != (sensors_catalog_components & ((uint64_t)1u << (index - CONTROL_SUPERVISED_SENSORS))));
+}
 
-#ifdef SERIAL_CONSOLE_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.outputs_status & (1 << SERIAL_CONSOLE_COMPONENT)))
+static bool isSupervisedFailed(uint8_t index, const components_status_ts *uninitialized_components)
+{
+    switch (index)
     {
-        components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status |= (1 << SERIAL_CONSOLE_COMPONENT);
-
-        error_code = serial_console_init();
+    CONTROL_OUTPUTS(CONTROL_OUTPUT_FAILED_CASE)
+    CONTROL_INITIALIZED_INPUTS(CONTROL_INPUT_FAILED_CASE)
 
-        if (ERROR_CODE_NO_ERROR == error_code)
-        {
-            components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status |= (1 << SERIAL_CONSOLE_COMPONENT);
-        }
-        else
-        {
-            device_to_init = {OUTPUT_SERIAL_CONSOLE, CONTROL_ID_UNUSED};
-            error = {error_code, device_to_init};
-            control_handleError(&error);
-        }
+    default:
+        break;
     }
-#endif  
+    return (0u != (uninitialized_components->sensors_status & ((uint64_t)1u << (index - CONTROL_SUPERVISED_SENSORS))));
+}
 
-#ifdef LCD_DISPLAY_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.outputs_status & (1 << LCD_DISPLAY_COMPONENT)))
+static bool initSupervised(uint8_t index)
+{
+    switch (index)
     {
-        components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].outputs_status |= (1 << LCD_DISPLAY_COMPONENT);
-
-        error_code = display_init();
+    CONTROL_OUTPUTS(CONTROL_INIT_OUTPUT_CASE)
+    CONTROL_INITIALIZED_INPUTS(CONTROL_INIT_INPUT_CASE)
 
-        if (ERROR_CODE_NO_ERROR == error_code)
-        {
-            components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status |= (1 << LCD_DISPLAY_COMPONENT);
-        }
-        else
-        {
-            device_to_init = {OUTPUT_DISPLAY, CONTROL_ID_UNUSED};
-            error = {error_code, device_to_init};
-            control_handleError(&error);
-        }
+    default:
+        break;
     }
-#endif  
+    return initSensor((uint8_t)(index - CONTROL_SUPERVISED_SENSORS));
+}
 
-#ifdef RTC_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.other_inputs_status & (1 << RTC_COMPONENT)))
+static void handleI2CBusHealth(i2c_bus_health_status_te health_status)
+{
+    if (I2C_BUS_HEALTHY == health_status)
     {
-        components_status[CONTROL_COMPONENTS_STATUS_USED_INDEX].other_inputs_status |= (1 << RTC_COMPONENT);
+        return;
+    }
 
-        error_code = rtc_init();
+    control_device_ts bus_device = {INPUT_I2C_SCAN, CONTROL_ID_UNUSED};
+    control_error_ts error = {ERROR_CODE_I2C_BUS_STUCK, bus_device};
 
-        if (ERROR_CODE_NO_ERROR == error_code)
-        {
-            components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status |= (1 << RTC_COMPONENT);
-        }
-        else
-        {
-            device_to_init = {INPUT_RTC, RTC_DEFAULT_RTC};
-            error = {error_code, device_to_init};
-            control_handleError(&error);
-        }
+    if (I2C_BUS_RECOVERED == health_status)
+    {
+        // Devices on the bus are initialized again by the supervisor, one per call
+        resetI2CComponents();
+        error.error_code = ERROR_CODE_I2C_BUS_RECOVERED;
     }
-#endif  
-
-#ifdef DHT11_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << DHT11_COMPONENT)))
+    else if (0u == control_i2c_bus_recovery.attempts)
     {
-        initSensor(DHT11_COMPONENT);
+        // Bus just got stuck, control_superviseComponents() retries the recovery after the first backoff delay
+        resetI2CComponents();
+        supervisor_recordAttempt(&control_i2c_bus_recovery, false);
     }
+
+    // Reported on every check while the bus is stuck, so the error stays raised
+    control_handleError(&error);
+}
+
+static void resetI2CComponents()
+{
+#ifdef LCD_DISPLAY_COMPONENT
+    components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].outputs_status &= ~(1 << LCD_DISPLAY_COMPONENT);
+    supervisor_schedule(&control_supervised_components[CONTROL_SUPERVISED_OUTPUT_DISPLAY]);
+#endif
+#ifdef RTC_COMPONENT
+    components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].other_inputs_status &= ~(1 << RTC_COMPONENT);
+    supervisor_schedule(&control_supervised_components[CONTROL_SUPERVISED_INPUT_RTC]);
 #endif
 #ifdef BMP280_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << BMP280_COMPONENT)))
-    {
-        initSensor(BMP280_COMPONENT);
-    }
+    components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status &= ~((uint64_t)1 << BMP280_COMPONENT);
+    supervisor_schedule(&control_supervised_components[CONTROL_SUPERVISED_SENSORS + BMP280_COMPONENT]);
 #endif
 #ifdef BH1750_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << BH1750_COMPONENT)))
-    {
-        initSensor(BH1750_COMPONENT);
-    }
+    components_status[CONTROL_COMPONENTS_STATUS_WORKING_INDEX].sensors_status &= ~((uint64_t)1 << BH1750_COMPONENT);
+    supervisor_schedule(&control_supervised_components[CONTROL_SUPERVISED_SENSORS + BH1750_COMPONENT]);
 #endif
-#ifdef MQ135_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << MQ135_COMPONENT)))
-    {
-        initSensor(MQ135_COMPONENT);
-    }
-#endif
-#ifdef MQ7_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << MQ7_COMPONENT)))
+}
+
+static bool control_initialize(bool reinit)
+{
+    // Re-check uninitialized components if reinitializing
+    components_status_ts uninitialized_components = {0};
+    if (CONTROL_REINIT == reinit)
     {
-        initSensor(MQ7_COMPONENT);
+        uninitialized_components = selectUninitialized();
     }
-#endif
-#ifdef GYML8511_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << GYML8511_COMPONENT)))
+    else
     {
-        initSensor(GYML8511_COMPONENT);
+        // Bus is shared by the I2C components, it is started before any of them
+        i2c_bus_init();
     }
-#endif
-#ifdef ARDUINORAIN_COMPONENT
-    if (CONTROL_FIRST_INIT == reinit || CONTROL_COMPONENT_INITIALIZED != (uninitialized_components.sensors_status & (1 << ARDUINORAIN_COMPONENT)))
+
+    // Outputs come first, so they can report the errors of the inputs, sensors end at the highest one with channels
+    for (uint8_t index = 0u; index < CONTROL_NUM_OF_SUPERVISED; index++)
     {
-        initSensor(ARDUINORAIN_COMPONENT);
+        if (CONTROL_FIRST_INIT == reinit && isSupervisedUsed(index))
+        {
+            (void)initSupervised(index);
+        }
+        else if (CONTROL_REINIT == reinit && isSupervisedFailed(index, &uninitialized_components))
+        {
+            supervisor_recordAttempt(&control_supervised_components[index], initSupervised(index));
+        }
     }
-#endif
 
     // Check initialization status
     uninitialized_components = selectUninitialized();
@@ -2,12 +2,19 @@
 #define CONTROL_H
 
 #include <Arduino.h>
+#include "../i2c_bus/i2c_bus.h"
 #include "../input/i2c_scan/i2c_scan.h"
 #include "../input/rtc/rtc.h"
+#include "../input/sensor_stats/sensor_stats.h"
 #include "../input/sensors/sensors.h"
+#include "../output/data_logger/data_logger.h"
 #include "../output/display/display.h"
 #include "../output/serial_console/serial_console.h"
+#include "control_config.h"
 #include "control_types.h"
+#include "error_manager/error_manager.h"
+#include "report_filter/report_filter.h"
+#include "supervisor/supervisor.h"
 
 /* Index for components that are used in the system. */
 #define CONTROL_COMPONENTS_STATUS_USED_INDEX     (uint8_t)(0u)
@@ -36,6 +43,73 @@
 /* Macro used for reinitialization */
 #define CONTROL_REINIT                           (bool)(true)
 
+/* Output of the error reports, the display only takes them in builds without a serial console */
+#define CONTROL_ERROR_OUTPUT                     (control_io_t)(control_isComponentUsed(OUTPUT_SERIAL_CONSOLE) ? OUTPUT_SERIAL_CONSOLE : OUTPUT_DISPLAY)
+
+/* Queue statistics counters stop at this value */
+#define CONTROL_QUEUE_COUNTER_MAX                (uint16_t)(0xFFFFu)
+
+/* Generates the index of the queue of an output, in the order of CONTROL_OUTPUTS */
+#define CONTROL_QUEUE_INDEX_ENTRY(io, component, init_function, data_function) CONTROL_QUEUE_INDEX_##io,
+
+/* Generates the depth of the queue of an output */
+#define CONTROL_QUEUE_DEPTH_ENTRY(io, component, init_function, data_function) CONTROL_QUEUE_DEPTH_##io +
+
+/* Index of the queue of every output of the build */
+typedef enum
+{
+    CONTROL_OUTPUTS(CONTROL_QUEUE_INDEX_ENTRY)
+    CONTROL_NUM_OF_QUEUES   /**< Number of output queues, not a queue. */
+} control_queue_index_te;
+
+/* Entries of the queues of all outputs of the build */
+#define CONTROL_QUEUE_NUM_OF_ENTRIES             (uint16_t)(CONTROL_OUTPUTS(CONTROL_QUEUE_DEPTH_ENTRY) 0u)
+
+/**
+ * @brief Data published to an output, waiting in the queue of the output.
+ *
+ * The data is a copy, so the publisher can reuse its buffer right away.
+ */
+typedef struct
+{
+    control_data_ts data;     // Published data, the output reads it in place
+    uint16_t published_at;    // Millisecond of publishing, wraps around
+} control_queue_entry_ts;
+
+/* SRAM of one queue entry */
+#define CONTROL_QUEUE_ENTRY_BYTES                (uint16_t)(sizeof(control_queue_entry_ts))
+
+/**
+ * @brief Statistics of the queue of one output.
+ *
+ * Latencies are measured from publishing until the output is done with the data, they are
+ * only valid below about 65 seconds. Counters stop at CONTROL_QUEUE_COUNTER_MAX.
+ */
+typedef struct
+{
+    uint16_t delivered;        // Entries handed to the output
+    uint16_t dropped;          // Entries lost because the queue was full
+    uint16_t last_latency_ms;  // Latency of the latest delivered entry
+    uint16_t max_latency_ms;   // Longest latency of a delivered entry
+    uint8_t high_water_mark;   // Most entries waiting at once
+    uint8_t depth;             // Entries the queue can hold
+} control_output_queue_stats_ts;
+
+/**
+ * @brief Bounded queue of one output, a ring of `count` entries from `head` (oldest).
+ */
+typedef struct
+{
+    control_queue_entry_ts *entries;
+    control_output_queue_stats_ts stats;
+    uint8_t head;
+    uint8_t count;
+} control_output_queue_ts;
+
+static_assert(0u < CONTROL_NUM_OF_QUEUES, "No output is enabled in project_settings.h, published data would have no destination");
+static_assert(CONTROL_QUEUE_MAX_ENTRIES >= CONTROL_QUEUE_NUM_OF_ENTRIES,
+              "Output queues exceed CONTROL_QUEUE_MAX_ENTRIES, make the queues in control_config.h shorter");
+
 /**
  * @brief Structure to track the status of system components.
  *
@@ -60,6 +134,27 @@ typedef struct
     uint8_t outputs_status;
 } components_status_ts;
 
+/* Generates the index of a supervised output, in the order of CONTROL_OUTPUTS */
+#define CONTROL_SUPERVISED_OUTPUT_ENTRY(io, component, init_function, data_function) CONTROL_SUPERVISED_##io,
+
+/* Generates the index of a supervised input other than the sensors */
+#define CONTROL_SUPERVISED_INPUT_ENTRY(io, component, device_id, init_function)      CONTROL_SUPERVISED_##io,
+
+/**
+ * Index of every component the supervisor retries, in the order of the initialization:
+ * the outputs, the other inputs and one index per sensor component up to the highest one
+ * in the sensor catalog.
+ */
+typedef enum
+{
+    CONTROL_OUTPUTS(CONTROL_SUPERVISED_OUTPUT_ENTRY)
+    CONTROL_INITIALIZED_INPUTS(CONTROL_SUPERVISED_INPUT_ENTRY)
+    CONTROL_SUPERVISED_SENSORS   /**< Index of sensor component 0, the others follow. */
+} control_supervised_index_te;
+
+/* Components of the build the supervisor keeps a retry entry for */
+#define CONTROL_NUM_OF_SUPERVISED                (uint8_t)(CONTROL_SUPERVISED_SENSORS + SENSORS_CATALOG_COMPONENTS_END)
+
 /**
  * @brief Performs the first-time initialization of all system components.
  * 
@@ -76,18 +171,34 @@ bool control_init();
  * 
  * Calls the control_initialize function with CONTROL_REINIT to check for and 
  * reattempt initialization of components that failed during the initial startup.
+ * Blocks until every failed component was tried, control_superviseComponents()
+ * retries them in the background instead.
  * 
  * @return CONTROL_INITIALIZATION_SUCCESSFUL if all components are successfully 
  *         initialized after reattempt, otherwise CONTROL_INITIALIZATION_FAILED.
  */
 bool control_reinit();
 
+/**
+ * @brief Retries the initialization of at most one failed component.
+ *
+ * Failed components are visited round robin, the first one whose backoff is over
+ * (see supervisor.h) is initialized again and the result is recorded in its own retry
+ * entry. So one call never takes longer than the initialization of one component and
+ * a component that stays broken does not hold up the others. Returns right away while
+ * every component works. While the I2C bus is stuck, the bus recovery is retried with its
+ * own backoff instead and no component is initialized.
+ * Must be called regularly, e.g. every few hundred milliseconds.
+ */
+void control_superviseComponents();
+
 /**
  * @brief Routes data to the specified output component.
  *
  * This function forwards data fetched from an input component to one of the
- * defined output components. It returns an error code that can be passed
- * to the Error Manager for handling.
+ * defined output components right away, the caller waits for the output. It returns
+ * an error code that can be passed to the Error Manager for handling.
+ * Readings are published with control_publishData() instead, so no output delays the caller.
  *
  * @param output_component The ID of the output component to which the data
  *                         is forwarded (e.g., display, serial console).
@@ -95,37 +206,150 @@ bool control_reinit();
  *                         the format/type of data part returned by the data fetch function.
  *
  * @return An error code of type `control_error_code_te` indicating the
- *         status of the routing operation.
+ *         status of the routing operation. Outputs that are not part of the
+ *         build (see CONTROL_OUTPUTS) return ERROR_CODE_INVALID_OUTPUT.
  */
 control_error_code_te control_routeDataToOutput(control_io_t output_component,
                                                 const control_data_ts *data);
 
+/**
+ * @brief Publishes data to a set of outputs without waiting for them.
+ *
+ * The data is copied into the bounded queue of every output in the set and the caller can reuse
+ * its buffer right away. Every output drains its own queue in control_runOutputsLoop() at its own pace,
+ * so a slow output neither delays the caller nor the other outputs. A full queue drops an entry by
+ * the policy of its output (see control_config.h) and counts it. Outputs that are not part of the build
+ * are ignored, errors of the outputs are passed to control_handleError() when the entry is delivered.
+ *
+ * @param data Pointer to the data to publish, e.g. written by control_fetchDataFromInput().
+ * @param outputs Set of output IDs (CONTROL_IO_MASK(OUTPUT_DISPLAY) | ...).
+ */
+void control_publishData(const control_data_ts *data, control_io_mask_t outputs);
+
+/**
+ * @brief Returns the statistics of the queue of an output.
+ *
+ * @param output The ID of the output component.
+ * @param stats Pointer to the caller's statistics, only written on success.
+ * @return control_error_code_te
+ *         - ERROR_CODE_NO_ERROR: Statistics are valid.
+ *         - ERROR_CODE_INVALID_OUTPUT: The output is not part of the build.
+ */
+control_error_code_te control_getOutputQueueStats(control_io_t output, control_output_queue_stats_ts *stats);
+
+/**
+ * @brief Checks if every output in the set can take one more entry without dropping it.
+ *
+ * For callers which publish many entries back to back, e.g. every sensor at once. They publish while
+ * this holds and continue on a later call, once control_runOutputsLoop() has drained the queues.
+ * A queue which drops new entries (CONTROL_QUEUE_DROP_NEWEST) would otherwise keep only the first ones.
+ * Queues which drop their oldest entry are not checked, their output only has to show the latest data.
+ *
+ * @param outputs Set of output IDs (CONTROL_IO_MASK(OUTPUT_DISPLAY) | ...).
+ * @return bool true if every queue has room.
+ */
+bool control_queuesHaveRoom(control_io_mask_t outputs);
+
+/**
+ * @brief Checks if every output in the set has delivered its whole queue.
+ *
+ * The outputs are also ready for the next entry then, e.g. the serial transmit ring has room for a line,
+ * so whatever the caller prints next follows the queued entries.
+ *
+ * @param outputs Set of output IDs (CONTROL_IO_MASK(OUTPUT_DISPLAY) | ...).
+ * @return bool true if every queue is delivered.
+ */
+bool control_queuesAreDelivered(control_io_mask_t outputs);
+
 /**
  * @brief Fetches data from the specified input component.
  *
  * This function retrieves data from a specified input component (e.g., sensors, RTC)
- * and returns it as a structured result. One part of the fetched data can then be used by
- * output components and the other can be forwarded to an Error manager.
+ * and writes it into the caller's data structure, which can then be published to the
+ * output components with control_publishData(). The reading is written once,
+ * directly by the input, and is not copied on the way. The returned error code can be
+ * forwarded to an Error manager.
+ * Valid sensor readings are also added to the rolling statistics (INPUT_SENSOR_STATS).
+ *
+ * Inputs that are not part of the build (see CONTROL_INPUTS) return ERROR_CODE_INVALID_INPUT.
  *
  * @param input_device Pointer to structure with ID of the input component from which data is fetched
  *         (e.g., sensors, RTC) and the specific ID within the input component (e.g., sensor ID).
+ * @param data Pointer to the caller's data structure. `input` is set to the input device, `input_return`
+ *         receives the reading and is only valid if ERROR_CODE_NO_ERROR is returned.
+ *
+ * @return An error code of type `control_error_code_te` indicating the status of the fetch.
+ */
+control_error_code_te control_fetchDataFromInput(const control_device_ts *input_device, control_data_ts *data);
+
+/**
+ * @brief Runs the background processing of the input components.
+ *
+ * Advances time based processes of the inputs that must not block the caller
+ * (e.g., DHT11 acquisition, MQ7 heating cycle) and executes a budget of queued
+ * I2C bus jobs. Afterwards the I2C bus is checked for timeouts and stuck lines; if
+ * the bus had to be recovered, the I2C components are handed to the supervisor, which
+ * initializes them again one at a time (see control_superviseComponents()). A bus the
+ * recovery could not free is not touched again until the supervisor retries the recovery.
+ * Must be called every few milliseconds.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void control_runInputsLoop(unsigned long current_millis);
+
+/**
+ * @brief Runs the background processing of the output components.
+ *
+ * Delivers published data from the output queues, every output gets at most its
+ * drain budget of entries per call and only while it is ready (the serial console
+ * needs CONTROL_SERIAL_CONSOLE_MIN_TX_FREE bytes in its transmit ring). Afterwards
+ * data logger pages are written, a running log dump is fed into the serial console
+ * and queued serial console output is moved to the hardware without waiting.
+ * Must be called every few milliseconds.
+ */
+void control_runOutputsLoop();
+
+/**
+ * @brief Returns how long the input and output loops have nothing to do.
  *
- * @return A structure of type `control_input_data_ts` has two parts.
- *         `data` - containing the fetched data, input type, and component ID.
- *         `error_msg` - containing error code, flag for input/output and the details of the
- *         component( ID, etc.)
+ * The loops are busy while I2C jobs are queued, an output queue or the serial transmit ring
+ * holds data, or the data logger writes a page or dumps the log. Otherwise they only have to run
+ * at the next deadline of the sensors (see sensors_getIdleTime()). Publishing data or reading
+ * a sensor can end the idle time, ask again afterwards.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return unsigned long Milliseconds until the loops must run, 0 if they are busy,
+ *                       INPUT_IDLE_FOREVER if nothing is pending.
  */
-control_input_data_ts control_fetchDataFromInput(const control_device_ts *input_device);
+unsigned long control_getIdleTime(unsigned long current_millis);
 
 /**
- * @brief Handles and routes error messages to the appropriate output.
+ * @brief Passes an error to the error manager.
  *
- * This function takes an error message, packages it into a control data structure, 
- * and attempts to route it to the serial console first. If that fails, it falls back 
- * to routing the error message to the display output.
+ * The error is only counted, nothing is formatted or sent here, so a component that fails
+ * in every cycle costs no more than a lookup. Outputs get the reports of the error manager
+ * from control_runErrorsLoop(), see error_manager.h.
  *
  * @param error Pointer to the error message structure to be handled.
  */
 void control_handleError(const control_error_ts *error);
 
+/**
+ * @brief Clears the errors of a component after it worked.
+ *
+ * Cheap while no error is tracked, so it can be called after every successful operation.
+ *
+ * @param component Pointer to the component which worked.
+ */
+void control_clearErrors(const control_device_ts *component);
+
+/**
+ * @brief Runs the background processing of the errors.
+ *
+ * Starts a new summary interval of the error manager when it is due and publishes up to
+ * CONTROL_ERROR_REPORTS_PER_LOOP reports to CONTROL_ERROR_OUTPUT, only while its queue has room.
+ * Must be called every few milliseconds.
+ */
+void control_runErrorsLoop();
+
 #endif
\ No newline at end of file
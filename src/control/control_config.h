@@ -0,0 +1,40 @@
+#ifndef CONTROL_CONFIG_H
+#define CONTROL_CONFIG_H
+
+#include <Arduino.h>
+
+/* What a full output queue does with a newly published entry */
+#define CONTROL_QUEUE_DROP_NEWEST                   (uint8_t)(0u) /** The new entry is dropped, queued entries are delivered in order */
+#define CONTROL_QUEUE_DROP_OLDEST                   (uint8_t)(1u) /** The oldest entry makes room, the output always gets the latest data */
+
+/**
+ * Entries every output can queue. Every entry costs CONTROL_QUEUE_ENTRY_BYTES of SRAM, only outputs of
+ * the build take SRAM. An output that cannot keep up loses entries, counted in its queue statistics.
+ */
+#define CONTROL_QUEUE_DEPTH_OUTPUT_SERIAL_CONSOLE   (uint8_t)(4u)
+#define CONTROL_QUEUE_DEPTH_OUTPUT_DISPLAY          (uint8_t)(2u)
+#define CONTROL_QUEUE_DEPTH_OUTPUT_DATA_LOGGER      (uint8_t)(2u)
+
+/* Drop policy of every output, a display only has to show the latest data */
+#define CONTROL_QUEUE_POLICY_OUTPUT_SERIAL_CONSOLE  CONTROL_QUEUE_DROP_NEWEST
+#define CONTROL_QUEUE_POLICY_OUTPUT_DISPLAY         CONTROL_QUEUE_DROP_OLDEST
+#define CONTROL_QUEUE_POLICY_OUTPUT_DATA_LOGGER     CONTROL_QUEUE_DROP_NEWEST
+
+/* Entries every output is given per control_runOutputsLoop(), limits the time a slow output takes per call */
+#define CONTROL_DRAIN_BUDGET_OUTPUT_SERIAL_CONSOLE  (uint8_t)(2u)
+#define CONTROL_DRAIN_BUDGET_OUTPUT_DISPLAY         (uint8_t)(1u)
+#define CONTROL_DRAIN_BUDGET_OUTPUT_DATA_LOGGER     (uint8_t)(2u)
+
+/**
+ * Room in the serial console transmit ring needed to hand it the next entry. Entries wait in their queue
+ * until the ring has drained that far, instead of being cut off in the ring.
+ */
+#define CONTROL_SERIAL_CONSOLE_MIN_TX_FREE          (uint16_t)(SERIAL_CONSOLE_STRING_RESERVED_GIANT + SERIAL_CONSOLE_LINE_END_LEN)
+
+/* Error reports of the error manager published per control_runErrorsLoop(), they only take free room in the queue */
+#define CONTROL_ERROR_REPORTS_PER_LOOP              (uint8_t)(1u)
+
+/* Upper limit of the entries of all output queues together, checked at compile time. 8 entries take about 210 bytes of SRAM */
+#define CONTROL_QUEUE_MAX_ENTRIES                   (uint8_t)(8u)
+
+#endif
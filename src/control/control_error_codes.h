@@ -40,6 +40,20 @@ typedef enum
   ERROR_CODE_UNKNOWN_I2C_DEVICE_STATUS,
   /* ********************************* */
 
+  /* I2C bus related */
+  ERROR_CODE_I2C_BUS_RECOVERED,
+  ERROR_CODE_I2C_BUS_STUCK,
+  /* ********************************* */
+
+  /* Data logger related */
+  ERROR_CODE_DATA_LOGGER_FULL,
+  /* ********************************* */
+
+  /* Sensor statistics related */
+  ERROR_CODE_SENSOR_STATS_NOT_TRACKED,
+  ERROR_CODE_SENSOR_STATS_NO_SAMPLES,
+  /* ********************************* */
+
   /* Init related */
   ERROR_CODE_INIT_FAILED,
   /* ********************************* */
@@ -19,34 +19,128 @@
  */
 typedef uint8_t control_io_t;
 
+/* Set of control I/O components, one bit per control_io_te ID */
+typedef uint16_t control_io_mask_t;
+
+/* Bit of a control I/O component in a control_io_mask_t */
+#define CONTROL_IO_MASK(io)   (control_io_mask_t)((control_io_mask_t)1u << (io))
+
+/* Empty set of control I/O components */
+#define CONTROL_NO_IO         (control_io_mask_t)(0u)
+
 /**
  * Enum listing all available inputs and outputs.
  *
  * This enumeration defines the possible inputs and outputs
- * within the data routing system.
+ * within the data routing system. Every ID exists in every build, components which are
+ * not enabled in project_settings.h are left out of the component graph below instead.
  */
 typedef enum
 {   
     INPUT_SENSORS,          /**< Input for sensors. */
-
-#ifdef RTC_COMPONENT
     INPUT_RTC,              /**< Input for the Real-Time Clock (RTC). */
-#endif
-
     INPUT_I2C_SCAN,         /**< Input for I2C address scanning. */
+    INPUT_SENSOR_STATS,     /**< Input for the rolling statistics of the sensor channels. */
     INPUT_ERROR,            /**< Input for error. */
-
-#ifdef LCD_DISPLAY_COMPONENT
     OUTPUT_DISPLAY,         /**< Output component for a display device. */
-#endif
-
-#ifdef SERIAL_CONSOLE_COMPONENT
     OUTPUT_SERIAL_CONSOLE,  /**< Output component for the serial console. */
-#endif
+    OUTPUT_DATA_LOGGER,     /**< Output component for the EEPROM data logger. */
+    CONTROL_IO_NUM_OF_IDS,  /**< Number of IDs, not a component. */
 
     IO_UNUSED = 0xFF
 } control_io_te;
 
+/* COMPONENT GRAPH */
+/**
+ * Inputs and outputs of the build, generated from project_settings.h. Every list entry is one X(...) call:
+ *  - CONTROL_INPUTS:             X(io, fetch_function)
+ *  - CONTROL_INITIALIZED_INPUTS: X(io, component, device_id, init_function)
+ *  - CONTROL_OUTPUTS:            X(io, component, init_function, data_function)
+ * Arguments:
+ *  - io:             ID from control_io_te.
+ *  - component:      Bit of the component in the component status (see control.h).
+ *  - device_id:      ID reported with initialization errors.
+ *  - fetch_function: Fetches the input into the caller's input_return_tu, a static adapter in control.cpp.
+ *  - init_function:  Initializes the component, returns control_error_code_te.
+ *  - data_function:  Shows control_data_ts on the output, returns control_error_code_te.
+ * Components that are not enabled expand to nothing. The dispatchers and the initialization in control.cpp
+ * are expanded from these lists, so every build only contains direct calls of its own components and
+ * the code of the others is not linked. Outputs are listed in the order they are initialized and their
+ * queues are drained, the slow display comes last so it does not hold up the others.
+ */
+#define CONTROL_GRAPH_SKIP(X)
+
+#define CONTROL_INPUT_SENSORS(X)           X(INPUT_SENSORS, fetchSensorReading)
+#define CONTROL_INPUT_I2C_SCAN(X)          X(INPUT_I2C_SCAN, fetchI2cScanReading)
+
+#ifdef RTC_COMPONENT
+  #define CONTROL_INPUT_RTC(X)             X(INPUT_RTC, fetchRtcReading)
+  #define CONTROL_INITIALIZED_RTC(X)       X(INPUT_RTC, RTC_COMPONENT, RTC_DEFAULT_RTC, rtc_init)
+#else
+  #define CONTROL_INPUT_RTC(X)             CONTROL_GRAPH_SKIP(X)
+  #define CONTROL_INITIALIZED_RTC(X)       CONTROL_GRAPH_SKIP(X)
+#endif
+#ifdef SENSOR_STATS_USED
+  #define CONTROL_INPUT_SENSOR_STATS(X)    X(INPUT_SENSOR_STATS, fetchSensorStatsReading)
+#else
+  #define CONTROL_INPUT_SENSOR_STATS(X)    CONTROL_GRAPH_SKIP(X)
+#endif
+#ifdef SERIAL_CONSOLE_COMPONENT
+  #define CONTROL_OUTPUT_SERIAL_CONSOLE(X) X(OUTPUT_SERIAL_CONSOLE, SERIAL_CONSOLE_COMPONENT, serial_console_init, serial_console_displayData)
+#else
+  #define CONTROL_OUTPUT_SERIAL_CONSOLE(X) CONTROL_GRAPH_SKIP(X)
+#endif
+#ifdef LCD_DISPLAY_COMPONENT
+  #define CONTROL_OUTPUT_DISPLAY(X)        X(OUTPUT_DISPLAY, LCD_DISPLAY_COMPONENT, display_init, display_displayData)
+#else
+  #define CONTROL_OUTPUT_DISPLAY(X)        CONTROL_GRAPH_SKIP(X)
+#endif
+#ifdef DATA_LOGGER_COMPONENT
+  #define CONTROL_OUTPUT_DATA_LOGGER(X)    X(OUTPUT_DATA_LOGGER, DATA_LOGGER_COMPONENT, data_logger_init, data_logger_displayData)
+#else
+  #define CONTROL_OUTPUT_DATA_LOGGER(X)    CONTROL_GRAPH_SKIP(X)
+#endif
+
+/* Inputs which can be fetched */
+#define CONTROL_INPUTS(X) \
+  CONTROL_INPUT_SENSORS(X) \
+  CONTROL_INPUT_RTC(X) \
+  CONTROL_INPUT_I2C_SCAN(X) \
+  CONTROL_INPUT_SENSOR_STATS(X)
+
+/* Inputs other than the sensors which have to be initialized */
+#define CONTROL_INITIALIZED_INPUTS(X) \
+  CONTROL_INITIALIZED_RTC(X)
+
+/* Outputs data can be routed to */
+#define CONTROL_OUTPUTS(X) \
+  CONTROL_OUTPUT_SERIAL_CONSOLE(X) \
+  CONTROL_OUTPUT_DATA_LOGGER(X) \
+  CONTROL_OUTPUT_DISPLAY(X)
+
+/* Generates the bit of an input or an output of the build */
+#define CONTROL_INPUT_MASK_ENTRY(io, fetch_function)                        CONTROL_IO_MASK(io) |
+#define CONTROL_OUTPUT_MASK_ENTRY(io, component, init_function, data_function) CONTROL_IO_MASK(io) |
+
+/* Inputs and outputs of the build, one bit per control_io_te ID */
+constexpr control_io_mask_t control_graph_components = CONTROL_INPUTS(CONTROL_INPUT_MASK_ENTRY) CONTROL_OUTPUTS(CONTROL_OUTPUT_MASK_ENTRY) CONTROL_NO_IO;
+
+static_assert(8u * sizeof(control_io_mask_t) >= CONTROL_IO_NUM_OF_IDS, "Component graph has one bit per control_io_te ID in control_io_mask_t");
+
+/**
+ * @brief Checks at compile time if an input or an output is part of the build.
+ *
+ * Branches on the result are removed by the compiler, together with every call inside them.
+ *
+ * @param io ID from control_io_te.
+ * @return bool true if the component is enabled in project_settings.h.
+ */
+constexpr bool control_isComponentUsed(control_io_t io)
+{
+    return (CONTROL_IO_NUM_OF_IDS > io) && (CONTROL_NO_IO != (control_graph_components & CONTROL_IO_MASK(io)));
+}
+/* ********************************* */
+
 /**
  * Structure representing a specific device.
  * 
@@ -78,11 +172,37 @@ typedef struct
     control_device_ts component;      /**< Detailed information about the error source and the ID of the component */
 } control_error_ts;
 
+/* Events of an error report */
+#define CONTROL_ERROR_EVENT_RAISED     (uint8_t)(0u) /**< Error occurred for the first time, or again after it was cleared */
+#define CONTROL_ERROR_EVENT_CLEARED    (uint8_t)(1u) /**< Component worked again, or the error did not occur for a summary interval */
+#define CONTROL_ERROR_EVENT_SUMMARY    (uint8_t)(2u) /**< Error is still present, repeated once per summary interval */
+
+/**
+ * Structure representing a report of the error manager about one error of one component.
+ *
+ * Members:
+ *  - error:        The error code and the affected component.
+ *  - first_seen_s: Second since start up the error was raised at.
+ *  - last_seen_s:  Second since start up of the latest occurrence.
+ *  - count:        Occurrences since the previous report of the error.
+ *  - total:        Occurrences since the error was raised.
+ *  - event:        CONTROL_ERROR_EVENT_RAISED, CONTROL_ERROR_EVENT_CLEARED or CONTROL_ERROR_EVENT_SUMMARY.
+ */
+typedef struct
+{
+    control_error_ts error;
+    uint32_t first_seen_s;
+    uint32_t last_seen_s;
+    uint16_t count;
+    uint16_t total;
+    uint8_t event;
+} control_error_report_ts;
+
 /**
  * Union for handling various input types dynamically.
  *
  * This union is designed to accommodate different types of input data that
- * may be returned from `control_fetchDataFromInput` or an error. The specific input
+ * may be written by `control_fetchDataFromInput` or an error. The specific input
  * type (e.g., sensor reading, RTC reading) is determined dynamically at runtime,
  * allowing the function to flexibly handle multiple input sources.
  *
@@ -92,15 +212,17 @@ typedef struct
  *  - rtc_reading:        Contains data specific to RTC readings, such as date and time.
  *  - i2c_scan_reading:    Contains data specific to I2C scan readings,
  *                        such as addresses bit fields or I2C device status.
- *  - error_msg           Contains data specific to the error message, such as error source,
- *                        input/output flag and specific error code.
+ *  - sensor_stats_reading: Contains the rolling statistics of a sensor channel.
+ *  - error_report:       Contains a report of the error manager, such as error source,
+ *                        specific error code and the number of occurrences.
  */
 typedef union
 {
     sensor_reading_ts sensor_reading;       /**< Data structure for sensor readings. */
     rtc_reading_ts rtc_reading;             /**< Data structure for RTC readings. */
     i2c_scan_reading_ts i2c_scan_reading;   /**< Data structure for I2C scan readings. */
-    control_error_ts error_msg;             /**< Data structure for error message. */
+    sensor_stats_reading_ts sensor_stats_reading; /**< Data structure for sensor statistics. */
+    control_error_report_ts error_report;   /**< Data structure for error reports. */
 } input_return_tu;
 
 /**
@@ -109,7 +231,8 @@ typedef union
  * This structure encapsulates the data recieved from an input,
  * including the actual return data, the type of input, and its unique identifier.
  * It is used to standardize and simplify the handling of data from various inputs
- * (e.g., sensors, RTC).
+ * (e.g., sensors, RTC). The caller owns the structure: the input writes its reading
+ * into it and the outputs read it through a const pointer, so a reading is never copied.
  *
  * Members:
  *  - input_return: A union (`input_return_tu`) holding the actual data returned from
@@ -123,24 +246,4 @@ typedef struct
     control_device_ts input;         /**< Structure with input type and ID. */
 } control_data_ts;
 
-/**
- * Structure for managing the dual output of data fetching operations.
- *
- * This structure is designed to encapsulate two outputs resulting from
- * a data fetch operation. One part (`data`) contains the fetched data
- * that can be forwarded to an output component, while the other part
- * (`error_code`) contains an error message to be handled by the Error Handler.
- *
- * Members:
- *  - data:       Contains the fetched data, encapsulated in the `control_data_ts`
- *                structure, to be forwarded to an output component (e.g., display, console).
- *  - error_code: Represents the error message of type `control_error_code_te`
- *                that can be passed to the Error Handler for further processing.
- */
-typedef struct
-{
-    control_data_ts data;             /**< The fetched data for output forwarding. */
-    control_error_code_te error_code;  /**< The error code for the Error Handler. */
-} control_input_data_ts;
-
 #endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "error_manager.h"
+
+/* STATIC GLOBAL VARIABLES */
+static error_manager_entry_ts error_manager_entries[ERROR_MANAGER_MAX_ENTRIES];
+static error_manager_stats_ts error_manager_stats = {0u, 0u, 0u, 0u};
+static uint8_t error_manager_num_of_tracked = 0u;  // Entries which are not free
+static uint8_t error_manager_escalations_left = ERROR_MANAGER_ESCALATIONS_PER_INTERVAL;
+static uint32_t error_manager_interval_start_s = 0u;
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Returns the current time in seconds, as used for the timestamps.
+ *
+ * @return uint32_t Seconds since start up.
+ */
+static uint32_t getTimestamp();
+
+/**
+ * @brief Finds the tracked entry of an error.
+ *
+ * @param error Pointer to the error code and the component.
+ * @return error_manager_entry_ts* The entry, nullptr if the error is not tracked.
+ */
+static error_manager_entry_ts *findEntry(const control_error_ts *error);
+
+/**
+ * @brief Finds the first entry with one of the pending reports.
+ *
+ * @param pending_mask ERROR_MANAGER_PENDING_... bits to look for.
+ * @return error_manager_entry_ts* The entry, nullptr if no entry has one of the reports pending.
+ */
+static error_manager_entry_ts *findPending(uint8_t pending_mask);
+
+/**
+ * @brief Takes one report of the escalation budget of the interval.
+ *
+ * @param entry Pointer to the entry which changed its state.
+ * @param pending The ERROR_MANAGER_PENDING_... bit of the change.
+ */
+static void escalate(error_manager_entry_ts *entry, uint8_t pending);
+
+/**
+ * @brief Increments a counter which stops at ERROR_MANAGER_COUNTER_MAX.
+ *
+ * @param counter Pointer to the counter.
+ */
+static void countSaturated(uint16_t *counter);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void error_manager_report(const control_error_ts *error)
+{
+  uint32_t now = getTimestamp();
+  countSaturated(&error_manager_stats.occurrences);
+
+  error_manager_entry_ts *entry = findEntry(error);
+  if(nullptr != entry)
+  {
+    // An error which is back before its clearing was reported has never really gone
+    entry->state = ERROR_MANAGER_STATE_ACTIVE;
+    entry->pending &= (uint8_t)~ERROR_MANAGER_PENDING_CLEARED;
+    entry->last_seen_s = now;
+    countSaturated(&entry->count);
+    countSaturated(&entry->total);
+    return;
+  }
+
+  for(uint8_t index = 0u; index < ERROR_MANAGER_MAX_ENTRIES; index++)
+  {
+    entry = &error_manager_entries[index];
+    if(ERROR_MANAGER_STATE_FREE == entry->state)
+    {
+      entry->error = *error;
+      entry->first_seen_s = now;
+      entry->last_seen_s = now;
+      entry->count = 1u;
+      entry->total = 1u;
+      entry->state = ERROR_MANAGER_STATE_ACTIVE;
+      entry->pending = 0u;
+      error_manager_num_of_tracked++;
+      escalate(entry, ERROR_MANAGER_PENDING_RAISED);
+      return;
+    }
+  }
+
+  countSaturated(&error_manager_stats.untracked);
+}
+
+void error_manager_clear(const control_device_ts *component)
+{
+  // Fast path for the usual case, every successful operation ends up here
+  if(0u == error_manager_num_of_tracked)
+  {
+    return;
+  }
+
+  for(uint8_t index = 0u; index < ERROR_MANAGER_MAX_ENTRIES; index++)
+  {
+    error_manager_entry_ts *entry = &error_manager_entries[index];
+    if(ERROR_MANAGER_STATE_ACTIVE == entry->state &&
+       component->io_component == entry->error.component.io_component &&
+       component->device_id == entry->error.component.device_id)
+    {
+      entry->state = ERROR_MANAGER_STATE_CLEARED;
+      entry->pending &= (uint8_t)~ERROR_MANAGER_PENDING_SUMMARY;
+      escalate(entry, ERROR_MANAGER_PENDING_CLEARED);
+    }
+  }
+}
+
+void error_manager_update()
+{
+  uint32_t now = getTimestamp();
+  if(ERROR_MANAGER_SUMMARY_SECONDS > now - error_manager_interval_start_s)
+  {
+    return;
+  }
+
+  error_manager_interval_start_s = now;
+  error_manager_escalations_left = ERROR_MANAGER_ESCALATIONS_PER_INTERVAL;
+
+  for(uint8_t index = 0u; index < ERROR_MANAGER_MAX_ENTRIES; index++)
+  {
+    error_manager_entry_ts *entry = &error_manager_entries[index];
+    if(ERROR_MANAGER_STATE_ACTIVE == entry->state && ERROR_MANAGER_SUMMARY_SECONDS <= now - entry->last_seen_s)
+    {
+      // Errors without a success of their component (e.g. bus recoveries) end when they stop occurring
+      entry->state = ERROR_MANAGER_STATE_CLEARED;
+      entry->pending = (entry->pending & ERROR_MANAGER_PENDING_RAISED) | ERROR_MANAGER_PENDING_CLEARED;
+    }
+    else if(ERROR_MANAGER_STATE_ACTIVE == entry->state && 0u != entry->count)
+    {
+      entry->pending |= ERROR_MANAGER_PENDING_SUMMARY;
+    }
+    else if(ERROR_MANAGER_STATE_CLEARED == entry->state)
+    {
+      entry->pending |= ERROR_MANAGER_PENDING_CLEARED; // Clearing waited for the summary
+    }
+  }
+}
+
+bool error_manager_nextReport(control_error_report_ts *report)
+{
+  while(true)
+  {
+    uint8_t event = CONTROL_ERROR_EVENT_RAISED;
+    error_manager_entry_ts *entry = findPending(ERROR_MANAGER_PENDING_RAISED);
+    if(nullptr == entry)
+    {
+      entry = findPending(ERROR_MANAGER_PENDING_CLEARED | ERROR_MANAGER_PENDING_SUMMARY);
+      if(nullptr == entry)
+      {
+        return ERROR_MANAGER_NO_REPORT;
+      }
+      event = (0u != (entry->pending & ERROR_MANAGER_PENDING_CLEARED)) ? CONTROL_ERROR_EVENT_CLEARED : CONTROL_ERROR_EVENT_SUMMARY;
+    }
+    entry->pending &= (uint8_t)~(1u << event);
+
+    // Occurrences were already reported by the raised report taken out after the summary started
+    if(CONTROL_ERROR_EVENT_SUMMARY == event && 0u == entry->count)
+    {
+      continue;
+    }
+
+    report->error = entry->error;
+    report->first_seen_s = entry->first_seen_s;
+    report->last_seen_s = entry->last_seen_s;
+    report->count = entry->count;
+    report->total = entry->total;
+    report->event = event;
+    entry->count = 0u;
+
+    if(CONTROL_ERROR_EVENT_CLEARED == event)
+    {
+      entry->state = ERROR_MANAGER_STATE_FREE;
+      entry->pending = 0u;
+      error_manager_num_of_tracked--;
+    }
+    return ERROR_MANAGER_REPORT_AVAILABLE;
+  }
+}
+
+error_manager_stats_ts error_manager_getStats()
+{
+  return error_manager_stats;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint32_t getTimestamp()
+{
+  return millis() / ERROR_MANAGER_MS_PER_SECOND;
+}
+
+static error_manager_entry_ts *findEntry(const control_error_ts *error)
+{
+  for(uint8_t index = 0u; index < ERROR_MANAGER_MAX_ENTRIES; index++)
+  {
+    error_manager_entry_ts *entry = &error_manager_entries[index];
+    if(ERROR_MANAGER_STATE_FREE != entry->state &&
+       error->error_code == entry->error.error_code &&
+       error->component.io_component == entry->error.component.io_component &&
+       error->component.device_id == entry->error.component.device_id)
+    {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+static error_manager_entry_ts *findPending(uint8_t pending_mask)
+{
+  for(uint8_t index = 0u; index < ERROR_MANAGER_MAX_ENTRIES; index++)
+  {
+    if(0u != (error_manager_entries[index].pending & pending_mask))
+    {
+      return &error_manager_entries[index];
+    }
+  }
+  return nullptr;
+}
+
+static void escalate(error_manager_entry_ts *entry, uint8_t pending)
+{
+  if(0u == error_manager_escalations_left)
+  {
+    // Change is reported with the next summary, see error_manager_update()
+    countSaturated(&error_manager_stats.deferred);
+    return;
+  }
+
+  error_manager_escalations_left--;
+  countSaturated(&error_manager_stats.escalations);
+  entry->pending |= pending;
+}
+
+static void countSaturated(uint16_t *counter)
+{
+  if(ERROR_MANAGER_COUNTER_MAX > *counter)
+  {
+    (*counter)++;
+  }
+}
+/* *************************************** */
@@ -0,0 +1,119 @@
+#ifndef ERROR_MANAGER_H
+#define ERROR_MANAGER_H
+
+#include <Arduino.h>
+#include "error_manager_config.h"
+#include "../control_types.h"
+
+/**
+ * @file error_manager.h
+ * @brief Aggregation and rate limiting of the errors of all components.
+ *
+ * Every occurrence of an error is only counted in the entry of its component and error code,
+ * reporting an error never formats or sends anything. Reports are taken out with
+ * error_manager_nextReport() at the pace of the outputs:
+ *  - RAISED when an error occurs for the first time, or again after it was cleared.
+ *  - CLEARED when the component works again, or the error did not occur for a summary interval.
+ *  - SUMMARY once per ERROR_MANAGER_SUMMARY_SECONDS for every error that is still present.
+ * At most ERROR_MANAGER_ESCALATIONS_PER_INTERVAL errors are raised or cleared right away per interval,
+ * further changes wait for the next summary. So the reports per interval are bounded, no matter how
+ * often the hardware fails.
+ *
+ * State is allocated statically, ERROR_MANAGER_ENTRY_BYTES per entry.
+ */
+
+/* Timestamps are seconds since start up */
+#define ERROR_MANAGER_MS_PER_SECOND               (uint32_t)(1000u)
+/* Occurrence counters stop at this value */
+#define ERROR_MANAGER_COUNTER_MAX                 (uint16_t)(0xFFFFu)
+
+/* States of an entry */
+#define ERROR_MANAGER_STATE_FREE                  (uint8_t)(0u) /** Entry is not used */
+#define ERROR_MANAGER_STATE_ACTIVE                (uint8_t)(1u) /** Error is present */
+#define ERROR_MANAGER_STATE_CLEARED               (uint8_t)(2u) /** Error is gone, entry is freed once that is reported */
+
+/* Reports waiting to be taken out of an entry, one bit per event */
+#define ERROR_MANAGER_PENDING_RAISED              (uint8_t)(1u << CONTROL_ERROR_EVENT_RAISED)
+#define ERROR_MANAGER_PENDING_CLEARED             (uint8_t)(1u << CONTROL_ERROR_EVENT_CLEARED)
+#define ERROR_MANAGER_PENDING_SUMMARY             (uint8_t)(1u << CONTROL_ERROR_EVENT_SUMMARY)
+
+/* Results of error_manager_nextReport() */
+#define ERROR_MANAGER_REPORT_AVAILABLE            (bool)(true)
+#define ERROR_MANAGER_NO_REPORT                   (bool)(false)
+
+/**
+ * Tracked error of one component.
+ */
+typedef struct
+{
+  control_error_ts error;    // Error code and component, the key of the entry
+  uint32_t first_seen_s;     // Second the error was raised at
+  uint32_t last_seen_s;      // Second of the latest occurrence
+  uint16_t count;            // Occurrences since the latest report
+  uint16_t total;            // Occurrences since the error was raised
+  uint8_t state;             // ERROR_MANAGER_STATE_...
+  uint8_t pending;           // ERROR_MANAGER_PENDING_... bits
+} error_manager_entry_ts;
+
+/**
+ * Counters of the error manager since start up, they stop at ERROR_MANAGER_COUNTER_MAX.
+ */
+typedef struct
+{
+  uint16_t occurrences;      // Errors passed to error_manager_report()
+  uint16_t escalations;      // Errors raised or cleared right away
+  uint16_t deferred;         // Changes that waited for the summary, the escalation budget was used up
+  uint16_t untracked;        // Occurrences of errors without a free entry
+} error_manager_stats_ts;
+
+/* SRAM of one entry */
+#define ERROR_MANAGER_ENTRY_BYTES                 (uint16_t)(sizeof(error_manager_entry_ts))
+
+static_assert(0u < ERROR_MANAGER_MAX_ENTRIES, "The error manager needs at least one entry");
+static_assert(0u < ERROR_MANAGER_SUMMARY_SECONDS, "ERROR_MANAGER_SUMMARY_SECONDS must not be 0");
+
+/**
+ * @brief Counts an occurrence of an error.
+ *
+ * A new error takes a free entry and is raised, if the escalation budget of the interval allows it.
+ * An error that was just cleared and occurs again before that was reported stays raised.
+ *
+ * @param error Pointer to the error code and the affected component.
+ */
+void error_manager_report(const control_error_ts *error);
+
+/**
+ * @brief Clears all errors of a component after it worked.
+ *
+ * Returns right away if no error is tracked, so it can be called after every successful operation.
+ *
+ * @param component Pointer to the component which worked.
+ */
+void error_manager_clear(const control_device_ts *component);
+
+/**
+ * @brief Starts a new summary interval when the current one is over.
+ *
+ * Errors that did not occur during the interval are cleared, the others get a summary report.
+ * The escalation budget is refilled. Must be called regularly, at least once per second.
+ */
+void error_manager_update();
+
+/**
+ * @brief Takes out the next waiting report.
+ *
+ * Raised reports come first. An entry is freed after its cleared report was taken out.
+ *
+ * @param report Pointer to the caller's report, only written if a report is available.
+ * @return bool ERROR_MANAGER_REPORT_AVAILABLE or ERROR_MANAGER_NO_REPORT.
+ */
+bool error_manager_nextReport(control_error_report_ts *report);
+
+/**
+ * @brief Returns the counters of the error manager.
+ *
+ * @return error_manager_stats_ts Copy of the counters.
+ */
+error_manager_stats_ts error_manager_getStats();
+
+#endif
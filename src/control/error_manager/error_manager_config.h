@@ -0,0 +1,21 @@
+#ifndef ERROR_MANAGER_CONFIG_H
+#define ERROR_MANAGER_CONFIG_H
+
+#include <Arduino.h>
+
+/**
+ * Number of different errors (component and error code) tracked at once. Every entry costs
+ * ERROR_MANAGER_ENTRY_BYTES of SRAM. Further errors are only counted as untracked.
+ */
+#define ERROR_MANAGER_MAX_ENTRIES                 (uint8_t)(6u)
+
+/**
+ * Interval in seconds of the summary of the errors that are still present. An error that did not
+ * occur for a whole interval is cleared.
+ */
+#define ERROR_MANAGER_SUMMARY_SECONDS             (uint16_t)(60u)
+
+/* Raised and cleared errors reported right away per summary interval, further changes wait for the summary */
+#define ERROR_MANAGER_ESCALATIONS_PER_INTERVAL    (uint8_t)(8u)
+
+#endif
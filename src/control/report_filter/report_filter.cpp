@@ -0,0 +1,142 @@
+#include "report_filter.h"
+#include "../../output/output_format/output_format.h"
+
+#ifdef REPORT_FILTER_USED
+/* STATIC GLOBAL VARIABLES */
+static report_filter_channel_ts report_filter_channels[SENSORS_CATALOG_LEN];
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Returns the current time in seconds, as used for the report timestamps.
+ *
+ * @return uint16_t Seconds since start up, wrapping around.
+ */
+static uint16_t getTimestamp();
+
+/**
+ * @brief Checks if a reading differs enough from the last reported one.
+ *
+ * @param channel Pointer to the channel with a reported reading.
+ * @param index Catalog index of the channel.
+ * @param sensor_id The sensor ID of the channel.
+ * @param reading Pointer to the new reading.
+ * @return bool REPORT_FILTER_REPORT_DUE or REPORT_FILTER_UNCHANGED.
+ */
+static bool hasChanged(const report_filter_channel_ts *channel, uint8_t index, uint8_t sensor_id, const sensor_reading_ts *reading);
+
+/**
+ * @brief Compares two values as they are written on the outputs.
+ *
+ * Uses the formatting of the outputs, so the rounding at the displayed number of decimals
+ * is exactly the one the user sees.
+ *
+ * @param first The first value.
+ * @param second The second value.
+ * @param sensor_id The sensor ID, selects the number of decimals.
+ * @return bool REPORT_FILTER_REPORT_DUE if the texts differ, otherwise REPORT_FILTER_UNCHANGED.
+ */
+static bool differsWhenDisplayed(sensors_value_t first, sensors_value_t second, uint8_t sensor_id);
+
+/**
+ * @brief Converts a reading into the value kept for the channel.
+ *
+ * @param reading Pointer to the reading.
+ * @return sensors_value_t The value, SENSORS_VALUE_ONE or 0 for indications.
+ */
+static sensors_value_t toReportedValue(const sensor_reading_ts *reading);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+bool report_filter_isReportDue(const control_data_ts *data, control_error_code_te error_code)
+{
+  if(INPUT_SENSORS != data->input.io_component)
+  {
+    return REPORT_FILTER_REPORT_DUE;
+  }
+
+  uint8_t sensor_id = data->input.device_id;
+  uint8_t index = sensors_interface_sensorIdToIndex(sensor_id);
+  if(SENSORS_CATALOG_NO_INDEX == index)
+  {
+    return REPORT_FILTER_REPORT_DUE; // Let the outputs report the unknown sensor
+  }
+
+  report_filter_channel_ts *channel = &report_filter_channels[index];
+  if(ERROR_CODE_NO_ERROR != error_code)
+  {
+    channel->has_report = false; // The first valid reading after a failure is always reported
+    return REPORT_FILTER_REPORT_DUE;
+  }
+
+  const sensor_reading_ts *reading = &data->input_return.sensor_reading;
+  uint16_t now = getTimestamp();
+
+  bool report_due = REPORT_FILTER_REPORT_DUE;
+  // Unsigned difference stays valid across the wrap around of the timestamps
+  if(channel->has_report && REPORT_FILTER_HEARTBEAT_SECONDS > (uint16_t)(now - channel->reported_at))
+  {
+    report_due = hasChanged(channel, index, sensor_id, reading);
+  }
+
+  if(REPORT_FILTER_REPORT_DUE == report_due)
+  {
+    // Deadband is measured from the last reported value, so slow drifts are reported too
+    channel->value = toReportedValue(reading);
+    channel->reported_at = now;
+    channel->has_report = true;
+  }
+  return report_due;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint16_t getTimestamp()
+{
+  return (uint16_t)(millis() / REPORT_FILTER_MS_PER_SECOND);
+}
+
+static bool hasChanged(const report_filter_channel_ts *channel, uint8_t index, uint8_t sensor_id, const sensor_reading_ts *reading)
+{
+  sensors_value_t value = toReportedValue(reading);
+  if(SENSORS_MEASUREMENT_TYPE_INDICATION == reading->measurement_type_switch)
+  {
+    return (channel->value != value) ? REPORT_FILTER_REPORT_DUE : REPORT_FILTER_UNCHANGED;
+  }
+
+  sensors_value_t deadband;
+  memcpy_P(&deadband, &report_filter_deadbands[index], sizeof(deadband));
+  if(sensors_toValue(REPORT_FILTER_DISPLAYED_PRECISION) == deadband)
+  {
+    return differsWhenDisplayed(channel->value, value, sensor_id);
+  }
+
+  sensors_value_t difference = (value > channel->value) ? (value - channel->value) : (channel->value - value);
+  return (deadband <= difference) ? REPORT_FILTER_REPORT_DUE : REPORT_FILTER_UNCHANGED;
+}
+
+static bool differsWhenDisplayed(sensors_value_t first, sensors_value_t second, uint8_t sensor_id)
+{
+  sensors_metadata_catalog_ts sensor_metadata;
+  if(SENSORS_INTERFACE_STATUS_SUCCESS != sensors_interface_getSensorMetadata(sensor_id, &sensor_metadata))
+  {
+    return REPORT_FILTER_REPORT_DUE;
+  }
+
+  char first_string[OUTPUT_FORMAT_FLOAT_BUFFER_SIZE];
+  char second_string[OUTPUT_FORMAT_FLOAT_BUFFER_SIZE];
+  (void)output_format_sensorValue(first, sensor_metadata.num_of_decimals, first_string, sizeof(first_string));
+  (void)output_format_sensorValue(second, sensor_metadata.num_of_decimals, second_string, sizeof(second_string));
+  return (0 != strcmp(first_string, second_string)) ? REPORT_FILTER_REPORT_DUE : REPORT_FILTER_UNCHANGED;
+}
+
+static sensors_value_t toReportedValue(const sensor_reading_ts *reading)
+{
+  if(SENSORS_MEASUREMENT_TYPE_INDICATION == reading->measurement_type_switch)
+  {
+    return reading->indication ? SENSORS_VALUE_ONE : (sensors_value_t)0;
+  }
+  return reading->value;
+}
+/* *************************************** */
+#endif
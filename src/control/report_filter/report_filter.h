@@ -0,0 +1,75 @@
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "report_filter_config.h"
+#include "../control_types.h"
+
+/**
+ * @file report_filter.h
+ * @brief Report by exception for the sensor readings.
+ *
+ * Sits between control_fetchDataFromInput() and control_publishData(). It remembers the last
+ * reported reading of every channel and tells whether a new reading is worth routing: a value must
+ * leave the deadband of the channel, an indication must change. Unchanged readings are reported
+ * again after REPORT_FILTER_HEARTBEAT_SECONDS. Failed readings are always reported and make the
+ * next valid reading of the channel report as well.
+ *
+ * State is allocated statically, REPORT_FILTER_CHANNEL_BYTES per configured channel.
+ */
+
+/* Deadband value which reports every reading that differs at the displayed number of decimals */
+#define REPORT_FILTER_DISPLAYED_PRECISION             (float)(0.0f)
+/* Report timestamps are seconds in 16 bits, the heartbeat must stay far below the wrap around */
+#define REPORT_FILTER_HEARTBEAT_MAX_SECONDS           (uint16_t)(0x7FFFu)
+/* Milliseconds per timestamp tick */
+#define REPORT_FILTER_MS_PER_SECOND                   (uint32_t)(1000u)
+
+/* Results of the filter */
+#define REPORT_FILTER_REPORT_DUE                      (bool)(true)
+#define REPORT_FILTER_UNCHANGED                       (bool)(false)
+
+/* Generates the deadband of every configured channel, in catalog order */
+#define REPORT_FILTER_DEADBAND_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  sensors_toValue(REPORT_FILTER_DEADBAND_##name),
+
+/* Deadbands in catalog order, the trailing entry only keeps the table from being empty */
+constexpr sensors_value_t report_filter_deadbands[] PROGMEM =
+{
+  SENSORS_REGISTRY(REPORT_FILTER_DEADBAND_ENTRY)
+  sensors_toValue(REPORT_FILTER_DISPLAYED_PRECISION)
+};
+
+/**
+ * Last reported reading of one channel.
+ * An indication is kept as SENSORS_VALUE_ONE (set) or 0 in `value`.
+ */
+typedef struct
+{
+  sensors_value_t value;     // Last reported value
+  uint16_t reported_at;      // Second of the last report, wraps around
+  bool has_report;           // false until a valid reading was reported, and after a failed one
+} report_filter_channel_ts;
+
+/* SRAM of one configured channel */
+#define REPORT_FILTER_CHANNEL_BYTES                   (uint16_t)(sizeof(report_filter_channel_ts))
+
+#ifdef REPORT_FILTER_USED
+static_assert(REPORT_FILTER_HEARTBEAT_MAX_SECONDS >= REPORT_FILTER_HEARTBEAT_SECONDS && 0u < REPORT_FILTER_HEARTBEAT_SECONDS,
+              "REPORT_FILTER_HEARTBEAT_SECONDS must be between 1 and REPORT_FILTER_HEARTBEAT_MAX_SECONDS");
+#endif
+
+/**
+ * @brief Decides if a fetched input must be routed to the filtered outputs.
+ *
+ * Only sensor readings are filtered, every other input is always due. A due sensor reading
+ * becomes the new reference of its channel, so the caller has to route it.
+ *
+ * @param data Pointer to the data written by control_fetchDataFromInput().
+ * @param error_code The error code returned by control_fetchDataFromInput().
+ * @return bool REPORT_FILTER_REPORT_DUE or REPORT_FILTER_UNCHANGED.
+ */
+bool report_filter_isReportDue(const control_data_ts *data, control_error_code_te error_code);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef REPORT_FILTER_CONFIG_H
+#define REPORT_FILTER_CONFIG_H
+
+#include <Arduino.h>
+
+/**
+ * Longest time in seconds a channel stays silent while its value does not change.
+ * After it the reading is reported anyway, so a receiver can tell a stable value from a dead station.
+ * Must not exceed REPORT_FILTER_HEARTBEAT_MAX_SECONDS.
+ */
+#define REPORT_FILTER_HEARTBEAT_SECONDS               (uint16_t)(300u)
+
+/**
+ * Deadband of every sensor channel in the unit of the measurement. A reading is only reported if it
+ * differs from the last reported one by at least the deadband. REPORT_FILTER_DISPLAYED_PRECISION reports
+ * every reading that looks different on the outputs, at the number of decimals from the sensors registry.
+ * Indications are always reported when they change, their deadband is not used.
+ */
+#define REPORT_FILTER_DEADBAND_DHT11_TEMPERATURE      REPORT_FILTER_DISPLAYED_PRECISION
+#define REPORT_FILTER_DEADBAND_DHT11_HUMIDITY         REPORT_FILTER_DISPLAYED_PRECISION
+#define REPORT_FILTER_DEADBAND_BMP280_PRESSURE        (float)(20.0f)  /** Pa, the BMP280 noise is a few Pa */
+#define REPORT_FILTER_DEADBAND_BMP280_TEMPERATURE     (float)(0.2f)
+#define REPORT_FILTER_DEADBAND_BMP280_ALTITUDE        (float)(2.0f)
+#define REPORT_FILTER_DEADBAND_BH1750_LUMINANCE       (float)(10.0f)
+#define REPORT_FILTER_DEADBAND_MQ135_PPM              (float)(5.0f)
+#define REPORT_FILTER_DEADBAND_MQ7_COPPM              (float)(5.0f)
+#define REPORT_FILTER_DEADBAND_GYML8511_UV            REPORT_FILTER_DISPLAYED_PRECISION
+#define REPORT_FILTER_DEADBAND_ARDUINORAIN_RAINING    REPORT_FILTER_DISPLAYED_PRECISION
+
+#endif
@@ -0,0 +1,117 @@
+#include "supervisor.h"
+
+/* STATIC GLOBAL VARIABLES */
+static supervisor_stats_ts supervisor_stats = {0u, 0u};
+static uint16_t supervisor_jitter_state = 0xACE1u;  // Any value but 0
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Returns the current time in seconds, as used for the retry times.
+ *
+ * @return uint16_t Seconds since start up, wraps around.
+ */
+static uint16_t getTimestamp();
+
+/**
+ * @brief Returns the backoff delay after a number of failed attempts.
+ *
+ * @param attempts Failed attempts since the component last worked, at least 1.
+ * @return uint16_t Delay in seconds, without the jitter.
+ */
+static uint16_t getBackoffDelay(uint16_t attempts);
+
+/**
+ * @brief Returns a random jitter for a delay.
+ *
+ * A 16 bit xorshift generator, stirred with micros() on every call so stations started
+ * at the same moment do not retry in step.
+ *
+ * @param delay_s The delay in seconds.
+ * @return uint16_t Jitter between 0 and delay_s / SUPERVISOR_JITTER_DIVISOR seconds.
+ */
+static uint16_t getJitter(uint16_t delay_s);
+
+/**
+ * @brief Increments a counter which stops at SUPERVISOR_COUNTER_MAX.
+ *
+ * @param counter Pointer to the counter.
+ */
+static void countSaturated(uint16_t *counter);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void supervisor_schedule(supervisor_entry_ts *entry)
+{
+  entry->retry_at_s = getTimestamp();
+  entry->attempts = 0u;
+}
+
+bool supervisor_isRetryDue(const supervisor_entry_ts *entry)
+{
+  // Difference of wrapping timestamps, a retry time in the past is negative
+  return (0 <= (int16_t)(getTimestamp() - entry->retry_at_s)) ? SUPERVISOR_RETRY_DUE : SUPERVISOR_RETRY_NOT_DUE;
+}
+
+void supervisor_recordAttempt(supervisor_entry_ts *entry, bool success)
+{
+  countSaturated(&supervisor_stats.attempts);
+
+  if(success)
+  {
+    countSaturated(&supervisor_stats.recoveries);
+    supervisor_schedule(entry);
+    return;
+  }
+
+  countSaturated(&entry->attempts);
+  uint16_t delay_s = getBackoffDelay(entry->attempts);
+  entry->retry_at_s = (uint16_t)(getTimestamp() + delay_s + getJitter(delay_s));
+}
+
+supervisor_stats_ts supervisor_getStats()
+{
+  return supervisor_stats;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint16_t getTimestamp()
+{
+  return (uint16_t)(millis() / SUPERVISOR_MS_PER_SECOND);
+}
+
+static uint16_t getBackoffDelay(uint16_t attempts)
+{
+  uint16_t delay_s = SUPERVISOR_BACKOFF_MIN_SECONDS;
+
+  // Stops at the longest delay, so the loop is short no matter how many attempts failed
+  for(uint16_t attempt = 1u; attempt < attempts && SUPERVISOR_BACKOFF_MAX_SECONDS > delay_s; attempt++)
+  {
+    delay_s = (SUPERVISOR_BACKOFF_MAX_SECONDS / 2u < delay_s) ? SUPERVISOR_BACKOFF_MAX_SECONDS : (uint16_t)(2u * delay_s);
+  }
+  return delay_s;
+}
+
+static uint16_t getJitter(uint16_t delay_s)
+{
+  supervisor_jitter_state ^= (uint16_t)micros();
+  if(0u == supervisor_jitter_state)
+  {
+    supervisor_jitter_state = 0xACE1u; // Xorshift never leaves 0
+  }
+  supervisor_jitter_state ^= (uint16_t)(supervisor_jitter_state << 7u);
+  supervisor_jitter_state ^= (uint16_t)(supervisor_jitter_state >> 9u);
+  supervisor_jitter_state ^= (uint16_t)(supervisor_jitter_state << 8u);
+
+  return (uint16_t)(supervisor_jitter_state % (uint16_t)(delay_s / SUPERVISOR_JITTER_DIVISOR + 1u));
+}
+
+static void countSaturated(uint16_t *counter)
+{
+  if(SUPERVISOR_COUNTER_MAX > *counter)
+  {
+    (*counter)++;
+  }
+}
+/* *************************************** */
@@ -0,0 +1,88 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <Arduino.h>
+#include "supervisor_config.h"
+
+/**
+ * @file supervisor.h
+ * @brief Retry backoff of the components which failed to initialize.
+ *
+ * Every supervised component has an entry owned by the caller (see control_superviseComponents()).
+ * After a failed attempt the next retry waits SUPERVISOR_BACKOFF_MIN_SECONDS, doubled with every
+ * further failed attempt up to SUPERVISOR_BACKOFF_MAX_SECONDS, plus a random jitter. A component
+ * that stays broken therefore costs ever less time, while a late powered or hot plugged one
+ * comes online within the current delay.
+ *
+ * Retry times are kept in 16 bit seconds which wrap around, delays are far below the wrap around.
+ */
+
+/* Retry times are seconds since start up */
+#define SUPERVISOR_MS_PER_SECOND                  (uint32_t)(1000u)
+/* Counters stop at this value */
+#define SUPERVISOR_COUNTER_MAX                    (uint16_t)(0xFFFFu)
+
+/* Results of supervisor_isRetryDue() */
+#define SUPERVISOR_RETRY_DUE                      (bool)(true)
+#define SUPERVISOR_RETRY_NOT_DUE                  (bool)(false)
+
+/**
+ * Retry state of one supervised component.
+ */
+typedef struct
+{
+  uint16_t retry_at_s;       // Second of the next retry, wraps around
+  uint16_t attempts;         // Failed attempts since the component last worked
+} supervisor_entry_ts;
+
+/**
+ * Counters of the supervisor since start up, they stop at SUPERVISOR_COUNTER_MAX.
+ */
+typedef struct
+{
+  uint16_t attempts;         // Initializations of failed components
+  uint16_t recoveries;       // Attempts which brought a component online
+} supervisor_stats_ts;
+
+static_assert(0u < SUPERVISOR_BACKOFF_MIN_SECONDS && SUPERVISOR_BACKOFF_MIN_SECONDS <= SUPERVISOR_BACKOFF_MAX_SECONDS,
+              "Retry backoff must be between 1 and SUPERVISOR_BACKOFF_MAX_SECONDS");
+static_assert(0x7FFFu > SUPERVISOR_BACKOFF_MAX_SECONDS + SUPERVISOR_BACKOFF_MAX_SECONDS / SUPERVISOR_JITTER_DIVISOR,
+              "Longest delay must stay below half of the 16 bit wrap around of the retry times");
+static_assert(0u < SUPERVISOR_JITTER_DIVISOR, "SUPERVISOR_JITTER_DIVISOR must not be 0");
+
+/**
+ * @brief Makes the retry of a component due right away and restarts its backoff.
+ *
+ * Used when a component stops working at run time, e.g. after a bus recovery.
+ *
+ * @param entry Pointer to the entry of the component.
+ */
+void supervisor_schedule(supervisor_entry_ts *entry);
+
+/**
+ * @brief Checks if the backoff of a component is over.
+ *
+ * @param entry Pointer to the entry of the component.
+ * @return bool SUPERVISOR_RETRY_DUE or SUPERVISOR_RETRY_NOT_DUE.
+ */
+bool supervisor_isRetryDue(const supervisor_entry_ts *entry);
+
+/**
+ * @brief Records the result of an initialization of a failed component and schedules the next retry.
+ *
+ * A failed attempt doubles the delay up to SUPERVISOR_BACKOFF_MAX_SECONDS and adds the jitter,
+ * a successful one restarts the backoff.
+ *
+ * @param entry Pointer to the entry of the component.
+ * @param success true if the component works after the attempt.
+ */
+void supervisor_recordAttempt(supervisor_entry_ts *entry, bool success);
+
+/**
+ * @brief Returns the counters of the supervisor.
+ *
+ * @return supervisor_stats_ts Copy of the counters.
+ */
+supervisor_stats_ts supervisor_getStats();
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SUPERVISOR_CONFIG_H
+#define SUPERVISOR_CONFIG_H
+
+#include <Arduino.h>
+
+/* Delay in seconds of the first retry of a failed component, doubled after every failed attempt */
+#define SUPERVISOR_BACKOFF_MIN_SECONDS            (uint16_t)(2u)
+
+/* Longest delay in seconds between two retries of a component */
+#define SUPERVISOR_BACKOFF_MAX_SECONDS            (uint16_t)(300u)
+
+/**
+ * Up to 1/SUPERVISOR_JITTER_DIVISOR of the delay is added at random, so components which failed
+ * together (e.g. after a bus recovery) spread out instead of being retried in the same runs.
+ */
+#define SUPERVISOR_JITTER_DIVISOR                 (uint8_t)(4u)
+
+#endif
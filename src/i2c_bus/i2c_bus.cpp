@@ -0,0 +1,274 @@
+#include "i2c_bus.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Ring buffer of queued jobs */
+static i2c_bus_job_ts i2c_bus_queue[I2C_BUS_QUEUE_SIZE];
+static uint8_t i2c_bus_queue_head = 0u;   // Index of the oldest job
+static uint8_t i2c_bus_queue_count = 0u;  // Number of queued jobs
+
+static i2c_bus_health_ts i2c_bus_health = {0u, 0u, 0u, 0u};
+static bool i2c_bus_stuck = false;  // Set when the recovery could not free the bus
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Runs the write and read phase of a job on the bus.
+ *
+ * @param job Pointer to the job, `result` and the read bytes are written back into it.
+ */
+static void executeJob(i2c_bus_job_ts *job);
+
+/**
+ * @brief Starts Wire as master with the transaction timeout.
+ */
+static void beginBus();
+
+/**
+ * @brief Frees the bus from a device that holds SDA low.
+ *
+ * Clocks SCL until SDA is released (at most I2C_BUS_RECOVERY_CLOCKS times), generates a STOP
+ * condition and starts Wire again.
+ *
+ * @return bool true if both lines are released afterwards, false otherwise.
+ */
+static bool recoverBus();
+
+/**
+ * @brief Runs the recovery sequence, counts its result and latches a bus that stays blocked.
+ *
+ * @return i2c_bus_health_status_te I2C_BUS_RECOVERED or I2C_BUS_STUCK.
+ */
+static i2c_bus_health_status_te runRecovery();
+
+/**
+ * @brief Pulls a bus line low, emulating an open drain output.
+ *
+ * @param pin The pin of the line.
+ */
+static void driveLineLow(uint8_t pin);
+
+/**
+ * @brief Releases a bus line, the pull-up takes it high unless a device holds it low.
+ *
+ * @param pin The pin of the line.
+ */
+static void releaseLine(uint8_t pin);
+
+/**
+ * @brief Increments a health counter without overflowing.
+ *
+ * @param counter Pointer to the counter.
+ */
+static void incrementCounter(uint16_t *counter);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void i2c_bus_init()
+{
+  beginBus();
+}
+
+bool i2c_bus_submit(const i2c_bus_job_ts *job)
+{
+  if(I2C_BUS_QUEUE_SIZE <= i2c_bus_queue_count)
+  {
+    return I2C_BUS_QUEUE_FULL;
+  }
+
+  uint8_t tail = (i2c_bus_queue_head + i2c_bus_queue_count) % I2C_BUS_QUEUE_SIZE;
+  i2c_bus_queue[tail] = *job;
+  i2c_bus_queue_count++;
+  return I2C_BUS_JOB_SUBMITTED;
+}
+
+uint8_t i2c_bus_process(uint8_t max_jobs)
+{
+  uint8_t executed_jobs = 0u;
+
+  while(executed_jobs < max_jobs && 0u != i2c_bus_queue_count)
+  {
+    // Take the job out of the queue first, so the callback can submit follow-up jobs
+    i2c_bus_job_ts job = i2c_bus_queue[i2c_bus_queue_head];
+    i2c_bus_queue_head = (i2c_bus_queue_head + 1u) % I2C_BUS_QUEUE_SIZE;
+    i2c_bus_queue_count--;
+
+    executeJob(&job);
+    executed_jobs++;
+
+    if(I2C_BUS_NO_CALLBACK != job.callback)
+    {
+      job.callback(&job);
+    }
+  }
+
+  return executed_jobs;
+}
+
+uint8_t i2c_bus_transfer(i2c_bus_job_ts *job)
+{
+  executeJob(job);
+  return job->result;
+}
+
+uint8_t i2c_bus_getPendingJobs()
+{
+  return i2c_bus_queue_count;
+}
+
+i2c_bus_health_status_te i2c_bus_checkHealth()
+{
+  if(i2c_bus_stuck)
+  {
+    return I2C_BUS_STUCK; // Recovery is retried by the caller, not on every check
+  }
+
+  bool timeout_happened = Wire.getWireTimeoutFlag();
+  // Both lines are high between transactions unless a device holds them
+  bool line_stuck = (LOW == digitalRead(SDA) || LOW == digitalRead(SCL));
+
+  if(!timeout_happened && !line_stuck)
+  {
+    return I2C_BUS_HEALTHY;
+  }
+
+  if(timeout_happened)
+  {
+    incrementCounter(&i2c_bus_health.timeouts);
+    Wire.clearWireTimeoutFlag();
+  }
+  if(line_stuck)
+  {
+    incrementCounter(&i2c_bus_health.stuck_lines);
+  }
+
+  return runRecovery();
+}
+
+i2c_bus_health_status_te i2c_bus_retryRecovery()
+{
+  if(!i2c_bus_stuck)
+  {
+    return I2C_BUS_RECOVERED;
+  }
+  return runRecovery();
+}
+
+bool i2c_bus_isStuck()
+{
+  return i2c_bus_stuck;
+}
+
+i2c_bus_health_ts i2c_bus_getHealth()
+{
+  return i2c_bus_health;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void executeJob(i2c_bus_job_ts *job)
+{
+  if(i2c_bus_stuck)
+  {
+    // Every transaction would only run into the Wire timeout
+    job->result = I2C_BUS_RESULT_BUS_STUCK;
+    return;
+  }
+
+  uint8_t write_len = min(job->write_len, I2C_BUS_JOB_BUFFER_SIZE);
+  uint8_t read_len = min(job->read_len, I2C_BUS_JOB_BUFFER_SIZE);
+  job->result = I2C_BUS_RESULT_SUCCESS;
+
+  // Write phase, also used as address probe when there is nothing to read
+  if(0u != write_len || 0u == read_len)
+  {
+    Wire.beginTransmission(job->address);
+    for (uint8_t index = 0u; index < write_len; index++)
+    {
+      (void)Wire.write(job->buffer[index]);
+    }
+    // Keep the bus with a repeated start if a read follows
+    job->result = Wire.endTransmission(0u == read_len);
+  }
+
+  // Read phase
+  if(I2C_BUS_RESULT_SUCCESS == job->result && 0u != read_len)
+  {
+    uint8_t received = Wire.requestFrom(job->address, read_len);
+    for (uint8_t index = 0u; index < received && index < read_len; index++)
+    {
+      job->buffer[index] = (uint8_t)Wire.read();
+    }
+    if(received < read_len)
+    {
+      job->result = I2C_BUS_RESULT_READ_INCOMPLETE;
+    }
+  }
+}
+
+static void beginBus()
+{
+  Wire.begin();
+  // Abort transactions that take too long and reset the TWI hardware, also for vendor libraries
+  Wire.setWireTimeout(I2C_BUS_TIMEOUT_US, true);
+}
+
+static bool recoverBus()
+{
+  // Take the pins over from the TWI hardware
+  Wire.end();
+  releaseLine(SDA);
+  releaseLine(SCL);
+  delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+
+  // A device in the middle of a byte releases SDA after it has clocked out the remaining bits
+  for (uint8_t clock = 0u; clock < I2C_BUS_RECOVERY_CLOCKS && LOW == digitalRead(SDA); clock++)
+  {
+    driveLineLow(SCL);
+    delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+    releaseLine(SCL);
+    delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+  }
+
+  // STOP condition, SDA rises while SCL is high
+  driveLineLow(SDA);
+  delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+  releaseLine(SDA);
+  delayMicroseconds(I2C_BUS_RECOVERY_HALF_PERIOD_US);
+
+  bool bus_released = (HIGH == digitalRead(SDA) && HIGH == digitalRead(SCL));
+  beginBus();
+  return bus_released;
+}
+
+static i2c_bus_health_status_te runRecovery()
+{
+  i2c_bus_stuck = !recoverBus();
+  if(i2c_bus_stuck)
+  {
+    incrementCounter(&i2c_bus_health.failed_recoveries);
+    return I2C_BUS_STUCK;
+  }
+  incrementCounter(&i2c_bus_health.recoveries);
+  return I2C_BUS_RECOVERED;
+}
+
+static void driveLineLow(uint8_t pin)
+{
+  // Output register is cleared first, so the pin never drives the line high
+  digitalWrite(pin, LOW);
+  pinMode(pin, OUTPUT);
+}
+
+static void releaseLine(uint8_t pin)
+{
+  pinMode(pin, INPUT_PULLUP);
+}
+
+static void incrementCounter(uint16_t *counter)
+{
+  if(I2C_BUS_COUNTER_MAX > *counter)
+  {
+    (*counter)++;
+  }
+}
+/* *************************************** */
@@ -0,0 +1,182 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * @file i2c_bus.h
+ * @brief Cooperative I2C transaction queue.
+ *
+ * Modules that talk to I2C devices directly submit jobs instead of calling Wire. Each job is one
+ * transaction (optional write followed by an optional read) and carries a completion callback.
+ * Jobs are executed by i2c_bus_process(), which is called from the background task with a job
+ * budget, so long sequences of transactions (e.g. a bus scan) are spread over many loop iterations
+ * instead of blocking one task.
+ *
+ * Vendor libraries (BMP280, BH1750, RTC, LCD) still use Wire directly. Jobs only run from the
+ * cooperative loop, so they never interleave with a vendor transaction.
+ *
+ * Every Wire transaction, including the ones of vendor libraries, is limited by the Wire timeout,
+ * so a device holding SDA low cannot hang the loop. i2c_bus_checkHealth() detects timeouts and stuck
+ * lines and frees the bus with the 9-clock recovery sequence. A bus the sequence cannot free is latched
+ * as stuck: jobs fail right away and only i2c_bus_retryRecovery() touches the lines again, so the
+ * caller decides how often the recovery is retried.
+ */
+
+/* Maximum number of queued jobs */
+#define I2C_BUS_QUEUE_SIZE                 (uint8_t)(4u)
+/* Maximum number of bytes written or read by one job */
+#define I2C_BUS_JOB_BUFFER_SIZE            (uint8_t)(8u)
+/* Number of jobs executed per call of i2c_bus_process() from the background task */
+#define I2C_BUS_JOBS_PER_PROCESS           (uint8_t)(4u)
+
+/* Maximum duration of one Wire transaction before it is aborted */
+#define I2C_BUS_TIMEOUT_US                 (uint32_t)(25000u)
+/* Number of SCL clocks sent to make a device release SDA (one byte and the acknowledge bit) */
+#define I2C_BUS_RECOVERY_CLOCKS            (uint8_t)(9u)
+/* Half period of the recovery clock, 100 kHz */
+#define I2C_BUS_RECOVERY_HALF_PERIOD_US    (uint8_t)(5u)
+/* Saturation value of the health counters */
+#define I2C_BUS_COUNTER_MAX                (uint16_t)(0xFFFFu)
+
+/* Job results, same values as returned by Wire.endTransmission() */
+#define I2C_BUS_RESULT_SUCCESS             (uint8_t)(0u)
+#define I2C_BUS_RESULT_TOOLONG             (uint8_t)(1u)
+#define I2C_BUS_RESULT_NACKADR             (uint8_t)(2u)
+#define I2C_BUS_RESULT_NACKDAT             (uint8_t)(3u)
+#define I2C_BUS_RESULT_UNKNOWN             (uint8_t)(4u)
+/* Transaction was aborted by the Wire timeout */
+#define I2C_BUS_RESULT_TIMEOUT             (uint8_t)(5u)
+/* Device returned fewer bytes than requested */
+#define I2C_BUS_RESULT_READ_INCOMPLETE     (uint8_t)(6u)
+/* Job was not executed because the bus is latched as stuck */
+#define I2C_BUS_RESULT_BUS_STUCK           (uint8_t)(7u)
+
+/* Submit status */
+#define I2C_BUS_JOB_SUBMITTED              (bool)(true)
+#define I2C_BUS_QUEUE_FULL                 (bool)(false)
+
+/* Placeholder for jobs without a completion callback */
+#define I2C_BUS_NO_CALLBACK                (nullptr)
+
+/**
+ * @brief Result of a bus health check.
+ */
+typedef enum
+{
+  I2C_BUS_HEALTHY,    // No timeout happened and both lines are released
+  I2C_BUS_RECOVERED,  // A fault was detected and the bus was freed, devices may need to be initialized again
+  I2C_BUS_STUCK       // The recovery sequence could not free the bus, it stays latched until i2c_bus_retryRecovery() frees it
+} i2c_bus_health_status_te;
+
+/**
+ * @brief Counters of detected and recovered bus faults since start up.
+ */
+typedef struct
+{
+  uint16_t timeouts;           // Transactions aborted by the Wire timeout
+  uint16_t stuck_lines;        // Health checks that found SDA or SCL held low while the bus was idle
+  uint16_t recoveries;         // Faults after which the bus was freed
+  uint16_t failed_recoveries;  // Faults after which the bus stayed blocked
+} i2c_bus_health_ts;
+
+struct i2c_bus_job;
+/* Completion callback, called from i2c_bus_process() after the job was removed from the queue */
+typedef void (*i2c_bus_callback_t)(const struct i2c_bus_job *job);
+
+/**
+ * @brief One I2C transaction.
+ *
+ * `write_len` bytes from `buffer` are written first (a job without write and read bytes is an address probe),
+ * then `read_len` bytes are read into `buffer`. The write is followed by a repeated start if bytes are read.
+ */
+typedef struct i2c_bus_job
+{
+  uint8_t address;                          // 7-bit device address
+  uint8_t write_len;                        // Number of bytes to write from buffer
+  uint8_t read_len;                         // Number of bytes to read into buffer
+  uint8_t buffer[I2C_BUS_JOB_BUFFER_SIZE];  // Bytes to write, replaced by the bytes read
+  uint8_t result;                           // I2C_BUS_RESULT_* after the job was executed
+  uint8_t tag;                              // Free for the submitter, returned unchanged
+  i2c_bus_callback_t callback;              // Called when the job is finished, optional
+} i2c_bus_job_ts;
+
+/**
+ * @brief Initializes the I2C bus as master and enables the transaction timeout.
+ */
+void i2c_bus_init();
+
+/**
+ * @brief Adds a job to the end of the queue.
+ *
+ * The job is copied, the caller can reuse its structure right away.
+ * Can be called from a completion callback to chain transactions.
+ *
+ * @param job Pointer to the job to submit.
+ * @return bool I2C_BUS_JOB_SUBMITTED or I2C_BUS_QUEUE_FULL.
+ */
+bool i2c_bus_submit(const i2c_bus_job_ts *job);
+
+/**
+ * @brief Executes queued jobs and calls their completion callbacks.
+ *
+ * While the bus is latched as stuck, jobs finish with I2C_BUS_RESULT_BUS_STUCK without touching the bus.
+ *
+ * @param max_jobs Maximum number of jobs to execute in this call.
+ * @return uint8_t Number of executed jobs.
+ */
+uint8_t i2c_bus_process(uint8_t max_jobs);
+
+/**
+ * @brief Executes a job immediately, bypassing the queue.
+ *
+ * Only for callers whose own interface is synchronous. The completion callback is not called.
+ *
+ * @param job Pointer to the job, `result` and the read bytes are written back into it.
+ * @return uint8_t The job result (I2C_BUS_RESULT_*).
+ */
+uint8_t i2c_bus_transfer(i2c_bus_job_ts *job);
+
+/**
+ * @brief Returns the number of jobs waiting in the queue.
+ *
+ * @return uint8_t Number of queued jobs.
+ */
+uint8_t i2c_bus_getPendingJobs();
+
+/**
+ * @brief Checks the bus for timeouts and stuck lines and recovers it if needed.
+ *
+ * Must be called while no transaction is in progress, e.g. from the background task.
+ * If a fault is found, SCL is clocked up to I2C_BUS_RECOVERY_CLOCKS times until the device
+ * releases SDA, a STOP condition is generated and Wire is started again.
+ * While the bus is latched as stuck, returns I2C_BUS_STUCK right away.
+ *
+ * @return i2c_bus_health_status_te I2C_BUS_HEALTHY, I2C_BUS_RECOVERED or I2C_BUS_STUCK.
+ */
+i2c_bus_health_status_te i2c_bus_checkHealth();
+
+/**
+ * @brief Runs the recovery sequence again on a bus latched as stuck.
+ *
+ * @return i2c_bus_health_status_te I2C_BUS_RECOVERED if the bus was freed (or was not stuck),
+ *                                  I2C_BUS_STUCK otherwise.
+ */
+i2c_bus_health_status_te i2c_bus_retryRecovery();
+
+/**
+ * @brief Returns whether the bus is latched as stuck.
+ *
+ * @return bool true if the last recovery could not free the bus.
+ */
+bool i2c_bus_isStuck();
+
+/**
+ * @brief Returns the bus fault counters.
+ *
+ * @return i2c_bus_health_ts Copy of the counters.
+ */
+i2c_bus_health_ts i2c_bus_getHealth();
+
+#endif
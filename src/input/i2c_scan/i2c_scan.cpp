@@ -1,5 +1,17 @@
 #include "i2c_scan.h"
 
+/* STATIC GLOBAL VARIABLES */
+/* Bitmap of the devices found by the running scan */
+static uint8_t i2c_scan_found_addresses[I2C_SCAN_ARRAY_SIZE];
+/* Next address to submit a probe for */
+static uint8_t i2c_scan_next_address = I2C_SCAN_I2C_ADDRESS_MIN;
+/* Number of probes of the running scan that finished */
+static uint8_t i2c_scan_finished_probes = 0u;
+static bool i2c_scan_in_progress = I2C_SCAN_NOT_IN_PROGRESS;
+
+static_assert(I2C_SCAN_ADDRESSES_PER_SLICE <= I2C_BUS_QUEUE_SIZE, "One scan slice must fit into the I2C bus queue");
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
 /**
  * @brief Scans the I2C bus for connected devices.
@@ -7,17 +19,17 @@
  * This function checks all 7-bit I2C addresses to detect connected devices 
  * and marks their presence in a bit field array. The result includes an error 
  * code indicating the success or failure of the scan.
+ * The probes run from the I2C bus queue, the function only starts the scan and reports its progress.
  * 
- * @return i2c_scan_return_ts
- *         - `i2c_scan_reading`: Contains a bit field array where each bit represents 
- *           an I2C address. Bits set to `1` indicate detected devices.
- *         - `error_code`: Status of the scan operation. Possible values:
+ * @param reading Pointer to the caller's reading. `addresses` receives a bit field array where each
+ *                bit represents an I2C address, bits set to `1` indicate detected devices.
+ * @return control_error_code_te Status of the scan operation. Possible values:
  *             - `ERROR_CODE_NO_ERROR`: Scan completed successfully.
  *             - `ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED`: Scan did not complete.
  * 
  * @note Ensure the I2C bus is initialized before calling this function.
  */
-static i2c_scan_return_ts i2c_scan_scanForAddresses();
+static control_error_code_te i2c_scan_scanForAddresses(i2c_scan_reading_ts *reading);
 
 /**
  * @brief Checks the status of a specific I2C device.
@@ -25,18 +37,17 @@ static i2c_scan_return_ts i2c_scan_scanForAddresses();
  * Sends a transmission to the specified I2C address and returns the result.
  * 
  * @param address The 7-bit I2C address to check (1–127).
- * 
- * @return i2c_scan_return_ts
- *         - `i2c_scan_reading.single_device_status`: Indicates the transmission result:
+ * @param reading Pointer to the caller's reading. `single_device_status` receives the transmission result:
  *             - `I2C_SCAN_TRANSMISSION_RESULT_SUCCESS`: Device detected.
  *             - Other values indicate specific transmission errors.
- *         - `error_code`: 
+ * 
+ * @return control_error_code_te
  *             - `ERROR_CODE_NO_ERROR`: Operation successful.
  *             - `ERROR_CODE_I2C_SCAN_ERROR_READING_DEVICE_STATUS`: Invalid result or bus issue.
  * 
  * @note Ensure the I2C bus is initialized before calling this function.
  */
-static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address);
+static control_error_code_te i2c_scan_checkDeviceStatus(uint8_t address, i2c_scan_reading_ts *reading);
 
 /**
  * @brief Updates the next available I2C address from the scan data.
@@ -51,77 +62,84 @@ static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address);
  * @return `I2C_SCAN_ADDRESS_FOUND` if a valid address is found, otherwise `I2C_SCAN_ADDRESS_NOT_FOUND`.
  */
 static bool i2c_scan_updateNextAddress(i2c_scan_reading_ts *i2c_scan_data);
+
+/**
+ * @brief Submits the next slice of address probes to the I2C bus queue.
+ *
+ * Stops early if the queue is full, the remaining probes are submitted with the next slice.
+ */
+static void i2c_scan_submitSlice();
+
+/**
+ * @brief Completion callback of an address probe, marks the address if the device answered.
+ *
+ * @param job The finished probe job.
+ */
+static void i2c_scan_onProbeFinished(const i2c_bus_job_ts *job);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
-i2c_scan_return_ts i2c_scan_getReading(uint8_t device_address)
+control_error_code_te i2c_scan_getReading(uint8_t device_address, i2c_scan_reading_ts *reading)
 {
-  i2c_scan_return_ts return_data;
+  control_error_code_te error_code = ERROR_CODE_I2C_SCAN_INVALID_ADDRESS_PARAMETER;
 
   if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == device_address)
   {
     // Find all I2C addresses on the bus
-    return_data = i2c_scan_scanForAddresses();
+    error_code = i2c_scan_scanForAddresses(reading);
   }
   else if(device_address >= I2C_SCAN_I2C_ADDRESS_MIN && device_address <= I2C_SCAN_I2C_ADDRESS_MAX)
   {
     // Find status of the I2C device with specific address
-    return_data = i2c_scan_checkDeviceStatus(device_address);
-  }
-  else
-  {
-    return_data.error_code = ERROR_CODE_I2C_SCAN_INVALID_ADDRESS_PARAMETER;
+    error_code = i2c_scan_checkDeviceStatus(device_address, reading);
   }
 
-  return_data.i2c_scan_reading.current_i2c_addr = I2C_SCAN_STARTING_ADDRESS; // Because we start the loop from current address + 1
-  return_data.i2c_scan_reading.update_i2c_address = i2c_scan_updateNextAddress;
-  return_data.i2c_scan_reading.device_address = device_address;
+  reading->current_i2c_addr = I2C_SCAN_STARTING_ADDRESS; // Because we start the loop from current address + 1
+  reading->update_i2c_address = i2c_scan_updateNextAddress;
+  reading->device_address = device_address;
 
-  return return_data;
+  return error_code;
 }
 /* *************************************** */
 
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
-static i2c_scan_return_ts i2c_scan_scanForAddresses()
+static control_error_code_te i2c_scan_scanForAddresses(i2c_scan_reading_ts *reading)
 {
-  i2c_scan_return_ts return_data;
-  return_data.error_code = ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED;
-  // Set all the bits to 0
-  memset(return_data.i2c_scan_reading.addresses, 0, sizeof(return_data.i2c_scan_reading.addresses));
+  control_error_code_te error_code = ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED;
 
-  uint8_t transmission_result = I2C_SCAN_TRANSMISSION_RESULT_SUCCESS;
-  uint8_t address;
-
-  // Iterate through all the possible I2C addresses for 7-bit addressing
-  for (address = I2C_SCAN_I2C_ADDRESS_MIN; address <= I2C_SCAN_I2C_ADDRESS_MAX; address++) 
+  if(I2C_SCAN_NOT_IN_PROGRESS == i2c_scan_in_progress)
   {
-    // Try to contact the address and capture the result
-    Wire.beginTransmission(address);
-    transmission_result = Wire.endTransmission();
-
-    if(I2C_SCAN_TRANSMISSION_RESULT_SUCCESS == transmission_result)
-    {
-      // Set the bit corresponding to this address in the addresses array
-      return_data.i2c_scan_reading.addresses[address / BITS_IN_BYTE] |= (1 << (address % BITS_IN_BYTE));
-    }
+    // Start a new scan, set all the bits to 0
+    memset(i2c_scan_found_addresses, 0, sizeof(i2c_scan_found_addresses));
+    i2c_scan_next_address = I2C_SCAN_I2C_ADDRESS_MIN;
+    i2c_scan_finished_probes = 0u;
+    i2c_scan_in_progress = I2C_SCAN_IN_PROGRESS;
   }
-  // The loop completed and every I2C address is tried out
-  if(I2C_SCAN_I2C_ADDRESS_MAX < address)
+
+  // Probe the next slice, the probes run in the background until the next call
+  i2c_scan_submitSlice();
+
+  // Every I2C address is tried out
+  if(I2C_7_BIT_ADDRESSING_MAX_DEVICES <= i2c_scan_finished_probes)
   {
-    return_data.error_code = ERROR_CODE_NO_ERROR;
+    i2c_scan_in_progress = I2C_SCAN_NOT_IN_PROGRESS;
+    error_code = ERROR_CODE_NO_ERROR;
   }
-  return return_data;
+  // Publish what is found so far, also while the scan is still running
+  memcpy(reading->addresses, i2c_scan_found_addresses, sizeof(reading->addresses));
+  reading->scan_cursor = i2c_scan_next_address;
+  return error_code;
 }
 
-static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address)
+static control_error_code_te i2c_scan_checkDeviceStatus(uint8_t address, i2c_scan_reading_ts *reading)
 {
-  i2c_scan_return_ts return_data;
-  return_data.error_code = ERROR_CODE_NO_ERROR;
-  uint8_t transmission_result = I2C_SCAN_TRANSMISSION_RESULT_SUCCESS;
+  control_error_code_te error_code = ERROR_CODE_NO_ERROR;
+  reading->scan_cursor = I2C_SCAN_STARTING_ADDRESS; // Not used for a single device
 
-  // Try to contact the address and capture the result
-  Wire.beginTransmission(address);
-  transmission_result = Wire.endTransmission();
+  // Try to contact the address and capture the result, the caller expects the status right away
+  i2c_bus_job_ts probe = {0};
+  probe.address = address;
+  uint8_t transmission_result = i2c_bus_transfer(&probe);
 
   // Check if the transmission result is valid
   if(I2C_SCAN_TRANSMISSION_RESULT_SUCCESS == transmission_result || 
@@ -130,14 +148,14 @@ static i2c_scan_return_ts i2c_scan_checkDeviceStatus(uint8_t address)
      I2C_SCAN_TRANSMISSION_RESULT_NACKDAT == transmission_result ||
      I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN == transmission_result)
   {
-    return_data.i2c_scan_reading.single_device_status = transmission_result;
+    reading->single_device_status = transmission_result;
   }
   else
   {
-    return_data.error_code = ERROR_CODE_I2C_SCAN_ERROR_READING_DEVICE_STATUS;
+    error_code = ERROR_CODE_I2C_SCAN_ERROR_READING_DEVICE_STATUS;
   }
 
-  return return_data;
+  return error_code;
 }
 
 static bool i2c_scan_updateNextAddress(i2c_scan_reading_ts *i2c_scan_data)
@@ -163,4 +181,31 @@ static bool i2c_scan_updateNextAddress(i2c_scan_reading_ts *i2c_scan_data)
 
   return next_address_is_found;
 }
+
+static void i2c_scan_submitSlice()
+{
+  i2c_bus_job_ts probe = {0};
+  probe.callback = i2c_scan_onProbeFinished;
+
+  for (uint8_t slice_index = 0u; slice_index < I2C_SCAN_ADDRESSES_PER_SLICE && I2C_SCAN_I2C_ADDRESS_MAX >= i2c_scan_next_address; slice_index++)
+  {
+    // Empty job is an address probe
+    probe.address = i2c_scan_next_address;
+    if(I2C_BUS_QUEUE_FULL == i2c_bus_submit(&probe))
+    {
+      break; // Retried with the next slice
+    }
+    i2c_scan_next_address++;
+  }
+}
+
+static void i2c_scan_onProbeFinished(const i2c_bus_job_ts *job)
+{
+  if(I2C_SCAN_TRANSMISSION_RESULT_SUCCESS == job->result)
+  {
+    // Set the bit corresponding to this address in the addresses array
+    i2c_scan_found_addresses[job->address / BITS_IN_BYTE] |= (1 << (job->address % BITS_IN_BYTE));
+  }
+  i2c_scan_finished_probes++;
+}
 /* *************************************** */
\ No newline at end of file
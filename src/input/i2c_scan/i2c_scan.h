@@ -2,13 +2,20 @@
 #define I2C_SCAN_H
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "../../i2c_bus/i2c_bus.h"
 #include "../input_types.h"
 
 #define I2C_SCAN_ADDRESS_FOUND                 (bool)(true)
 
 #define I2C_SCAN_ADDRESS_NOT_FOUND             (bool)(false)
 
+/* Number of addresses probed per call while scanning for all devices, must fit into the I2C bus queue */
+#define I2C_SCAN_ADDRESSES_PER_SLICE           (uint8_t)(4u)
+
+/* State of the non-blocking scan for all devices */
+#define I2C_SCAN_IN_PROGRESS                   (bool)(true)
+#define I2C_SCAN_NOT_IN_PROGRESS               (bool)(false)
+
 /**
  * This macro is used to indicate that no address update function is assigned.
  * This is default if scan for all addresses is NOT called.
@@ -30,16 +37,18 @@
  * 
  * Depending on the input, this function either:
  * 1. Scans all I2C addresses (`I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES`) and marks detected devices.
+ *    The scan does not block: every call submits the next slice of I2C_SCAN_ADDRESSES_PER_SLICE
+ *    address probes to the I2C bus queue and returns `ERROR_CODE_I2C_SCAN_SCANNING_NOT_FINISHED`
+ *    with the partial bitmap and the scan cursor until every address has been probed.
  * 2. Checks the status of a device at a specific 7-bit address (1–127).
  * 
  * @param device_address Address to check or `I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES` for a full scan.
+ * @param reading Pointer to the caller's reading, receives the detected devices or the single device status.
  * 
- * @return i2c_scan_return_ts
- *         - `i2c_scan_reading`: Contains detected devices or single device status.
- *         - `error_code`: Indicates success or specific errors.
+ * @return control_error_code_te Indicates success or specific errors.
  * 
  * @note Ensure the I2C bus is initialized before calling.
  */
-i2c_scan_return_ts i2c_scan_getReading(uint8_t device_address);
+control_error_code_te i2c_scan_getReading(uint8_t device_address, i2c_scan_reading_ts *reading);
 
 #endif
\ No newline at end of file
@@ -11,6 +11,9 @@
 /* Flag indicating that bit is set */
 #define BIT_SET                          (uint8_t)(1u)
 
+/* Idle time of a background loop which has no deadline, it only gets work from a request */
+#define INPUT_IDLE_FOREVER               (unsigned long)(0xFFFFFFFFul)
+
 /* Maximum number of devices that can be addressed in 7-bit I2C addressing */
 #define I2C_7_BIT_ADDRESSING_MAX_DEVICES (uint8_t)(127u)
 
@@ -47,31 +50,94 @@
 #define I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN   (uint8_t)(4u)
 
 /* SENSORS COMPONENT */
+#ifdef SENSORS_FIXED_POINT_USED
+/* Sensor values are integers in thousandths of the unit, e.g. 21.5 C is 21500 */
+typedef int32_t sensors_value_t;
+/* Number of decimals stored in a sensor value */
+#define SENSORS_VALUE_DECIMALS           (uint8_t)(3u)
+/* Sensor value of one unit */
+#define SENSORS_VALUE_ONE                (int32_t)(1000)
+/* Returned by value functions instead of NAN, never a valid reading */
+#define SENSORS_VALUE_INVALID            (int32_t)(-2147483647L - 1L)
+/* Largest magnitude in units that fits into a sensor value */
+#define SENSORS_VALUE_MAX_UNITS          (float)(2147483.0f)
+#else
+typedef float sensors_value_t;
+#define SENSORS_VALUE_ONE                (float)(1.0f)
+#define SENSORS_VALUE_INVALID            (NAN)
+#endif
+
+/**
+ * @brief Converts a value in the unit of the measurement into a sensor value.
+ *
+ * Evaluated at compile time for configuration constants. At run time it is only needed for
+ * values of libraries that work with float. In fixed-point mode the value is rounded half away
+ * from zero, NAN and values outside of the fixed-point range become SENSORS_VALUE_INVALID.
+ *
+ * @param value The value in the unit of the measurement.
+ * @return sensors_value_t The sensor value.
+ */
+constexpr sensors_value_t sensors_toValue(float value)
+{
+#ifdef SENSORS_FIXED_POINT_USED
+  // NAN is the only value that differs from itself, isnan() cannot be used in a constant expression
+  return (value != value || SENSORS_VALUE_MAX_UNITS < value || -SENSORS_VALUE_MAX_UNITS > value) ? SENSORS_VALUE_INVALID :
+         (sensors_value_t)(value * SENSORS_VALUE_ONE + ((0.0f > value) ? -0.5f : 0.5f));
+#else
+  return value;
+#endif
+}
+
+/**
+ * @brief Checks that a value function returned a reading and not SENSORS_VALUE_INVALID.
+ *
+ * @param value The sensor value.
+ * @return bool true if the value is a reading.
+ */
+inline bool sensors_isValueValid(sensors_value_t value)
+{
+#ifdef SENSORS_FIXED_POINT_USED
+  return (SENSORS_VALUE_INVALID != value);
+#else
+  return !isnan(value);
+#endif
+}
+
 /**
  * Structure representing a single sensor reading.
  * Members:
- *  - value: The measured value from the sensor.
+ *  - value: The measured value from the sensor, float or fixed-point (see SENSORS_FIXED_POINT_USED).
  *  - indication: A flag for indication (for example raining / not raining).
  *  - measurement_type_switch: Identifier for the type of measurement (float value / indication).
  */
 typedef struct
 {
-  float value;
+  sensors_value_t value;
   bool indication;
   uint8_t measurement_type_switch;
 }sensor_reading_ts;
+/* ***************************************** */
 
+/* SENSOR STATS COMPONENT */
 /**
- * Structure containing the result of a sensor reading operation.
+ * Structure representing the rolling statistics of a sensor channel.
  * Members:
- *  - sensor_reading: Contains the actual data retrieved from the sensor.
- *  - error_code: Indicates whether the operation succeeded or provides an error code in case of failure.
+ *  - min_value: The lowest reading in the window.
+ *  - max_value: The highest reading in the window.
+ *  - mean: The mean of the readings.
+ *  - std_deviation: The sample standard deviation, every reading taken as the mean of its bucket.
+ *  - covered_seconds: Age of the oldest bucket with readings, the time span the statistics describe.
+ *  - num_of_samples: Number of readings in the window.
  */
 typedef struct
 {
-  sensor_reading_ts sensor_reading;
-  control_error_code_te error_code;
-} sensor_return_ts;
+  sensors_value_t min_value;
+  sensors_value_t max_value;
+  sensors_value_t mean;
+  sensors_value_t std_deviation;
+  uint16_t covered_seconds;
+  uint16_t num_of_samples;
+} sensor_stats_reading_ts;
 /* ***************************************** */
 
 /* RTC COMPONENT */
@@ -94,18 +160,6 @@ typedef struct
   uint8_t mins;
   uint8_t secs;
 }rtc_reading_ts;
-
-/**
- * Structure containing the result of an RTC operation.
- * Members:
- *  - rtc_reading: Contains the actual time data retrieved from the RTC.
- *  - error_code: Indicates whether the operation succeeded or provides an error code in case of failure.
- */
-typedef struct
-{
-  rtc_reading_ts rtc_reading;
-  control_error_code_te error_code;
-} rtc_return_ts;
 /* ***************************************** */
 
 /* I2C SCAN COMPONENT */
@@ -130,6 +184,8 @@ typedef bool (*update_i2c_address_fn)(struct i2c_scan_reading *i2c_scan_data);
  *  - update_to_next_i2c_address: Function pointer that updates `current_i2c_addr` 
  *                                to the next detected I2C address in `addresses` bit-field.
  *  - current_i2c_addr: Stores the currently selected I2C address during iteration.
+ *  - scan_cursor: Next address to be probed by a running scan for all devices. While the scan
+ *                 is not finished, `addresses` holds the devices found below this address.
  */
 typedef struct i2c_scan_reading
 {
@@ -138,19 +194,8 @@ typedef struct i2c_scan_reading
   uint8_t device_address;
   update_i2c_address_fn update_i2c_address;
   uint8_t current_i2c_addr;
+  uint8_t scan_cursor;
 } i2c_scan_reading_ts;
-
-/**
- * Structure containing the result of an I2C scan operation.
- * Members:
- *  - i2c_scan_reading: Contains the data from the I2C scan.
- *  - error_code: Indicates whether the operation succeeded or provides an error code in case of failure.
- */
-typedef struct 
-{
-  i2c_scan_reading_ts i2c_scan_reading;
-  control_error_code_te error_code;
-} i2c_scan_return_ts;
 /* ***************************************** */
 
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "rtc.h"
 
+// Library object and code are only part of builds with the component
+#ifdef RTC_COMPONENT
 /* STATIC GLOBAL VARIABLES */
 static RTC_DS3231 rtc;
 /* *************************************** */
@@ -13,17 +15,17 @@ control_error_code_te rtc_init()
   {
     error_code = ERROR_CODE_INIT_FAILED;
   }
-
-  if (rtc.lostPower()) // When time needs to be set on a new device, or after a power loss
+  else if (rtc.lostPower()) // When time needs to be set on a new device, or after a power loss
   {
     rtc.adjust(DateTime(F(RTC_COMPILE_DATE), F(RTC_COMPILE_TIME))); // Set to the compile time
   }
+
+  return error_code;
 }
 
-rtc_return_ts rtc_getTime(uint8_t id)
+control_error_code_te rtc_getTime(uint8_t id, rtc_reading_ts *reading)
 {
-  rtc_return_ts new_reading;
-  new_reading.error_code = ERROR_CODE_RTC_NOT_FOUND;
+  control_error_code_te error_code = ERROR_CODE_RTC_NOT_FOUND;
 
   if(id == RTC_DEFAULT_RTC)
   {
@@ -36,16 +38,17 @@ rtc_return_ts rtc_getTime(uint8_t id)
         now.month() >= RTC_MIN_MONTH && now.month() <= RTC_MAX_MONTH &&
         now.day() >= RTC_MIN_DAY && now.day() <= RTC_MAX_DAY)
     {
-      new_reading.rtc_reading.year = now.year();
-      new_reading.rtc_reading.month = now.month();
-      new_reading.rtc_reading.day = now.day();
-      new_reading.rtc_reading.hour = now.hour();
-      new_reading.rtc_reading.mins = now.minute();
-      new_reading.rtc_reading.secs = now.second();
-
-      new_reading.error_code = ERROR_CODE_NO_ERROR;
+      reading->year = now.year();
+      reading->month = now.month();
+      reading->day = now.day();
+      reading->hour = now.hour();
+      reading->mins = now.minute();
+      reading->secs = now.second();
+
+      error_code = ERROR_CODE_NO_ERROR;
     }
   }
-  return new_reading;
+  return error_code;
 }
-/* *************************************** */
\ No newline at end of file
+/* *************************************** */
+#endif
@@ -59,13 +59,14 @@ control_error_code_te rtc_init();
  *
  * This function reads the current time from the RTC module and performs basic validation 
  * to ensure the values fall within expected ranges. If the RTC is found and the values 
- * are valid, the function returns a structure containing the timestamp. Otherwise, 
+ * are valid, the timestamp is written into the caller's reading. Otherwise, 
  * it returns an error code indicating that the RTC was not found.
  *
  * @param[in] id Identifier for the RTC module. Should be `RTC_DEFAULT_RTC` for the default module.
- * @return `rtc_return_ts` structure containing the current date and time if valid, 
+ * @param[out] reading Pointer to the caller's reading, only written if the time is valid.
+ * @return control_error_code_te ERROR_CODE_NO_ERROR if the time is valid, 
  *         or an error code if the RTC is not found or the values are out of range.
  */
-rtc_return_ts rtc_getTime(uint8_t id);
+control_error_code_te rtc_getTime(uint8_t id, rtc_reading_ts *reading);
 
 #endif
\ No newline at end of file
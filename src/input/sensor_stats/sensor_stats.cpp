@@ -0,0 +1,267 @@
+#include "sensor_stats.h"
+
+#ifdef SENSOR_STATS_USED
+/* TRACKED CHANNELS */
+/**
+ * @brief Slot of a catalog entry in the channel array, evaluated at compile time.
+ *
+ * @param index Catalog index of the channel.
+ * @return uint8_t Slot, or SENSOR_STATS_NO_SLOT if the channel is not tracked.
+ */
+constexpr uint8_t sensor_stats_slotOf(uint8_t index)
+{
+  return (SENSORS_CATALOG_NO_INDEX == index || SENSOR_STATS_NOT_TRACKED == sensor_stats_windows[index]) ?
+         SENSOR_STATS_NO_SLOT : sensor_stats_countChannels(index);
+}
+
+/* Generates the slot of every configured channel, in catalog order */
+#define SENSOR_STATS_SLOT_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  sensor_stats_slotOf(sensors_catalog_indexOf(name)),
+
+/* Slot of every catalog index, the trailing entry only keeps the table from being empty */
+constexpr uint8_t sensor_stats_slots[] PROGMEM =
+{
+  SENSORS_REGISTRY(SENSOR_STATS_SLOT_ENTRY)
+  SENSOR_STATS_NO_SLOT
+};
+/* *************************************** */
+
+/* STATIC GLOBAL VARIABLES */
+static sensor_stats_channel_ts sensor_stats_channels[SENSOR_STATS_NUM_OF_CHANNELS];
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Finds the catalog index of a tracked sensor ID.
+ *
+ * @param id The sensor ID.
+ * @return uint8_t Catalog index, or SENSORS_CATALOG_NO_INDEX if the ID is not configured or not tracked.
+ */
+static uint8_t findTrackedIndex(uint8_t id);
+
+/**
+ * @brief Returns the current time in seconds, as used for the bucket numbers.
+ *
+ * @return uint32_t Seconds since start up.
+ */
+static uint32_t getSeconds();
+
+/**
+ * @brief Moves the newest bucket of a channel to the current one and empties the buckets in between.
+ *
+ * Every bucket that becomes newer than the previous newest one replaces a bucket which left the window.
+ * A gap of a whole window or more, or a step back at the wrap around of millis(), empties all buckets.
+ *
+ * @param channel Pointer to the channel.
+ * @param bucket Number of the current bucket.
+ */
+static void evictExpired(sensor_stats_channel_ts *channel, uint16_t bucket);
+
+/**
+ * @brief Folds a reading into the newest bucket of a channel.
+ *
+ * The squared deviations are updated like in Welford's algorithm. Unlike a plain sum of squares they
+ * keep the precision of float for readings with a large offset, e.g. the air pressure.
+ *
+ * @param channel Pointer to the channel, its newest bucket is the current one.
+ * @param value The reading.
+ */
+static void foldReading(sensor_stats_channel_ts *channel, sensors_value_t value);
+
+/**
+ * @brief Position of a bucket in the ring of SENSOR_STATS_WINDOW_SAMPLES entries.
+ *
+ * @param bucket Number of the bucket.
+ * @return uint8_t The ring position.
+ */
+static uint8_t ringPosition(uint16_t bucket);
+
+/**
+ * @brief Converts a sensor value into the unit of the measurement for the bucket sums.
+ *
+ * @param value The sensor value.
+ * @return float The value in units.
+ */
+static float toUnits(sensors_value_t value);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void sensor_stats_addReading(uint8_t id, const sensor_reading_ts *reading)
+{
+  uint8_t index = findTrackedIndex(id);
+  if(SENSORS_CATALOG_NO_INDEX == index)
+  {
+    return;
+  }
+
+  sensors_value_t value = reading->value;
+  if(SENSORS_MEASUREMENT_TYPE_INDICATION == reading->measurement_type_switch)
+  {
+    value = reading->indication ? SENSORS_VALUE_ONE : (sensors_value_t)0;
+  }
+  if(!sensors_isValueValid(value))
+  {
+    return;
+  }
+
+  sensor_stats_channel_ts *channel = &sensor_stats_channels[pgm_read_byte(&sensor_stats_slots[index])];
+  uint16_t span = (uint16_t)(pgm_read_word(&sensor_stats_windows[index]) / SENSOR_STATS_WINDOW_SAMPLES);
+
+  evictExpired(channel, (uint16_t)(getSeconds() / span));
+  foldReading(channel, value);
+}
+
+control_error_code_te sensor_stats_getReading(uint8_t id, sensor_stats_reading_ts *stats)
+{
+  uint8_t index = findTrackedIndex(id);
+  if(SENSORS_CATALOG_NO_INDEX == index)
+  {
+    return ERROR_CODE_SENSOR_STATS_NOT_TRACKED;
+  }
+
+  sensor_stats_channel_ts *channel = &sensor_stats_channels[pgm_read_byte(&sensor_stats_slots[index])];
+  uint16_t span = (uint16_t)(pgm_read_word(&sensor_stats_windows[index]) / SENSOR_STATS_WINDOW_SAMPLES);
+  uint32_t seconds = getSeconds();
+  evictExpired(channel, (uint16_t)(seconds / span));
+
+  // Extremes and sums of all buckets, from the newest one back
+  float sum = 0.0f;
+  uint16_t num_of_readings = 0u;
+  uint8_t oldest_age = 0u;
+  for (uint8_t age = 0u; age < SENSOR_STATS_WINDOW_SAMPLES; age++)
+  {
+    uint8_t position = ringPosition((uint16_t)(channel->newest_bucket - age));
+    if(0u == channel->counts[position])
+    {
+      continue;
+    }
+    if(0u == num_of_readings || channel->min_values[position] < stats->min_value)
+    {
+      stats->min_value = channel->min_values[position];
+    }
+    if(0u == num_of_readings || channel->max_values[position] > stats->max_value)
+    {
+      stats->max_value = channel->max_values[position];
+    }
+    sum += channel->sums[position];
+    num_of_readings += channel->counts[position];
+    oldest_age = age;
+  }
+
+  if(0u == num_of_readings)
+  {
+    return ERROR_CODE_SENSOR_STATS_NO_SAMPLES;
+  }
+
+  // Spread within the buckets plus the spread of the bucket means around the mean of the window
+  float mean = sum / num_of_readings;
+  float squared_deviations = 0.0f;
+  for (uint8_t position = 0u; position < SENSOR_STATS_WINDOW_SAMPLES; position++)
+  {
+    if(0u != channel->counts[position])
+    {
+      float delta = channel->sums[position] / channel->counts[position] - mean;
+      squared_deviations += channel->sums_sq[position] + delta * delta * channel->counts[position];
+    }
+  }
+
+  stats->mean = sensors_toValue(mean);
+  stats->std_deviation = (1u < num_of_readings) ? sensors_toValue(sqrtf(squared_deviations / (num_of_readings - 1u))) :
+                                                  sensors_toValue(0.0f);
+  stats->covered_seconds = (uint16_t)(seconds % span + (uint16_t)oldest_age * span);
+  stats->num_of_samples = num_of_readings;
+  return ERROR_CODE_NO_ERROR;
+}
+
+bool sensor_stats_isTracked(uint8_t id)
+{
+  return (SENSORS_CATALOG_NO_INDEX != findTrackedIndex(id)) ? SENSOR_STATS_CHANNEL_TRACKED : SENSOR_STATS_CHANNEL_NOT_TRACKED;
+}
+
+uint16_t sensor_stats_getWindow(uint8_t id)
+{
+  uint8_t index = findTrackedIndex(id);
+  return (SENSORS_CATALOG_NO_INDEX != index) ? pgm_read_word(&sensor_stats_windows[index]) : SENSOR_STATS_NOT_TRACKED;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t findTrackedIndex(uint8_t id)
+{
+  uint8_t index = sensors_interface_sensorIdToIndex(id);
+  if(SENSORS_CATALOG_NO_INDEX == index || SENSOR_STATS_NO_SLOT == pgm_read_byte(&sensor_stats_slots[index]))
+  {
+    return SENSORS_CATALOG_NO_INDEX;
+  }
+  return index;
+}
+
+static uint32_t getSeconds()
+{
+  return millis() / SENSOR_STATS_MS_PER_SECOND;
+}
+
+static void evictExpired(sensor_stats_channel_ts *channel, uint16_t bucket)
+{
+  // Unsigned difference stays valid across the wrap around of the bucket numbers
+  uint16_t elapsed = (uint16_t)(bucket - channel->newest_bucket);
+  if(SENSOR_STATS_WINDOW_SAMPLES < elapsed)
+  {
+    elapsed = SENSOR_STATS_WINDOW_SAMPLES;
+  }
+  for (uint8_t step = 1u; step <= elapsed; step++)
+  {
+    channel->counts[ringPosition((uint16_t)(channel->newest_bucket + step))] = 0u;
+  }
+  channel->newest_bucket = bucket;
+}
+
+static void foldReading(sensor_stats_channel_ts *channel, sensors_value_t value)
+{
+  uint8_t position = ringPosition(channel->newest_bucket);
+  if(0u == channel->counts[position])
+  {
+    channel->min_values[position] = value;
+    channel->max_values[position] = value;
+    channel->sums[position] = 0.0f;
+    channel->sums_sq[position] = 0.0f;
+  }
+  else
+  {
+    if(value < channel->min_values[position])
+    {
+      channel->min_values[position] = value;
+    }
+    if(value > channel->max_values[position])
+    {
+      channel->max_values[position] = value;
+    }
+  }
+
+  // A full bucket keeps the mean of its first readings, the extremes still see every reading
+  if(SENSOR_STATS_BUCKET_MAX_READINGS > channel->counts[position])
+  {
+    float units = toUnits(value);
+    // Deviation from the bucket mean before and after the reading, 0 for the first reading
+    float delta_before = (0u != channel->counts[position]) ? (units - channel->sums[position] / channel->counts[position]) : 0.0f;
+    channel->sums[position] += units;
+    channel->counts[position]++;
+    channel->sums_sq[position] += delta_before * (units - channel->sums[position] / channel->counts[position]);
+  }
+}
+
+static uint8_t ringPosition(uint16_t bucket)
+{
+  return (uint8_t)(bucket % SENSOR_STATS_WINDOW_SAMPLES);
+}
+
+static float toUnits(sensors_value_t value)
+{
+#ifdef SENSORS_FIXED_POINT_USED
+  return (float)value / SENSORS_VALUE_ONE;
+#else
+  return value;
+#endif
+}
+/* *************************************** */
+#endif
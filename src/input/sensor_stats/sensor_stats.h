@@ -0,0 +1,154 @@
+#ifndef SENSOR_STATS_H
+#define SENSOR_STATS_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "sensor_stats_config.h"
+#include "../input_types.h"
+
+/**
+ * @file sensor_stats.h
+ * @brief Rolling statistics of the sensor channels.
+ *
+ * The window of every tracked channel is split into SENSOR_STATS_WINDOW_SAMPLES buckets of
+ * window / SENSOR_STATS_WINDOW_SAMPLES seconds, kept in a ring. Every reading is folded into the
+ * minimum, the maximum, the sum and the squared deviations of its bucket, however often the channel is read, and the oldest
+ * bucket leaves the window as a whole. Adding a reading is O(1), reading the statistics combines the
+ * buckets. Sums are rebuilt with every bucket, so no rounding drift accumulates over months.
+ *
+ * Samples are fed by the data router with every successful sensor reading, the statistics never
+ * read a sensor themselves. The SRAM of all channels is allocated statically, SENSOR_STATS_CHANNEL_BYTES
+ * per tracked channel and SENSOR_STATS_RAM_BYTES in total.
+ */
+
+/* Window value of a channel without statistics */
+#define SENSOR_STATS_NOT_TRACKED                (uint16_t)(0u)
+/* Largest window in seconds, far below the wrap around of the 16 bit window values */
+#define SENSOR_STATS_WINDOW_MAX_SECONDS         (uint16_t)(0x7FFFu)
+/* Slot of a sensor ID that is not tracked */
+#define SENSOR_STATS_NO_SLOT                    (uint8_t)(0xFFu)
+/* Milliseconds per timestamp tick */
+#define SENSOR_STATS_MS_PER_SECOND              (uint32_t)(1000u)
+/* Readings summed up in one bucket, later readings of the bucket only move its minimum and maximum */
+#define SENSOR_STATS_BUCKET_MAX_READINGS        (uint8_t)(0xFFu)
+
+/* Status of a sensor ID */
+#define SENSOR_STATS_CHANNEL_TRACKED            (bool)(true)
+#define SENSOR_STATS_CHANNEL_NOT_TRACKED        (bool)(false)
+
+/* Generates the window of every configured channel, in catalog order */
+#define SENSOR_STATS_WINDOW_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  SENSOR_STATS_WINDOW_##name,
+
+/* Windows in seconds in catalog order, the trailing entry only keeps the table from being empty */
+constexpr uint16_t sensor_stats_windows[] PROGMEM =
+{
+  SENSORS_REGISTRY(SENSOR_STATS_WINDOW_ENTRY)
+  SENSOR_STATS_NOT_TRACKED
+};
+
+/**
+ * @brief Counts the tracked channels among the first catalog entries at compile time.
+ *
+ * @param end Number of catalog entries to look at.
+ * @param index The index to start counting from.
+ * @return uint8_t Number of tracked channels before end.
+ */
+constexpr uint8_t sensor_stats_countChannels(uint8_t end, uint8_t index = 0u)
+{
+  return (index >= end) ? 0u :
+         ((SENSOR_STATS_NOT_TRACKED != sensor_stats_windows[index]) ? 1u : 0u) + sensor_stats_countChannels(end, index + 1u);
+}
+
+/**
+ * @brief Checks at compile time that every window fits into the bucket numbers and has buckets of at least a second.
+ *
+ * @param index The index to start checking from.
+ * @return bool true if every tracked window from index onward is between SENSOR_STATS_WINDOW_SAMPLES
+ *              and SENSOR_STATS_WINDOW_MAX_SECONDS.
+ */
+constexpr bool sensor_stats_windowsAreValid(uint8_t index = 0u)
+{
+  return (index >= SENSORS_CATALOG_LEN) ||
+         ((SENSOR_STATS_NOT_TRACKED == sensor_stats_windows[index] ||
+           (SENSOR_STATS_WINDOW_SAMPLES <= sensor_stats_windows[index] && SENSOR_STATS_WINDOW_MAX_SECONDS >= sensor_stats_windows[index])) &&
+          sensor_stats_windowsAreValid(index + 1u));
+}
+
+/**
+ * Rolling window of one tracked channel.
+ * Bucket number n covers the seconds from n * span to (n + 1) * span since start up, span being
+ * window / SENSOR_STATS_WINDOW_SAMPLES. It is kept at ring position n % SENSOR_STATS_WINDOW_SAMPLES,
+ * the ring holds the buckets up to `newest_bucket`. A bucket without readings has a count of 0.
+ */
+typedef struct
+{
+  sensors_value_t min_values[SENSOR_STATS_WINDOW_SAMPLES]; // Lowest reading of every bucket
+  sensors_value_t max_values[SENSOR_STATS_WINDOW_SAMPLES]; // Highest reading of every bucket
+  float sums[SENSOR_STATS_WINDOW_SAMPLES];                 // Sum of the readings of every bucket in units of the measurement
+  float sums_sq[SENSOR_STATS_WINDOW_SAMPLES];              // Sum of the squared deviations from the bucket mean, see foldReading()
+  uint8_t counts[SENSOR_STATS_WINDOW_SAMPLES];             // Readings summed up in every bucket
+  uint16_t newest_bucket;                                  // Number of the newest bucket, wraps around
+} sensor_stats_channel_ts;
+
+/* Number of tracked channels of enabled components */
+#define SENSOR_STATS_NUM_OF_CHANNELS            (uint8_t)(sensor_stats_countChannels(SENSORS_CATALOG_LEN))
+/* SRAM of one tracked channel */
+#define SENSOR_STATS_CHANNEL_BYTES              (uint16_t)(sizeof(sensor_stats_channel_ts))
+/* SRAM of all tracked channels */
+#define SENSOR_STATS_RAM_BYTES                  (uint16_t)(SENSOR_STATS_NUM_OF_CHANNELS * SENSOR_STATS_CHANNEL_BYTES)
+
+#ifdef SENSOR_STATS_USED
+static_assert(2u <= SENSOR_STATS_WINDOW_SAMPLES, "A window needs at least two samples");
+static_assert(sensor_stats_windowsAreValid(), "Windows must be between SENSOR_STATS_WINDOW_SAMPLES and SENSOR_STATS_WINDOW_MAX_SECONDS");
+static_assert(0u < SENSOR_STATS_NUM_OF_CHANNELS, "No channel is tracked, comment out SENSOR_STATS_USED in project_settings.h instead");
+static_assert(SENSOR_STATS_RAM_BUDGET_BYTES >= SENSOR_STATS_RAM_BYTES,
+              "Tracked channels exceed SENSOR_STATS_RAM_BUDGET_BYTES, track fewer channels or keep fewer samples");
+#endif
+
+/**
+ * @brief Adds a sensor reading to the window of its channel.
+ *
+ * Readings of channels that are not tracked are ignored. Every reading is folded into the current
+ * bucket, buckets which left the window are evicted first. Indications are kept as
+ * SENSORS_VALUE_ONE (set) and 0.
+ *
+ * @param id The sensor ID of the reading.
+ * @param reading Pointer to the valid reading.
+ */
+void sensor_stats_addReading(uint8_t id, const sensor_reading_ts *reading);
+
+/**
+ * @brief Returns the statistics of the current window of a channel.
+ *
+ * Buckets older than the window are evicted before, so a channel that stopped delivering
+ * readings runs empty. Mean and standard deviation are calculated in float, also in fixed-point mode.
+ * The standard deviation is the sample standard deviation of all summed up readings, the spread within
+ * every bucket combined with the spread of the bucket means.
+ *
+ * @param id The sensor ID.
+ * @param stats Pointer to the caller's statistics, only written if there are samples.
+ * @return control_error_code_te
+ *         - ERROR_CODE_NO_ERROR: Statistics are valid.
+ *         - ERROR_CODE_SENSOR_STATS_NOT_TRACKED: The channel is not configured or keeps no statistics.
+ *         - ERROR_CODE_SENSOR_STATS_NO_SAMPLES: No bucket of the window holds a reading.
+ */
+control_error_code_te sensor_stats_getReading(uint8_t id, sensor_stats_reading_ts *stats);
+
+/**
+ * @brief Checks if statistics are kept for a sensor ID.
+ *
+ * @param id The sensor ID.
+ * @return bool SENSOR_STATS_CHANNEL_TRACKED or SENSOR_STATS_CHANNEL_NOT_TRACKED.
+ */
+bool sensor_stats_isTracked(uint8_t id);
+
+/**
+ * @brief Returns the window of a sensor ID.
+ *
+ * @param id The sensor ID.
+ * @return uint16_t Window in seconds, SENSOR_STATS_NOT_TRACKED if no statistics are kept.
+ */
+uint16_t sensor_stats_getWindow(uint8_t id);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef SENSOR_STATS_CONFIG_H
+#define SENSOR_STATS_CONFIG_H
+
+#include <Arduino.h>
+
+/**
+ * Number of buckets per tracked channel. Every bucket costs SRAM, see SENSOR_STATS_RAM_BYTES.
+ * A bucket keeps minimum, maximum and sum of the readings of window / SENSOR_STATS_WINDOW_SAMPLES
+ * seconds, so the window always covers its whole duration, however often the channel is read.
+ */
+#define SENSOR_STATS_WINDOW_SAMPLES             (uint8_t)(8u)
+
+/* Upper limit of the SRAM used by all tracked channels together, checked at compile time */
+#define SENSOR_STATS_RAM_BUDGET_BYTES           (uint16_t)(432u)
+
+/**
+ * Window of every sensor channel in seconds, SENSOR_STATS_NOT_TRACKED keeps no statistics for the channel.
+ * Windows must be between SENSOR_STATS_WINDOW_SAMPLES and SENSOR_STATS_WINDOW_MAX_SECONDS. Only channels of enabled components take SRAM.
+ */
+#define SENSOR_STATS_WINDOW_DHT11_TEMPERATURE   (uint16_t)(600u)
+#define SENSOR_STATS_WINDOW_DHT11_HUMIDITY      (uint16_t)(600u)
+#define SENSOR_STATS_WINDOW_BMP280_PRESSURE     (uint16_t)(600u)
+#define SENSOR_STATS_WINDOW_BMP280_TEMPERATURE  SENSOR_STATS_NOT_TRACKED
+#define SENSOR_STATS_WINDOW_BMP280_ALTITUDE     SENSOR_STATS_NOT_TRACKED
+#define SENSOR_STATS_WINDOW_BH1750_LUMINANCE    SENSOR_STATS_NOT_TRACKED
+#define SENSOR_STATS_WINDOW_MQ135_PPM           SENSOR_STATS_NOT_TRACKED
+#define SENSOR_STATS_WINDOW_MQ7_COPPM           SENSOR_STATS_NOT_TRACKED
+#define SENSOR_STATS_WINDOW_GYML8511_UV         SENSOR_STATS_NOT_TRACKED
+#define SENSOR_STATS_WINDOW_ARDUINORAIN_RAINING SENSOR_STATS_NOT_TRACKED /** Mean of an indication is the fraction of time it was set */
+
+#endif
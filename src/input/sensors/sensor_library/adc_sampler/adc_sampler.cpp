@@ -0,0 +1,122 @@
+#include "adc_sampler.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Multiplexer channel of every attached pin */
+static uint8_t adc_sampler_muxes[ADC_SAMPLER_MAX_CHANNELS];
+/* Last decimated value of every attached pin, written by the ADC interrupt */
+static volatile uint16_t adc_sampler_values[ADC_SAMPLER_MAX_CHANNELS];
+static volatile uint8_t adc_sampler_num_of_channels = 0u;
+
+/* State of the running sampling, only used by the ADC interrupt once the ADC is started */
+static uint8_t adc_sampler_current_channel = 0u;
+static uint8_t adc_sampler_num_of_samples = 0u;
+static uint8_t adc_sampler_samples_to_discard = 0u;
+static uint16_t adc_sampler_sum = 0u;
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Switches the multiplexer to a pin, with AVCC as reference like analogRead().
+ *
+ * @param mux Multiplexer channel of the pin.
+ */
+static void selectMux(uint8_t mux);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+uint8_t adc_sampler_attach(uint8_t pin)
+{
+  uint8_t mux = ADC_SAMPLER_PIN_TO_MUX(pin);
+
+  for (uint8_t channel = 0u; channel < adc_sampler_num_of_channels; channel++)
+  {
+    if(mux == adc_sampler_muxes[channel])
+    {
+      return channel; // Already attached, e.g. by a re-initialization
+    }
+  }
+  if(ADC_SAMPLER_MAX_CHANNELS <= adc_sampler_num_of_channels)
+  {
+    return ADC_SAMPLER_NO_CHANNEL;
+  }
+
+  uint8_t channel = adc_sampler_num_of_channels;
+  adc_sampler_muxes[channel] = mux;
+  adc_sampler_values[channel] = ADC_SAMPLER_NO_VALUE;
+  if(ADC_SAMPLER_DIDR0_CHANNELS > mux)
+  {
+    DIDR0 |= (uint8_t)(1u << mux); // Digital input buffer only adds noise to an analog pin
+  }
+
+  noInterrupts();
+  adc_sampler_num_of_channels = channel + 1u; // Visible to the interrupt after the channel is complete
+  interrupts();
+
+#ifdef ADC_SAMPLER_USED
+  if(0u == channel)
+  {
+    // First pin, start the conversion chain
+    adc_sampler_current_channel = 0u;
+    adc_sampler_num_of_samples = 0u;
+    adc_sampler_sum = 0u;
+    selectMux(mux);
+    ADCSRA = (uint8_t)((1u << ADEN) | (1u << ADIE) | (1u << ADSC) | ADC_SAMPLER_PRESCALER_BITS);
+  }
+#endif
+  return channel;
+}
+
+uint16_t adc_sampler_read(uint8_t channel)
+{
+  if(channel >= adc_sampler_num_of_channels)
+  {
+    return ADC_SAMPLER_NO_VALUE;
+  }
+
+  // 16-bit value is written by the interrupt, it must not change between the two byte reads
+  noInterrupts();
+  uint16_t value = adc_sampler_values[channel];
+  interrupts();
+  return value;
+}
+/* *************************************** */
+
+/* INTERRUPT HANDLER */
+#ifdef ADC_SAMPLER_USED
+ISR(ADC_vect)
+{
+  uint16_t conversion = ADC;
+
+  if(0u != adc_sampler_samples_to_discard)
+  {
+    adc_sampler_samples_to_discard--; // Sample and hold capacitor still settles to the new pin
+  }
+  else
+  {
+    adc_sampler_sum += conversion;
+    adc_sampler_num_of_samples++;
+
+    if(ADC_SAMPLER_SAMPLES_PER_VALUE <= adc_sampler_num_of_samples)
+    {
+      // Decimation, the sum of 4^n conversions shifted by n keeps n extra bits
+      adc_sampler_values[adc_sampler_current_channel] = adc_sampler_sum >> SENSORS_ADC_OVERSAMPLING_BITS;
+      adc_sampler_sum = 0u;
+      adc_sampler_num_of_samples = 0u;
+
+      adc_sampler_current_channel = (uint8_t)((adc_sampler_current_channel + 1u) % adc_sampler_num_of_channels);
+      selectMux(adc_sampler_muxes[adc_sampler_current_channel]);
+    }
+  }
+
+  ADCSRA |= (uint8_t)(1u << ADSC); // Next conversion, the multiplexer is only switched between conversions
+}
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void selectMux(uint8_t mux)
+{
+  ADMUX = (uint8_t)((1u << REFS0) | (mux & ADC_SAMPLER_MUX_MASK));
+  adc_sampler_samples_to_discard = ADC_SAMPLER_SETTLING_SAMPLES;
+}
+/* *************************************** */
@@ -0,0 +1,78 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include "../sensors_config.h"
+#include "../../../../project_settings.h"
+
+/**
+ * @file adc_sampler.h
+ * @brief Interrupt driven oversampling of the analog sensor pins.
+ *
+ * The ADC converts continuously, driven by its conversion complete interrupt. Attached pins are
+ * sampled round-robin: 4^n conversions of one pin are summed and shifted right by n (decimation),
+ * which gives a value with n extra bits of resolution and averages out the noise. Then the next pin
+ * is selected, the first conversion after a switch of the multiplexer is discarded.
+ *
+ * Drivers only read the last finished value, they never wait for a conversion. One value of a pin is
+ * ready every (4^n + 1) * (number of pins) conversions, about 7 ms for 4 pins and n = 2.
+ *
+ * The sampler owns the ADC, analogRead() must not be used while pins are attached.
+ */
+
+/* Analog sensors which are sampled by the ADC interrupt, the interrupt is not compiled without them */
+#if defined(MQ135_COMPONENT) || defined(MQ7_COMPONENT) || defined(GYML8511_COMPONENT) || \
+    (defined(ARDUINORAIN_COMPONENT) && defined(SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT))
+#define ADC_SAMPLER_USED
+#endif
+
+/* Maximum number of attached pins */
+#define ADC_SAMPLER_MAX_CHANNELS        (uint8_t)(4u)
+/* Number of conversions summed per value */
+#define ADC_SAMPLER_SAMPLES_PER_VALUE   (uint8_t)(1u << (2u * SENSORS_ADC_OVERSAMPLING_BITS))
+/* Conversions discarded after the multiplexer was switched to another pin */
+#define ADC_SAMPLER_SETTLING_SAMPLES    (uint8_t)(1u)
+/* Highest value of one conversion (10-bit ADC) */
+#define ADC_SAMPLER_ADC_MAX             (uint16_t)(1023u)
+/* Highest decimated value, the full scale of the values returned by adc_sampler_read() */
+#define ADC_SAMPLER_FULL_SCALE          (uint16_t)(ADC_SAMPLER_ADC_MAX << SENSORS_ADC_OVERSAMPLING_BITS)
+
+/* Returned by adc_sampler_attach() if no channel is free */
+#define ADC_SAMPLER_NO_CHANNEL          (uint8_t)(0xFFu)
+/* Returned by adc_sampler_read() until the first value of the channel is ready */
+#define ADC_SAMPLER_NO_VALUE            (uint16_t)(0xFFFFu)
+
+/* Multiplexer channel of an analog pin, both A0 and 0 select the first analog input */
+#define ADC_SAMPLER_PIN_TO_MUX(pin)     (uint8_t)(((pin) >= A0) ? ((pin) - A0) : (pin))
+/* Mask of the multiplexer channel bits in ADMUX */
+#define ADC_SAMPLER_MUX_MASK            (uint8_t)(0x07u)
+/* Analog inputs with a digital input buffer that can be disabled in DIDR0 (A6 and A7 have none) */
+#define ADC_SAMPLER_DIDR0_CHANNELS      (uint8_t)(6u)
+/* ADC clock prescaler 128, 125 kHz at 16 MHz, one conversion takes 104 us */
+#define ADC_SAMPLER_PRESCALER_BITS      (uint8_t)((1u << ADPS2) | (1u << ADPS1) | (1u << ADPS0))
+
+static_assert(3u >= SENSORS_ADC_OVERSAMPLING_BITS, "The sum of the conversions must fit into 16 bits");
+
+/**
+ * @brief Adds an analog pin to the sampling sequence and starts the ADC with the first pin.
+ *
+ * Attaching a pin which is already attached returns its channel again, so drivers can call this
+ * from every initialization.
+ *
+ * @param pin The analog pin (e.g. A0).
+ * @return uint8_t Channel of the pin for adc_sampler_read(), ADC_SAMPLER_NO_CHANNEL if all channels are used.
+ */
+uint8_t adc_sampler_attach(uint8_t pin);
+
+/**
+ * @brief Returns the last decimated value of a channel.
+ *
+ * Does not block, the value is at most one sampling round old.
+ *
+ * @param channel Channel returned by adc_sampler_attach().
+ * @return uint16_t Value from 0 to ADC_SAMPLER_FULL_SCALE, ADC_SAMPLER_NO_VALUE if no value is ready
+ *         or the channel is not attached.
+ */
+uint16_t adc_sampler_read(uint8_t channel);
+
+#endif
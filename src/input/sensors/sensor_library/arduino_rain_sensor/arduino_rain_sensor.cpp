@@ -1,10 +1,17 @@
 #include "arduino_rain_sensor.h"
 
+/* STATIC GLOBAL VARIABLES */
+#ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
+// Channel of the analog pin in the ADC sampler
+static uint8_t arduino_rain_sensor_adc_channel = ADC_SAMPLER_NO_CHANNEL;
+#endif
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
 #ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
 /**
  * @brief Checks rain status using an analog rain sensor pin.
- * @return true if the analog reading is below the threshold, false otherwise.
+ * @return true if the oversampled analog value is below the threshold, false otherwise or if nothing is sampled yet.
  */
 static bool arduino_rain_sensor_isRainingAnalog();
 #else
@@ -22,6 +29,7 @@ void arduino_rain_sensor_init()
 #ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
   // Configure the pin for analog input if analog measurement is enabled
   pinMode(SENSORS_ARDUINO_RAIN_PIN_ANALOG, INPUT);
+  arduino_rain_sensor_adc_channel = adc_sampler_attach(SENSORS_ARDUINO_RAIN_PIN_ANALOG);
 #else
   // Configure the pin for digital input if digital measurement is enabled
   pinMode(SENSORS_ARDUINO_RAIN_PIN_DIGITAL, INPUT);
@@ -44,9 +52,10 @@ bool arduino_rain_sensor_readRaining()
 #ifdef SENSORS_ARDUINO_RAIN_SENSOR_ANALOG_MEASUREMENT
 static bool arduino_rain_sensor_isRainingAnalog()
 {
-  int analog_reading = analogRead(SENSORS_ARDUINO_RAIN_PIN_ANALOG);
-  // Return true if the reading is below or equal to the defined threshold
-  if(ARDUINO_RAIN_SENSOR_ANALOG_THRESHOLD >= analog_reading)
+  uint16_t analog_value = adc_sampler_read(arduino_rain_sensor_adc_channel);
+  // Return true if the value is below or equal to the defined threshold, scaled to the oversampled resolution
+  if(ADC_SAMPLER_NO_VALUE != analog_value &&
+     ((uint16_t)ARDUINO_RAIN_SENSOR_ANALOG_THRESHOLD << SENSORS_ADC_OVERSAMPLING_BITS) >= analog_value)
   {
     return true;
   }
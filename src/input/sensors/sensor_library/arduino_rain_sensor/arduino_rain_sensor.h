@@ -3,12 +3,13 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../adc_sampler/adc_sampler.h"
 
 /* Define the digital output value indicating rain detected by the sensor, used in digital read mode */
 /* NOTE: The sensor uses reverse logic — 0 means rain is detected, and 1 means no rain */
 #define ARDUINO_RAIN_SENSOR_RAIN_DETECTED    (int)(0)
 
-/* Define the threshold value for analog readings; values below this indicate rain */
+/* Define the threshold value for analog readings (10-bit ADC); values below this indicate rain */
 #define ARDUINO_RAIN_SENSOR_ANALOG_THRESHOLD (int)(500u)
 
 /**
@@ -14,8 +14,8 @@ bool bh1750_init()
   return true;
 }
 
-float bh1750_readLightLevel()
+sensors_value_t bh1750_readLightLevel()
 {
-  return lightMeter.readLightLevel();
+  return sensors_toValue(lightMeter.readLightLevel());
 }
 /* *************************************** */
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <BH1750.h>
 #include "../sensors_config.h"
+#include "../../../input_types.h"
 
 /**
  * @brief Initializes the BH1750 light sensor.
@@ -20,10 +21,10 @@ bool bh1750_init();
  * @brief Reads the light level from the BH1750 sensor.
  *
  * This function retrieves the current light level in lux from the BH1750 sensor.
- * The value returned is a float, representing the light intensity measured by the sensor.
+ * The library measures in float, the value is converted into a sensor value.
  *
- * @return The light level in lux as a float.
+ * @return The light level in lux.
  */
-float bh1750_readLightLevel();
+sensors_value_t bh1750_readLightLevel();
 
 #endif
\ No newline at end of file
@@ -1,7 +1,24 @@
 #include "bmp280.h"
 
+// Library object and code are only part of builds with the component
+#ifdef BMP280_COMPONENT
 /* STATIC GLOBAL VARIABLES */
 static Adafruit_BMP280 bmp;
+/* Values of the last acquisition, shared by all BMP280 channels */
+static bmp280_snapshot_ts bmp280_snapshot = {NAN, NAN, NAN};
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Calculates the altitude from a pressure value with the barometric formula.
+ *
+ * Same formula as the Adafruit library, but it works on an already measured pressure
+ * instead of triggering a new measurement.
+ *
+ * @param pressure_pa Pressure in Pascals.
+ * @return float Altitude in meters.
+ */
+static float calculateAltitude(float pressure_pa);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -19,18 +36,38 @@ bool bmp280_init()
   return true;
 }
 
-float bmp280_readTemperature()
+bool bmp280_sample()
+{
+  // readPressure() reads the temperature internally for compensation, the library gives no way to reuse it
+  bmp280_snapshot.temperature = bmp.readTemperature();
+  bmp280_snapshot.pressure = bmp.readPressure();
+  // Altitude is derived from the snapshot pressure, no additional bus transaction
+  bmp280_snapshot.altitude = calculateAltitude(bmp280_snapshot.pressure);
+
+  return (!isnan(bmp280_snapshot.temperature) && !isnan(bmp280_snapshot.pressure));
+}
+
+sensors_value_t bmp280_readTemperature()
 {
-    return bmp.readTemperature();
+  return sensors_toValue(bmp280_snapshot.temperature);
 }
 
-float bmp280_readPressure()
+sensors_value_t bmp280_readPressure()
 {
-    return bmp.readPressure();
+  return sensors_toValue(bmp280_snapshot.pressure);
 }
 
-float bmp280_readAltitude()
+sensors_value_t bmp280_readAltitude()
 {
-    return bmp.readAltitude(SENSORS_BMP280_LOCAL_SEA_LEVEL_PRESSURE);
+  return sensors_toValue(bmp280_snapshot.altitude);
 }
-/* *************************************** */
\ No newline at end of file
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static float calculateAltitude(float pressure_pa)
+{
+  float pressure_hpa = pressure_pa / BMP280_PA_PER_HPA;
+  return BMP280_ALTITUDE_FACTOR * (1.0f - pow(pressure_hpa / SENSORS_BMP280_LOCAL_SEA_LEVEL_PRESSURE, BMP280_ALTITUDE_EXPONENT));
+}
+/* *************************************** */
+#endif
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <Adafruit_BMP280.h>
 #include "../sensors_config.h"
+#include "../../../input_types.h"
 
 
 #define BMP280_MODE_NORMAL    Adafruit_BMP280::MODE_NORMAL //The sensor continuously takes measurements based on the configured sampling and standby time.
@@ -35,6 +36,24 @@
 #define BMP280_WAIT_MS_2000   Adafruit_BMP280::STANDBY_MS_2000
 #define BMP280_WAIT_MS_4000   Adafruit_BMP280::STANDBY_MS_4000
 
+/* Constants of the barometric formula used for the altitude calculation */
+#define BMP280_PA_PER_HPA           (float)(100.0f)
+#define BMP280_ALTITUDE_FACTOR      (float)(44330.0f)
+#define BMP280_ALTITUDE_EXPONENT    (float)(0.1903f)
+
+/**
+ * @brief Values of one BMP280 acquisition.
+ *
+ * All BMP280 channels are served from the same snapshot, so temperature, pressure
+ * and altitude of one cycle always belong together. Kept in float, the library works in float.
+ */
+typedef struct
+{
+  float temperature; // Temperature in degrees Celsius
+  float pressure;    // Pressure in Pascals
+  float altitude;    // Altitude in meters, calculated from the pressure
+} bmp280_snapshot_ts;
+
 /**
  * @brief Initializes the BMP280 sensor.
  *
@@ -49,34 +68,41 @@
 bool bmp280_init();
 
 /**
- * @brief Reads the current temperature from the BMP280 sensor.
+ * @brief Takes one acquisition of all BMP280 channels.
+ *
+ * Reads temperature and pressure from the sensor and calculates the altitude from
+ * the measured pressure. The read functions below return values of this snapshot.
+ *
+ * @return true if the readings are valid, false otherwise.
+ */
+bool bmp280_sample();
+
+/**
+ * @brief Returns the temperature of the last BMP280 acquisition.
  *
- * This function retrieves the current temperature from the BMP280 sensor.
  * The temperature is measured in degrees Celsius.
  *
- * @return The current temperature in degrees Celsius.
+ * @return The temperature in degrees Celsius, SENSORS_VALUE_INVALID if no valid acquisition was taken.
  */
-float bmp280_readTemperature();
+sensors_value_t bmp280_readTemperature();
 
 /**
- * @brief Reads the current atmospheric pressure from the BMP280 sensor.
+ * @brief Returns the atmospheric pressure of the last BMP280 acquisition.
  *
- * This function retrieves the current atmospheric pressure from the BMP280 sensor.
  * The pressure is returned in Pascals (Pa).
  *
- * @return The current atmospheric pressure in Pascals.
+ * @return The atmospheric pressure in Pascals, SENSORS_VALUE_INVALID if no valid acquisition was taken.
  */
-float bmp280_readPressure();
+sensors_value_t bmp280_readPressure();
 
 /**
- * @brief Reads the current altitude from the BMP280 sensor.
+ * @brief Returns the altitude of the last BMP280 acquisition.
  *
- * This function calculates and returns the current altitude based on the pressure
- * measurement and a given sea-level pressure value. The altitude is calculated
- * using the barometric formula.
+ * The altitude is calculated from the snapshot pressure and the configured sea-level
+ * pressure using the barometric formula.
  *
- * @return The calculated altitude in meters.
+ * @return The calculated altitude in meters, SENSORS_VALUE_INVALID if no valid acquisition was taken.
  */
-float bmp280_readAltitude();
+sensors_value_t bmp280_readAltitude();
 
 #endif
\ No newline at end of file
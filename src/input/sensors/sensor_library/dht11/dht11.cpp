@@ -1,22 +1,240 @@
 #include "dht11.h"
 
 /* STATIC GLOBAL VARIABLES */
-static DHT dht(SENSORS_DHT11_PIN, DHT11);
+/* Values of the last acquisition, shared by both DHT11 channels */
+static dht11_snapshot_ts dht11_snapshot = {SENSORS_VALUE_INVALID, SENSORS_VALUE_INVALID};
+
+static dht11_state_te dht11_state = DHT11_STATE_POWER_UP;
+/* Time of the last state change, or of the last finished acquisition while idle */
+static unsigned long dht11_state_millis = 0u;
+/* Set when an acquisition was requested and not started yet */
+static bool dht11_reading_requested = false;
+
+/* Falling edge timestamps of the current frame, written by the pin interrupt */
+static volatile uint16_t dht11_edges_us[DHT11_FRAME_EDGES];
+static volatile uint8_t dht11_num_of_edges = 0u;
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Pin interrupt handler, stores the timestamp of a falling edge on the data line.
+ */
+static void onFallingEdge();
+
+/**
+ * @brief Changes the state of the acquisition and remembers when it happened.
+ *
+ * @param state The new state.
+ * @param current_millis The current time in milliseconds.
+ */
+static void changeState(dht11_state_te state, unsigned long current_millis);
+
+/**
+ * @brief Stops the edge capture and decodes the received frame into the snapshot.
+ */
+static void finishReading();
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
-void dht11_init()
+bool dht11_init()
 {
-    dht.begin();
+    if(NOT_AN_INTERRUPT == digitalPinToInterrupt(SENSORS_DHT11_PIN))
+    {
+        return false;
+    }
+    pinMode(SENSORS_DHT11_PIN, INPUT_PULLUP);
+    changeState(DHT11_STATE_POWER_UP, millis());
+    dht11_reading_requested = true; // First acquisition right after the power up delay
+    return true;
 }
 
-float dht11_readTemperature()
+void dht11_startReading()
 {
-    return dht.readTemperature();
+    dht11_reading_requested = true;
+}
+
+bool dht11_isReadingReady()
+{
+    return (DHT11_STATE_IDLE == dht11_state && !dht11_reading_requested) ? DHT11_READING_READY : DHT11_READING_IN_PROGRESS;
+}
+
+void dht11_loop(unsigned long current_millis)
+{
+    unsigned long elapsed = current_millis - dht11_state_millis;
+
+    switch(dht11_state)
+    {
+    case DHT11_STATE_POWER_UP:
+        if(elapsed >= DHT11_POWER_UP_DELAY_MS)
+        {
+            changeState(DHT11_STATE_IDLE, current_millis - DHT11_MIN_READ_INTERVAL_MS); // Allow the first read immediately
+        }
+        break;
+
+    case DHT11_STATE_IDLE:
+        if(dht11_reading_requested && elapsed >= DHT11_MIN_READ_INTERVAL_MS)
+        {
+            dht11_reading_requested = false;
+            // Hold the data line low to wake up the sensor
+            pinMode(SENSORS_DHT11_PIN, OUTPUT);
+            digitalWrite(SENSORS_DHT11_PIN, LOW);
+            changeState(DHT11_STATE_START_SIGNAL, current_millis);
+        }
+        break;
+
+    case DHT11_STATE_START_SIGNAL:
+        if(elapsed >= DHT11_START_SIGNAL_MS)
+        {
+            dht11_num_of_edges = 0u;
+            // The start signal latched a falling edge, the mode stays FALLING after the last detach
+            EIFR = _BV(INTF0 + digitalPinToInterrupt(SENSORS_DHT11_PIN));
+            // Capture is armed before the line is released, the release itself is a rising edge
+            attachInterrupt(digitalPinToInterrupt(SENSORS_DHT11_PIN), onFallingEdge, FALLING);
+            pinMode(SENSORS_DHT11_PIN, INPUT_PULLUP);
+            changeState(DHT11_STATE_RECEIVING, current_millis);
+        }
+        break;
+
+    case DHT11_STATE_RECEIVING:
+        if(DHT11_FRAME_EDGES <= dht11_num_of_edges || elapsed >= DHT11_RECEIVE_TIMEOUT_MS)
+        {
+            finishReading();
+            changeState(DHT11_STATE_IDLE, current_millis);
+        }
+        break;
+
+    default:
+        break;
+    }
 }
 
-float dht11_readHumidity()
+unsigned long dht11_getIdleTime(unsigned long current_millis)
 {
-    return dht.readHumidity();
+    unsigned long wait_ms = INPUT_IDLE_FOREVER;
+
+    switch(dht11_state)
+    {
+    case DHT11_STATE_POWER_UP:
+        wait_ms = DHT11_POWER_UP_DELAY_MS;
+        break;
+
+    case DHT11_STATE_IDLE:
+        if(dht11_reading_requested)
+        {
+            wait_ms = DHT11_MIN_READ_INTERVAL_MS;
+        }
+        break;
+
+    case DHT11_STATE_START_SIGNAL:
+        wait_ms = DHT11_START_SIGNAL_MS;
+        break;
+
+    case DHT11_STATE_RECEIVING:
+        wait_ms = (DHT11_FRAME_EDGES <= dht11_num_of_edges) ? 0u : DHT11_RECEIVE_TIMEOUT_MS;
+        break;
+
+    default:
+        break;
+    }
+
+    unsigned long elapsed = current_millis - dht11_state_millis;
+    if(INPUT_IDLE_FOREVER != wait_ms)
+    {
+        wait_ms = (elapsed >= wait_ms) ? 0u : (wait_ms - elapsed);
+    }
+    return wait_ms;
 }
-/* *************************************** */
\ No newline at end of file
+
+bool dht11_decodeFrame(const uint16_t *falling_edges_us, uint8_t num_of_edges, dht11_snapshot_ts *snapshot)
+{
+    if(DHT11_FRAME_EDGES > num_of_edges)
+    {
+        return DHT11_FRAME_INVALID; // Frame is incomplete
+    }
+
+    // Unsigned 16-bit differences stay correct when micros() wraps within the frame
+    uint16_t response_period = falling_edges_us[1] - falling_edges_us[0];
+    if(DHT11_RESPONSE_PERIOD_MIN_US > response_period || DHT11_RESPONSE_PERIOD_MAX_US < response_period)
+    {
+        return DHT11_FRAME_INVALID; // First edge does not belong to a sensor response
+    }
+
+    uint8_t frame[DHT11_FRAME_BYTES] = {0u};
+    for (uint8_t bit = 0u; bit < DHT11_FRAME_BITS; bit++)
+    {
+        uint16_t bit_period = falling_edges_us[DHT11_RESPONSE_EDGES + bit] - falling_edges_us[DHT11_RESPONSE_EDGES + bit - 1u];
+        if(DHT11_BIT_PERIOD_MIN_US > bit_period || DHT11_BIT_PERIOD_MAX_US < bit_period)
+        {
+            return DHT11_FRAME_INVALID; // Glitch or missed edge
+        }
+        // Bits are sent MSB first, a long high phase means 1
+        frame[bit / 8u] = (uint8_t)((frame[bit / 8u] << 1u) | ((DHT11_BIT_ONE_THRESHOLD_US < bit_period) ? 1u : 0u));
+    }
+
+    uint8_t checksum = (uint8_t)(frame[DHT11_HUMIDITY_BYTE] + frame[DHT11_HUMIDITY_DECIMAL_BYTE] +
+                                 frame[DHT11_TEMPERATURE_BYTE] + frame[DHT11_TEMPERATURE_DECIMAL_BYTE]);
+    if(checksum != frame[DHT11_CHECKSUM_BYTE])
+    {
+        return DHT11_FRAME_INVALID;
+    }
+
+    snapshot->humidity = frame[DHT11_HUMIDITY_BYTE] * SENSORS_VALUE_ONE + frame[DHT11_HUMIDITY_DECIMAL_BYTE] * DHT11_DECIMAL_FACTOR;
+
+    sensors_value_t temperature = frame[DHT11_TEMPERATURE_BYTE] * SENSORS_VALUE_ONE;
+    if(frame[DHT11_TEMPERATURE_DECIMAL_BYTE] & DHT11_TEMPERATURE_NEGATIVE_MASK)
+    {
+        temperature = -SENSORS_VALUE_ONE - temperature; // Sensors with negative temperature support count down from -1
+    }
+    snapshot->temperature = temperature + (frame[DHT11_TEMPERATURE_DECIMAL_BYTE] & DHT11_TEMPERATURE_DECIMAL_MASK) * DHT11_DECIMAL_FACTOR;
+
+    return DHT11_FRAME_VALID;
+}
+
+sensors_value_t dht11_readTemperature()
+{
+    return dht11_snapshot.temperature;
+}
+
+sensors_value_t dht11_readHumidity()
+{
+    return dht11_snapshot.humidity;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void onFallingEdge()
+{
+    uint8_t index = dht11_num_of_edges;
+    if(DHT11_FRAME_EDGES > index)
+    {
+        dht11_edges_us[index] = (uint16_t)micros();
+        dht11_num_of_edges = index + 1u;
+    }
+}
+
+static void changeState(dht11_state_te state, unsigned long current_millis)
+{
+    dht11_state = state;
+    dht11_state_millis = current_millis;
+}
+
+static void finishReading()
+{
+    detachInterrupt(digitalPinToInterrupt(SENSORS_DHT11_PIN));
+
+    // Interrupt is detached, the buffer can be copied without locking
+    uint16_t edges_us[DHT11_FRAME_EDGES];
+    uint8_t num_of_edges = dht11_num_of_edges;
+    for (uint8_t index = 0u; index < num_of_edges; index++)
+    {
+        edges_us[index] = dht11_edges_us[index];
+    }
+
+    if(DHT11_FRAME_VALID != dht11_decodeFrame(edges_us, num_of_edges, &dht11_snapshot))
+    {
+        // Failed acquisition is reported through invalid values of the channels
+        dht11_snapshot.temperature = SENSORS_VALUE_INVALID;
+        dht11_snapshot.humidity = SENSORS_VALUE_INVALID;
+    }
+}
+/* *************************************** */
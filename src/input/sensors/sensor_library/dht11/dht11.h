@@ -2,29 +2,139 @@
 #define DHT11_H
 
 #include <Arduino.h>
-#include <DHT.h>
 #include "../sensors_config.h"
+#include "../../../input_types.h"
 
+/* Protocol timing */
+#define DHT11_POWER_UP_DELAY_MS          (unsigned long)(1000u) /** Time the sensor needs after power up before the first read */
+#define DHT11_MIN_READ_INTERVAL_MS       (unsigned long)(1000u) /** Minimum time between two acquisitions */
+#define DHT11_START_SIGNAL_MS            (unsigned long)(20u)   /** Duration of the low start signal, at least 18 ms */
+#define DHT11_RECEIVE_TIMEOUT_MS         (unsigned long)(10u)   /** Time after the start signal in which the whole frame must arrive */
+
+/* Frame layout */
+#define DHT11_FRAME_BYTES                (uint8_t)(5u)   /** Humidity (2), temperature (2) and checksum (1) */
+#define DHT11_FRAME_BITS                 (uint8_t)(40u)
+#define DHT11_RESPONSE_EDGES             (uint8_t)(2u)   /** Falling edges of the sensor response, before the first data bit */
+#define DHT11_FRAME_EDGES                (uint8_t)(DHT11_RESPONSE_EDGES + DHT11_FRAME_BITS) /** Falling edges of a complete frame */
+#define DHT11_HUMIDITY_BYTE              (uint8_t)(0u)
+#define DHT11_HUMIDITY_DECIMAL_BYTE      (uint8_t)(1u)
+#define DHT11_TEMPERATURE_BYTE           (uint8_t)(2u)
+#define DHT11_TEMPERATURE_DECIMAL_BYTE   (uint8_t)(3u)
+#define DHT11_CHECKSUM_BYTE              (uint8_t)(4u)
+#define DHT11_TEMPERATURE_NEGATIVE_MASK  (uint8_t)(0x80u)
+#define DHT11_TEMPERATURE_DECIMAL_MASK   (uint8_t)(0x0Fu)
+#define DHT11_DECIMAL_FACTOR             (sensors_value_t)(SENSORS_VALUE_ONE / 10)
+
+/**
+ * Falling edge to falling edge periods in microseconds. The sensor answers with 80 us low and 80 us high,
+ * every bit is 50 us low followed by 26-28 us high for a 0 or 70 us high for a 1.
+ */
+#define DHT11_RESPONSE_PERIOD_MIN_US     (uint16_t)(120u)
+#define DHT11_RESPONSE_PERIOD_MAX_US     (uint16_t)(200u)
+#define DHT11_BIT_PERIOD_MIN_US          (uint16_t)(50u)
+#define DHT11_BIT_PERIOD_MAX_US          (uint16_t)(160u)
+#define DHT11_BIT_ONE_THRESHOLD_US       (uint16_t)(100u)
+
+/* Frame decode results */
+#define DHT11_FRAME_VALID                (bool)(true)
+#define DHT11_FRAME_INVALID              (bool)(false)
+
+/* Reading ready poll results */
+#define DHT11_READING_READY              (bool)(true)
+#define DHT11_READING_IN_PROGRESS        (bool)(false)
+
+/**
+ * @brief Values of one DHT11 acquisition, shared by the temperature and humidity channels.
+ */
+typedef struct
+{
+    sensors_value_t temperature; // Temperature in Celsius
+    sensors_value_t humidity;    // Relative humidity in percent
+} dht11_snapshot_ts;
+
+/**
+ * @brief States of the non-blocking acquisition.
+ */
+typedef enum
+{
+    DHT11_STATE_POWER_UP,      // Waiting for the sensor to settle after power up
+    DHT11_STATE_IDLE,          // No acquisition in progress
+    DHT11_STATE_START_SIGNAL,  // Data line is held low to wake up the sensor
+    DHT11_STATE_RECEIVING      // Data line is released, falling edges are captured by the interrupt
+} dht11_state_te;
 
 /**
  * @brief Initializes the DHT11 sensor.
- * 
- * Prepares the DHT11 sensor for reading temperature and humidity.
+ *
+ * Prepares the data pin and schedules the first acquisition after the power up delay.
+ * The data pin must support an external interrupt (pin 2 or 3 on the ATmega328).
+ *
+ * @return bool true if the data pin can be used, false otherwise.
+ */
+bool dht11_init();
+
+/**
+ * @brief Requests a new acquisition of both DHT11 channels.
+ *
+ * Does not block. The start signal is sent from dht11_loop() as soon as the minimum
+ * read interval allows it, the frame is captured by the pin interrupt and decoded in dht11_loop().
+ * Until the new acquisition is finished, the read functions return the previous snapshot.
+ */
+void dht11_startReading();
+
+/**
+ * @brief Checks whether no acquisition is pending or in progress.
+ *
+ * @return bool DHT11_READING_READY if the snapshot holds the result of the last requested acquisition,
+ *              DHT11_READING_IN_PROGRESS otherwise.
+ */
+bool dht11_isReadingReady();
+
+/**
+ * @brief Advances the acquisition state machine.
+ *
+ * NEEDS TO BE CALLED IN A LOOP, every few milliseconds.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ */
+void dht11_loop(unsigned long current_millis);
+
+/**
+ * @brief Returns how long dht11_loop() has nothing to do.
+ *
+ * Lets the caller sleep through the power up delay, the minimum read interval and the start signal
+ * instead of polling. Requests made in the meantime shorten it, ask again after dht11_startReading().
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return unsigned long Milliseconds until the next state change, 0 if it is due,
+ *                       INPUT_IDLE_FOREVER if no acquisition is requested.
+ */
+unsigned long dht11_getIdleTime(unsigned long current_millis);
+
+/**
+ * @brief Decodes a captured DHT11 frame.
+ *
+ * Works only on the captured timestamps, so it can be fed with recorded edge timings.
+ *
+ * @param falling_edges_us Timestamps of the falling edges in microseconds, only the lower 16 bits are used.
+ * @param num_of_edges Number of captured edges.
+ * @param snapshot Pointer to the structure where the decoded values are stored.
+ * @return bool DHT11_FRAME_VALID if the timing and the checksum are correct, DHT11_FRAME_INVALID otherwise.
  */
-void dht11_init();
+bool dht11_decodeFrame(const uint16_t *falling_edges_us, uint8_t num_of_edges, dht11_snapshot_ts *snapshot);
 
 /**
- * @brief Reads the temperature from the DHT11 sensor.
- * 
- * @return float Temperature in Celsius.
+ * @brief Returns the temperature of the last DHT11 acquisition.
+ *
+ * @return sensors_value_t Temperature in Celsius, SENSORS_VALUE_INVALID if the last acquisition failed.
  */
-float dht11_readTemperature();
+sensors_value_t dht11_readTemperature();
 
 /**
- * @brief Reads the humidity from the DHT11 sensor.
- * 
- * @return float Humidity as a percentage.
+ * @brief Returns the humidity of the last DHT11 acquisition.
+ *
+ * @return sensors_value_t Humidity as a percentage, SENSORS_VALUE_INVALID if the last acquisition failed.
  */
-float dht11_readHumidity();
+sensors_value_t dht11_readHumidity();
 
-#endif
\ No newline at end of file
+#endif
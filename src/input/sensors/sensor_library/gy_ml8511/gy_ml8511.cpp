@@ -1,20 +1,38 @@
 #include "gy_ml8511.h"
 
+/* STATIC GLOBAL VARIABLES */
+// Channel of the analog pin in the ADC sampler
+static uint8_t gy_ml8511_adc_channel = ADC_SAMPLER_NO_CHANNEL;
+/* *************************************** */
+
 /* EXPORTED FUNCTIONS */
 void gy_ml8511_init()
 {
   pinMode(SENSORS_GY_ML8511_PIN_ANALOG, INPUT);
+  gy_ml8511_adc_channel = adc_sampler_attach(SENSORS_GY_ML8511_PIN_ANALOG);
 }
 
-float gy_ml8511_readUvIntensity()
+sensors_value_t gy_ml8511_readUvIntensity()
 {
-  int analog_value = analogRead(SENSORS_GY_ML8511_PIN_ANALOG);
-  float uv_voltage = ((float)analog_value / GY_ML8511_ANALOG_INPUT_MAX) * GY_ML8511_VCC_VOLTAGE;  //Convert to voltage
-  
-  // Convert voltage to intensity (UV intensity in mW/cm^2)
-  float calculated_intensity = (float)map(uv_voltage, GY_ML8511_OUTPUT_VOLTAGE_MIN, GY_ML8511_OUTPUT_VOLTAGE_MAX, 
-                                   SENSORS_GYML8511_UV_MIN, SENSORS_GYML8511_UV_MAX);  // range from datasheet
+  uint16_t analog_value = adc_sampler_read(gy_ml8511_adc_channel);
+  if(ADC_SAMPLER_NO_VALUE == analog_value)
+  {
+    return SENSORS_VALUE_INVALID; // Nothing sampled yet
+  }
+#ifdef SENSORS_FIXED_POINT_USED
+  constexpr sensors_value_t uv_min = sensors_toValue(SENSORS_GYML8511_UV_MIN);
+  constexpr sensors_value_t uv_max = sensors_toValue(SENSORS_GYML8511_UV_MAX);
+  int32_t uv_millivolts = ((int32_t)analog_value * GY_ML8511_VCC_MILLIVOLTS) / ADC_SAMPLER_FULL_SCALE; // Convert to voltage
+
+  // Convert voltage to intensity (UV intensity in mW/cm^2), range from datasheet
+  return (uv_millivolts - GY_ML8511_OUTPUT_MILLIVOLTS_MIN) * (uv_max - uv_min) /
+         (GY_ML8511_OUTPUT_MILLIVOLTS_MAX - GY_ML8511_OUTPUT_MILLIVOLTS_MIN) + uv_min;
+#else
+  float uv_voltage = ((float)analog_value / ADC_SAMPLER_FULL_SCALE) * GY_ML8511_VCC_VOLTAGE;  //Convert to voltage
 
-  return calculated_intensity;
+  // Convert voltage to intensity (UV intensity in mW/cm^2), range from datasheet. map() works on long and would cut the volts.
+  return (uv_voltage - GY_ML8511_OUTPUT_VOLTAGE_MIN) * (SENSORS_GYML8511_UV_MAX - SENSORS_GYML8511_UV_MIN) /
+         (GY_ML8511_OUTPUT_VOLTAGE_MAX - GY_ML8511_OUTPUT_VOLTAGE_MIN) + SENSORS_GYML8511_UV_MIN;
+#endif
 }
 /* *************************************** */
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../../../input_types.h"
+#include "../adc_sampler/adc_sampler.h"
 
 /* Minimum output voltage of the GY-ML8511 UV sensor (in volts) */
 #define GY_ML8511_OUTPUT_VOLTAGE_MIN    (float)(0.99)
@@ -10,26 +12,29 @@
 /* Maximum output voltage of the GY-ML8511 UV sensor (in volts) */
 #define GY_ML8511_OUTPUT_VOLTAGE_MAX    (float)(2.9)
 
-/* Maximum analog input value for the Arduino ADC (10-bit resolution, range 0-1023) */
-#define GY_ML8511_ANALOG_INPUT_MAX      (int)(1023)
-
 /* Supply voltage for the GY-ML8511 UV sensor, typically 3.3V */
 #define GY_ML8511_VCC_VOLTAGE           (float)(3.3)
 
+/* Same voltages in millivolts, used in fixed-point mode */
+#define GY_ML8511_OUTPUT_MILLIVOLTS_MIN (int32_t)(990)
+#define GY_ML8511_OUTPUT_MILLIVOLTS_MAX (int32_t)(2900)
+#define GY_ML8511_VCC_MILLIVOLTS        (int32_t)(3300)
+
 /**
  * @brief Initializes the GY-ML8511 UV sensor.
  * 
- * Sets the analog pin for reading UV intensity as input.
+ * Sets the analog pin for reading UV intensity as input and attaches it to the ADC sampler.
  */
 void gy_ml8511_init();
 
 /**
  * @brief Reads the UV intensity from the GY-ML8511 sensor.
  * 
- * Converts the analog reading to a voltage and then maps it to UV intensity.
+ * Converts the oversampled analog value to a voltage and then maps it linearly to UV intensity.
+ * In fixed-point mode the voltage is calculated in millivolts and the whole conversion is integer arithmetic.
  * 
- * @return float UV intensity in mW/cm^2.
+ * @return sensors_value_t UV intensity in mW/cm^2, SENSORS_VALUE_INVALID until the first value is sampled.
  */
-float gy_ml8511_readUvIntensity();
+sensors_value_t gy_ml8511_readUvIntensity();
 
 #endif
\ No newline at end of file
@@ -1,28 +1,51 @@
 #include "mq135.h"
 
+/* STATIC GLOBAL VARIABLES */
+// Channel of the analog pin in the ADC sampler
+static uint8_t mq135_adc_channel = ADC_SAMPLER_NO_CHANNEL;
+/* *************************************** */
+
+/* PPM LOOKUP TABLE */
+#if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
+static_assert(SENSORS_MQ135_R_ZERO >= MQ135_R_ZERO_MINIMUM, "SENSORS_MQ135_R_ZERO is not a valid R0 resistance");
+
+/**
+ * @brief MQ135 calibration curve, evaluated at compile time for every lookup table entry.
+ *
+ * PPM = A * (ADC / R0)^-B, calculated as e^(ln(A) - B * ln(ADC / R0)).
+ * The lowest ADC value is moved one step up to avoid division by zero.
+ *
+ * @param raw_adc The raw ADC value.
+ * @return sensors_value_t Gas concentration in PPM.
+ */
+static constexpr sensors_value_t mq135CurveValue(uint16_t raw_adc)
+{
+  return mq_table_fromLn(mq_table_ln(SENSORS_MQ135_PARAMETER_A) - SENSORS_MQ135_PARAMETER_B *
+                         mq_table_ln((float)((MQ135_ANALOG_INPUT_MIN == raw_adc) ? MQ135_ANALOG_INPUT_MIN_VALID : raw_adc) / SENSORS_MQ135_R_ZERO));
+}
+
+/* Generated from the calibration macros, rebuilt with every change of them */
+typedef mq_table_ts<mq135CurveValue> mq135_ppm_table;
+#endif
+/* *************************************** */
+
 
 /* EXPORTED FUNCTIONS */
 void mq135_init()
 {
   pinMode(SENSORS_MQ135_PIN_ANALOG, INPUT);
+  mq135_adc_channel = adc_sampler_attach(SENSORS_MQ135_PIN_ANALOG);
 }
 
-float mq135_readPPM()
+sensors_value_t mq135_readPPM()
 {
-  float ppm = MQ135_INVALID_VALUE;
+  sensors_value_t ppm = SENSORS_VALUE_INVALID;
 #if defined(SENSORS_MQ135_PARAMETER_A) && defined(SENSORS_MQ135_PARAMETER_B) && defined(SENSORS_MQ135_R_ZERO)
-  int sensor_analog_reading = analogRead(SENSORS_MQ135_PIN_ANALOG); // Read the analog value from the MQ135 sensor pin
+  uint16_t sensor_analog_reading = adc_sampler_read(mq135_adc_channel); // Oversampled value of the MQ135 sensor pin, does not wait for the ADC
   
-  if(MQ135_ANALOG_INPUT_MIN <= sensor_analog_reading && 
-     MQ135_ANALOG_INPUT_MAX >= sensor_analog_reading && // Check for valid analog read
-     SENSORS_MQ135_R_ZERO >= MQ135_R_ZERO_MINIMUM)      // Check for valid R0 resistance and avoid division by 0
+  if(ADC_SAMPLER_NO_VALUE != sensor_analog_reading) // Check for valid analog read
   {
-    if(MQ135_ANALOG_INPUT_MIN == sensor_analog_reading)
-    {
-      sensor_analog_reading = MQ135_ANALOG_INPUT_MIN_VALID; // To avoid division by 0
-    }
-    float ratio = (float)sensor_analog_reading / SENSORS_MQ135_R_ZERO;
-    ppm = SENSORS_MQ135_PARAMETER_A * pow(ratio, -SENSORS_MQ135_PARAMETER_B); // Calculate PPM with formula
+    ppm = mq_table_lookup(mq135_ppm_table::values, sensor_analog_reading); // Precomputed calibration curve
   }
 #endif
   return ppm; // Return calculated PPM or invalid value
@@ -32,14 +55,14 @@ float mq135_readResistanceForCalibration()
 {
   float calculated_resistance = MQ135_INVALID_VALUE; // If analog read is not valid
 
-  int sensor_analog_reading = analogRead(SENSORS_MQ135_PIN_ANALOG);
-  if(MQ135_ANALOG_INPUT_MIN <= sensor_analog_reading && MQ135_ANALOG_INPUT_MAX >= sensor_analog_reading) // Check for valid analog read
+  uint16_t sensor_analog_reading = adc_sampler_read(mq135_adc_channel);
+  if(ADC_SAMPLER_NO_VALUE != sensor_analog_reading) // Check for valid analog read
   {
     if(MQ135_ANALOG_INPUT_MIN == sensor_analog_reading)
     {
       sensor_analog_reading = MQ135_ANALOG_INPUT_MIN_VALID; // To avoid division by 0
     }
-    calculated_resistance = (((float)MQ135_ANALOG_INPUT_MAX / sensor_analog_reading) - 1) * MQ135_LOAD_RESISTANCE_VAL; // Calculate resistance
+    calculated_resistance = (((float)ADC_SAMPLER_FULL_SCALE / sensor_analog_reading) - 1) * MQ135_LOAD_RESISTANCE_VAL; // Calculate resistance
   }
   return calculated_resistance;
 }
@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../../../input_types.h"
+#include "../mq_table/mq_table.h"
+#include "../adc_sampler/adc_sampler.h"
 
 /* Load resistance in ohms which is connected to from analog output of sensor to ground (default value for the module) */
 #define MQ135_LOAD_RESISTANCE_VAL           (float)(10000)
@@ -30,15 +33,14 @@ void mq135_init();
 /**
  * @brief Reads the PPM value from the MQ135 sensor.
  * 
- * This function calculates the Parts Per Million (PPM) concentration of gases
- * based on the analog reading and the defined sensor parameters. It ensures
- * that the analog reading and sensor configuration are valid before performing
- * the calculation.
+ * This function converts the analog reading into the Parts Per Million (PPM) concentration
+ * of gases with a lookup table, which is generated at compile time from the defined sensor
+ * parameters (see mq_table.h). An invalid R0 resistance is rejected at compile time.
  * 
- * @return The calculated PPM value or `MQ135_INVALID_VALUE` if parameters are
+ * @return The calculated PPM value or `SENSORS_VALUE_INVALID` if parameters are
  * not defined or invalid.
  */
-float mq135_readPPM();
+sensors_value_t mq135_readPPM();
 
 /**
  * @brief Calculates the sensor's \( R0 \) value during calibration.
@@ -47,10 +49,10 @@ float mq135_readPPM();
  * based on the analog input value during the calibration phase. The \( R0 \) value 
  * is crucial for determining the gas concentration later during normal operation. 
  * 
- * The function ensures the analog reading is within valid ranges and avoids division by zero. 
- * Unlike other gas sensors (e.g., MQ7), this function uses only one sample because the MQ135 
- * is designed for air quality monitoring in stable environments. Gas concentration does not 
- * fluctuate rapidly in such use cases, making multiple samples unnecessary.
+ * The function ensures the analog reading is valid and avoids division by zero. 
+ * Unlike other gas sensors (e.g., MQ7), this function uses only one value because the MQ135 
+ * is designed for air quality monitoring in stable environments. The value from the ADC sampler 
+ * is already an average of 4^n conversions, so multiple samples are unnecessary.
  * 
  * @return float - The calculated \( R0 \) resistance (Ohms) or NAN if the input reading is invalid.
  */
@@ -3,21 +3,49 @@
 /* STATIC GLOBAL VARIABLES */
 // Global variable for heater status
 static bool mq7_is_heater_hot = MQ7_HEATER_IS_OFF;
+// Time of the last transition from high to low or low to high
+static unsigned long mq7_heater_switch_millis = 0;
+// Channel of the analog pin in the ADC sampler
+static uint8_t mq7_adc_channel = ADC_SAMPLER_NO_CHANNEL;
 /* *************************************** */
 
-/* STATIC FUNCTION PROTOTYPES */
-/** 
- * @brief Converts raw ADC reading to resistance value.
- * 
- * This function takes the raw ADC value from the MQ7 sensor and converts it to a resistance value
- * using the sensor's voltage and a predefined load resistance. It avoids division by zero by adjusting 
- * the raw ADC value when it's equal to the minimum.
- * 
- * @param raw_adc The raw ADC value from the MQ7 sensor.
- * @return float The calculated resistance in ohms.
+/* CO PPM LOOKUP TABLE */
+#if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2)
+/**
+ * @brief Calculates Rs / R0 for a raw ADC value at compile time.
+ *
+ * Rs = (VCC - Vout) / Vout * RL, which is (1023 - ADC) / ADC * RL. The lowest and the highest
+ * ADC value are moved one step inwards to avoid division by zero and a zero resistance.
+ *
+ * @param raw_adc The raw ADC value.
+ * @return float The resistance ratio.
+ */
+static constexpr float mq7ResistanceRatio(uint16_t raw_adc)
+{
+  return (float)(MQ7_ANALOG_INPUT_MAX - ((MQ7_ANALOG_INPUT_MAX <= raw_adc) ? MQ7_ANALOG_INPUT_MAX - MQ7_ANALOG_INPUT_MIN_VALID : raw_adc)) /
+         ((MQ7_ANALOG_INPUT_MIN == raw_adc) ? MQ7_ANALOG_INPUT_MIN_VALID : raw_adc) * MQ7_LOAD_RESISTANCE_VAL / SENSORS_MQ7_R_ZERO;
+}
+
+/**
+ * @brief MQ7 calibration curve, evaluated at compile time for every lookup table entry.
+ *
+ * PPM = 10^((log10(ratio) - C1) / C2), calculated with natural logarithms.
+ *
+ * @param raw_adc The raw ADC value.
+ * @return sensors_value_t CO concentration in PPM.
  */
-static float convertToResistance(int raw_adc);
+static constexpr sensors_value_t mq7CurveValue(uint16_t raw_adc)
+{
+  return mq_table_fromLn((mq_table_ln(mq7ResistanceRatio(raw_adc)) - SENSORS_MQ7_CALCULATION_CONSTANT_1 * MQ_TABLE_LN10) /
+                         SENSORS_MQ7_CALCULATION_CONSTANT_2);
+}
 
+/* Generated from the calibration macros, rebuilt with every change of them */
+typedef mq_table_ts<mq7CurveValue> mq7_ppm_table;
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
 /** 
  * @brief Turns the heater on for the MQ7 sensor.
  * 
@@ -43,21 +71,19 @@ static bool heaterOff();
 void mq7_init()
 {
   pinMode(SENSORS_MQ7_PIN_ANALOG, INPUT);
+  mq7_adc_channel = adc_sampler_attach(SENSORS_MQ7_PIN_ANALOG);
   pinMode(SENSORS_MQ7_PIN_PWM_HEATER, OUTPUT);
   mq7_is_heater_hot = heaterOn(); //Start heating
 }
 
-float mq7_readPPM()
+sensors_value_t mq7_readPPM()
 {
-  float coPPM = MQ7_INVALID_VALUE; // Return value in case of not defined macros(handled by sensors module)
+  sensors_value_t coPPM = SENSORS_VALUE_INVALID; // Return value in case of not defined macros(handled by sensors module)
 #if defined(SENSORS_MQ7_R_ZERO) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_1) && defined(SENSORS_MQ7_CALCULATION_CONSTANT_2) // All parameters must be defined
-  int raw_analog_read = analogRead(SENSORS_MQ7_PIN_ANALOG);
-  if(raw_analog_read >= MQ7_ANALOG_INPUT_MIN && raw_analog_read <= MQ7_ANALOG_INPUT_MAX) // Check for valid analog read
+  uint16_t analog_value = adc_sampler_read(mq7_adc_channel); // Oversampled, does not wait for the ADC
+  if(ADC_SAMPLER_NO_VALUE != analog_value) // Check for valid analog read
   {
-    float resistance_under_CO = convertToResistance(raw_analog_read); // Convert analog read to resistance in ohms
-    float ratio = resistance_under_CO / SENSORS_MQ7_R_ZERO; // Calculate ratio based on calibrated resistance in clear air
-    /* Function for calculating PPM */
-    coPPM = pow(MQ7_CALCULATION_POW_BASE_CONSTANT, ((log10(ratio) - SENSORS_MQ7_CALCULATION_CONSTANT_1) / (SENSORS_MQ7_CALCULATION_CONSTANT_2)));
+    coPPM = mq_table_lookup(mq7_ppm_table::values, analog_value); // Precomputed calibration curve
   }
 #endif
   return coPPM;
@@ -67,16 +93,16 @@ float mq7_readResistanceForCalibration()
 {
   float calculated_resistance = MQ7_INVALID_VALUE; // Default invalid value
 
-  int sensor_analog_reading = analogRead(SENSORS_MQ7_PIN_ANALOG);
+  uint16_t sensor_analog_reading = adc_sampler_read(mq7_adc_channel);
   
-  if (MQ7_ANALOG_INPUT_MIN <= sensor_analog_reading && sensor_analog_reading <= MQ7_ANALOG_INPUT_MAX) // Ensure valid reading
+  if (ADC_SAMPLER_NO_VALUE != sensor_analog_reading) // Ensure valid reading
   {
-    if (sensor_analog_reading == MQ7_ANALOG_INPUT_MIN)
+    if (MQ7_ANALOG_INPUT_MIN == sensor_analog_reading)
     {
       sensor_analog_reading = MQ7_ANALOG_INPUT_MIN_VALID; // Avoid division by zero
     }
     
-    calculated_resistance = (((float)MQ7_ANALOG_INPUT_MAX / sensor_analog_reading) - 1) * MQ7_LOAD_RESISTANCE_VAL; // Calculate resistance
+    calculated_resistance = (((float)ADC_SAMPLER_FULL_SCALE / sensor_analog_reading) - 1) * MQ7_LOAD_RESISTANCE_VAL; // Calculate resistance
   }
 
   return calculated_resistance;
@@ -85,36 +111,31 @@ float mq7_readResistanceForCalibration()
 // Needs to be called in loop
 void mq7_heatingCycle(unsigned long current_millis) 
 {
-  static unsigned long previous_millis = 0;
-  unsigned long elapsed_time = current_millis - previous_millis; // Elapsed time between last transition from high to low or low to high till now
+  unsigned long elapsed_time = current_millis - mq7_heater_switch_millis; // Elapsed time between last transition from high to low or low to high till now
 
   // If the heater has been in the high state for the specified duration and is currently hot
   if (elapsed_time >= SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS && MQ7_HEATER_IS_ON == mq7_is_heater_hot) // Case heater 
   {
     mq7_is_heater_hot = heaterOff(); // Turn the heater off
-    previous_millis = current_millis; // Update the last transition time
+    mq7_heater_switch_millis = current_millis; // Update the last transition time
   } 
   // If the heater has been in the low state for the specified duration and is currently off
   else if (elapsed_time >= SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS && MQ7_HEATER_IS_OFF == mq7_is_heater_hot) 
   {
     mq7_is_heater_hot = heaterOn(); // Turn the heater on
-    previous_millis = current_millis; // Update the last transition time
+    mq7_heater_switch_millis = current_millis; // Update the last transition time
   }
 }
-/* *************************************** */
 
-/* STATIC FUNCTIONS IMPLEMENTATIONS */
-static float convertToResistance(int raw_adc) 
+unsigned long mq7_getIdleTime(unsigned long current_millis)
 {
-  if(MQ7_ANALOG_INPUT_MIN == raw_adc)
-  {
-    raw_adc += 1; // To avoid division by 0
-  }
-  float v_out = raw_adc * (MQ7_VCC_VOLTAGE / MQ7_ANALOG_INPUT_MAX);
-  float Rs = ((MQ7_VCC_VOLTAGE - v_out) / v_out) * MQ7_LOAD_RESISTANCE_VAL; // return in ohms
-  return Rs;
+  unsigned long phase_ms = (MQ7_HEATER_IS_ON == mq7_is_heater_hot) ? SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS : SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS;
+  unsigned long elapsed_time = current_millis - mq7_heater_switch_millis;
+  return (elapsed_time >= phase_ms) ? 0u : (phase_ms - elapsed_time);
 }
+/* *************************************** */
 
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
 static bool heaterOn()
 {
   analogWrite(SENSORS_MQ7_PIN_PWM_HEATER, MQ7_5V_ANALOG_OUTPUT_HEATER);   // Set heater to 5V
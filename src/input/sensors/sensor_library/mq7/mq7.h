@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include "../sensors_config.h"
+#include "../../../input_types.h"
+#include "../mq_table/mq_table.h"
+#include "../adc_sampler/adc_sampler.h"
 
 /* Maximum value of the analog input reading (10-bit ADC resolution). */
 #define MQ7_ANALOG_INPUT_MAX              (int)(1023)
@@ -19,9 +22,6 @@
 /* Analog output value for the heater at 1.4V. */
 #define MQ7_1_4V_ANALOG_OUTPUT_HEATER     (int)(71u)   
 
-/* The supply voltage of the sensor (5V). */
-#define MQ7_VCC_VOLTAGE                   (float)(5)
-
 /* Heater flags. */
 #define MQ7_HEATER_IS_ON                  (bool)(true)
 #define MQ7_HEATER_IS_OFF                 (bool)(false)
@@ -29,9 +29,6 @@
 /* Load resistance value in ohms, connected between the analog output of the sensor and ground (based on datasheet). */
 #define MQ7_LOAD_RESISTANCE_VAL           (float)(10000) // Load resistance in ohms
 
-/* Base constant for the calculation of CO PPM, used in logarithmic equation. */
-#define MQ7_CALCULATION_POW_BASE_CONSTANT (float)(10)
-
 /* Defines the invalid value for the MQ7 sensor readings */
 #define MQ7_INVALID_VALUE                 (NAN)
 
@@ -46,18 +43,18 @@ void mq7_init();
 /**
  * @brief Reads the carbon monoxide concentration in parts per million (PPM) using the MQ7 sensor.
  *
- * This function reads the analog value from the MQ7 sensor, converts it to resistance, and calculates the carbon monoxide
- * concentration in PPM based on predefined calibration constants. If the necessary constants or analog input range are 
- * not defined or invalid, the function returns NaN.
+ * This function reads the analog value from the MQ7 sensor and converts it to the carbon monoxide concentration in PPM
+ * with a lookup table, which is generated at compile time from the calibration constants (see mq_table.h).
+ * If the necessary constants or analog input range are not defined or invalid, the function returns SENSORS_VALUE_INVALID.
  *
- * @return float The carbon monoxide concentration in PPM or NaN if calibration parameters are missing or invalid.
+ * @return sensors_value_t The carbon monoxide concentration in PPM or SENSORS_VALUE_INVALID if calibration parameters are missing or invalid.
  */
-float mq7_readPPM();
+sensors_value_t mq7_readPPM();
 
 /**
  * @brief Reads the resistance of the MQ-7 sensor for calibration.
  *
- * This function performs a single ADC reading from the MQ-7 sensor, validates the reading, 
+ * This function takes the last oversampled value of the MQ-7 pin from the ADC sampler, validates it, 
  * and calculates the sensor resistance (Rs) using the voltage divider formula.
  *
  * @return The calculated sensor resistance in ohms, or MQ7_INVALID_VALUE if the reading is out of range.
@@ -74,4 +71,12 @@ float mq7_readResistanceForCalibration();
  */
 void mq7_heatingCycle(unsigned long current_millis);
 
+/**
+ * @brief Returns how long the heating cycle keeps its current phase.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return unsigned long Milliseconds until mq7_heatingCycle() switches the heater, 0 if the switch is due.
+ */
+unsigned long mq7_getIdleTime(unsigned long current_millis);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "mq_table.h"
+
+/* EXPORTED FUNCTIONS */
+sensors_value_t mq_table_lookup(const sensors_value_t *table, uint16_t adc_value)
+{
+  uint16_t index = adc_value / MQ_TABLE_INTERVAL;
+  uint8_t fraction = (uint8_t)(adc_value % MQ_TABLE_INTERVAL);
+
+  sensors_value_t lower;
+  memcpy_P(&lower, &table[index], sizeof(lower));
+  if(0u == fraction)
+  {
+    return lower; // Value hits an entry
+  }
+
+  sensors_value_t upper;
+  memcpy_P(&upper, &table[index + 1u], sizeof(upper));
+  sensors_value_t difference = upper - lower;
+#ifdef SENSORS_FIXED_POINT_USED
+  // Quotient and remainder are scaled separately, so the product never leaves 32 bits
+  return lower + (difference / MQ_TABLE_INTERVAL) * fraction + ((difference % MQ_TABLE_INTERVAL) * fraction) / MQ_TABLE_INTERVAL;
+#else
+  return lower + difference * fraction / MQ_TABLE_INTERVAL;
+#endif
+}
+/* *************************************** */
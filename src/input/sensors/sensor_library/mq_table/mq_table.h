@@ -0,0 +1,207 @@
+#ifndef MQ_TABLE_H
+#define MQ_TABLE_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "../sensors_config.h"
+#include "../../../input_types.h"
+
+/**
+ * @file mq_table.h
+ * @brief Compile-time ADC to PPM lookup tables of the MQ gas sensors.
+ *
+ * The ADC has 10 bits, so a calibration curve has only 1024 possible results. A driver describes
+ * its curve as a constexpr function of the raw ADC value, mq_table_ts evaluates it at compile time
+ * for every SENSORS_MQ_TABLE_STEP-th ADC value and stores the results in flash. A reading is one
+ * table read and a linear interpolation between two entries, no pow() or log10() at run time.
+ * The extra bits of oversampled readings (SENSORS_ADC_OVERSAMPLING_BITS) are used for the interpolation.
+ *
+ * The tables are generated from the calibration macros in sensors_config.h, they follow every change
+ * of those macros with the next build. Table size per sensor is MQ_TABLE_LEN * sizeof(sensors_value_t).
+ */
+
+/* Highest raw ADC value (10-bit ADC) */
+#define MQ_TABLE_ADC_MAX           (uint16_t)(1023u)
+/* Number of table entries, the last one closes the interpolation interval of the highest ADC values */
+#define MQ_TABLE_LEN               (uint16_t)((MQ_TABLE_ADC_MAX + 1u) / SENSORS_MQ_TABLE_STEP + 1u)
+/* Distance of two table entries in oversampled ADC units */
+#define MQ_TABLE_INTERVAL          (uint16_t)(SENSORS_MQ_TABLE_STEP << SENSORS_ADC_OVERSAMPLING_BITS)
+
+/* Entries saturate at this value, readings above it are outside of every configured range */
+#define MQ_TABLE_VALUE_MAX         (float)(2000000.0f)
+/* Entries below this value are stored as 0 */
+#define MQ_TABLE_VALUE_MIN         (float)(0.0001f)
+
+/* Constants of the compile-time math */
+#define MQ_TABLE_LN2               (float)(0.69314718f)
+#define MQ_TABLE_LN10              (float)(2.30258509f)
+#define MQ_TABLE_SERIES_TERMS      (uint8_t)(12u)
+/* Arguments of the exponential series are halved until they are below this */
+#define MQ_TABLE_EXP_SERIES_LIMIT  (float)(0.5f)
+
+static_assert(0u != SENSORS_MQ_TABLE_STEP && 0u == (SENSORS_MQ_TABLE_STEP & (SENSORS_MQ_TABLE_STEP - 1u)),
+              "SENSORS_MQ_TABLE_STEP must be a power of two");
+static_assert(32u >= SENSORS_MQ_TABLE_STEP, "SENSORS_MQ_TABLE_STEP must not exceed 32, coarser tables lose too much accuracy");
+static_assert(256u >= MQ_TABLE_INTERVAL, "Position inside an interpolation interval must fit into 8 bits");
+
+/* Calibration curve of a sensor, returns the value for a raw ADC reading. Must be constexpr. */
+typedef sensors_value_t (*mq_table_curve_t)(uint16_t raw_adc);
+
+/* COMPILE-TIME MATH */
+/**
+ * @brief Sums the series ln(x) = 2 * (y + y^3 / 3 + y^5 / 5 + ...) with y = (x - 1) / (x + 1).
+ *
+ * @param y_squared y * y.
+ * @param power The current odd power of y.
+ * @param term Index of the current term.
+ * @return float Sum of the remaining terms.
+ */
+constexpr float mq_table_lnSeries(float y_squared, float power, uint8_t term)
+{
+  return (MQ_TABLE_SERIES_TERMS <= term) ? 0.0f :
+         power / (2u * term + 1u) + mq_table_lnSeries(y_squared, power * y_squared, term + 1u);
+}
+
+/**
+ * @brief Natural logarithm for constant expressions.
+ *
+ * The argument is scaled into [1, 2] by powers of two, where the series converges quickly.
+ *
+ * @param x The argument, must be above zero.
+ * @return float ln(x).
+ */
+constexpr float mq_table_ln(float x)
+{
+  return (2.0f < x) ? mq_table_ln(x / 2.0f) + MQ_TABLE_LN2 :
+         (1.0f > x) ? mq_table_ln(x * 2.0f) - MQ_TABLE_LN2 :
+         2.0f * mq_table_lnSeries(((x - 1.0f) / (x + 1.0f)) * ((x - 1.0f) / (x + 1.0f)), (x - 1.0f) / (x + 1.0f), 0u);
+}
+
+/**
+ * @brief Sums the Taylor series of e^x.
+ *
+ * @param x The argument.
+ * @param term_value Value of the current term, x^n / n!.
+ * @param term Index of the current term.
+ * @return float Sum of the remaining terms.
+ */
+constexpr float mq_table_expSeries(float x, float term_value, uint8_t term)
+{
+  return (MQ_TABLE_SERIES_TERMS <= term) ? 0.0f :
+         term_value + mq_table_expSeries(x, term_value * x / (term + 1u), term + 1u);
+}
+
+/**
+ * @brief Squares a value, so the value is only calculated once.
+ *
+ * @param value The value.
+ * @return float value * value.
+ */
+constexpr float mq_table_square(float value)
+{
+  return value * value;
+}
+
+/**
+ * @brief Exponential function for constant expressions, e^x = (e^(x / 2))^2.
+ *
+ * @param x The argument, the result must not overflow.
+ * @return float e^x.
+ */
+constexpr float mq_table_exp(float x)
+{
+  return (MQ_TABLE_EXP_SERIES_LIMIT < x || -MQ_TABLE_EXP_SERIES_LIMIT > x) ? mq_table_square(mq_table_exp(x / 2.0f)) :
+         mq_table_expSeries(x, 1.0f, 0u);
+}
+
+/**
+ * @brief Converts the natural logarithm of a curve value into a table entry.
+ *
+ * Curves are calculated in the logarithmic domain, so huge values near the ends of the ADC range
+ * saturate before they could overflow.
+ *
+ * @param ln_value Natural logarithm of the value.
+ * @return sensors_value_t The table entry.
+ */
+constexpr sensors_value_t mq_table_fromLn(float ln_value)
+{
+  return (mq_table_ln(MQ_TABLE_VALUE_MAX) < ln_value) ? sensors_toValue(MQ_TABLE_VALUE_MAX) :
+         (mq_table_ln(MQ_TABLE_VALUE_MIN) > ln_value) ? sensors_toValue(0.0f) :
+         sensors_toValue(mq_table_exp(ln_value));
+}
+/* ********************************* */
+
+/* TABLE GENERATION */
+/* List of table indices, expanded into one curve evaluation per entry */
+template<uint16_t... indices>
+struct mq_table_indices_ts
+{
+};
+
+/* Appends a copy of the list shifted by its length, plus one index if extra_index is set */
+template<typename list, bool extra_index>
+struct mq_table_extend_indices_ts;
+
+template<uint16_t... indices>
+struct mq_table_extend_indices_ts<mq_table_indices_ts<indices...>, false>
+{
+  typedef mq_table_indices_ts<indices..., (sizeof...(indices) + indices)...> type;
+};
+
+template<uint16_t... indices>
+struct mq_table_extend_indices_ts<mq_table_indices_ts<indices...>, true>
+{
+  typedef mq_table_indices_ts<indices..., (sizeof...(indices) + indices)..., 2u * sizeof...(indices)> type;
+};
+
+/* Indices 0 to len - 1, built by doubling so that even the full table stays within the template depth */
+template<uint16_t len>
+struct mq_table_make_indices_ts
+{
+  typedef typename mq_table_extend_indices_ts<typename mq_table_make_indices_ts<len / 2u>::type, (0u != len % 2u)>::type type;
+};
+
+template<>
+struct mq_table_make_indices_ts<0u>
+{
+  typedef mq_table_indices_ts<> type;
+};
+
+/**
+ * @brief Raw ADC value of a table entry.
+ *
+ * @param index Index of the entry.
+ * @return uint16_t The ADC value, the entry behind the last ADC value uses the last ADC value.
+ */
+constexpr uint16_t mq_table_entryAdc(uint16_t index)
+{
+  return (MQ_TABLE_ADC_MAX < index * SENSORS_MQ_TABLE_STEP) ? MQ_TABLE_ADC_MAX : (uint16_t)(index * SENSORS_MQ_TABLE_STEP);
+}
+
+/* Lookup table of a curve, stored in flash */
+template<mq_table_curve_t curve, typename list = typename mq_table_make_indices_ts<MQ_TABLE_LEN>::type>
+struct mq_table_ts;
+
+template<mq_table_curve_t curve, uint16_t... indices>
+struct mq_table_ts<curve, mq_table_indices_ts<indices...>>
+{
+  static constexpr sensors_value_t values[sizeof...(indices)] PROGMEM = { curve(mq_table_entryAdc(indices))... };
+};
+
+template<mq_table_curve_t curve, uint16_t... indices>
+constexpr sensors_value_t mq_table_ts<curve, mq_table_indices_ts<indices...>>::values[sizeof...(indices)];
+/* ********************************* */
+
+/**
+ * @brief Converts an oversampled ADC value into the curve value with a lookup table.
+ *
+ * Interpolates linearly between the two entries around the value. With SENSORS_MQ_TABLE_STEP 1
+ * every ADC value has its own entry and only the extra bits of the oversampling are interpolated.
+ *
+ * @param table The values of an mq_table_ts, in program memory.
+ * @param adc_value ADC value with SENSORS_ADC_OVERSAMPLING_BITS extra bits, at most ADC_SAMPLER_FULL_SCALE.
+ * @return sensors_value_t The curve value.
+ */
+sensors_value_t mq_table_lookup(const sensors_value_t *table, uint16_t adc_value);
+
+#endif
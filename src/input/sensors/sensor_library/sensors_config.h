@@ -46,6 +46,12 @@
 #define SENSORS_MQ7_HEATER_LOW_TIMEOUT_MS             (unsigned long)(90000u)  /** Low timeout for MQ7 heater */
 #define SENSORS_MQ7_HEATER_HIGH_TIMEOUT_MS            (unsigned long)(60000u)  /** High timeout for MQ7 heater */
 
+/* Analog sampling (MQ135, MQ7, GY-ML8511 and the analog rain sensor) */
+#define SENSORS_ADC_OVERSAMPLING_BITS                 (uint8_t)(2u)            /** Extra bits of resolution (at most 3), 4^n conversions are summed per value */
+
+/* MQ lookup tables (MQ135 and MQ7) */
+#define SENSORS_MQ_TABLE_STEP                         (uint16_t)(8u)           /** ADC steps between two table entries (power of two, at most 32), 1 stores all 1024 values */
+
 /* GY-ML8511 */
 #define SENSORS_GY_ML8511_PIN_ANALOG                  (A2)  /** Analog pin for GY-ML8511 sensor */
 #define SENSORS_GYML8511_UV_MIN                       (float)(0)   /** Minimum UV for GY-ML8511 sensor */
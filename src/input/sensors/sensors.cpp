@@ -1,100 +1,47 @@
 #include "sensors.h"
 
 /* SENSOR FUNCTIONAL CONFIGURATION CATALOG */
-/* MUST BE IN THE SAME ORDER AS THE METADATA CONFIG ARRAY IN sensors_metadata.cpp */
-const sensors_functional_catalog_ts sensors_functional_catalog[] PROGMEM =
+/* Generates one functional catalog entry per configured channel, the limits are converted to sensor values at compile time */
+#define SENSORS_FUNCTIONAL_CATALOG_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  { sensors_toValue(min_value), sensors_toValue(max_value), value_function, indication_function, component, name },
+
+/* Generated from the registry in sensors_catalog.h, in the same order as the metadata catalog */
+constexpr sensors_functional_catalog_ts sensors_functional_catalog[] PROGMEM =
 {
-#ifdef DHT11_TEMPERATURE
-  { 
-    SENSORS_DHT11_TEMPERATURE_MIN,     
-    SENSORS_DHT11_TEMPERATURE_MAX,    
-    dht11_readTemperature,          
-    SENSORS_NO_INDICATION_FUNCTION,  
-    DHT11_TEMPERATURE   
-  },
-#endif
-#ifdef DHT11_HUMIDITY
-  {
-    SENSORS_DHT11_HUMIDITY_MIN,        
-    SENSORS_DHT11_HUMIDITY_MAX,       
-    dht11_readHumidity,             
-    SENSORS_NO_INDICATION_FUNCTION,  
-    DHT11_HUMIDITY
-  },
-#endif  
-#ifdef BMP280_PRESSURE
-  {
-    SENSORS_BMP280_PRESSURE_MIN,       
-    SENSORS_BMP280_PRESSURE_MAX,      
-    bmp280_readPressure,            
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BMP280_PRESSURE
-  },
-#endif  
-#ifdef BMP280_TEMPERATURE
-  {
-    SENSORS_BMP280_TEMPERATURE_MIN,    
-    SENSORS_BMP280_TEMPERATURE_MAX,   
-    bmp280_readTemperature,         
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BMP280_TEMPERATURE
-  },
-#endif  
-#ifdef BMP280_ALTITUDE
-  { 
-    SENSORS_BMP280_ALTITUDE_MIN,       
-    SENSORS_BMP280_ALTITUDE_MAX,      
-    bmp280_readAltitude,            
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BMP280_ALTITUDE
-  },
-#endif  
-#ifdef BH1750_LUMINANCE
-  {
-    SENSORS_BH1750_LUMINANCE_MIN,      
-    SENSORS_BH1750_LUMINANCE_MAX,     
-    bh1750_readLightLevel,          
-    SENSORS_NO_INDICATION_FUNCTION,  
-    BH1750_LUMINANCE
-  },
-#endif  
-#ifdef MQ135_PPM
-  { 
-    SENSORS_MQ135_PPM_MIN,             
-    SENSORS_MQ135_PPM_MAX,            
-    mq135_readPPM,                  
-    SENSORS_NO_INDICATION_FUNCTION,  
-    MQ135_PPM
-  },
-#endif  
-#ifdef MQ7_COPPM
-  { 
-    SENSORS_MQ7_PPM_MIN,               
-    SENSORS_MQ7_PPM_MAX,              
-    mq7_readPPM,                    
-    SENSORS_NO_INDICATION_FUNCTION,  
-    MQ7_COPPM
-  },
-#endif  
-#ifdef GYML8511_UV
-  { 
-    SENSORS_GYML8511_UV_MIN,           
-    SENSORS_GYML8511_UV_MAX,          
-    gy_ml8511_readUvIntensity,      
-    SENSORS_NO_INDICATION_FUNCTION,  
-    GYML8511_UV
-  },
-#endif  
-#ifdef ARDUINORAIN_RAINING
-  { 
-    SENSORS_INDICATION_NO_MIN,         
-    SENSORS_INDICATION_NO_MAX,        
-    SENSORS_NO_VALUE_FUNCTION,      
-    arduino_rain_sensor_readRaining, 
-    ARDUINORAIN_RAINING
-  },
-#endif
+  SENSORS_REGISTRY(SENSORS_FUNCTIONAL_CATALOG_ENTRY)
 };
+
+static_assert(sizeof(sensors_functional_catalog) == SENSORS_CATALOG_LEN * sizeof(sensors_functional_catalog_ts),
+              "sensors_functional_catalog[] must have one entry per configured sensor");
+static_assert(SENSORS_CATALOG_MAX_ID < (sizeof(uint16_t) * 8u), "Sensor IDs must fit into the consumed channels mask");
+/* *************************************** */
+
+/* STATIC GLOBAL VARIABLES */
+/* Channels of each component already returned since its last acquisition, one bit per sensor ID */
+static uint16_t sensors_consumed_channels[SENSORS_NUM_OF_COMPONENTS] = {SENSORS_NO_CHANNELS_CONSUMED};
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Takes a new acquisition of a component with several channels.
+ *
+ * Components with a single channel are read directly by their value or indication function
+ * and need no acquisition.
+ *
+ * @param component The component to sample.
+ */
+static void sampleComponent(uint8_t component);
+
+/**
+ * @brief Makes sure the snapshot of a component is fresh for the requested channel.
+ *
+ * A new acquisition is taken only if the channel was already returned from the current
+ * snapshot, so every channel of a component is served once per acquisition.
+ *
+ * @param component The component the channel belongs to.
+ * @param id The sensor ID of the requested channel.
+ */
+static void prepareComponentSnapshot(uint8_t component, uint8_t id);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -102,11 +49,17 @@ control_error_code_te sensors_init(uint8_t sensor)
 {
   switch(sensor)
   {
+#ifdef DHT11_COMPONENT
     // DHT11
     case DHT11_COMPONENT:
-      dht11_init();
+      if(!dht11_init())
+      {
+        return ERROR_CODE_INIT_FAILED;
+      }
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef BMP280_COMPONENT
     // BMP280
     case BMP280_COMPONENT:
       if(!bmp280_init())
@@ -114,7 +67,9 @@ control_error_code_te sensors_init(uint8_t sensor)
         return ERROR_CODE_INIT_FAILED;
       }
       return ERROR_CODE_NO_ERROR;
-    
+#endif
+
+#ifdef BH1750_COMPONENT
     // BH1750
     case BH1750_COMPONENT:
       if(!bh1750_init())
@@ -122,101 +77,157 @@ control_error_code_te sensors_init(uint8_t sensor)
         return ERROR_CODE_INIT_FAILED;
       }
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef MQ135_COMPONENT
     // MQ135
     case MQ135_COMPONENT:
       mq135_init();
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef MQ7_COMPONENT
     // MQ7
     case MQ7_COMPONENT:
       mq7_init();
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef GYML8511_COMPONENT
     // GYML8511
     case GYML8511_COMPONENT:
       gy_ml8511_init();
       return ERROR_CODE_NO_ERROR;
+#endif
 
+#ifdef ARDUINORAIN_COMPONENT
     // ARDUINO RAIN SENSOR
     case ARDUINORAIN_COMPONENT:
       arduino_rain_sensor_init();
       return ERROR_CODE_NO_ERROR;
+#endif
   }
 
   return ERROR_CODE_INIT_FAILED;
 }
 
-sensor_return_ts sensors_getReading(uint8_t id)
+control_error_code_te sensors_getReading(uint8_t id, sensor_reading_ts *reading)
 {
-  sensor_return_ts return_data;
-  return_data.error_code = ERROR_CODE_NO_SENSORS_CONFIGURED; // Set default error code to indicate no sensors are configured
+  control_error_code_te error_code = ERROR_CODE_NO_SENSORS_CONFIGURED; // Set default error code to indicate no sensors are configured
 
   size_t catalog_len = sensors_interface_getSensorsLen(); // Get the length of the sensor configuration array
   if(SENSORS_INTERFACE_NO_SENSORS_CONFIGURED != catalog_len) // Check if any sensors are configured
   {
-    bool is_sensor_configured = false; // Flag to check if the sensor is found
-    uint8_t sensor_index = SENSORS_FIRST_SENSOR_INDEX;
+    uint8_t sensor_index = sensors_interface_sensorIdToIndex(id); // Single table read, same index as in the metadata catalog
+    bool is_sensor_configured = (SENSORS_CATALOG_NO_INDEX != sensor_index);
 
-    for (uint8_t index = SENSORS_FIRST_SENSOR_INDEX; index < catalog_len; index++) // Iterate through sensor configurations to find the matching sensor ID
-    {
-      if(pgm_read_byte(&sensors_functional_catalog[index].sensor_id) == id)
-      {
-        // Sensor ID is found, store it and exit the loop
-        is_sensor_configured = true;
-        sensor_index = index;
-        break;
-      }
-    }
     if(SENSORS_SENSOR_CONFIGURED == is_sensor_configured) // If the sensor is configured, proceed to read its values
     {
       sensors_functional_catalog_ts current_sensor;
       memcpy_P(&current_sensor, &sensors_functional_catalog[sensor_index], sizeof(sensors_functional_catalog_ts)); // Copy the sensor configuration from program memory to a local structure
+      prepareComponentSnapshot(current_sensor.component, current_sensor.sensor_id); // Sample the component only if this channel was already served
 
       if(SENSORS_NO_VALUE_FUNCTION != current_sensor.sensor_value_function) // Check if the sensor has a value function defined
       {
-        return_data.sensor_reading.measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
-        return_data.sensor_reading.value = current_sensor.sensor_value_function();
-        if(!isnan(return_data.sensor_reading.value)) // Check if the value is valid
+        reading->measurement_type_switch = SENSORS_MEASUREMENT_TYPE_VALUE;
+        reading->value = current_sensor.sensor_value_function();
+        if(sensors_isValueValid(reading->value)) // Check if the value is valid
         {
           // Check if the value is within the acceptable range
-          if(return_data.sensor_reading.value >= current_sensor.min_value && return_data.sensor_reading.value <= current_sensor.max_value)
+          if(reading->value >= current_sensor.min_value && reading->value <= current_sensor.max_value)
           {
-            return_data.error_code = ERROR_CODE_NO_ERROR; // No error, value is valid
+            error_code = ERROR_CODE_NO_ERROR; // No error, value is valid
           }
           else
           {
-            return_data.error_code = ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR; // Value is outside the range
+            error_code = ERROR_CODE_ABNORMAL_VALUE_FROM_SENSOR; // Value is outside the range
           }
         }
         else
         {
-          return_data.error_code = ERROR_CODE_INVALID_VALUE_FROM_SENSOR; // Sensor returned an invalid value
+          error_code = ERROR_CODE_INVALID_VALUE_FROM_SENSOR; // Sensor returned an invalid value
         }
       }
       else if(SENSORS_NO_INDICATION_FUNCTION != current_sensor.sensor_indication_function) // Check if the sensor has an indication function defined
       {
-        return_data.sensor_reading.measurement_type_switch = SENSORS_MEASUREMENT_TYPE_INDICATION;
-        return_data.sensor_reading.indication = current_sensor.sensor_indication_function();
-        return_data.error_code = ERROR_CODE_NO_ERROR;
+        reading->measurement_type_switch = SENSORS_MEASUREMENT_TYPE_INDICATION;
+        reading->indication = current_sensor.sensor_indication_function();
+        error_code = ERROR_CODE_NO_ERROR;
       }
       else
       {
-        return_data.error_code = ERROR_CODE_SENSORS_MEASUREMENT_TYPE_MISSING_FUNCTION; // Error: No function defined for the sensor's measurement type
+        error_code = ERROR_CODE_SENSORS_MEASUREMENT_TYPE_MISSING_FUNCTION; // Error: No function defined for the sensor's measurement type
       }
     }
     else
     {
-      return_data.error_code = ERROR_CODE_SENSOR_NOT_FOUND; // Error: Sensor ID not found in the configuration
+      error_code = ERROR_CODE_SENSOR_NOT_FOUND; // Error: Sensor ID not found in the configuration
     }
   }
-  return return_data;
+  return error_code;
 }
 
 void sensors_loop(unsigned long current_millis)
 {
-#ifdef MQ7_COPPM
+#ifdef DHT11_COMPONENT
+  dht11_loop(current_millis);
+#endif
+#ifdef MQ7_COMPONENT
   mq7_heatingCycle(current_millis);
 #endif
 }
+
+unsigned long sensors_getIdleTime(unsigned long current_millis)
+{
+  unsigned long idle_time = INPUT_IDLE_FOREVER;
+#ifdef DHT11_COMPONENT
+  idle_time = min(idle_time, dht11_getIdleTime(current_millis));
+#endif
+#ifdef MQ7_COMPONENT
+  idle_time = min(idle_time, mq7_getIdleTime(current_millis));
+#endif
+  (void)current_millis;
+  return idle_time;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void sampleComponent(uint8_t component)
+{
+  switch(component)
+  {
+#ifdef DHT11_COMPONENT
+    case DHT11_COMPONENT:
+      // Non-blocking, the channels are served from the last finished acquisition until the new one is ready
+      if(DHT11_READING_READY == dht11_isReadingReady())
+      {
+        dht11_startReading();
+      }
+      break;
+#endif
+
+#ifdef BMP280_COMPONENT
+    case BMP280_COMPONENT:
+      (void)bmp280_sample(); // Failed acquisition is reported through NAN values of the channels
+      break;
+#endif
+
+    default:
+      break; // Single channel components are read directly
+  }
+}
+
+static void prepareComponentSnapshot(uint8_t component, uint8_t id)
+{
+  if(SENSORS_NUM_OF_COMPONENTS > component)
+  {
+    if(SENSORS_NO_CHANNELS_CONSUMED == sensors_consumed_channels[component] ||
+       (sensors_consumed_channels[component] & SENSORS_CHANNEL_BIT(id)))
+    {
+      sampleComponent(component);
+      sensors_consumed_channels[component] = SENSORS_NO_CHANNELS_CONSUMED;
+    }
+    sensors_consumed_channels[component] |= SENSORS_CHANNEL_BIT(id);
+  }
+}
 /* *************************************** */
\ No newline at end of file
@@ -42,8 +42,15 @@
 /* Flag indicating the sensor is configured in functional catalog */
 #define SENSORS_SENSOR_CONFIGURED             (bool)(true)
 
-/* Function pointer type for sensors returning a float value */
-typedef float (*sensors_sensor_value_function_t)();
+/* Number of sensor components, component values in project_settings.h must be below this */
+#define SENSORS_NUM_OF_COMPONENTS             (uint8_t)(7u)
+/* No channel of a component has been consumed since its last acquisition */
+#define SENSORS_NO_CHANNELS_CONSUMED          (uint16_t)(0u)
+/* Bit of a sensor ID in the consumed channels mask */
+#define SENSORS_CHANNEL_BIT(id)               (uint16_t)(1u << (id))
+
+/* Function pointer type for sensors returning a value, float or fixed-point (see SENSORS_FIXED_POINT_USED) */
+typedef sensors_value_t (*sensors_sensor_value_function_t)();
 /* Function pointer type for sensors returning a bool indication */
 typedef bool (*sensors_sensor_indication_function_t)();
 
@@ -55,13 +62,17 @@ typedef bool (*sensors_sensor_indication_function_t)();
  */
 typedef struct
 {
-  float min_value;                                                 /* The minimum valid value for the sensor's reading. Values below this are considered invalid. */
-  float max_value;                                                 /* The maximum valid value for the sensor's reading. Values above this are considered invalid. */
+  sensors_value_t min_value;                                       /* The minimum valid value for the sensor's reading. Values below this are considered invalid. */
+  sensors_value_t max_value;                                       /* The maximum valid value for the sensor's reading. Values above this are considered invalid. */
   sensors_sensor_value_function_t sensor_value_function;           /* Function pointer for obtaining a numerical reading from the sensor. Optional. */
   sensors_sensor_indication_function_t sensor_indication_function; /* Function pointer for obtaining a boolean status/indication from the sensor. Optional. */
+  uint8_t component;                                               /* Component the sensor belongs to. Channels of one component share one acquisition. */
   uint8_t sensor_id;                                               /* Unique identifier for the sensor. Used to reference the sensor. From config file. */
 } sensors_functional_catalog_ts;
 
+/* Fixed flash cost of one configured channel: functional entry, metadata entry and ID lookup table entry (strings not included) */
+#define SENSORS_CHANNEL_TABLE_BYTES           (sizeof(sensors_functional_catalog_ts) + sizeof(sensors_metadata_catalog_ts) + sizeof(uint8_t))
+
 /**
  * @brief Initializes a specific sensor.
  *
@@ -83,10 +94,9 @@ control_error_code_te sensors_init(uint8_t sensor);
  * Validates sensor data against configured thresholds.
  *
  * @param id The sensor ID for which the reading is requested.
+ * @param reading Pointer to the caller's reading, the value or indication is written into it.
  * 
- * @return A `sensor_return_ts` structure containing:
- *         - Sensor reading (value or indication).
- *         - Error code indicating success or failure:
+ * @return control_error_code_te Error code indicating success or failure:
  *           - ERROR_CODE_NO_ERROR: Reading successful.
  *           - ERROR_CODE_NO_SENSORS_CONFIGURED: No sensors are configured.
  *           - ERROR_CODE_SENSOR_NOT_FOUND: Sensor ID is not found in the configuration.
@@ -97,18 +107,36 @@ control_error_code_te sensors_init(uint8_t sensor);
  * @note The function verifies whether the requested sensor ID exists in the configuration.
  *       If the sensor ID is valid, it invokes the appropriate function for the sensor 
  *       (either value-based or indication-based).
+ * @note Components with several channels (DHT11, BMP280) are sampled once and all of their
+ *       channels are served from that snapshot. A new acquisition is taken only when a channel
+ *       is requested again, so one cycle through the catalog costs one acquisition per component.
+ *       DHT11 acquisitions do not block, they are finished in sensors_loop() and until then
+ *       the DHT11 channels return the previous snapshot.
  **/
-sensor_return_ts sensors_getReading(uint8_t id);
+control_error_code_te sensors_getReading(uint8_t id, sensor_reading_ts *reading);
 
 /**
  * @brief Handles periodic tasks for sensors in the main loop.
  *
  * This function manages sensor-related operations, including handling 
- * time-based processes. It should be called 
- * periodically in the main loop with the current time in milliseconds.
+ * time-based processes (DHT11 acquisition, MQ7 heating cycle). It should be called 
+ * every few milliseconds with the current time in milliseconds.
  *
  * @param current_millis The current time in milliseconds (e.g., from millis()).
  */
 void sensors_loop(unsigned long current_millis);
 
+/**
+ * @brief Returns how long sensors_loop() has nothing to do.
+ *
+ * The earliest deadline of the time-based processes: the DHT11 acquisition while one is requested
+ * or running, and the next switch of the MQ7 heater. Reading a sensor may request an acquisition,
+ * which shortens the idle time.
+ *
+ * @param current_millis The current time in milliseconds (e.g., from millis()).
+ * @return unsigned long Milliseconds until sensors_loop() must run, 0 if it is due,
+ *                       INPUT_IDLE_FOREVER if nothing is pending.
+ */
+unsigned long sensors_getIdleTime(unsigned long current_millis);
+
 #endif
\ No newline at end of file
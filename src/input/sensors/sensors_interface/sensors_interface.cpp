@@ -1,17 +1,14 @@
 #include "sensors_interface.h"
 
 /* EXPORTED FUNCTIONS */
-sensors_interface_metadata_ts sensors_interface_getSensorMetadata(uint8_t id)
+bool sensors_interface_getSensorMetadata(uint8_t id, sensors_metadata_catalog_ts *metadata)
 {
-    sensors_interface_metadata_ts metadata_return;
-    metadata_return.success_status = SENSORS_INTERFACE_STATUS_FAILED; // Default failure status
-
     // Attempt to retrieve the sensor metadata from the catalog
-    if(SENSORS_METADATA_RETRIEVE_SUCCESS == sensors_metadata_getSensorFromCatalog(id, &metadata_return.metadata))
+    if(SENSORS_METADATA_RETRIEVE_SUCCESS == sensors_metadata_getSensorFromCatalog(id, metadata))
     {
-        metadata_return.success_status = SENSORS_INTERFACE_STATUS_SUCCESS;
+        return SENSORS_INTERFACE_STATUS_SUCCESS;
     }
-    return metadata_return;
+    return SENSORS_INTERFACE_STATUS_FAILED; // Sensor is not in the catalog
 }
 
 size_t sensors_interface_getSensorsLen()
@@ -23,4 +20,9 @@ uint8_t sensors_interface_sensorIndexToId(uint8_t index)
 {
     return sensors_metadata_sensorIndexToId(index);
 }
+
+uint8_t sensors_interface_sensorIdToIndex(uint8_t id)
+{
+    return sensors_metadata_sensorIdToIndex(id);
+}
 /* *************************************** */
\ No newline at end of file
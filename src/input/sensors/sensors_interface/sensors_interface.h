@@ -23,31 +23,18 @@
 /* Indicates that no sensors are configured */
 #define SENSORS_INTERFACE_NO_SENSORS_CONFIGURED (size_t)(SENSORS_METADATA_NO_SENSORS_CONFIGURED)
 
-/**
- * @brief Structure representing the sensor metadata interface.
- * 
- * Contains metadata information for a sensor and the status of the operation
- * (whether metadata retrieval was successful or not).
- */
-typedef struct
-{
-    sensors_metadata_catalog_ts metadata; /* Metadata details for a sensor */
-    bool success_status;                  /* Status of the metadata retrieval operation */
-} sensors_interface_metadata_ts;
-
 /**
  * @brief Retrieves sensor metadata for a given sensor ID from the metadata catalog.
  * 
  * This function attempts to retrieve the metadata for a sensor by its ID.
- * If the sensor is found in the catalog, the metadata is returned along 
- * with a success status. If the sensor is not found, the success status 
- * indicates failure.
+ * If the sensor is found in the catalog, its entry is copied from program memory
+ * into the caller's structure. If the sensor is not found, the structure is not written.
  * 
  * @param id The unique identifier of the sensor to retrieve.
- * @return sensors_interface_metadata_ts A structure containing the sensor metadata 
- *                                    and success status.
+ * @param metadata Pointer to the caller's structure the metadata is copied to.
+ * @return bool SENSORS_INTERFACE_STATUS_SUCCESS or SENSORS_INTERFACE_STATUS_FAILED.
  */
-sensors_interface_metadata_ts sensors_interface_getSensorMetadata(uint8_t id);
+bool sensors_interface_getSensorMetadata(uint8_t id, sensors_metadata_catalog_ts *metadata);
 
 /**
  * @brief Returns the number of configured sensors.
@@ -69,4 +56,14 @@ size_t sensors_interface_getSensorsLen();
  */
 uint8_t sensors_interface_sensorIndexToId(uint8_t index);
 
+/**
+ * @brief Gets the catalog index for a given sensor ID.
+ *
+ * The index is the same in the metadata and the functional catalog.
+ *
+ * @param id ID of the sensor.
+ * @return uint8_t Catalog index or SENSORS_CATALOG_NO_INDEX if the sensor is not configured.
+ */
+uint8_t sensors_interface_sensorIdToIndex(uint8_t id);
+
 #endif
\ No newline at end of file
@@ -4,39 +4,221 @@
 #include <Arduino.h>
 #include "../../../../project_settings.h"
 
-/* SENSOR ID'S */
-    #define INVALID_SENSOR_ID                     (uint8_t)(0u)
+/**
+ * @file sensors_catalog.h
+ * @brief Single compile-time registry of all sensor channels.
+ *
+ * Every sensor channel is described exactly once, in the registry below. The sensor ID enumeration,
+ * the number of configured channels, the functional catalog (sensors.cpp) and the metadata catalog
+ * (sensors_metadata.cpp) are all generated from it, so they can never get out of sync.
+ *
+ * Channels of components that are not enabled in project_settings.h are not expanded into any table,
+ * so they cost no flash. Everything the registry generates lives in flash, a configured channel costs
+ * no SRAM. Every channel has its own named strings (sensors_registry_type_<ID>, sensors_registry_unit_<ID>),
+ * tools/channel_size_report.py reads them and the tables from a build and prints flash and SRAM per channel.
+ * The fixed part per channel is SENSORS_CHANNEL_TABLE_BYTES from sensors.h (functional entry, metadata entry
+ * and lookup table entry).
+ */
 
-#ifdef DHT11
-    #define DHT11_TEMPERATURE                     (uint8_t)(1u)    
-    #define DHT11_HUMIDITY                        (uint8_t)(2u)
-#endif
+/* SENSORS REGISTRY */
+/**
+ * Each channel is one X(...) entry with the following arguments:
+ *  - name:                Name of the sensor ID constant.
+ *  - id:                  Sensor ID. IDs are stable across builds, they must be unique, start at 1 and be listed in ascending order without gaps.
+ *  - component:           Component (device) the channel belongs to, channels of one component share one acquisition.
+ *  - min_value:           Minimum valid value of the reading (SENSORS_INDICATION_NO_MIN for indications).
+ *  - max_value:           Maximum valid value of the reading (SENSORS_INDICATION_NO_MAX for indications).
+ *  - value_function:      Function returning a float reading, or SENSORS_NO_VALUE_FUNCTION.
+ *  - indication_function: Function returning a bool indication, or SENSORS_NO_INDICATION_FUNCTION.
+ *  - sensor_type:         Name of the measurement, must not exceed 25 characters.
+ *  - measurement_unit:    Unit of the measurement, must not exceed 10 characters.
+ *  - measurement_type:    SENSORS_MEASUREMENT_TYPE_VALUE or SENSORS_MEASUREMENT_TYPE_INDICATION.
+ *  - num_of_decimals:     Number of decimals shown on outputs.
+ *  - display_letters:     Number of letters of the sensor name shown on compact outputs.
+ * New channels of an existing component get the next free ID and are appended at the end of the registry,
+ * so that IDs already used by gateways and logs never change.
+ */
+#define SENSORS_REGISTRY_DHT11(X) \
+  X(DHT11_TEMPERATURE,   1u,  DHT11_COMPONENT,       SENSORS_DHT11_TEMPERATURE_MIN,  SENSORS_DHT11_TEMPERATURE_MAX,  dht11_readTemperature,     SENSORS_NO_INDICATION_FUNCTION,  "Temperature",  "C",   SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_1_DECIMAL,  SENSORS_DISPLAY_4_LETTERS) \
+  X(DHT11_HUMIDITY,      2u,  DHT11_COMPONENT,       SENSORS_DHT11_HUMIDITY_MIN,     SENSORS_DHT11_HUMIDITY_MAX,     dht11_readHumidity,        SENSORS_NO_INDICATION_FUNCTION,  "Humidity",     "%",   SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_1_DECIMAL,  SENSORS_DISPLAY_8_LETTERS)
 
-#ifdef BMP280
-    #define BMP280_PRESSURE                       (uint8_t)(3u)
-    #define BMP280_TEMPERATURE                    (uint8_t)(4u)
-    #define BMP280_ALTITUDE                       (uint8_t)(5u)
-#endif
+#define SENSORS_REGISTRY_BMP280(X) \
+  X(BMP280_PRESSURE,     3u,  BMP280_COMPONENT,      SENSORS_BMP280_PRESSURE_MIN,    SENSORS_BMP280_PRESSURE_MAX,    bmp280_readPressure,       SENSORS_NO_INDICATION_FUNCTION,  "Pressure",     "hPa", SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_1_DECIMAL,  SENSORS_DISPLAY_5_LETTERS) \
+  X(BMP280_TEMPERATURE,  4u,  BMP280_COMPONENT,      SENSORS_BMP280_TEMPERATURE_MIN, SENSORS_BMP280_TEMPERATURE_MAX, bmp280_readTemperature,    SENSORS_NO_INDICATION_FUNCTION,  "Temperature",  "C",   SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_1_DECIMAL,  SENSORS_DISPLAY_4_LETTERS) \
+  X(BMP280_ALTITUDE,     5u,  BMP280_COMPONENT,      SENSORS_BMP280_ALTITUDE_MIN,    SENSORS_BMP280_ALTITUDE_MAX,    bmp280_readAltitude,       SENSORS_NO_INDICATION_FUNCTION,  "Altitude",     "m",   SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_8_LETTERS)
 
-#ifdef BH1750
-    #define BH1750_LUMINANCE                      (uint8_t)(6u)
-#endif
+#define SENSORS_REGISTRY_BH1750(X) \
+  X(BH1750_LUMINANCE,    6u,  BH1750_COMPONENT,      SENSORS_BH1750_LUMINANCE_MIN,   SENSORS_BH1750_LUMINANCE_MAX,   bh1750_readLightLevel,     SENSORS_NO_INDICATION_FUNCTION,  "Luminance",    "lx",  SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_9_LETTERS)
 
-#ifdef MQ135
-    #define MQ135_PPM                             (uint8_t)(7u)
-#endif
+#define SENSORS_REGISTRY_MQ135(X) \
+  X(MQ135_PPM,           7u,  MQ135_COMPONENT,       SENSORS_MQ135_PPM_MIN,          SENSORS_MQ135_PPM_MAX,          mq135_readPPM,             SENSORS_NO_INDICATION_FUNCTION,  "Gases PPM",    "",    SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_9_LETTERS)
 
-#ifdef MQ7
-    #define MQ7_COPPM                             (uint8_t)(8u)
-#endif
+#define SENSORS_REGISTRY_MQ7(X) \
+  X(MQ7_COPPM,           8u,  MQ7_COMPONENT,         SENSORS_MQ7_PPM_MIN,            SENSORS_MQ7_PPM_MAX,            mq7_readPPM,               SENSORS_NO_INDICATION_FUNCTION,  "CO PPM",       "",    SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_6_LETTERS)
 
-#ifdef GYML8511
-    #define GYML8511_UV                           (uint8_t)(9u)
-#endif
+#define SENSORS_REGISTRY_GYML8511(X) \
+  X(GYML8511_UV,         9u,  GYML8511_COMPONENT,    SENSORS_GYML8511_UV_MIN,        SENSORS_GYML8511_UV_MAX,        gy_ml8511_readUvIntensity, SENSORS_NO_INDICATION_FUNCTION,  "UV intensity", "",    SENSORS_MEASUREMENT_TYPE_VALUE,      SENSORS_DISPLAY_1_DECIMAL,  SENSORS_DISPLAY_2_LETTERS)
+
+#define SENSORS_REGISTRY_ARDUINORAIN(X) \
+  X(ARDUINORAIN_RAINING, 10u, ARDUINORAIN_COMPONENT, SENSORS_INDICATION_NO_MIN,      SENSORS_INDICATION_NO_MAX,      SENSORS_NO_VALUE_FUNCTION, arduino_rain_sensor_readRaining, "Raining",      "",    SENSORS_MEASUREMENT_TYPE_INDICATION, SENSORS_DISPLAY_0_DECIMALS, SENSORS_DISPLAY_7_LETTERS)
+
+/* Expands every channel, including the ones of disabled components. Only used for the sensor IDs. */
+#define SENSORS_REGISTRY_ALL(X) \
+  SENSORS_REGISTRY_DHT11(X) \
+  SENSORS_REGISTRY_BMP280(X) \
+  SENSORS_REGISTRY_BH1750(X) \
+  SENSORS_REGISTRY_MQ135(X) \
+  SENSORS_REGISTRY_MQ7(X) \
+  SENSORS_REGISTRY_GYML8511(X) \
+  SENSORS_REGISTRY_ARDUINORAIN(X)
+
+/* Drops channels of components which are not enabled in project_settings.h */
+#define SENSORS_REGISTRY_SKIP(X)
 
-#ifdef ARDUINORAIN
-    #define ARDUINORAIN_RAINING                   (uint8_t)(10u)
+#ifdef DHT11_COMPONENT
+  #define SENSORS_REGISTRY_DHT11_USED(X)        SENSORS_REGISTRY_DHT11(X)
+#else
+  #define SENSORS_REGISTRY_DHT11_USED(X)        SENSORS_REGISTRY_SKIP(X)
 #endif
+#ifdef BMP280_COMPONENT
+  #define SENSORS_REGISTRY_BMP280_USED(X)       SENSORS_REGISTRY_BMP280(X)
+#else
+  #define SENSORS_REGISTRY_BMP280_USED(X)       SENSORS_REGISTRY_SKIP(X)
+#endif
+#ifdef BH1750_COMPONENT
+  #define SENSORS_REGISTRY_BH1750_USED(X)       SENSORS_REGISTRY_BH1750(X)
+#else
+  #define SENSORS_REGISTRY_BH1750_USED(X)       SENSORS_REGISTRY_SKIP(X)
+#endif
+#ifdef MQ135_COMPONENT
+  #define SENSORS_REGISTRY_MQ135_USED(X)        SENSORS_REGISTRY_MQ135(X)
+#else
+  #define SENSORS_REGISTRY_MQ135_USED(X)        SENSORS_REGISTRY_SKIP(X)
+#endif
+#ifdef MQ7_COMPONENT
+  #define SENSORS_REGISTRY_MQ7_USED(X)          SENSORS_REGISTRY_MQ7(X)
+#else
+  #define SENSORS_REGISTRY_MQ7_USED(X)          SENSORS_REGISTRY_SKIP(X)
+#endif
+#ifdef GYML8511_COMPONENT
+  #define SENSORS_REGISTRY_GYML8511_USED(X)     SENSORS_REGISTRY_GYML8511(X)
+#else
+  #define SENSORS_REGISTRY_GYML8511_USED(X)     SENSORS_REGISTRY_SKIP(X)
+#endif
+#ifdef ARDUINORAIN_COMPONENT
+  #define SENSORS_REGISTRY_ARDUINORAIN_USED(X)  SENSORS_REGISTRY_ARDUINORAIN(X)
+#else
+  #define SENSORS_REGISTRY_ARDUINORAIN_USED(X)  SENSORS_REGISTRY_SKIP(X)
+#endif
+
+/* Expands only the channels of enabled components, in catalog order */
+#define SENSORS_REGISTRY(X) \
+  SENSORS_REGISTRY_DHT11_USED(X) \
+  SENSORS_REGISTRY_BMP280_USED(X) \
+  SENSORS_REGISTRY_BH1750_USED(X) \
+  SENSORS_REGISTRY_MQ135_USED(X) \
+  SENSORS_REGISTRY_MQ7_USED(X) \
+  SENSORS_REGISTRY_GYML8511_USED(X) \
+  SENSORS_REGISTRY_ARDUINORAIN_USED(X)
+/* ********************************* */
+
+/* SENSOR ID'S */
+/* Generates one enumerator per channel with its stable ID */
+#define SENSORS_CATALOG_ID_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  name = (id),
+
+/* Generates a list of IDs in registry order */
+#define SENSORS_CATALOG_ID_LIST_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  name,
+
+/* Generates one lookup table entry per channel, in ID order */
+#define SENSORS_CATALOG_INDEX_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  sensors_catalog_indexOf(name),
+
+/* Sensor IDs of every channel, stable across builds regardless of which components are enabled */
+enum
+{
+  INVALID_SENSOR_ID = 0u,
+  SENSORS_REGISTRY_ALL(SENSORS_CATALOG_ID_ENTRY)
+};
+
+/* IDs of all channels in registry order, preceded by INVALID_SENSOR_ID, used to check that IDs are contiguous */
+constexpr uint8_t sensors_catalog_all_ids[] =
+{
+  INVALID_SENSOR_ID,
+  SENSORS_REGISTRY_ALL(SENSORS_CATALOG_ID_LIST_ENTRY)
+};
+
+/* Highest sensor ID, the ID to index lookup table has one entry per ID up to this one */
+#define SENSORS_CATALOG_MAX_ID                (uint8_t)(sizeof(sensors_catalog_all_ids) / sizeof(sensors_catalog_all_ids[0]) - 1u)
 /* ********************************* */
 
-#endif
\ No newline at end of file
+/* SENSORS CATALOG ORDER */
+/* Marks a sensor ID that has no entry in the catalogs */
+#define SENSORS_CATALOG_NO_INDEX                  (uint8_t)(0xFFu)
+
+/**
+ * Order of the configured sensors in the functional and the metadata catalog, generated from the registry.
+ * The trailing INVALID_SENSOR_ID is only a terminator, so the list is never empty. It is not counted as a sensor.
+ */
+constexpr uint8_t sensors_catalog_order[] =
+{
+  SENSORS_REGISTRY(SENSORS_CATALOG_ID_LIST_ENTRY)
+  INVALID_SENSOR_ID
+};
+
+/* Number of sensors in the catalogs */
+#define SENSORS_CATALOG_LEN  (uint8_t)(sizeof(sensors_catalog_order) / sizeof(sensors_catalog_order[0]) - 1u)
+
+/**
+ * @brief Finds the catalog index of a sensor ID at compile time.
+ *
+ * @param id The sensor ID to look for.
+ * @param index The index to start searching from.
+ * @return uint8_t Catalog index of the sensor, or SENSORS_CATALOG_NO_INDEX if it is not configured.
+ */
+constexpr uint8_t sensors_catalog_indexOf(uint8_t id, uint8_t index = 0u)
+{
+  return (index >= SENSORS_CATALOG_LEN) ? SENSORS_CATALOG_NO_INDEX :
+         (sensors_catalog_order[index] == id) ? index : sensors_catalog_indexOf(id, index + 1u);
+}
+
+/**
+ * @brief Checks at compile time that the registry IDs start at 1 and are contiguous.
+ *
+ * @param index The index in sensors_catalog_all_ids[] to start checking from.
+ * @return bool true if every ID from index onward equals its position.
+ */
+constexpr bool sensors_catalog_idsAreContiguous(uint8_t index = 0u)
+{
+  return (index > SENSORS_CATALOG_MAX_ID) ||
+         (sensors_catalog_all_ids[index] == index && sensors_catalog_idsAreContiguous(index + 1u));
+}
+
+static_assert(sensors_catalog_idsAreContiguous(), "Sensor IDs in the registry must start at 1 and be listed in ascending order without gaps");
+/* ********************************* */
+
+/* SENSOR COMPONENTS */
+/* Generates the bit of the component of every configured channel */
+#define SENSORS_CATALOG_COMPONENT_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  ((uint64_t)1u << (component)) |
+
+/* Enabled sensor components, one bit per component, the channels of a component share its bit */
+constexpr uint64_t sensors_catalog_components = SENSORS_REGISTRY(SENSORS_CATALOG_COMPONENT_ENTRY) (uint64_t)0u;
+
+/**
+ * @brief Number of component bits up to the highest enabled component, evaluated at compile time.
+ *
+ * @param components The remaining component bits.
+ * @return uint8_t Position of the highest set bit plus one, 0 if no component is enabled.
+ */
+constexpr uint8_t sensors_catalog_componentsEnd(uint64_t components = sensors_catalog_components)
+{
+  return (0u == components) ? 0u : 1u + sensors_catalog_componentsEnd(components >> 1u);
+}
+
+/* Upper bound of the component numbers, initialization loops stop here */
+#define SENSORS_CATALOG_COMPONENTS_END            (uint8_t)(sensors_catalog_componentsEnd())
+/* ********************************* */
+
+#endif
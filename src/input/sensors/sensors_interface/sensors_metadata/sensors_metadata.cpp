@@ -1,138 +1,66 @@
 #include "sensors_metadata.h"
 
+/* SENSORS METADATA STRINGS */
+/* Generates the name and unit strings of every configured channel in program memory, one named object each */
+#define SENSORS_METADATA_STRINGS_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  const char sensors_registry_type_##name[] PROGMEM = sensor_type; \
+  const char sensors_registry_unit_##name[] PROGMEM = measurement_unit;
+
+SENSORS_REGISTRY(SENSORS_METADATA_STRINGS_ENTRY)
+/* *************************************** */
+
 /* SENSORS METADATA CATALOG */
-/* It's crucial to keep the strings (sensor_type and measurement_unit) short enough to fit into the allocated buffer size.
-   Ensure that:
-   - `sensor_type` does not exceed 25 characters.
-   - `measurement_unit` does not exceed 10 characters.
-   This prevents potential overflow issues when formatting the final output in the buffer and ensures proper display of sensor readings. */
-const sensors_metadata_catalog_ts sensors_metadata_catalog[] PROGMEM =
+/* Generates one metadata catalog entry per configured channel */
+#define SENSORS_METADATA_CATALOG_ENTRY(name, id, component, min_value, max_value, value_function, indication_function, sensor_type, measurement_unit, measurement_type, num_of_decimals, display_letters) \
+  { sensors_registry_type_##name, sensors_registry_unit_##name, name, measurement_type, num_of_decimals, display_letters },
+
+/* Generated from the registry in sensors_catalog.h, in the same order as the functional catalog */
+constexpr sensors_metadata_catalog_ts sensors_metadata_catalog[] PROGMEM =
 {
-#ifdef DHT11_TEMPERATURE
-  {
-    "Temperature",     
-    "C",     
-    DHT11_TEMPERATURE,   
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_4_LETTERS
-  },
-#endif
-#ifdef DHT11_HUMIDITY
-  {
-    "Humidity",        
-    "%",   
-    DHT11_HUMIDITY,      
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_8_LETTERS
-  },
-#endif  
-#ifdef BMP280_PRESSURE
-  {
-    "Pressure",        
-    "hPa",  
-    BMP280_PRESSURE,     
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_5_LETTERS
-  },
-#endif  
-#ifdef BMP280_TEMPERATURE
-  {
-    "Temperature",     
-    "C",   
-    BMP280_TEMPERATURE,  
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_4_LETTERS
-  },
-#endif  
-#ifdef BMP280_ALTITUDE
-  {
-    "Altitude",        
-    "m",   
-    BMP280_ALTITUDE,     
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_8_LETTERS
-  },
-#endif  
-#ifdef BH1750_LUMINANCE
-  {
-    "Luminance",       
-    "lx",  
-    BH1750_LUMINANCE,    
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_9_LETTERS
-  },
-#endif  
-#ifdef MQ135_PPM
-  {
-    "Gases PPM",       
-    "",    
-    MQ135_PPM,           
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_9_LETTERS
-  },
-#endif  
-#ifdef MQ7_COPPM
-  {
-    "CO PPM",          
-    "",    
-    MQ7_COPPM,           
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_6_LETTERS
-  },
-#endif  
-#ifdef GYML8511_UV
-  {
-    "UV intensity",    
-    "",     
-    GYML8511_UV,         
-    SENSORS_MEASUREMENT_TYPE_VALUE,
-    SENSORS_DISPLAY_1_DECIMAL,
-    SENSORS_DISPLAY_2_LETTERS
-  },
-#endif  
-#ifdef ARDUINORAIN_RAINING
-  {
-    "Raining",  
-    "",    
-    ARDUINORAIN_RAINING, 
-    SENSORS_MEASUREMENT_TYPE_INDICATION,
-    SENSORS_DISPLAY_0_DECIMALS,
-    SENSORS_DISPLAY_7_LETTERS
-  },
-#endif
+  SENSORS_REGISTRY(SENSORS_METADATA_CATALOG_ENTRY)
 };
+
+static_assert(sizeof(sensors_metadata_catalog) == SENSORS_CATALOG_LEN * sizeof(sensors_metadata_catalog_ts),
+              "sensors_metadata_catalog[] must have one entry per configured sensor");
+/* *************************************** */
+
+/* SENSOR ID TO CATALOG INDEX LOOKUP TABLE */
+/* Generated at compile time, one entry per sensor ID, SENSORS_CATALOG_NO_INDEX for IDs that are not configured */
+const uint8_t sensors_metadata_id_to_index[] PROGMEM =
+{
+  SENSORS_CATALOG_NO_INDEX, // INVALID_SENSOR_ID
+  SENSORS_REGISTRY_ALL(SENSORS_CATALOG_INDEX_ENTRY)
+};
+
+static_assert(sizeof(sensors_metadata_id_to_index) == SENSORS_CATALOG_MAX_ID + 1u,
+              "sensors_metadata_id_to_index[] must have one entry per sensor ID up to SENSORS_CATALOG_MAX_ID");
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
 bool sensors_metadata_getSensorFromCatalog(uint8_t id, sensors_metadata_catalog_ts * current_sensor)
 {
   bool success_status = SENSORS_METADATA_RETRIEVE_FAILED;
-  size_t num_of_sensors = sensors_metadata_getSensorsLen();
-  uint8_t current_id = INVALID_SENSOR_ID;
+  uint8_t index = sensors_metadata_sensorIdToIndex(id);
 
-  // Loop through all sensors in the catalog
-  for (uint8_t index = SENSORS_METADATA_FIRST_SENSOR_INDEX; index < num_of_sensors; index++)
+  if(SENSORS_CATALOG_NO_INDEX != index)
   {
-    current_id = pgm_read_byte(&sensors_metadata_catalog[index].sensor_id); // Read from program memory
-    if(id == current_id)
-    {
-      // Copy the sensor configuration from program memory to the provided structure
-      memcpy_P(current_sensor, &sensors_metadata_catalog[index], sizeof(sensors_metadata_catalog_ts));
-      success_status = SENSORS_METADATA_RETRIEVE_SUCCESS; // Mark as successful
-      break;
-    }
+    // Copy the sensor configuration from program memory to the provided structure
+    memcpy_P(current_sensor, &sensors_metadata_catalog[index], sizeof(sensors_metadata_catalog_ts));
+    success_status = SENSORS_METADATA_RETRIEVE_SUCCESS; // Mark as successful
   }
   return success_status;
 }
 
+uint8_t sensors_metadata_sensorIdToIndex(uint8_t id)
+{
+  uint8_t index = SENSORS_CATALOG_NO_INDEX; // Default in case the ID is out of range or not configured
+  if(SENSORS_CATALOG_MAX_ID >= id)
+  {
+    index = pgm_read_byte(&sensors_metadata_id_to_index[id]); // Single indexed read from program memory
+  }
+  return index;
+}
+
 size_t sensors_metadata_getSensorsLen()
 {
   size_t sensors_len = SENSORS_METADATA_NO_SENSORS_CONFIGURED; // Default value in case of no sensors configured
@@ -51,11 +51,12 @@
  * measurement unit, unique ID, and display-related attributes. It is used to 
  * store descriptive information about sensors that does not change during runtime.
  * Used in other components like Display, Serial Console etc.
+ * Both strings are stored in program memory and must be read with the _P functions (e.g. strlen_P, "%S" format).
  */
 typedef struct
 {
-  const char* sensor_type;            // Type of the sensor (e.g., Temperature, Pressure, etc.).
-  const char* measurement_unit;       // Unit of measurement for the sensor (e.g., C, Pa, etc.).
+  const char* sensor_type;            // Type of the sensor (e.g., Temperature, Pressure, etc.), in program memory.
+  const char* measurement_unit;       // Unit of measurement for the sensor (e.g., C, Pa, etc.), in program memory.
   uint8_t sensor_id;                  // Unique identifier for the sensor. Used to reference the sensor. From config file.
   uint8_t measurement_type;           // Type of measurement the sensor provides (e.g., value, indication).
   uint8_t num_of_decimals;            // Number of decimal places for the sensor's measurement values.
@@ -75,6 +76,17 @@ typedef struct
  */
 bool sensors_metadata_getSensorFromCatalog(uint8_t id, sensors_metadata_catalog_ts *current_sensor);
 
+/**
+ * @brief Converts a sensor ID to its index in the catalogs.
+ *
+ * The lookup is a single read from a table generated at compile time, and the index
+ * is valid for both the metadata catalog and the functional catalog.
+ *
+ * @param id The ID of the sensor.
+ * @return uint8_t Catalog index of the sensor, or SENSORS_CATALOG_NO_INDEX if it is not configured.
+ */
+uint8_t sensors_metadata_sensorIdToIndex(uint8_t id);
+
 /**
  * @brief Retrieves the number of sensors in the metadata catalog.
  * 
@@ -0,0 +1,410 @@
+#include "data_logger.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Days before the first day of each month in a non-leap year */
+static const uint16_t data_logger_days_before_month[12] PROGMEM = {0u, 31u, 59u, 90u, 120u, 151u, 181u, 212u, 243u, 273u, 304u, 334u};
+
+/* Records collected for the next page */
+static data_logger_record_ts data_logger_fill_records[DATA_LOGGER_RECORDS_PER_PAGE];
+static uint8_t data_logger_fill_count = 0u;
+
+/* Page being written to the EEPROM */
+static uint8_t data_logger_flush_buffer[DATA_LOGGER_PAGE_SIZE];
+static uint8_t data_logger_flush_page = DATA_LOGGER_NO_PAGE;
+static uint8_t data_logger_flush_index = 0u;  // Number of bytes of the page already written
+
+/* Page the next full buffer goes to and its sequence number */
+static uint8_t data_logger_head_page = 0u;
+static uint16_t data_logger_next_sequence = 0u;
+
+/* Sensor channels already logged in the current interval */
+static uint16_t data_logger_logged_channels = 0u;
+static unsigned long data_logger_interval_start_ms = 0u;
+
+/* Last RTC time and the moment it was received */
+static uint32_t data_logger_clock_unix_time = DATA_LOGGER_TIME_UNKNOWN;
+static unsigned long data_logger_clock_millis = 0u;
+
+static uint16_t data_logger_dropped_records = 0u;
+
+/* State of a running dump */
+static bool data_logger_dump_active = false;
+static uint8_t data_logger_dump_page = 0u;
+static uint8_t data_logger_dump_pages_left = 0u;
+static uint8_t data_logger_dump_record = 0u;
+static uint8_t data_logger_dump_page_records = 0u;  // Valid records of the current dump page, 0 if not loaded
+
+static_assert(SENSORS_CATALOG_MAX_ID < 16u, "Logged channels are tracked in a 16-bit mask");
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Adds a sensor reading to the page buffer if the channel was not logged in this interval.
+ *
+ * @param data Pointer to data containing the sensor reading.
+ * @return control_error_code_te ERROR_CODE_NO_ERROR or ERROR_CODE_DATA_LOGGER_FULL.
+ */
+static control_error_code_te logSensorReading(const control_data_ts *data);
+
+/**
+ * @brief Moves the full page buffer into the flush buffer and starts writing it.
+ */
+static void startPageFlush();
+
+/**
+ * @brief Checks the CRC and the record count of a stored page.
+ *
+ * @param page Index of the page.
+ * @param sequence Pointer where the sequence number of the page is stored.
+ * @return uint8_t Number of records, 0 if the page is not valid.
+ */
+static uint8_t checkStoredPage(uint8_t page, uint16_t *sequence);
+
+/**
+ * @brief Finds the valid page with the newest sequence number and places the write head after it.
+ */
+static void recoverHead();
+
+/**
+ * @brief Converts an RTC reading to Unix time.
+ *
+ * @param time_data Pointer to the RTC reading, years from 2000 to 2099 are supported.
+ * @return uint32_t Seconds since 1970-01-01 00:00:00.
+ */
+static uint32_t toUnixTime(const rtc_reading_ts *time_data);
+
+/**
+ * @brief Returns the current time based on the last RTC reading.
+ *
+ * @return uint32_t Unix time in seconds, DATA_LOGGER_TIME_UNKNOWN if no RTC time was received yet.
+ */
+static uint32_t currentTimestamp();
+
+/**
+ * @brief Updates a CRC-8 with one byte.
+ *
+ * @param crc The CRC so far.
+ * @param data The next byte.
+ * @return uint8_t The updated CRC.
+ */
+static uint8_t crc8Update(uint8_t crc, uint8_t data);
+
+/**
+ * @brief Returns the EEPROM address of a byte in a page.
+ *
+ * @param page Index of the page.
+ * @param offset Offset of the byte in the page.
+ * @return uint16_t EEPROM address.
+ */
+static uint16_t pageAddress(uint8_t page, uint8_t offset);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+control_error_code_te data_logger_init()
+{
+  data_logger_fill_count = 0u;
+  data_logger_flush_page = DATA_LOGGER_NO_PAGE;
+  data_logger_logged_channels = 0u;
+  data_logger_interval_start_ms = millis();
+  data_logger_dump_active = false;
+  recoverHead();
+  return ERROR_CODE_NO_ERROR;
+}
+
+control_error_code_te data_logger_displayData(const control_data_ts *data)
+{
+  control_error_code_te error_code = ERROR_CODE_INVALID_INPUT_TYPE;
+
+  switch(data->input.io_component)
+  {
+    case INPUT_SENSORS:
+      error_code = logSensorReading(data);
+      break;
+
+#ifdef RTC_COMPONENT
+    case INPUT_RTC:
+      // Time between RTC readings is interpolated with millis()
+      data_logger_clock_unix_time = toUnixTime(&data->input_return.rtc_reading);
+      data_logger_clock_millis = millis();
+      error_code = ERROR_CODE_NO_ERROR;
+      break;
+#endif
+
+    default:
+      break;
+  }
+
+  return error_code;
+}
+
+void data_logger_loop()
+{
+  if(DATA_LOGGER_NO_PAGE == data_logger_flush_page)
+  {
+    if(DATA_LOGGER_RECORDS_PER_PAGE <= data_logger_fill_count)
+    {
+      startPageFlush();
+    }
+    return;
+  }
+
+  // One byte per call, an EEPROM write takes about 3.3 ms
+  if(eeprom_is_ready())
+  {
+    // Records first, header last, so a torn page never has a valid CRC
+    uint8_t offset = (data_logger_flush_index + DATA_LOGGER_HEADER_LEN) % DATA_LOGGER_PAGE_SIZE;
+    eeprom_update_byte((uint8_t *)pageAddress(data_logger_flush_page, offset), data_logger_flush_buffer[offset]);
+    data_logger_flush_index++;
+
+    if(DATA_LOGGER_PAGE_SIZE <= data_logger_flush_index)
+    {
+      data_logger_flush_page = DATA_LOGGER_NO_PAGE;
+    }
+  }
+}
+
+void data_logger_startDump()
+{
+  // Head is the page written next, which holds the oldest records
+  data_logger_dump_page = data_logger_head_page;
+  data_logger_dump_pages_left = DATA_LOGGER_NUM_OF_PAGES;
+  data_logger_dump_record = 0u;
+  data_logger_dump_page_records = 0u;
+  data_logger_dump_active = true;
+}
+
+bool data_logger_readDumpLine(char *line)
+{
+  if(!data_logger_dump_active)
+  {
+    return DATA_LOGGER_DUMP_FINISHED;
+  }
+
+  // Skip to the next valid page when the current one is exhausted
+  while(data_logger_dump_record >= data_logger_dump_page_records)
+  {
+    if(0u == data_logger_dump_pages_left)
+    {
+      snprintf_P(line, DATA_LOGGER_DUMP_LINE_SIZE, PSTR("LOG,END,%u"), data_logger_dropped_records);
+      data_logger_dump_active = false;
+      return DATA_LOGGER_DUMP_LINE_READY;
+    }
+
+    uint16_t sequence = 0u;
+    bool page_in_flush = (data_logger_dump_page == data_logger_flush_page);
+    data_logger_dump_page_records = page_in_flush ? 0u : checkStoredPage(data_logger_dump_page, &sequence);
+    data_logger_dump_record = 0u;
+    if(0u != data_logger_dump_page_records)
+    {
+      break;
+    }
+    data_logger_dump_page = (data_logger_dump_page + 1u) % DATA_LOGGER_NUM_OF_PAGES;
+    data_logger_dump_pages_left--;
+  }
+
+  uint8_t bytes[DATA_LOGGER_RECORD_LEN];
+  uint8_t offset = DATA_LOGGER_HEADER_LEN + data_logger_dump_record * DATA_LOGGER_RECORD_LEN;
+  eeprom_read_block(bytes, (const void *)pageAddress(data_logger_dump_page, offset), sizeof(bytes));
+
+  data_logger_record_ts record;
+  memcpy(&record.timestamp, &bytes[0], sizeof(record.timestamp));
+  record.sensor_id = bytes[4];
+  memcpy(&record.value, &bytes[5], sizeof(record.value));
+
+  char value_string[OUTPUT_FORMAT_FLOAT_BUFFER_SIZE];
+  (void)output_format_sensorValue(record.value, OUTPUT_FORMAT_MAX_DECIMALS, value_string, sizeof(value_string));
+  snprintf_P(line, DATA_LOGGER_DUMP_LINE_SIZE, PSTR("LOG,%lu,%u,%s"), (unsigned long)record.timestamp, record.sensor_id, value_string);
+
+  data_logger_dump_record++;
+  if(data_logger_dump_record >= data_logger_dump_page_records)
+  {
+    data_logger_dump_page = (data_logger_dump_page + 1u) % DATA_LOGGER_NUM_OF_PAGES;
+    data_logger_dump_pages_left--;
+  }
+  return DATA_LOGGER_DUMP_LINE_READY;
+}
+
+bool data_logger_isBusy()
+{
+  return (DATA_LOGGER_NO_PAGE != data_logger_flush_page) ||
+         (DATA_LOGGER_RECORDS_PER_PAGE <= data_logger_fill_count) ||
+         data_logger_dump_active;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static control_error_code_te logSensorReading(const control_data_ts *data)
+{
+  const sensor_reading_ts *reading = &data->input_return.sensor_reading;
+  uint8_t sensor_id = data->input.device_id;
+  unsigned long current_millis = millis();
+
+  if(current_millis - data_logger_interval_start_ms >= DATA_LOGGER_LOG_INTERVAL_MS)
+  {
+    data_logger_interval_start_ms = current_millis;
+    data_logger_logged_channels = 0u;
+  }
+
+  bool is_indication = (SENSORS_MEASUREMENT_TYPE_INDICATION == reading->measurement_type_switch);
+  bool already_logged = (0u != (data_logger_logged_channels & DATA_LOGGER_CHANNEL_BIT(sensor_id)));
+  if(SENSORS_CATALOG_MAX_ID < sensor_id || already_logged || (!is_indication && !sensors_isValueValid(reading->value)))
+  {
+    return ERROR_CODE_NO_ERROR; // Nothing to log in this interval
+  }
+
+  if(DATA_LOGGER_RECORDS_PER_PAGE <= data_logger_fill_count)
+  {
+    // Previous page is still being written and the next one is full as well
+    if(DATA_LOGGER_COUNTER_MAX > data_logger_dropped_records)
+    {
+      data_logger_dropped_records++;
+    }
+    return ERROR_CODE_DATA_LOGGER_FULL;
+  }
+
+  data_logger_record_ts *record = &data_logger_fill_records[data_logger_fill_count];
+  record->timestamp = currentTimestamp();
+  record->sensor_id = sensor_id;
+  record->value = is_indication ? (reading->indication ? SENSORS_VALUE_ONE : 0) : reading->value;
+  data_logger_fill_count++;
+  data_logger_logged_channels |= DATA_LOGGER_CHANNEL_BIT(sensor_id);
+
+  return ERROR_CODE_NO_ERROR;
+}
+
+static void startPageFlush()
+{
+  memset(data_logger_flush_buffer, 0, sizeof(data_logger_flush_buffer));
+
+  for (uint8_t index = 0u; index < data_logger_fill_count; index++)
+  {
+    uint8_t *bytes = &data_logger_flush_buffer[DATA_LOGGER_HEADER_LEN + index * DATA_LOGGER_RECORD_LEN];
+    memcpy(&bytes[0], &data_logger_fill_records[index].timestamp, sizeof(uint32_t));
+    bytes[4] = data_logger_fill_records[index].sensor_id;
+    memcpy(&bytes[5], &data_logger_fill_records[index].value, sizeof(sensors_value_t));
+  }
+
+  data_logger_flush_buffer[DATA_LOGGER_SEQUENCE_OFFSET] = (uint8_t)(data_logger_next_sequence & 0xFFu);
+  data_logger_flush_buffer[DATA_LOGGER_SEQUENCE_OFFSET + 1u] = (uint8_t)(data_logger_next_sequence >> 8u);
+  data_logger_flush_buffer[DATA_LOGGER_COUNT_OFFSET] = data_logger_fill_count;
+
+  uint8_t crc = DATA_LOGGER_CRC_INIT;
+  for (uint8_t offset = 0u; offset < DATA_LOGGER_PAGE_SIZE; offset++)
+  {
+    if(DATA_LOGGER_CRC_OFFSET != offset)
+    {
+      crc = crc8Update(crc, data_logger_flush_buffer[offset]);
+    }
+  }
+  data_logger_flush_buffer[DATA_LOGGER_CRC_OFFSET] = crc;
+
+  data_logger_flush_page = data_logger_head_page;
+  data_logger_flush_index = 0u;
+  data_logger_head_page = (data_logger_head_page + 1u) % DATA_LOGGER_NUM_OF_PAGES;
+  data_logger_next_sequence++;
+  data_logger_fill_count = 0u;
+}
+
+static uint8_t checkStoredPage(uint8_t page, uint16_t *sequence)
+{
+  uint8_t crc = DATA_LOGGER_CRC_INIT;
+  uint8_t header[DATA_LOGGER_HEADER_LEN];
+
+  for (uint8_t offset = 0u; offset < DATA_LOGGER_PAGE_SIZE; offset++)
+  {
+    uint8_t data = eeprom_read_byte((const uint8_t *)pageAddress(page, offset));
+    if(DATA_LOGGER_HEADER_LEN > offset)
+    {
+      header[offset] = data;
+    }
+    if(DATA_LOGGER_CRC_OFFSET != offset)
+    {
+      crc = crc8Update(crc, data);
+    }
+  }
+
+  uint8_t num_of_records = header[DATA_LOGGER_COUNT_OFFSET];
+  // Erased EEPROM reads 0xFF, which is never a valid record count
+  if(crc != header[DATA_LOGGER_CRC_OFFSET] || 0u == num_of_records || DATA_LOGGER_RECORDS_PER_PAGE < num_of_records)
+  {
+    return 0u;
+  }
+
+  *sequence = (uint16_t)(header[DATA_LOGGER_SEQUENCE_OFFSET] | (header[DATA_LOGGER_SEQUENCE_OFFSET + 1u] << 8u));
+  return num_of_records;
+}
+
+static void recoverHead()
+{
+  uint8_t newest_page = DATA_LOGGER_NO_PAGE;
+  uint16_t newest_sequence = 0u;
+
+  for (uint8_t page = 0u; page < DATA_LOGGER_NUM_OF_PAGES; page++)
+  {
+    uint16_t sequence = 0u;
+    if(0u == checkStoredPage(page, &sequence))
+    {
+      continue;
+    }
+    // Sequence numbers wrap around, a positive difference means newer
+    if(DATA_LOGGER_NO_PAGE == newest_page || 0 < (int16_t)(sequence - newest_sequence))
+    {
+      newest_page = page;
+      newest_sequence = sequence;
+    }
+  }
+
+  if(DATA_LOGGER_NO_PAGE == newest_page)
+  {
+    data_logger_head_page = 0u;
+    data_logger_next_sequence = 0u;
+  }
+  else
+  {
+    data_logger_head_page = (newest_page + 1u) % DATA_LOGGER_NUM_OF_PAGES;
+    data_logger_next_sequence = newest_sequence + 1u;
+  }
+}
+
+static uint32_t toUnixTime(const rtc_reading_ts *time_data)
+{
+  uint16_t years = time_data->year - DATA_LOGGER_FIRST_YEAR;
+  uint8_t month_index = constrain(time_data->month, 1u, 12u) - 1u;
+
+  // Every fourth year from 2000 on is a leap year, 2100 is out of range
+  uint32_t days = (uint32_t)years * 365u + (years + 3u) / 4u;
+  days += pgm_read_word(&data_logger_days_before_month[month_index]);
+  if(0u == (years % 4u) && 2u <= month_index)
+  {
+    days++; // February 29th of this year
+  }
+  days += time_data->day - 1u;
+
+  return DATA_LOGGER_UNIX_TIME_2000 + days * DATA_LOGGER_SECONDS_PER_DAY +
+         (uint32_t)time_data->hour * 3600u + (uint32_t)time_data->mins * 60u + time_data->secs;
+}
+
+static uint32_t currentTimestamp()
+{
+  if(DATA_LOGGER_TIME_UNKNOWN == data_logger_clock_unix_time)
+  {
+    return DATA_LOGGER_TIME_UNKNOWN;
+  }
+  return data_logger_clock_unix_time + (millis() - data_logger_clock_millis) / 1000u;
+}
+
+static uint8_t crc8Update(uint8_t crc, uint8_t data)
+{
+  crc ^= data;
+  for (uint8_t bit = 0u; bit < 8u; bit++)
+  {
+    crc = (crc & 0x80u) ? (uint8_t)((crc << 1u) ^ DATA_LOGGER_CRC_POLYNOMIAL) : (uint8_t)(crc << 1u);
+  }
+  return crc;
+}
+
+static uint16_t pageAddress(uint8_t page, uint8_t offset)
+{
+  return DATA_LOGGER_STORAGE_START + (uint16_t)page * DATA_LOGGER_PAGE_SIZE + offset;
+}
+/* *************************************** */
@@ -0,0 +1,135 @@
+#ifndef DATA_LOGGER_H
+#define DATA_LOGGER_H
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include "data_logger_config.h"
+#include "../output_format/output_format.h"
+#include "../../control/control_types.h"
+
+/**
+ * @file data_logger.h
+ * @brief Persistent circular log of timestamped sensor readings in EEPROM.
+ *
+ * Readings are collected in RAM until a page is full, then the page is written one byte
+ * per background loop call, so the loop never waits for the EEPROM. Pages are used in a
+ * circle, which spreads the writes evenly over the whole log area.
+ *
+ * Page layout, multi-byte fields are little endian:
+ *
+ *   | sequence (2) | number of records | CRC-8 | records (9 bytes each) | unused |
+ *
+ * Record layout: | Unix time in seconds (4) | sensor ID | value (sensor value, 4) |
+ *
+ * The value is a float or a fixed-point sensor value depending on SENSORS_FIXED_POINT_USED.
+ * Both modes use a different CRC start value, so pages of the other mode are ignored.
+ *
+ * The header is written after the records. A page torn by a power loss fails the CRC and
+ * is ignored, at start up the write head continues after the valid page with the newest
+ * sequence number. Records still waiting in RAM are lost on power loss.
+ */
+
+/* Page layout */
+#define DATA_LOGGER_HEADER_LEN          (uint8_t)(4u)
+#define DATA_LOGGER_RECORD_LEN          (uint8_t)(9u)
+#define DATA_LOGGER_RECORDS_PER_PAGE    (uint8_t)((DATA_LOGGER_PAGE_SIZE - DATA_LOGGER_HEADER_LEN) / DATA_LOGGER_RECORD_LEN)
+#define DATA_LOGGER_NUM_OF_PAGES        (uint8_t)(DATA_LOGGER_STORAGE_SIZE / DATA_LOGGER_PAGE_SIZE)
+#define DATA_LOGGER_SEQUENCE_OFFSET     (uint8_t)(0u)
+#define DATA_LOGGER_COUNT_OFFSET        (uint8_t)(2u)
+#define DATA_LOGGER_CRC_OFFSET          (uint8_t)(3u)
+
+/* CRC-8, polynomial 0x07 */
+#ifdef SENSORS_FIXED_POINT_USED
+#define DATA_LOGGER_CRC_INIT            (uint8_t)(0x5Au)
+#else
+#define DATA_LOGGER_CRC_INIT            (uint8_t)(0xFFu)
+#endif
+#define DATA_LOGGER_CRC_POLYNOMIAL      (uint8_t)(0x07u)
+
+/* Timestamp of records logged before the first RTC time was received */
+#define DATA_LOGGER_TIME_UNKNOWN        (uint32_t)(0u)
+/* Unix time of 2000-01-01 00:00:00, the epoch of the day calculation */
+#define DATA_LOGGER_UNIX_TIME_2000      (uint32_t)(946684800UL)
+#define DATA_LOGGER_SECONDS_PER_DAY     (uint32_t)(86400UL)
+#define DATA_LOGGER_FIRST_YEAR          (uint16_t)(2000u)
+
+/* Marks that no page is valid or being written */
+#define DATA_LOGGER_NO_PAGE             (uint8_t)(0xFFu)
+/* Bit of a sensor channel in the mask of channels logged in the current interval */
+#define DATA_LOGGER_CHANNEL_BIT(id)     (uint16_t)(1u << (id))
+/* Saturation value of the dropped records counter */
+#define DATA_LOGGER_COUNTER_MAX         (uint16_t)(0xFFFFu)
+/* Size of the buffer for one dump line */
+#define DATA_LOGGER_DUMP_LINE_SIZE      (uint8_t)(40u)
+
+/* Dump line poll results */
+#define DATA_LOGGER_DUMP_LINE_READY     (bool)(true)
+#define DATA_LOGGER_DUMP_FINISHED       (bool)(false)
+
+static_assert(sizeof(uint32_t) + sizeof(uint8_t) + sizeof(sensors_value_t) == DATA_LOGGER_RECORD_LEN, "Record layout must match the stored record length");
+static_assert(0u < DATA_LOGGER_RECORDS_PER_PAGE, "Log page must fit at least one record");
+static_assert(DATA_LOGGER_NUM_OF_PAGES < DATA_LOGGER_NO_PAGE, "Page index must not collide with DATA_LOGGER_NO_PAGE");
+
+/**
+ * @brief One logged reading.
+ */
+typedef struct
+{
+  uint32_t timestamp;  // Unix time in seconds, DATA_LOGGER_TIME_UNKNOWN if no RTC time was received yet
+  uint8_t sensor_id;   // ID of the sensor channel
+  sensors_value_t value; // Measured value, 0 or SENSORS_VALUE_ONE for indications
+} data_logger_record_ts;
+
+/**
+ * @brief Initializes the logger and recovers the write head from the stored pages.
+ *
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Logger is ready.
+ */
+control_error_code_te data_logger_init();
+
+/**
+ * @brief Takes data from the data router.
+ *
+ * Sensor readings are logged once per DATA_LOGGER_LOG_INTERVAL_MS and channel,
+ * RTC readings set the time used for the record timestamps.
+ *
+ * @param data Pointer to data structure containing the input type and associated readings.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Data was taken (a reading may still be skipped by the log interval).
+ * - ERROR_CODE_DATA_LOGGER_FULL: Both page buffers are busy, the reading was dropped.
+ * - ERROR_CODE_INVALID_INPUT_TYPE: Invalid input type specified.
+ */
+control_error_code_te data_logger_displayData(const control_data_ts *data);
+
+/**
+ * @brief Writes a full page to the EEPROM, one byte per call.
+ *
+ * NEEDS TO BE CALLED IN A LOOP, every few milliseconds.
+ */
+void data_logger_loop();
+
+/**
+ * @brief Starts a dump of all stored records, from the oldest to the newest.
+ */
+void data_logger_startDump();
+
+/**
+ * @brief Formats the next line of a running dump.
+ *
+ * Lines have the form "LOG,<unix time>,<sensor ID>,<value>", the last line is
+ * "LOG,END,<dropped records>".
+ *
+ * @param line Buffer for the line, at least DATA_LOGGER_DUMP_LINE_SIZE bytes.
+ * @return bool DATA_LOGGER_DUMP_LINE_READY if a line was written, DATA_LOGGER_DUMP_FINISHED otherwise.
+ */
+bool data_logger_readDumpLine(char *line);
+
+/**
+ * @brief Checks whether the logger needs data_logger_loop() or data_logger_readDumpLine() to be called soon.
+ *
+ * @return bool true while a page is full or being written, or a dump is running.
+ */
+bool data_logger_isBusy();
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef DATA_LOGGER_CONFIG_H
+#define DATA_LOGGER_CONFIG_H
+
+#include <Arduino.h>
+
+/* EEPROM area used by the log, the ATmega328 has 1024 bytes */
+#define DATA_LOGGER_STORAGE_START     (uint16_t)(0u)
+#define DATA_LOGGER_STORAGE_SIZE      (uint16_t)(1024u)
+
+/* Size of one log page, pages are the unit of writing and of power loss recovery */
+#define DATA_LOGGER_PAGE_SIZE         (uint8_t)(32u)
+
+/**
+ * Every sensor channel is logged at most once per interval.
+ * Together with the page batching this keeps every EEPROM cell far below its
+ * write endurance (100 000 cycles): with ten channels a page is rewritten about
+ * every 1.5 hours, which is more than 15 years of logging.
+ */
+#define DATA_LOGGER_LOG_INTERVAL_MS   (uint32_t)(600000u)
+
+#endif
@@ -1,7 +1,19 @@
 #include "display.h"
 
+// Library object and code are only part of builds with the component
+#ifdef LCD_DISPLAY_COMPONENT
 /* STATIC GLOBAL VARIABLES */
 static LiquidCrystal_I2C lcd(DISPLAY_LCD_I2C_ADDDR, DISPLAY_LCD_WIDTH, DISPLAY_LCD_HEIGHT);
+
+/* Shadow of the LCD content, every write goes here first */
+static char display_framebuffer[DISPLAY_LCD_HEIGHT][DISPLAY_LCD_WIDTH];
+/* One bit per cell that differs from what the LCD shows, bit 0 is the first column */
+static uint16_t display_dirty_cells[DISPLAY_LCD_HEIGHT];
+/* Position the LCD writes the next character to */
+static uint8_t display_cursor_row = DISPLAY_CURSOR_UNKNOWN;
+static uint8_t display_cursor_column = DISPLAY_CURSOR_UNKNOWN;
+
+static_assert(16u >= DISPLAY_LCD_WIDTH, "Dirty mask of a framebuffer row has 16 bits");
 /* *************************************** */
 
 /* STATIC FUNCTION PROTOTYPES */
@@ -19,6 +31,22 @@ static LiquidCrystal_I2C lcd(DISPLAY_LCD_I2C_ADDDR, DISPLAY_LCD_WIDTH, DISPLAY_L
  **/
 static control_error_code_te display_displaySensorMeasurement(const control_data_ts *data);
 
+#ifdef SENSOR_STATS_USED
+/**
+ * @brief Displays the rolling statistics of a sensor channel on the sensors row.
+ *
+ * The row holds minimum, mean and maximum with the unit (e.g. "20.1/21.0/22.3C"), the sensor name
+ * does not fit next to three values on a 16 character row.
+ *
+ * @param data Pointer to data containing the statistics and the sensor ID.
+ *
+ * @return control_error_code_te Returns an error code:
+ *         - ERROR_CODE_NO_ERROR if the statistics are displayed.
+ *         - ERROR_CODE_SENSOR_NOT_CONFIGURED if the sensor metadata is not found.
+ **/
+static control_error_code_te display_displaySensorStats(const control_data_ts *data);
+#endif
+
 /** 
  * @brief Displays the current time on the LCD, formatted to fit a 16-character wide display.
  * This function formats the time and date values from the RTC reading and displays it.
@@ -46,21 +74,40 @@ static control_error_code_te display_displayI2cScan(const control_data_ts *data)
 /**
  * @brief Formats sensor data for display on an LCD screen.
  * 
- * This function takes sensor metadata and a measurement value, 
- * formats it as a string, and ensures it fits within the display width.
+ * This function takes sensor metadata and a measurement value and formats them
+ * into the caller's buffer, cut to the display width.
  * 
- * @param sensor_metadata Metadata containing sensor type, unit, and display settings.
+ * @param sensor_metadata Pointer to metadata containing sensor type, unit, and display settings.
  * @param val The sensor measurement value as a string.
- * @return A formatted string ready for LCD display.
+ * @param display_string Buffer for the formatted row, at least DISPLAY_MAX_STRING_LEN bytes.
  */
-static String formatDisplaySensorData(sensors_metadata_catalog_ts sensor_metadata, char* val);
+static void formatDisplaySensorData(const sensors_metadata_catalog_ts *sensor_metadata, const char *val, char *display_string);
 
 /** 
- * @brief Clears a specific row on the LCD by printing blank spaces.
+ * @brief Clears a specific row of the framebuffer.
  * 
  * @param row The row index to clear.
  */
 static void displayEmptyLine(uint8_t row);
+
+/**
+ * @brief Writes a text into a framebuffer row, padded with spaces to the display width.
+ *
+ * Only cells whose character changes are marked dirty. Text longer than the display is cut.
+ *
+ * @param row The row index to write.
+ * @param text Null terminated text.
+ */
+static void displayWriteRow(uint8_t row, const char *text);
+
+/**
+ * @brief Sends the dirty cells of the framebuffer to the LCD.
+ *
+ * Consecutive dirty cells are written as one run, the cursor is only moved when the next run
+ * does not start where the LCD cursor already is. Gaps of up to DISPLAY_MAX_REWRITTEN_GAP clean
+ * cells are rewritten, which is cheaper than moving the cursor.
+ */
+static void displayFlush();
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -70,6 +117,12 @@ control_error_code_te display_init()
   lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_START_ROW);
   lcd.backlight();
   lcd.noCursor();
+
+  // LCD initialization clears the screen and homes the cursor
+  memset(display_framebuffer, ' ', sizeof(display_framebuffer));
+  memset(display_dirty_cells, 0, sizeof(display_dirty_cells));
+  display_cursor_row = DISPLAY_START_ROW;
+  display_cursor_column = DISPLAY_START_COLUMN;
   return ERROR_CODE_NO_ERROR;
 }
 
@@ -83,9 +136,17 @@ control_error_code_te display_displayData(const control_data_ts *data)
       error_code = display_displaySensorMeasurement(data);
       break;
 
+#ifdef RTC_COMPONENT
     case INPUT_RTC:
       error_code = display_displayTime(data);
       break;
+#endif
+
+#ifdef SENSOR_STATS_USED
+    case INPUT_SENSOR_STATS:
+      error_code = display_displaySensorStats(data);
+      break;
+#endif
 
     case INPUT_I2C_SCAN:
       error_code = display_displayI2cScan(data);
@@ -99,6 +160,7 @@ control_error_code_te display_displayData(const control_data_ts *data)
       break;
   }
 
+  displayFlush();
   return error_code;
 }
 /* *************************************** */
@@ -106,7 +168,7 @@ control_error_code_te display_displayData(const control_data_ts *data)
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
 static control_error_code_te display_displaySensorMeasurement(const control_data_ts *data)
 {
-  sensor_reading_ts sensor_data = data->input_return.sensor_reading;
+  const sensor_reading_ts *sensor_data = &data->input_return.sensor_reading;
   uint8_t sensor_id = data->input.device_id;
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR; // Default Error code
@@ -114,27 +176,24 @@ static control_error_code_te display_displaySensorMeasurement(const control_data
   char val[DISPLAY_MAX_STRING_LEN]; // Holds the formatted sensor value or indication
 
   // Retrieve metadata for the given sensor ID
-  sensors_interface_metadata_ts sensor_metadata = sensors_interface_getSensorMetadata(sensor_id);
+  sensors_metadata_catalog_ts sensor_metadata;
 
-  if(SENSORS_INTERFACE_STATUS_SUCCESS == sensor_metadata.success_status)
+  if(SENSORS_INTERFACE_STATUS_SUCCESS == sensors_interface_getSensorMetadata(sensor_id, &sensor_metadata))
   {
     // Extract what's needed for now
-    uint8_t measurement_type = sensor_metadata.metadata.measurement_type; // Expected measurement type
-    uint8_t num_of_decimals = sensor_metadata.metadata.num_of_decimals; // Number of decimal places for display
+    uint8_t measurement_type = sensor_metadata.measurement_type; // Expected measurement type
+    uint8_t num_of_decimals = sensor_metadata.num_of_decimals; // Number of decimal places for display
 
-    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
+    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
     {
       // Case: Sensor provides a numerical value
-      char val_buffer[DISPLAY_DTOSTRF_BUFFER_SIZE]; // Buffer for formatted float value
-      dtostrf(sensor_data.value, DISPLAY_MIN_FLOAT_STRING_LEN, num_of_decimals, val_buffer); // Convert float to string
-      strncpy(val, val_buffer, sizeof(val) - DISPLAY_NULL_TERMINATOR_SIZE); // Copy into val
-      val[sizeof(val) - DISPLAY_NULL_TERMINATOR_SIZE] = '\0'; // Null terminate
+      (void)output_format_sensorValue(sensor_data->value, num_of_decimals, val, sizeof(val));
       proceed_with_display = DISPLAY_PROCEED_WITH_DISPLAY;
     }
-    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
+    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
     {
       // Case: Sensor provides an indication (boolean)
-      snprintf(val, sizeof(val), "%s", sensor_data.indication ? "yes" : "no");
+      (void)output_format_indication(sensor_data->indication, val, sizeof(val));
       proceed_with_display = DISPLAY_PROCEED_WITH_DISPLAY;
     }
     else
@@ -150,9 +209,9 @@ static control_error_code_te display_displaySensorMeasurement(const control_data
   // Display the formatted value if valid, otherwise clear the display row
   if(DISPLAY_PROCEED_WITH_DISPLAY == proceed_with_display)
   {
-    lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_SENSORS_ROW);
-    String display_string = formatDisplaySensorData(sensor_metadata.metadata, val); // Format display string
-    lcd.print(display_string); // Print the formatted sensor data to the LCD
+    char display_string[DISPLAY_MAX_STRING_LEN];
+    formatDisplaySensorData(&sensor_metadata, val, display_string); // Format display string
+    displayWriteRow(DISPLAY_SENSORS_ROW, display_string); // Write the formatted sensor data to the framebuffer
   }
   else
   {
@@ -161,48 +220,72 @@ static control_error_code_te display_displaySensorMeasurement(const control_data
   return error_code;
 }
 
-static control_error_code_te display_displayTime(const control_data_ts *data)
+#ifdef SENSOR_STATS_USED
+static control_error_code_te display_displaySensorStats(const control_data_ts *data)
 {
-  rtc_reading_ts time_data = data->input_return.rtc_reading;
+  const sensor_stats_reading_ts *stats = &data->input_return.sensor_stats_reading;
+  sensors_metadata_catalog_ts sensor_metadata;
+
+  if(SENSORS_INTERFACE_STATUS_SUCCESS != sensors_interface_getSensorMetadata(data->input.device_id, &sensor_metadata))
+  {
+    displayEmptyLine(DISPLAY_SENSORS_ROW);
+    return ERROR_CODE_SENSOR_NOT_CONFIGURED;
+  }
+
+  uint8_t num_of_decimals = sensor_metadata.num_of_decimals;
+  char min_string[DISPLAY_MAX_STRING_LEN];
+  char mean_string[DISPLAY_MAX_STRING_LEN];
+  char max_string[DISPLAY_MAX_STRING_LEN];
+  (void)output_format_sensorValue(stats->min_value, num_of_decimals, min_string, sizeof(min_string));
+  (void)output_format_sensorValue(stats->mean, num_of_decimals, mean_string, sizeof(mean_string));
+  (void)output_format_sensorValue(stats->max_value, num_of_decimals, max_string, sizeof(max_string));
+
+  char display_string[DISPLAY_MAX_STRING_LEN];
+  snprintf_P(display_string, sizeof(display_string), PSTR("%s/%s/%s%S"), min_string, mean_string, max_string,
+             sensor_metadata.measurement_unit);
+  displayWriteRow(DISPLAY_SENSORS_ROW, display_string);
+  return ERROR_CODE_NO_ERROR;
+}
+#endif
 
-  lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_TIME_ROW);
+static control_error_code_te display_displayTime(const control_data_ts *data)
+{
+  const rtc_reading_ts *time_data = &data->input_return.rtc_reading;
 
-  uint16_t year = time_data.year;
-  uint8_t month = time_data.month;
-  uint8_t day = time_data.day;
-  uint8_t hour = time_data.hour;
-  uint8_t mins = time_data.mins;
-  uint8_t secs = time_data.secs;
+  uint16_t year = time_data->year;
+  uint8_t month = time_data->month;
+  uint8_t day = time_data->day;
+  uint8_t hour = time_data->hour;
+  uint8_t mins = time_data->mins;
 
-  // Build the formatted time string to fit the 16-character display
+  // Build the formatted time string to fit the 16-character display, there is no room for the seconds
   char time_string[DISPLAY_MAX_STRING_LEN]; // One extra for null terminator
-  snprintf(time_string, sizeof(time_string), "%02d:%02d %02d/%02d/%04d", hour, mins, day, month, year); // To avoid dynamic allocation
+  snprintf_P(time_string, sizeof(time_string), PSTR("%02d:%02d %02d/%02d/%04d"), hour, mins, day, month, year); // To avoid dynamic allocation
 
-  lcd.print(time_string);
+  displayWriteRow(DISPLAY_TIME_ROW, time_string); // Usually only the last minute digit changes
 
   return ERROR_CODE_NO_ERROR; // Return success error code
 }
 
 static control_error_code_te display_displayI2cScan(const control_data_ts *data)
 {
-  i2c_scan_reading_ts i2c_scan_data = data->input_return.i2c_scan_reading;
+  const i2c_scan_reading_ts *i2c_scan_data = &data->input_return.i2c_scan_reading;
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
 
   // Create buffer for display strings
   char display_string[DISPLAY_MAX_STRING_LEN];  // +1 for null terminator
 
-  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == i2c_scan_data.device_address)
+  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == i2c_scan_data->device_address)
   {
     // Print user friendly scanning message
-    lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_STRING_ROW);
-    snprintf(display_string, sizeof(display_string), "Scanning I2C....");
-    lcd.print(display_string);
+    strncpy_P(display_string, PSTR("Scanning I2C...."), sizeof(display_string) - DISPLAY_NULL_TERMINATOR_SIZE);
+    display_string[sizeof(display_string) - DISPLAY_NULL_TERMINATOR_SIZE] = '\0';
+    displayWriteRow(DISPLAY_I2C_SCAN_STRING_ROW, display_string);
 
     // Print I2C address
-    lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_ADDR_ROW);
-    snprintf(display_string, sizeof(display_string), "I2C Addr: 0x%02X", i2c_scan_data.current_i2c_addr);
-    lcd.print(display_string);
+    snprintf_P(display_string, sizeof(display_string), PSTR("I2C Addr: 0x%02X"), i2c_scan_data->current_i2c_addr);
+    displayWriteRow(DISPLAY_I2C_SCAN_ADDR_ROW, display_string);
   }
   else
   {
@@ -211,26 +294,26 @@ static control_error_code_te display_displayI2cScan(const control_data_ts *data)
     // Create buffer for status
     char status_string[DISPLAY_MAX_STRING_LEN];  // +1 for null terminator
 
-    switch(i2c_scan_data.single_device_status)
+    switch(i2c_scan_data->single_device_status)
     {
       case I2C_SCAN_TRANSMISSION_RESULT_SUCCESS:
-        snprintf(status_string, sizeof(status_string), "Successful");
+        snprintf_P(status_string, sizeof(status_string), PSTR("Successful"));
         break;
 
       case I2C_SCAN_TRANSMISSION_RESULT_TOOLONG:
-        snprintf(status_string, sizeof(status_string), "Result too long");
+        snprintf_P(status_string, sizeof(status_string), PSTR("Result too long"));
         break;
 
       case I2C_SCAN_TRANSMISSION_RESULT_NACKADR:
-        snprintf(status_string, sizeof(status_string), "Result NACK");
+        snprintf_P(status_string, sizeof(status_string), PSTR("Result NACK"));
         break;
 
       case I2C_SCAN_TRANSMISSION_RESULT_NACKDAT:
-        snprintf(status_string, sizeof(status_string), "Result NACKDAT");
+        snprintf_P(status_string, sizeof(status_string), PSTR("Result NACKDAT"));
         break;
 
       case I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN:
-        snprintf(status_string, sizeof(status_string), "Unknown error");
+        snprintf_P(status_string, sizeof(status_string), PSTR("Unknown error"));
         break;
 
       default:
@@ -242,48 +325,81 @@ static control_error_code_te display_displayI2cScan(const control_data_ts *data)
     if(DISPLAY_PROCEED_WITH_DISPLAY == proceed_with_display)
     {
       // Print headline with device address
-      lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_STRING_ROW);
-      snprintf(display_string, sizeof(display_string), "I2C 0x%02X status:", i2c_scan_data.device_address);
-      lcd.print(display_string);
-
-      // Print device status based on scan result
-      lcd.setCursor(DISPLAY_START_COLUMN, DISPLAY_I2C_SCAN_ADDR_ROW);
-      // Print the status on LCD with padding
-      while(strlen(status_string) < DISPLAY_LCD_WIDTH) 
-      {
-        strcat(status_string, " "); // Pad the string with spaces
-      }
-      lcd.print(status_string);
+      snprintf_P(display_string, sizeof(display_string), PSTR("I2C 0x%02X status:"), i2c_scan_data->device_address);
+      displayWriteRow(DISPLAY_I2C_SCAN_STRING_ROW, display_string);
+
+      // Print device status based on scan result, the rest of the row is padded with spaces
+      displayWriteRow(DISPLAY_I2C_SCAN_ADDR_ROW, status_string);
     }
   }
   /* IMPORTANT: Check of invalid I2C address is done on I2C scanner side and it should not arrive on the Display */
   return error_code;
 }
 
-static String formatDisplaySensorData(sensors_metadata_catalog_ts sensor_metadata, char* val)
+static void formatDisplaySensorData(const sensors_metadata_catalog_ts *sensor_metadata, const char *val, char *display_string)
 {
-  char display_string[DISPLAY_MAX_STRING_LEN]; // Buffer to hold formatted string
-  int display_sensor_type_length = min(sensor_metadata.display_num_of_letters, strlen(sensor_metadata.sensor_type));
-  
-  snprintf(display_string, sizeof(display_string), "%s: %s%s", sensor_metadata.sensor_type, val, sensor_metadata.measurement_unit);
-
-  // Ensure the string fits the display by padding with spaces
-  int len = strlen(display_string);
-  for (int i = len; i < DISPLAY_LCD_WIDTH; ++i)
+  // Sensor type and unit are stored in program memory, padding to the display width is done by the framebuffer
+  snprintf_P(display_string, DISPLAY_MAX_STRING_LEN, PSTR("%S: %s%S"), sensor_metadata->sensor_type, val, sensor_metadata->measurement_unit);
+}
+
+static void displayEmptyLine(uint8_t row)
+{
+  displayWriteRow(row, "");
+}
+
+static void displayWriteRow(uint8_t row, const char *text)
+{
+  bool end_of_text = false;
+
+  for (uint8_t column = 0u; column < DISPLAY_LCD_WIDTH; column++)
   {
-    display_string[i] = ' ';
+    end_of_text = end_of_text || ('\0' == text[column]);
+    char character = end_of_text ? ' ' : text[column];
+
+    if(character != display_framebuffer[row][column])
+    {
+      display_framebuffer[row][column] = character;
+      display_dirty_cells[row] |= (uint16_t)(1u << column);
+    }
   }
-  display_string[DISPLAY_LCD_WIDTH] = '\0';  // Null-terminate the string
-  
-  return String(display_string); // Return the formatted string as a String object
 }
 
-static void displayEmptyLine(uint8_t row)
+static void displayFlush()
 {
-  lcd.setCursor(DISPLAY_START_COLUMN, row);
-  for (uint8_t i = 0; i < DISPLAY_LCD_WIDTH; i++) 
+  for (uint8_t row = 0u; row < DISPLAY_LCD_HEIGHT; row++)
   {
-    lcd.print(" ");
+    uint16_t dirty_cells = display_dirty_cells[row];
+    uint8_t column = 0u;
+
+    // The width bounds the shift first, shifting the 16 bit int of the AVR by 16 is undefined
+    while(column < DISPLAY_LCD_WIDTH && DISPLAY_NO_DIRTY_CELLS != (dirty_cells >> column))
+    {
+      if(0u == ((dirty_cells >> column) & 1u))
+      {
+        column++;
+        continue;
+      }
+
+      // A short gap to the cursor is cheaper to rewrite than a cursor move
+      bool gap_rewritable = (row == display_cursor_row && column > display_cursor_column &&
+                             DISPLAY_MAX_REWRITTEN_GAP >= (column - display_cursor_column));
+      if(gap_rewritable)
+      {
+        column = display_cursor_column;
+      }
+      else if(row != display_cursor_row || column != display_cursor_column)
+      {
+        lcd.setCursor(column, row);
+      }
+
+      (void)lcd.write((uint8_t)display_framebuffer[row][column]);
+      column++;
+      display_cursor_row = row;
+      display_cursor_column = column;
+    }
+
+    display_dirty_cells[row] = DISPLAY_NO_DIRTY_CELLS;
   }
 }
 /* *************************************** */
+#endif
@@ -3,8 +3,8 @@
 
 #include <Arduino.h>
 #include <LiquidCrystal_I2C.h>
-#include <WString.h>
 #include "display_config.h"
+#include "../output_format/output_format.h"
 #include "../../control/control_types.h"
 
 /* Start column for display cursor */
@@ -17,20 +17,27 @@
 /* Flag to prevent displaying data */
 #define DISPLAY_DONT_PROCEED_WITH_DISPLAY (false)
 
-/* Minimum length of the float string for display */
-#define DISPLAY_MIN_FLOAT_STRING_LEN  (signed char)(1)
-/* Size of the buffer for converting float to string */
-#define DISPLAY_DTOSTRF_BUFFER_SIZE   (uint8_t)(20u)
 /* Size for the null terminator in strings */
 #define DISPLAY_NULL_TERMINATOR_SIZE  (uint8_t)(1u)
 /** Defines the maximum string length for the display, including the null terminator. */
 #define DISPLAY_MAX_STRING_LEN        (uint8_t)(DISPLAY_LCD_WIDTH + DISPLAY_NULL_TERMINATOR_SIZE)
 
+/* Dirty mask of a framebuffer row with no changed cells */
+#define DISPLAY_NO_DIRTY_CELLS        (uint16_t)(0u)
+/* Cursor position that is not known, e.g. before the first flush */
+#define DISPLAY_CURSOR_UNKNOWN        (uint8_t)(0xFFu)
+/**
+ * Clean cells between two changed runs that are rewritten instead of moving the cursor.
+ * A cursor move costs one command byte, the same as one character.
+ */
+#define DISPLAY_MAX_REWRITTEN_GAP     (uint8_t)(1u)
+
 /**
  * @brief Initializes the LCD display module.
  *
  * This function sets up the LCD display with the specified dimensions,
  * configures its cursor and backlight settings, and ensures it is ready for use.
+ * The framebuffer is reset to the blank screen left by the LCD initialization.
  *
  * @return control_error_code_te
  * - ERROR_CODE_NO_ERROR: Display initialized successfully.
@@ -42,6 +49,8 @@ control_error_code_te display_init();
  * This function checks the `input_type` of the provided data structure and 
  * calls the appropriate display function to show the corresponding data 
  * (such as sensor readings, RTC readings, I2C scan results) on the LCD.
+ * The display functions only write into the framebuffer, afterwards the changed
+ * characters are sent to the LCD.
  * 
  * @param data A pointer to structure containing the data to be displayed, with the input type 
  *             and the corresponding data based on that type.
@@ -0,0 +1,153 @@
+#include "output_format.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Scale of the fraction part for each number of decimals */
+static const uint16_t output_format_decimal_scales[OUTPUT_FORMAT_MAX_DECIMALS + 1u] PROGMEM = {1u, 10u, 100u, 1000u, 10000u};
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Copies a string from program memory into the buffer, cut to the buffer size.
+ *
+ * @param text String in program memory.
+ * @param buffer Buffer for the text.
+ * @param buffer_size Size of the buffer including the null terminator.
+ * @return uint8_t Number of characters written, without the null terminator.
+ */
+static uint8_t copyText(PGM_P text, char *buffer, uint8_t buffer_size);
+
+/**
+ * @brief Writes a number that is already split into its integer and fraction part.
+ *
+ * @param negative true if a minus sign is written, it is left out if all digits are zero.
+ * @param integer_part The integer part.
+ * @param fraction_part The fraction part, below 10 to the power of decimals.
+ * @param decimals Number of decimals, at most OUTPUT_FORMAT_MAX_DECIMALS.
+ * @param buffer Buffer for the text.
+ * @param buffer_size Size of the buffer including the null terminator.
+ * @return uint8_t Number of characters written, without the null terminator.
+ */
+static uint8_t writeNumber(bool negative, uint32_t integer_part, uint16_t fraction_part, uint8_t decimals, char *buffer, uint8_t buffer_size);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+uint8_t output_format_float(float value, uint8_t num_of_decimals, char *buffer, uint8_t buffer_size)
+{
+  if(isnan(value))
+  {
+    return copyText(PSTR("nan"), buffer, buffer_size);
+  }
+  if(isinf(value))
+  {
+    return copyText(PSTR("inf"), buffer, buffer_size);
+  }
+
+  uint8_t decimals = min(num_of_decimals, OUTPUT_FORMAT_MAX_DECIMALS);
+  uint16_t scale = pgm_read_word(&output_format_decimal_scales[decimals]);
+
+  bool negative = (0.0f > value);
+  float magnitude = (negative ? -value : value) + 0.5f / scale; // Round at the last decimal
+  if(OUTPUT_FORMAT_MAX_INTEGER_PART < magnitude)
+  {
+    return copyText(PSTR("ovf"), buffer, buffer_size);
+  }
+
+  uint32_t integer_part = (uint32_t)magnitude;
+  uint16_t fraction_part = (uint16_t)((magnitude - (float)integer_part) * scale);
+  fraction_part = min(fraction_part, (uint16_t)(scale - 1u)); // Float error must not carry into the integer part
+
+  return writeNumber(negative, integer_part, fraction_part, decimals, buffer, buffer_size);
+}
+
+uint8_t output_format_fixed(int32_t value, uint8_t value_decimals, uint8_t num_of_decimals, char *buffer, uint8_t buffer_size)
+{
+  if(OUTPUT_FORMAT_FIXED_INVALID == value)
+  {
+    return copyText(PSTR("nan"), buffer, buffer_size);
+  }
+
+  uint8_t decimals = min(num_of_decimals, OUTPUT_FORMAT_MAX_DECIMALS);
+  uint8_t stored_decimals = min(value_decimals, OUTPUT_FORMAT_MAX_DECIMALS);
+
+  bool negative = (0 > value);
+  uint32_t magnitude = negative ? (uint32_t)(-value) : (uint32_t)value;
+  if(decimals < stored_decimals)
+  {
+    // Round at the last written decimal
+    uint16_t divisor = pgm_read_word(&output_format_decimal_scales[stored_decimals - decimals]);
+    magnitude = (magnitude + divisor / 2u) / divisor;
+    stored_decimals = decimals;
+  }
+
+  uint16_t stored_scale = pgm_read_word(&output_format_decimal_scales[stored_decimals]);
+  uint32_t integer_part = magnitude / stored_scale;
+  uint16_t fraction_part = (uint16_t)(magnitude % stored_scale) * pgm_read_word(&output_format_decimal_scales[decimals - stored_decimals]);
+
+  return writeNumber(negative, integer_part, fraction_part, decimals, buffer, buffer_size);
+}
+
+uint8_t output_format_sensorValue(sensors_value_t value, uint8_t num_of_decimals, char *buffer, uint8_t buffer_size)
+{
+#ifdef SENSORS_FIXED_POINT_USED
+  return output_format_fixed(value, SENSORS_VALUE_DECIMALS, num_of_decimals, buffer, buffer_size);
+#else
+  return output_format_float(value, num_of_decimals, buffer, buffer_size);
+#endif
+}
+
+uint8_t output_format_indication(bool indication, char *buffer, uint8_t buffer_size)
+{
+  return copyText(indication ? PSTR("yes") : PSTR("no"), buffer, buffer_size);
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static uint8_t copyText(PGM_P text, char *buffer, uint8_t buffer_size)
+{
+  strncpy_P(buffer, text, buffer_size - OUTPUT_FORMAT_NULL_TERMINATOR_SIZE);
+  buffer[buffer_size - OUTPUT_FORMAT_NULL_TERMINATOR_SIZE] = '\0';
+  return (uint8_t)strlen(buffer);
+}
+
+static uint8_t writeNumber(bool negative, uint32_t integer_part, uint16_t fraction_part, uint8_t decimals, char *buffer, uint8_t buffer_size)
+{
+  // Digits are produced from the last one, the text is built backwards
+  char reversed[OUTPUT_FORMAT_FLOAT_BUFFER_SIZE];
+  uint8_t len = 0u;
+
+  for (uint8_t digit = 0u; digit < decimals; digit++)
+  {
+    reversed[len++] = (char)('0' + fraction_part % 10u);
+    fraction_part /= 10u;
+  }
+  if(0u != decimals)
+  {
+    reversed[len++] = '.';
+  }
+  do
+  {
+    reversed[len++] = (char)('0' + integer_part % 10u);
+    integer_part /= 10u;
+  } while(0u != integer_part);
+
+  // No sign if the value rounds to zero
+  bool is_zero = true;
+  for (uint8_t index = 0u; index < len; index++)
+  {
+    is_zero = is_zero && ('0' == reversed[index] || '.' == reversed[index]);
+  }
+  if(negative && !is_zero)
+  {
+    reversed[len++] = '-';
+  }
+
+  uint8_t written = 0u;
+  while(written < len && written < buffer_size - OUTPUT_FORMAT_NULL_TERMINATOR_SIZE)
+  {
+    buffer[written] = reversed[len - 1u - written];
+    written++;
+  }
+  buffer[written] = '\0';
+  return written;
+}
+/* *************************************** */
@@ -0,0 +1,78 @@
+#ifndef OUTPUT_FORMAT_H
+#define OUTPUT_FORMAT_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "../../input/input_types.h"
+
+/**
+ * @file output_format.h
+ * @brief Allocation free formatting helpers shared by the output components.
+ *
+ * All functions write into a buffer provided by the caller and always null terminate it,
+ * text that does not fit is cut.
+ */
+
+/* Maximum number of decimals, more requested decimals are limited to this */
+#define OUTPUT_FORMAT_MAX_DECIMALS       (uint8_t)(4u)
+/** Buffer size for any formatted float: sign, 10 integer digits, point, 4 decimals and null terminator */
+#define OUTPUT_FORMAT_FLOAT_BUFFER_SIZE  (uint8_t)(17u)
+/* Values with a magnitude above this do not fit into the 32-bit integer part */
+#define OUTPUT_FORMAT_MAX_INTEGER_PART   (float)(4294967040.0f)
+/* Fixed-point value without a reading, same as SENSORS_VALUE_INVALID in fixed-point mode */
+#define OUTPUT_FORMAT_FIXED_INVALID      (int32_t)(-2147483647L - 1L)
+/* Size for the null terminator in strings */
+#define OUTPUT_FORMAT_NULL_TERMINATOR_SIZE (uint8_t)(1u)
+
+/**
+ * @brief Formats a float with a fixed number of decimals, replacement for dtostrf().
+ *
+ * The value is rounded half away from zero at the last decimal. NAN, infinity and values
+ * that do not fit into 32 bits are written as "nan", "inf" and "ovf", like Print does.
+ *
+ * @param value The value to format.
+ * @param num_of_decimals Number of decimals, at most OUTPUT_FORMAT_MAX_DECIMALS.
+ * @param buffer Buffer for the text.
+ * @param buffer_size Size of the buffer including the null terminator, must not be zero.
+ * @return uint8_t Number of characters written, without the null terminator.
+ */
+uint8_t output_format_float(float value, uint8_t num_of_decimals, char *buffer, uint8_t buffer_size);
+
+/**
+ * @brief Formats a fixed-point value with a fixed number of decimals.
+ *
+ * Works in integer arithmetic only. The value is rounded half away from zero if fewer decimals
+ * are requested than stored, missing decimals are filled with zeros. OUTPUT_FORMAT_FIXED_INVALID
+ * is written as "nan".
+ *
+ * @param value The value, scaled by 10 to the power of value_decimals.
+ * @param value_decimals Number of decimals stored in the value, at most OUTPUT_FORMAT_MAX_DECIMALS.
+ * @param num_of_decimals Number of decimals to write, at most OUTPUT_FORMAT_MAX_DECIMALS.
+ * @param buffer Buffer for the text.
+ * @param buffer_size Size of the buffer including the null terminator, must not be zero.
+ * @return uint8_t Number of characters written, without the null terminator.
+ */
+uint8_t output_format_fixed(int32_t value, uint8_t value_decimals, uint8_t num_of_decimals, char *buffer, uint8_t buffer_size);
+
+/**
+ * @brief Formats a sensor value, float or fixed-point depending on SENSORS_FIXED_POINT_USED.
+ *
+ * @param value The sensor value.
+ * @param num_of_decimals Number of decimals, at most OUTPUT_FORMAT_MAX_DECIMALS.
+ * @param buffer Buffer for the text.
+ * @param buffer_size Size of the buffer including the null terminator, must not be zero.
+ * @return uint8_t Number of characters written, without the null terminator.
+ */
+uint8_t output_format_sensorValue(sensors_value_t value, uint8_t num_of_decimals, char *buffer, uint8_t buffer_size);
+
+/**
+ * @brief Writes the text of an indication measurement.
+ *
+ * @param indication The indication value.
+ * @param buffer Buffer for the text.
+ * @param buffer_size Size of the buffer including the null terminator, must not be zero.
+ * @return uint8_t Number of characters written, without the null terminator.
+ */
+uint8_t output_format_indication(bool indication, char *buffer, uint8_t buffer_size);
+
+#endif
@@ -1,5 +1,24 @@
 #include "serial_console.h"
 
+/* STATIC GLOBAL VARIABLES */
+static uint8_t serial_console_output_mode = SERIAL_CONSOLE_DEFAULT_OUTPUT_MODE;
+/* Sequence number of the next telemetry frame, wraps around */
+static uint8_t serial_console_frame_sequence = 0u;
+
+/* Transmit ring, filled by the display functions and drained by serial_console_processTx() */
+static uint8_t serial_console_tx_buffer[SERIAL_CONSOLE_TX_BUFFER_SIZE];
+static uint16_t serial_console_tx_head = 0u;   // Index of the oldest queued byte
+static uint16_t serial_console_tx_count = 0u;  // Number of queued bytes
+static serial_console_tx_stats_ts serial_console_tx_stats = {0u, 0u, 0u};
+/* Lengths of the queued messages, oldest first, so the drop policy never cuts a message */
+static uint8_t serial_console_tx_messages[SERIAL_CONSOLE_TX_MAX_MESSAGES];
+static uint8_t serial_console_tx_first_message = 0u;
+static uint8_t serial_console_tx_num_of_messages = 0u;
+static uint8_t serial_console_tx_message_sent = 0u;  // Bytes of the oldest message already moved to the hardware
+
+static_assert(0xFFu >= SERIAL_CONSOLE_TX_BUFFER_SIZE, "Message lengths are kept in bytes");
+/* *************************************** */
+
 /* STATIC FUNCTION PROTOTYPES */
 /**
  * @brief Displays sensor measurements on the serial console.
@@ -15,6 +34,33 @@
  */
 static control_error_code_te serial_console_displaySensorMeasurement(const control_data_ts *data);
 
+#ifdef SENSOR_STATS_USED
+/**
+ * @brief Displays the rolling statistics of a sensor channel on the serial console.
+ *
+ * Statistics are always sent as a text line, also in the binary output mode.
+ *
+ * @param data Pointer to data containing the statistics and the sensor ID.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Statistics displayed successfully.
+ * - ERROR_CODE_SENSOR_NOT_CONFIGURED: Sensor metadata retrieval failed.
+ */
+static control_error_code_te serial_console_displaySensorStats(const control_data_ts *data);
+
+/**
+ * @brief Appends a labelled value of the statistics to a line, cut at the end of the buffer.
+ *
+ * @param line Null-terminated line to append to.
+ * @param line_size Size of the line buffer.
+ * @param label Label of the value, in program memory.
+ * @param value The value.
+ * @param num_of_decimals Number of decimals of the value.
+ * @param measurement_unit Unit of the value, in program memory.
+ */
+static void appendStatsValue(char *line, uint8_t line_size, PGM_P label, sensors_value_t value, uint8_t num_of_decimals,
+                             PGM_P measurement_unit);
+#endif
+
 /**
  * @brief Displays the current RTC time on the serial console.
  *
@@ -39,6 +85,83 @@ static control_error_code_te serial_console_displayTime(const control_data_ts *d
  * - ERROR_CODE_UNKNOWN_I2C_DEVICE_STATUS: Unknown device status during communication.
  */
 static control_error_code_te serial_console_displayI2cScan(const control_data_ts *data);
+
+/**
+ * @brief Displays a report of the error manager on the serial console.
+ *
+ * Reports are always sent as a text line, also in the binary output mode.
+ *
+ * @param data Pointer to data containing the error report.
+ * @return control_error_code_te
+ * - ERROR_CODE_NO_ERROR: Report displayed successfully.
+ */
+static control_error_code_te serial_console_displayErrorReport(const control_data_ts *data);
+
+/**
+ * @brief Sends a telemetry frame and advances the frame sequence number.
+ *
+ * @param frame Pointer to the encoded frame.
+ * @param frame_len Length of the frame.
+ */
+static void writeFrame(const uint8_t *frame, uint8_t frame_len);
+
+/**
+ * @brief Queues a text line followed by the line ending.
+ *
+ * @param line Null-terminated string.
+ */
+static void writeLine(const char *line);
+
+/**
+ * @brief Queues one message in the transmit ring, applying the drop policy if it does not fit.
+ *
+ * The message and the optional line ending are queued or dropped together.
+ *
+ * @param message Pointer to the bytes.
+ * @param len Number of bytes.
+ * @param line_end true to append SERIAL_CONSOLE_LINE_END.
+ */
+static void queueMessage(const uint8_t *message, uint16_t len, bool line_end);
+
+/**
+ * @brief Copies bytes to the end of the transmit ring, the caller ensures there is room.
+ *
+ * @param bytes Pointer to the bytes.
+ * @param len Number of bytes.
+ */
+static void pushBytes(const uint8_t *bytes, uint16_t len);
+
+/**
+ * @brief Checks if a message of a length can be queued without dropping anything.
+ *
+ * @param len Number of bytes, including the line ending.
+ * @return bool true if the ring has room for the bytes and the message.
+ */
+static bool hasRoomFor(uint16_t len);
+
+/**
+ * @brief Drops the oldest queued message which has not started to be sent.
+ *
+ * A message which is being sent is kept whole, the message after it is dropped and
+ * the unsent rest of the message in progress is moved up to close the gap.
+ *
+ * @return bool SERIAL_CONSOLE_MESSAGE_DROPPED or SERIAL_CONSOLE_NOTHING_TO_DROP.
+ */
+static bool dropOldestMessage();
+
+/**
+ * @brief Forgets the messages which were moved to the hardware serial buffer.
+ *
+ * @param sent_bytes Number of bytes moved to the hardware.
+ */
+static void markSent(uint16_t sent_bytes);
+
+/**
+ * @brief Counts a dropped message and its dropped bytes.
+ *
+ * @param dropped_bytes Number of bytes which will not be sent.
+ */
+static void countDrop(uint16_t dropped_bytes);
 /* *************************************** */
 
 /* EXPORTED FUNCTIONS */
@@ -67,14 +190,26 @@ control_error_code_te serial_console_displayData(const control_data_ts *data)
       error_code = serial_console_displaySensorMeasurement(data); // Display sensor data
       break;
 
+#ifdef RTC_COMPONENT
     case INPUT_RTC:
       error_code = serial_console_displayTime(data); // Display RTC time data 
       break;
+#endif
+
+#ifdef SENSOR_STATS_USED
+    case INPUT_SENSOR_STATS:
+      error_code = serial_console_displaySensorStats(data); // Display rolling statistics of a sensor
+      break;
+#endif
 
     case INPUT_I2C_SCAN:
       error_code = serial_console_displayI2cScan(data); // Display I2C scan results
       break;
 
+    case INPUT_ERROR:
+      error_code = serial_console_displayErrorReport(data); // Display a report of the error manager
+      break;
+
     default:
       // No action, error code is already set
       break;
@@ -82,55 +217,115 @@ control_error_code_te serial_console_displayData(const control_data_ts *data)
 
   return error_code;
 }
+
+void serial_console_printLine(const char *line)
+{
+  writeLine(line);
+}
+
+char serial_console_readCommand()
+{
+  while(Serial.available() > 0)
+  {
+    char command = (char)Serial.read();
+    // Skip line endings and spaces sent by terminals
+    if(' ' != command && '\r' != command && '\n' != command)
+    {
+      return command;
+    }
+  }
+  return SERIAL_CONSOLE_NO_COMMAND;
+}
+
+void serial_console_setOutputMode(uint8_t output_mode)
+{
+  serial_console_output_mode = output_mode;
+}
+
+void serial_console_toggleOutputMode()
+{
+  serial_console_output_mode = (SERIAL_CONSOLE_OUTPUT_MODE_TEXT == serial_console_output_mode) ?
+                               SERIAL_CONSOLE_OUTPUT_MODE_BINARY : SERIAL_CONSOLE_OUTPUT_MODE_TEXT;
+}
+
+void serial_console_processTx()
+{
+  int hardware_room = Serial.availableForWrite();
+  uint16_t num_of_bytes = (0 < hardware_room) ? min(serial_console_tx_count, (uint16_t)hardware_room) : 0u;
+  markSent(num_of_bytes);
+
+  while(0u != num_of_bytes)
+  {
+    // Send the contiguous part up to the end of the ring at once
+    uint16_t chunk = min(num_of_bytes, (uint16_t)(SERIAL_CONSOLE_TX_BUFFER_SIZE - serial_console_tx_head));
+    (void)Serial.write(&serial_console_tx_buffer[serial_console_tx_head], chunk);
+    serial_console_tx_head = (serial_console_tx_head + chunk) % SERIAL_CONSOLE_TX_BUFFER_SIZE;
+    serial_console_tx_count -= chunk;
+    num_of_bytes -= chunk;
+  }
+}
+
+uint16_t serial_console_getTxFree()
+{
+  return SERIAL_CONSOLE_TX_BUFFER_SIZE - serial_console_tx_count;
+}
+
+serial_console_tx_stats_ts serial_console_getTxStats()
+{
+  return serial_console_tx_stats;
+}
 /* *************************************** */
 
 /* STATIC FUNCTIONS IMPLEMENTATIONS */
 static control_error_code_te serial_console_displaySensorMeasurement(const control_data_ts *data)
 {
-  sensor_reading_ts sensor_data = data->input_return.sensor_reading;
+  const sensor_reading_ts *sensor_data = &data->input_return.sensor_reading;
   uint8_t sensor_id = data->input.device_id;
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
 
   // Retrieve sensor metadata
-  sensors_interface_metadata_ts sensor_metadata = sensors_interface_getSensorMetadata(sensor_id);
+  sensors_metadata_catalog_ts sensor_metadata;
 
   // Check if metadata retrieval was successful
-  if(SENSORS_INTERFACE_STATUS_SUCCESS == sensor_metadata.success_status)
+  if(SENSORS_INTERFACE_STATUS_SUCCESS == sensors_interface_getSensorMetadata(sensor_id, &sensor_metadata))
   {
     // Extract metadata fields (display_num_of_letters is not needed in this case since everything is displayed)
-    const char* sensor_type = sensor_metadata.metadata.sensor_type;
-    const char* measurement_unit = sensor_metadata.metadata.measurement_unit;
-    uint8_t measurement_type = sensor_metadata.metadata.measurement_type;
-    uint8_t num_of_decimals = sensor_metadata.metadata.num_of_decimals;
-
-    char display_string[SERIAL_CONSOLE_STRING_RESERVED_LARGE]; // Buffer for output string
-    char val[SERIAL_CONSOLE_DTOSTRF_BUFFER_SIZE]; // Buffer for value string
+    const char* sensor_type = sensor_metadata.sensor_type;            // In program memory
+    const char* measurement_unit = sensor_metadata.measurement_unit;  // In program memory
+    uint8_t measurement_type = sensor_metadata.measurement_type;
+    uint8_t num_of_decimals = sensor_metadata.num_of_decimals;
 
-    bool proceed_with_display = SERIAL_CONSOLE_PROCEED_WITH_DISPLAY;
+    bool value_measurement = (SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type);
+    bool indication_measurement = (SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data->measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type);
 
-    // Handle value-based measurements
-    if(SENSORS_MEASUREMENT_TYPE_VALUE == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_VALUE == measurement_type)
+    if(!value_measurement && !indication_measurement)
     {
-      dtostrf(sensor_data.value, SERIAL_CONSOLE_MIN_FLOAT_STRING_LEN, num_of_decimals, val); // Convert float to char array
+      // Set error code for invalid measurement type
+      error_code = ERROR_CODE_INVALID_SENSOR_MEASUREMENT_TYPE;
     }
-    // Handle indication-based measurements
-    else if(SENSORS_MEASUREMENT_TYPE_INDICATION == sensor_data.measurement_type_switch && SENSORS_MEASUREMENT_TYPE_INDICATION == measurement_type)
+    else if(SERIAL_CONSOLE_OUTPUT_MODE_BINARY == serial_console_output_mode)
     {
-      strncpy(val, (sensor_data.indication ? "yes" : "no"), sizeof(val) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
-      val[sizeof(val) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE] = '\0'; // Ensure null termination
+      uint8_t frame[SERIAL_TELEMETRY_MAX_FRAME_LEN];
+      uint8_t frame_len = serial_telemetry_encodeSensorFrame(serial_console_frame_sequence, millis(), sensor_id,
+                                                             sensor_data, num_of_decimals, frame);
+      writeFrame(frame, frame_len);
     }
     else
     {
-      // Set error code for invalid measurement type
-      error_code = ERROR_CODE_INVALID_SENSOR_MEASUREMENT_TYPE;
-      proceed_with_display = SERIAL_CONSOLE_DONT_PROCEED_WITH_DISPLAY;
-    }
-    // Format and display the sensor data if everything is okay
-    if(SERIAL_CONSOLE_PROCEED_WITH_DISPLAY == proceed_with_display)
-    {
-      snprintf(display_string, sizeof(display_string), "%s: %s%s", sensor_type, val, measurement_unit);
-      Serial.println(display_string);
+      char display_string[SERIAL_CONSOLE_STRING_RESERVED_LARGE]; // Buffer for output string
+      char val[SERIAL_CONSOLE_VALUE_BUFFER_SIZE]; // Buffer for value string
+
+      if(value_measurement)
+      {
+        (void)output_format_sensorValue(sensor_data->value, num_of_decimals, val, sizeof(val)); // Convert value to char array
+      }
+      else
+      {
+        (void)output_format_indication(sensor_data->indication, val, sizeof(val));
+      }
+      snprintf_P(display_string, sizeof(display_string), PSTR("%S: %s%S"), sensor_type, val, measurement_unit);
+      writeLine(display_string);
     }
   }
   else
@@ -140,72 +335,115 @@ static control_error_code_te serial_console_displaySensorMeasurement(const contr
   return error_code;
 }
 
+#ifdef SENSOR_STATS_USED
+static control_error_code_te serial_console_displaySensorStats(const control_data_ts *data)
+{
+  const sensor_stats_reading_ts *stats = &data->input_return.sensor_stats_reading;
+  sensors_metadata_catalog_ts sensor_metadata;
+
+  if(SENSORS_INTERFACE_STATUS_SUCCESS != sensors_interface_getSensorMetadata(data->input.device_id, &sensor_metadata))
+  {
+    return ERROR_CODE_SENSOR_NOT_CONFIGURED;
+  }
+
+  const char* measurement_unit = sensor_metadata.measurement_unit; // In program memory
+  uint8_t num_of_decimals = sensor_metadata.num_of_decimals;
+  char display_string[SERIAL_CONSOLE_STRING_RESERVED_GIANT];
+
+  snprintf_P(display_string, sizeof(display_string), PSTR("%S last %us/%u samples:"),
+             sensor_metadata.sensor_type, stats->covered_seconds, stats->num_of_samples);
+  appendStatsValue(display_string, sizeof(display_string), PSTR("min"), stats->min_value, num_of_decimals, measurement_unit);
+  appendStatsValue(display_string, sizeof(display_string), PSTR("mean"), stats->mean, num_of_decimals, measurement_unit);
+  appendStatsValue(display_string, sizeof(display_string), PSTR("max"), stats->max_value, num_of_decimals, measurement_unit);
+  // One more decimal for the deviation, it is usually smaller than the resolution of the values
+  appendStatsValue(display_string, sizeof(display_string), PSTR("sd"), stats->std_deviation, num_of_decimals + 1u, measurement_unit);
+
+  writeLine(display_string);
+  return ERROR_CODE_NO_ERROR;
+}
+
+static void appendStatsValue(char *line, uint8_t line_size, PGM_P label, sensors_value_t value, uint8_t num_of_decimals,
+                             PGM_P measurement_unit)
+{
+  char val[SERIAL_CONSOLE_VALUE_BUFFER_SIZE];
+  (void)output_format_sensorValue(value, num_of_decimals, val, sizeof(val));
+
+  size_t len = strlen(line); // Never beyond the buffer, snprintf_P cuts and terminates
+  snprintf_P(line + len, line_size - len, PSTR(" %S %s%S"), label, val, measurement_unit);
+}
+#endif
+
 static control_error_code_te serial_console_displayTime(const control_data_ts *data)
 {
-  rtc_reading_ts time_data = data->input_return.rtc_reading;
+  const rtc_reading_ts *time_data = &data->input_return.rtc_reading;
+
+  if(SERIAL_CONSOLE_OUTPUT_MODE_BINARY == serial_console_output_mode)
+  {
+    uint8_t frame[SERIAL_TELEMETRY_MAX_FRAME_LEN];
+    uint8_t frame_len = serial_telemetry_encodeTimeFrame(serial_console_frame_sequence, millis(), time_data, frame);
+    writeFrame(frame, frame_len);
+    return ERROR_CODE_NO_ERROR;
+  }
 
   // Extract time components
-  uint16_t year = time_data.year;
-  uint8_t month = time_data.month;
-  uint8_t day = time_data.day;
-  uint8_t hour = time_data.hour;
-  uint8_t mins = time_data.mins;
-  uint8_t secs = time_data.secs;
+  uint16_t year = time_data->year;
+  uint8_t month = time_data->month;
+  uint8_t day = time_data->day;
+  uint8_t hour = time_data->hour;
+  uint8_t mins = time_data->mins;
+  uint8_t secs = time_data->secs;
 
   // Buffer for formatted time string
   char time_string[SERIAL_CONSOLE_STRING_RESERVED_MEDIUM]; // Ensures enough space
 
   // Format the time string with zero-padding
-  snprintf(time_string, sizeof(time_string), 
-           "Current time: %02u:%02u %02u/%02u/%u", 
-           hour, mins, day, month, year);
+  snprintf_P(time_string, sizeof(time_string), 
+             PSTR("Current time: %02u:%02u:%02u %02u/%02u/%u"), 
+             hour, mins, secs, day, month, year);
 
   // Display the formatted time
-  Serial.println(time_string);
+  writeLine(time_string);
 
   return ERROR_CODE_NO_ERROR;
 }
 
 static control_error_code_te serial_console_displayI2cScan(const control_data_ts *data)
 {
-  i2c_scan_reading_ts i2c_scan_data = data->input_return.i2c_scan_reading;
+  const i2c_scan_reading_ts *i2c_scan_data = &data->input_return.i2c_scan_reading;
 
   control_error_code_te error_code = ERROR_CODE_NO_ERROR;
 
   bool proceed_with_display = SERIAL_CONSOLE_PROCEED_WITH_DISPLAY;
 
   char display_string[SERIAL_CONSOLE_STRING_RESERVED_GIANT]; // Allocate a reasonable buffer
-  char addr_string[SERIAL_CONSOLE_HEX_ADDR_STRING_LEN]; // Buffer for hexadecimal address representation
 
   // Handle scan for all devices mode
-  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == i2c_scan_data.device_address)
+  if(I2C_SCAN_MODE_SCAN_FOR_ALL_DEVICES == i2c_scan_data->device_address)
   {
-    snprintf(addr_string, sizeof(addr_string), "%02X", i2c_scan_data.current_i2c_addr);
-    snprintf(display_string, sizeof(display_string), "I2C scan - I2C device found at address: 0x%s", addr_string);
+    snprintf_P(display_string, sizeof(display_string), PSTR("I2C scan - I2C device found at address: 0x%02X"), i2c_scan_data->current_i2c_addr);
   }
   else
   {
-    snprintf(addr_string, sizeof(addr_string), "%02X", i2c_scan_data.device_address);
-    snprintf(display_string, sizeof(display_string), "I2C device on address 0x%s status: ", addr_string);
+    snprintf_P(display_string, sizeof(display_string), PSTR("I2C device on address 0x%02X status: "), i2c_scan_data->device_address);
 
-    char status_msg[SERIAL_CONSOLE_STRING_RESERVED_LARGE]; // Buffer for the status message
+    PGM_P status_msg = nullptr; // Status message in program memory
     // Interpret and append the device status
-    switch (i2c_scan_data.single_device_status)
+    switch (i2c_scan_data->single_device_status)
     {
       case I2C_SCAN_TRANSMISSION_RESULT_SUCCESS:
-        strncpy(status_msg, "Successful transmission", sizeof(status_msg) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+        status_msg = PSTR("Successful transmission");
         break;
       case I2C_SCAN_TRANSMISSION_RESULT_TOOLONG:
-        strncpy(status_msg, "Data too long to fit in transmit buffer", sizeof(status_msg) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+        status_msg = PSTR("Data too long to fit in transmit buffer");
         break;
       case I2C_SCAN_TRANSMISSION_RESULT_NACKADR:
-        strncpy(status_msg, "Received NACK on transmit of the address", sizeof(status_msg) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+        status_msg = PSTR("Received NACK on transmit of the address");
         break;
       case I2C_SCAN_TRANSMISSION_RESULT_NACKDAT:
-        strncpy(status_msg, "Received NACK on transmit of the data", sizeof(status_msg) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+        status_msg = PSTR("Received NACK on transmit of the data");
         break;
       case I2C_SCAN_TRANSMISSION_RESULT_UNKNOWN:
-        strncpy(status_msg, "Unknown error occurred during communication", sizeof(status_msg) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+        status_msg = PSTR("Unknown error occurred during communication");
         break;
       default:
         error_code = ERROR_CODE_UNKNOWN_I2C_DEVICE_STATUS;
@@ -215,16 +453,158 @@ static control_error_code_te serial_console_displayI2cScan(const control_data_ts
 
     if (SERIAL_CONSOLE_PROCEED_WITH_DISPLAY == proceed_with_display)
     {
-      strncat(display_string, status_msg, sizeof(display_string) - strlen(display_string) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
+      strncat_P(display_string, status_msg, sizeof(display_string) - strlen(display_string) - SERIAL_CONSOLE_NULL_TERMINATOR_SIZE);
     }
   }
   // IMPORTANT: Check of invalid I2C address is done on I2C scanner side and it should not arrive on the Serial Console
   // Display the formatted string if no error occurred
   if(SERIAL_CONSOLE_PROCEED_WITH_DISPLAY == proceed_with_display)
   {
-    Serial.println(display_string);
+    writeLine(display_string);
   }
 
   return error_code;
 }
-/* *************************************** */
\ No newline at end of file
+
+static control_error_code_te serial_console_displayErrorReport(const control_data_ts *data)
+{
+  const control_error_report_ts *report = &data->input_return.error_report;
+
+  PGM_P event_label = PSTR("summary");
+  if(CONTROL_ERROR_EVENT_RAISED == report->event)
+  {
+    event_label = PSTR("raised");
+  }
+  else if(CONTROL_ERROR_EVENT_CLEARED == report->event)
+  {
+    event_label = PSTR("cleared");
+  }
+
+  // Count is since the previous report of the error, total since it was raised
+  char display_string[SERIAL_CONSOLE_STRING_RESERVED_GIANT];
+  snprintf_P(display_string, sizeof(display_string), PSTR("Error %S: code %u, component %u/%u, count %u/%u, seen %lus-%lus"),
+             event_label, (unsigned)report->error.error_code, report->error.component.io_component,
+             report->error.component.device_id, report->count, report->total,
+             (unsigned long)report->first_seen_s, (unsigned long)report->last_seen_s);
+  writeLine(display_string);
+
+  return ERROR_CODE_NO_ERROR;
+}
+
+static void writeFrame(const uint8_t *frame, uint8_t frame_len)
+{
+  queueMessage(frame, frame_len, false);
+  serial_console_frame_sequence++; // Also advanced for dropped frames, so the receiver sees the loss
+}
+
+static void writeLine(const char *line)
+{
+  queueMessage((const uint8_t *)line, (uint16_t)strlen(line), true);
+}
+
+static void queueMessage(const uint8_t *message, uint16_t len, bool line_end)
+{
+  uint16_t total_len = len + (line_end ? SERIAL_CONSOLE_LINE_END_LEN : 0u);
+
+  if(SERIAL_CONSOLE_TX_BUFFER_SIZE < total_len)
+  {
+    countDrop(total_len); // Never fits, regardless of the policy
+    return;
+  }
+
+  if(SERIAL_CONSOLE_TX_DROP_OLDEST == SERIAL_CONSOLE_TX_DROP_POLICY)
+  {
+    // Whole messages make room, every one of them is counted
+    while(!hasRoomFor(total_len) && SERIAL_CONSOLE_MESSAGE_DROPPED == dropOldestMessage())
+    {
+    }
+  }
+  if(!hasRoomFor(total_len))
+  {
+    countDrop(total_len);
+    return;
+  }
+
+  serial_console_tx_messages[(serial_console_tx_first_message + serial_console_tx_num_of_messages) % SERIAL_CONSOLE_TX_MAX_MESSAGES] = (uint8_t)total_len;
+  serial_console_tx_num_of_messages++;
+  pushBytes(message, len);
+  if(line_end)
+  {
+    pushBytes((const uint8_t *)SERIAL_CONSOLE_LINE_END, SERIAL_CONSOLE_LINE_END_LEN);
+  }
+  serial_console_tx_stats.high_water_mark = max(serial_console_tx_stats.high_water_mark, serial_console_tx_count);
+}
+
+static void pushBytes(const uint8_t *bytes, uint16_t len)
+{
+  for (uint16_t index = 0u; index < len; index++)
+  {
+    uint16_t tail = (serial_console_tx_head + serial_console_tx_count) % SERIAL_CONSOLE_TX_BUFFER_SIZE;
+    serial_console_tx_buffer[tail] = bytes[index];
+    serial_console_tx_count++;
+  }
+}
+
+static bool hasRoomFor(uint16_t len)
+{
+  return (len <= SERIAL_CONSOLE_TX_BUFFER_SIZE - serial_console_tx_count &&
+          SERIAL_CONSOLE_TX_MAX_MESSAGES > serial_console_tx_num_of_messages);
+}
+
+static bool dropOldestMessage()
+{
+  // The message in progress would be cut on the line, the one after it goes instead
+  uint8_t dropped = (0u != serial_console_tx_message_sent) ? 1u : 0u;
+  if(dropped >= serial_console_tx_num_of_messages)
+  {
+    return SERIAL_CONSOLE_NOTHING_TO_DROP;
+  }
+
+  uint8_t dropped_slot = (serial_console_tx_first_message + dropped) % SERIAL_CONSOLE_TX_MAX_MESSAGES;
+  uint8_t dropped_len = serial_console_tx_messages[dropped_slot];
+  if(0u != dropped)
+  {
+    // Rest of the message in progress is moved up to the end of the dropped one, back to front
+    uint8_t rest = serial_console_tx_messages[serial_console_tx_first_message] - serial_console_tx_message_sent;
+    for (uint8_t offset = rest; 0u != offset; offset--)
+    {
+      serial_console_tx_buffer[(serial_console_tx_head + offset - 1u + dropped_len) % SERIAL_CONSOLE_TX_BUFFER_SIZE] =
+        serial_console_tx_buffer[(serial_console_tx_head + offset - 1u) % SERIAL_CONSOLE_TX_BUFFER_SIZE];
+    }
+    serial_console_tx_messages[dropped_slot] = serial_console_tx_messages[serial_console_tx_first_message];
+  }
+
+  serial_console_tx_head = (serial_console_tx_head + dropped_len) % SERIAL_CONSOLE_TX_BUFFER_SIZE;
+  serial_console_tx_count -= dropped_len;
+  serial_console_tx_first_message = dropped_slot;
+  serial_console_tx_num_of_messages--;
+  countDrop(dropped_len);
+  return SERIAL_CONSOLE_MESSAGE_DROPPED;
+}
+
+static void markSent(uint16_t sent_bytes)
+{
+  while(0u != sent_bytes)
+  {
+    uint8_t rest = serial_console_tx_messages[serial_console_tx_first_message] - serial_console_tx_message_sent;
+    if(sent_bytes < rest)
+    {
+      serial_console_tx_message_sent += (uint8_t)sent_bytes;
+      break;
+    }
+    sent_bytes -= rest;
+    serial_console_tx_message_sent = 0u;
+    serial_console_tx_first_message = (serial_console_tx_first_message + 1u) % SERIAL_CONSOLE_TX_MAX_MESSAGES;
+    serial_console_tx_num_of_messages--;
+  }
+}
+
+static void countDrop(uint16_t dropped_bytes)
+{
+  serial_console_tx_stats.dropped_bytes += dropped_bytes;
+  if(SERIAL_CONSOLE_COUNTER_MAX > serial_console_tx_stats.dropped_messages)
+  {
+    serial_console_tx_stats.dropped_messages++;
+  }
+}
+/* *************************************** */
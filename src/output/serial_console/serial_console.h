@@ -3,23 +3,30 @@
 
 #include <Arduino.h>
 #include <avr/pgmspace.h>
-#include <WString.h>
+#include "../output_format/output_format.h"
 #include "../../control/control_types.h"
 #include "serial_console_config.h"
+#include "serial_telemetry.h"
 
 /* Flag to proceed with displaying data */
 #define SERIAL_CONSOLE_PROCEED_WITH_DISPLAY      (bool)(true)
 /* Flag to prevent displaying data */
 #define SERIAL_CONSOLE_DONT_PROCEED_WITH_DISPLAY (bool)(false)
 
-/* Size of the buffer for converting float to string */
-#define SERIAL_CONSOLE_DTOSTRF_BUFFER_SIZE   (uint8_t)(20u)
+/* Size of the buffer for the value or indication text of a measurement */
+#define SERIAL_CONSOLE_VALUE_BUFFER_SIZE     (uint8_t)(OUTPUT_FORMAT_FLOAT_BUFFER_SIZE)
 /* Size for the null terminator in strings */
 #define SERIAL_CONSOLE_NULL_TERMINATOR_SIZE  (uint8_t)(1u)
-/* Minimal size of float string for serial console */
-#define SERIAL_CONSOLE_MIN_FLOAT_STRING_LEN  (signed char)(1)
-/* Len of formated hex address */
-#define SERIAL_CONSOLE_HEX_ADDR_STRING_LEN   (uint8_t)(3u)
+/* Line ending appended to text messages */
+#define SERIAL_CONSOLE_LINE_END              "\r\n"
+#define SERIAL_CONSOLE_LINE_END_LEN          (uint8_t)(2u)
+/* Saturation value of the transmit counters */
+#define SERIAL_CONSOLE_COUNTER_MAX           (uint16_t)(0xFFFFu)
+/* Results of dropping the oldest queued message */
+#define SERIAL_CONSOLE_MESSAGE_DROPPED       (bool)(true)
+#define SERIAL_CONSOLE_NOTHING_TO_DROP       (bool)(false)
+/* Returned by serial_console_readCommand() if no command was received */
+#define SERIAL_CONSOLE_NO_COMMAND            (char)('\0')
 
 // Predefined buffer sizes for string storage in serial console output
 #define SERIAL_CONSOLE_STRING_RESERVED_MINI          (uint16_t)(10u)  /* Suitable for short strings like status codes or flags */
@@ -29,6 +36,16 @@
 #define SERIAL_CONSOLE_STRING_RESERVED_GIANT         (uint16_t)(100u) /* Suitable for multi-field messages or debugging output */
 #define SERIAL_CONSOLE_STRING_RESERVED_ENORMOUS      (uint16_t)(200u) /* Very large messages or extensive debugging output, not recommended for RAM saving */
 
+/**
+ * @brief Transmit ring statistics since start up.
+ */
+typedef struct
+{
+  uint32_t dropped_bytes;     // Bytes that were never sent because the ring was full
+  uint16_t dropped_messages;  // Messages that were dropped, a message is always dropped as a whole
+  uint16_t high_water_mark;   // Highest number of bytes queued at once
+} serial_console_tx_stats_ts;
+
 /**
  * @brief Initializes the serial console communication.
  *
@@ -45,7 +62,8 @@ control_error_code_te serial_console_init();
  * @brief Displays data on the serial console based on input type.
  *
  * This function handles data routing and invokes specific display functions
- * based on the type of input provided (e.g., sensor data, RTC time, or I2C scan results).
+ * based on the type of input provided (e.g., sensor data, RTC time, I2C scan results or error reports).
+ * The output is queued in the transmit ring and sent by serial_console_processTx().
  *
  * @param data Pointer to data structure containing the input type and associated readings.
  * @return control_error_code_te
@@ -54,4 +72,58 @@ control_error_code_te serial_console_init();
  */
 control_error_code_te serial_console_displayData(const control_data_ts *data);
 
+/**
+ * @brief Prints a single preformatted line on the serial console.
+ *
+ * Used for diagnostic output which does not go through the data router (e.g. task profiles).
+ *
+ * @param line Null-terminated string to print.
+ */
+void serial_console_printLine(const char *line);
+
+/**
+ * @brief Reads a single-character command from the serial console without blocking.
+ *
+ * Whitespace and line endings are skipped, so commands can be sent from any terminal.
+ *
+ * @return char The received command, or SERIAL_CONSOLE_NO_COMMAND if nothing was received.
+ */
+char serial_console_readCommand();
+
+/**
+ * @brief Selects whether sensor readings and time are sent as text lines or binary frames.
+ *
+ * I2C scan results and diagnostic lines are always sent as text, the frame receiver skips them.
+ *
+ * @param output_mode SERIAL_CONSOLE_OUTPUT_MODE_TEXT or SERIAL_CONSOLE_OUTPUT_MODE_BINARY.
+ */
+void serial_console_setOutputMode(uint8_t output_mode);
+
+/**
+ * @brief Switches between the text and the binary output mode.
+ */
+void serial_console_toggleOutputMode();
+
+/**
+ * @brief Moves queued bytes from the transmit ring to the hardware serial buffer.
+ *
+ * Never waits, only as many bytes are moved as the hardware buffer has room for.
+ * NEEDS TO BE CALLED IN A LOOP, every few milliseconds.
+ */
+void serial_console_processTx();
+
+/**
+ * @brief Returns the number of bytes that can be queued without dropping anything.
+ *
+ * @return uint16_t Free bytes in the transmit ring.
+ */
+uint16_t serial_console_getTxFree();
+
+/**
+ * @brief Returns the transmit ring statistics.
+ *
+ * @return serial_console_tx_stats_ts Copy of the statistics.
+ */
+serial_console_tx_stats_ts serial_console_getTxStats();
+
 #endif
\ No newline at end of file
@@ -9,4 +9,34 @@
  */
 #define SERIAL_CONSOLE_BAUDRATE (uint64_t)(9600u)
 
+/* Output modes of the serial console */
+#define SERIAL_CONSOLE_OUTPUT_MODE_TEXT    (uint8_t)(0u) /** Human readable lines */
+#define SERIAL_CONSOLE_OUTPUT_MODE_BINARY  (uint8_t)(1u) /** Telemetry frames, see serial_telemetry.h */
+
+/**
+ * Output mode after start up. Binary frames are shorter than text lines and need no parsing,
+ * use them when the station is read by a gateway instead of a terminal.
+ */
+#define SERIAL_CONSOLE_DEFAULT_OUTPUT_MODE SERIAL_CONSOLE_OUTPUT_MODE_TEXT
+
+/**
+ * Size of the transmit ring in bytes. Messages are queued here and moved to the
+ * hardware serial buffer only as far as it has room, so writers never wait.
+ */
+#define SERIAL_CONSOLE_TX_BUFFER_SIZE      (uint16_t)(128u)
+
+/* What happens with a message that does not fit into the transmit ring */
+#define SERIAL_CONSOLE_TX_DROP_NEWEST      (uint8_t)(0u) /** The new message is dropped, queued messages stay complete */
+#define SERIAL_CONSOLE_TX_DROP_OLDEST      (uint8_t)(1u) /** Oldest whole messages are dropped until the new one fits, a message being sent is never cut */
+
+#ifndef SERIAL_CONSOLE_TX_DROP_POLICY // A build profile can select the other policy
+#define SERIAL_CONSOLE_TX_DROP_POLICY      SERIAL_CONSOLE_TX_DROP_NEWEST
+#endif
+
+/**
+ * Messages the transmit ring keeps apart at once, one byte of SRAM each. A message which finds
+ * all of them taken is handled like one which does not fit into the ring.
+ */
+#define SERIAL_CONSOLE_TX_MAX_MESSAGES     (uint8_t)(16u)
+
 #endif
\ No newline at end of file
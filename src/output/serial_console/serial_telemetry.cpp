@@ -0,0 +1,165 @@
+#include "serial_telemetry.h"
+
+/* STATIC GLOBAL VARIABLES */
+/* Fixed-point scale for each number of decimals */
+static const uint16_t serial_telemetry_decimal_scales[SERIAL_TELEMETRY_MAX_DECIMALS + 1u] PROGMEM = {1u, 10u, 100u, 1000u, 10000u};
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Writes the frame header.
+ *
+ * @param frame_type SERIAL_TELEMETRY_FRAME_TYPE_*.
+ * @param payload_len Length of the payload which follows the header.
+ * @param sequence Sequence number of the frame.
+ * @param timestamp_ms Time of the reading in milliseconds.
+ * @param frame Buffer for the frame.
+ */
+static void writeHeader(uint8_t frame_type, uint8_t payload_len, uint8_t sequence, uint32_t timestamp_ms, uint8_t *frame);
+
+/**
+ * @brief Appends the CRC behind the payload.
+ *
+ * @param payload_len Length of the payload.
+ * @param frame Buffer with the header and the payload.
+ * @return uint8_t Length of the whole frame.
+ */
+static uint8_t finishFrame(uint8_t payload_len, uint8_t *frame);
+
+/**
+ * @brief Writes a 32-bit value in little endian byte order.
+ *
+ * @param value The value.
+ * @param destination Pointer to the first byte.
+ */
+static void writeUint32(uint32_t value, uint8_t *destination);
+
+/**
+ * @brief Converts a measurement to the fixed-point value of the frame.
+ *
+ * In fixed-point mode the sensor value is only rescaled to the requested decimals.
+ *
+ * @param value The measurement.
+ * @param decimals Number of decimals, already limited to SERIAL_TELEMETRY_MAX_DECIMALS.
+ * @return int32_t The scaled and rounded value, or SERIAL_TELEMETRY_NO_VALUE.
+ */
+static int32_t toFixedPoint(sensors_value_t value, uint8_t decimals);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+uint8_t serial_telemetry_encodeSensorFrame(uint8_t sequence, uint32_t timestamp_ms, uint8_t sensor_id,
+                                           const sensor_reading_ts *reading, uint8_t num_of_decimals, uint8_t *frame)
+{
+  uint8_t decimals = min(num_of_decimals, SERIAL_TELEMETRY_MAX_DECIMALS);
+  int32_t value = 0;
+
+  if(SENSORS_MEASUREMENT_TYPE_INDICATION == reading->measurement_type_switch)
+  {
+    decimals = 0u;
+    value = reading->indication ? 1 : 0;
+  }
+  else
+  {
+    value = toFixedPoint(reading->value, decimals);
+  }
+
+  writeHeader(SERIAL_TELEMETRY_FRAME_TYPE_SENSOR, SERIAL_TELEMETRY_SENSOR_PAYLOAD_LEN, sequence, timestamp_ms, frame);
+  uint8_t *payload = &frame[SERIAL_TELEMETRY_HEADER_LEN];
+  payload[0] = sensor_id;
+  payload[1] = reading->measurement_type_switch;
+  payload[2] = decimals;
+  writeUint32((uint32_t)value, &payload[3]);
+
+  return finishFrame(SERIAL_TELEMETRY_SENSOR_PAYLOAD_LEN, frame);
+}
+
+uint8_t serial_telemetry_encodeTimeFrame(uint8_t sequence, uint32_t timestamp_ms, const rtc_reading_ts *time_data, uint8_t *frame)
+{
+  writeHeader(SERIAL_TELEMETRY_FRAME_TYPE_TIME, SERIAL_TELEMETRY_TIME_PAYLOAD_LEN, sequence, timestamp_ms, frame);
+  uint8_t *payload = &frame[SERIAL_TELEMETRY_HEADER_LEN];
+  payload[0] = (uint8_t)(time_data->year & 0xFFu);
+  payload[1] = (uint8_t)(time_data->year >> 8u);
+  payload[2] = time_data->month;
+  payload[3] = time_data->day;
+  payload[4] = time_data->hour;
+  payload[5] = time_data->mins;
+  payload[6] = time_data->secs;
+
+  return finishFrame(SERIAL_TELEMETRY_TIME_PAYLOAD_LEN, frame);
+}
+
+uint16_t serial_telemetry_crc16(const uint8_t *data, uint8_t len)
+{
+  uint16_t crc = SERIAL_TELEMETRY_CRC_INIT;
+
+  for (uint8_t index = 0u; index < len; index++)
+  {
+    crc ^= (uint16_t)data[index] << 8u;
+    for (uint8_t bit = 0u; bit < 8u; bit++)
+    {
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1u) ^ SERIAL_TELEMETRY_CRC_POLYNOMIAL) : (uint16_t)(crc << 1u);
+    }
+  }
+  return crc;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static void writeHeader(uint8_t frame_type, uint8_t payload_len, uint8_t sequence, uint32_t timestamp_ms, uint8_t *frame)
+{
+  frame[0] = SERIAL_TELEMETRY_SYNC_BYTE;
+  frame[1] = frame_type;
+  frame[2] = payload_len;
+  frame[3] = sequence;
+  writeUint32(timestamp_ms, &frame[4]);
+}
+
+static uint8_t finishFrame(uint8_t payload_len, uint8_t *frame)
+{
+  uint8_t crc_offset = SERIAL_TELEMETRY_HEADER_LEN + payload_len;
+  // Sync byte is not part of the CRC
+  uint16_t crc = serial_telemetry_crc16(&frame[1], crc_offset - 1u);
+  frame[crc_offset] = (uint8_t)(crc & 0xFFu);
+  frame[crc_offset + 1u] = (uint8_t)(crc >> 8u);
+  return crc_offset + SERIAL_TELEMETRY_CRC_LEN;
+}
+
+static void writeUint32(uint32_t value, uint8_t *destination)
+{
+  for (uint8_t index = 0u; index < sizeof(value); index++)
+  {
+    destination[index] = (uint8_t)(value >> (8u * index));
+  }
+}
+
+static int32_t toFixedPoint(sensors_value_t value, uint8_t decimals)
+{
+#ifdef SENSORS_FIXED_POINT_USED
+  if(SENSORS_VALUE_INVALID == value)
+  {
+    return SERIAL_TELEMETRY_NO_VALUE;
+  }
+  if(SENSORS_VALUE_DECIMALS >= decimals)
+  {
+    int32_t divisor = pgm_read_word(&serial_telemetry_decimal_scales[SENSORS_VALUE_DECIMALS - decimals]);
+    // Division truncates towards zero, so this rounds half away from zero like the text output
+    return (value + ((0 > value) ? -(divisor / 2) : (divisor / 2))) / divisor;
+  }
+  int32_t factor = pgm_read_word(&serial_telemetry_decimal_scales[decimals - SENSORS_VALUE_DECIMALS]);
+  if((SERIAL_TELEMETRY_MAX_VALUE / factor) < value || -(SERIAL_TELEMETRY_MAX_VALUE / factor) > value)
+  {
+    return SERIAL_TELEMETRY_NO_VALUE;
+  }
+  return value * factor;
+#else
+  float scaled = value * pgm_read_word(&serial_telemetry_decimal_scales[decimals]);
+
+  if(isnan(scaled) || SERIAL_TELEMETRY_MAX_SCALED_VALUE < fabs(scaled))
+  {
+    return SERIAL_TELEMETRY_NO_VALUE;
+  }
+  // Round half away from zero, like the text output
+  return (int32_t)((0.0f > scaled) ? (scaled - 0.5f) : (scaled + 0.5f));
+#endif
+}
+/* *************************************** */
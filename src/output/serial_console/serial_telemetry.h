@@ -0,0 +1,88 @@
+#ifndef SERIAL_TELEMETRY_H
+#define SERIAL_TELEMETRY_H
+
+#include <Arduino.h>
+#include "../../input/input_types.h"
+
+/**
+ * @file serial_telemetry.h
+ * @brief Binary telemetry frames for the serial console.
+ *
+ * Frame layout, multi-byte fields are little endian:
+ *
+ *   | sync | type | payload len | sequence | timestamp ms (4) | payload (payload len) | CRC-16 (2) |
+ *
+ * The CRC is CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) over all bytes from
+ * `type` up to the end of the payload. Receivers synchronize on the sync byte and drop frames
+ * with a wrong CRC, so text lines printed between frames are skipped.
+ *
+ * Sensor payload: | sensor ID | measurement type | decimals | value (int32) |
+ *   The value is the measurement multiplied by 10^decimals, indications are 0 or 1.
+ * Time payload:   | year (2) | month | day | hour | mins | secs |
+ *
+ * tools/telemetry_decoder.py turns a captured stream back into CSV.
+ */
+
+/* Frame constants */
+#define SERIAL_TELEMETRY_SYNC_BYTE               (uint8_t)(0xA5u)
+#define SERIAL_TELEMETRY_FRAME_TYPE_SENSOR       (uint8_t)(0x01u)
+#define SERIAL_TELEMETRY_FRAME_TYPE_TIME         (uint8_t)(0x02u)
+/* Sync, type, payload length, sequence and timestamp */
+#define SERIAL_TELEMETRY_HEADER_LEN              (uint8_t)(8u)
+#define SERIAL_TELEMETRY_CRC_LEN                 (uint8_t)(2u)
+/* Sensor ID, measurement type, decimals and value */
+#define SERIAL_TELEMETRY_SENSOR_PAYLOAD_LEN      (uint8_t)(7u)
+/* Year, month, day, hour, minutes and seconds */
+#define SERIAL_TELEMETRY_TIME_PAYLOAD_LEN        (uint8_t)(7u)
+/** Size of a buffer that fits every frame type */
+#define SERIAL_TELEMETRY_MAX_FRAME_LEN           (uint8_t)(SERIAL_TELEMETRY_HEADER_LEN + SERIAL_TELEMETRY_SENSOR_PAYLOAD_LEN + SERIAL_TELEMETRY_CRC_LEN)
+
+/* Fixed-point value encoding */
+#define SERIAL_TELEMETRY_MAX_DECIMALS            (uint8_t)(4u)
+/** Sent instead of a value which is NAN or does not fit into 32 bits */
+#define SERIAL_TELEMETRY_NO_VALUE                (int32_t)(-2147483647L - 1L)
+#define SERIAL_TELEMETRY_MAX_SCALED_VALUE        (float)(2147483520.0f)
+/** Largest value that can be sent, used when a fixed-point sensor value gets more decimals */
+#define SERIAL_TELEMETRY_MAX_VALUE               (int32_t)(2147483647L)
+
+/* CRC-16/CCITT-FALSE */
+#define SERIAL_TELEMETRY_CRC_INIT                (uint16_t)(0xFFFFu)
+#define SERIAL_TELEMETRY_CRC_POLYNOMIAL          (uint16_t)(0x1021u)
+
+static_assert(SERIAL_TELEMETRY_SENSOR_PAYLOAD_LEN >= SERIAL_TELEMETRY_TIME_PAYLOAD_LEN, "Largest payload defines the frame buffer size");
+
+/**
+ * @brief Encodes a sensor reading into a frame.
+ *
+ * @param sequence Sequence number of the frame, lets the receiver detect lost frames.
+ * @param timestamp_ms Time of the reading in milliseconds since start up.
+ * @param sensor_id ID of the sensor channel.
+ * @param reading Pointer to the reading.
+ * @param num_of_decimals Number of decimals kept in the fixed-point value, at most SERIAL_TELEMETRY_MAX_DECIMALS.
+ * @param frame Buffer for the frame, at least SERIAL_TELEMETRY_MAX_FRAME_LEN bytes.
+ * @return uint8_t Length of the frame.
+ */
+uint8_t serial_telemetry_encodeSensorFrame(uint8_t sequence, uint32_t timestamp_ms, uint8_t sensor_id,
+                                           const sensor_reading_ts *reading, uint8_t num_of_decimals, uint8_t *frame);
+
+/**
+ * @brief Encodes an RTC reading into a frame.
+ *
+ * @param sequence Sequence number of the frame, lets the receiver detect lost frames.
+ * @param timestamp_ms Time of the reading in milliseconds since start up.
+ * @param time_data Pointer to the RTC reading.
+ * @param frame Buffer for the frame, at least SERIAL_TELEMETRY_MAX_FRAME_LEN bytes.
+ * @return uint8_t Length of the frame.
+ */
+uint8_t serial_telemetry_encodeTimeFrame(uint8_t sequence, uint32_t timestamp_ms, const rtc_reading_ts *time_data, uint8_t *frame);
+
+/**
+ * @brief Calculates the CRC-16/CCITT-FALSE of a byte sequence.
+ *
+ * @param data Pointer to the bytes.
+ * @param len Number of bytes.
+ * @return uint16_t The CRC.
+ */
+uint16_t serial_telemetry_crc16(const uint8_t *data, uint8_t len);
+
+#endif
@@ -16,6 +16,19 @@
  * Make sure to enable communication protocol which the display uses (I2C for example).
  */
 #define LCD_DISPLAY_COMPONENT               (uint8_t)(1u)
+
+/**
+ * Uncomment to keep a history of sensor readings in the EEPROM.
+ * The history is dumped on the serial console on demand (send 'd').
+ * Costs SRAM for its page buffers and its output queue, which is why it is commented out by default.
+ */
+// #define DATA_LOGGER_COMPONENT               (uint8_t)(2u)
+
+/**
+ * Uncomment to switch the serial console between text lines and binary telemetry frames
+ * at run time (send 'm'). The output mode after start up is set in serial_console_config.h.
+ */
+#define SERIAL_CONSOLE_MODE_COMMAND_USED
 /* ********************************* */
 
 /* INPUT HARDWARE COMPONENTS */
@@ -38,4 +51,39 @@
 /* ********************************* */
 /* ********************************* */
 
+/* MEASUREMENTS */
+/**
+ * Uncomment to pass sensor values as scaled integers (thousandths of the unit) instead of float.
+ * Drivers, range checks and output formatting then work without floating point math,
+ * except for the values of the BMP280 and BH1750 libraries, which are converted once per read.
+ * Changing this setting invalidates the history stored by the data logger.
+ */
+// #define SENSORS_FIXED_POINT_USED
+
+/**
+ * Uncomment to keep rolling min/max/mean/standard deviation windows of the sensor channels.
+ * Tracked channels and their windows are set in src/input/sensor_stats/sensor_stats_config.h,
+ * every tracked channel costs SRAM. Send 'a' on the serial console to print the statistics.
+ * The windows take up to SENSOR_STATS_RAM_BUDGET_BYTES of SRAM, which is why they are commented out by default.
+ */
+// #define SENSOR_STATS_USED
+
+/**
+ * Uncomment to route periodic sensor readings to the serial console only when they changed.
+ * Deadbands of the channels and the heartbeat interval are set in src/control/report_filter/report_filter_config.h.
+ * The display still shows every reading, requested readings are never filtered.
+ * The last reported value of every channel is kept in SRAM, which is why it is commented out by default.
+ */
+// #define REPORT_FILTER_USED
+/* ********************************* */
+
+/* DIAGNOSTICS */
+/**
+ * Uncomment to measure run time, start lateness and overruns of every task.
+ * Statistics are dumped on the serial console on demand (send 'p').
+ * Leave commented out in production builds, the profiler then compiles out completely.
+ */
+// #define TASK_PROFILER_USED
+/* ********************************* */
+
 #endif
\ No newline at end of file
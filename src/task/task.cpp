@@ -1,66 +1,524 @@
 #include "task.h"
+#include "task_heap/task_heap.h"
 
+/* STATIC GLOBAL VARIABLES */
 static tasks_config_ts tasks_config[] =
 {
-  {millis(), TASK_I2C_ADDR_READ_TIMER, TASK_I2C_ADDR_READ},
-  {millis(), TASK_SENSOR_READ_TIMER, TASK_SENSOR_READ},
-  {millis(), TASK_TIME_READ_TIMER, TASK_TIME_READ}
+  {0u, TASK_I2C_SCAN_SLICE_TIMER, TASK_I2C_ADDR_READ_PHASE, TASK_PRIORITY_HIGH, TASK_I2C_ADDR_READ, TASK_NOT_SCHEDULED},
+  {0u, TASK_SENSOR_READ_TIMER, TASK_SENSOR_READ_PHASE, TASK_PRIORITY_MEDIUM, TASK_SENSOR_READ, TASK_NOT_SCHEDULED},
+  {0u, TASK_TIME_READ_TIMER, TASK_TIME_READ_PHASE, TASK_PRIORITY_HIGH, TASK_TIME_READ, TASK_NOT_SCHEDULED},
+  {0u, TASK_SENSORS_LOOP_TIMER, TASK_SENSORS_LOOP_PHASE, TASK_PRIORITY_HIGH, TASK_SENSORS_LOOP, TASK_NOT_SCHEDULED},
+  {0u, TASK_SUPERVISOR_TIMER, TASK_SUPERVISOR_PHASE, TASK_PRIORITY_LOW, TASK_SUPERVISOR, TASK_NOT_SCHEDULED}
 };
 
-static bool intervalPassed(uint8_t task_id);
+static_assert(sizeof(tasks_config) / sizeof(tasks_config[TASK_FIRST_TASK_INDEX]) <= TASK_HEAP_CAPACITY,
+              "The task heap must hold every task");
+
+/* Active tasks, keyed on next_deadline, the sensors loop is tracked as it is moved earlier after every wakeup */
+static task_heap_ts task_heap;
+
+#ifdef TASK_PROFILER_USED
+// A line must fit into the empty transmit ring, otherwise the dump would wait for it forever
+static_assert(TASK_PROFILER_LINE_LEN + SERIAL_CONSOLE_LINE_END_LEN <= SERIAL_CONSOLE_TX_BUFFER_SIZE,
+              "A line of the profile dump must fit into the serial transmit ring");
+
+/* Index of the next line of the profile dump */
+static uint8_t task_profile_dump_line = TASK_PROFILER_DUMP_IDLE;
+#endif
+
+#ifdef SENSOR_STATS_USED
+/* Progress of the statistics report requested by TASK_SENSOR_STATS_COMMAND */
+static sensor_reading_context_ts task_sensor_stats_report_context;
+static bool task_sensor_stats_report = TASK_SENSOR_STATS_REPORT_IDLE;
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Runs the task with the given index and handles state transitions.
+ *
+ * @param task_index Index of the task in tasks_config[].
+ * @return bool TASK_SCHEDULED if the task should be rescheduled by its period,
+ *              TASK_NOT_SCHEDULED if it was deactivated by a state transition.
+ */
+static bool runTask(uint8_t task_index);
+
+/**
+ * @brief Activates a task so that its first run happens after its phase offset.
+ *
+ * @param task_id ID of the task to activate.
+ * @param current_millis Current time in milliseconds.
+ */
+static void activateTask(uint8_t task_id, uint32_t current_millis);
+
+#ifdef TASK_SERIAL_COMMANDS_USED
+/**
+ * @brief Handles a single-character command received on the serial console.
+ *
+ * @param command The received command.
+ */
+static void handleSerialCommand(char command);
+#endif
+
+#ifdef TASK_PROFILER_USED
+/**
+ * @brief Records run time and start lateness of a finished task run.
+ *
+ * @param task_index Index of the task in tasks_config[].
+ * @param lateness_ms How late the task started relative to its deadline.
+ * @param run_time_us How long the task run took.
+ */
+static void recordTaskRun(uint8_t task_index, uint32_t lateness_ms, uint32_t run_time_us);
+
+/**
+ * @brief Maps a start lateness to its histogram bucket.
+ *
+ * @param lateness_ms How late the task started relative to its deadline.
+ * @return uint8_t Index of the histogram bucket.
+ */
+static uint8_t latenessToBucket(uint32_t lateness_ms);
+
+/**
+ * @brief Prints the pending lines of the profile dump which fit into the serial transmit ring.
+ */
+static void continueProfileDump();
+
+/**
+ * @brief Formats one line of the profile dump.
+ *
+ * @param line_index Index of the line: the tasks, the serial transmit ring, the output queues,
+ *                   the error manager and the supervisor, in this order.
+ * @param line Buffer of TASK_PROFILER_LINE_LEN bytes.
+ * @return uint8_t TASK_PROFILER_LINE_READY, TASK_PROFILER_LINE_SKIPPED or TASK_PROFILER_DUMP_FINISHED.
+ */
+static uint8_t formatProfileLine(uint8_t line_index, char *line);
+#endif
+
+#ifdef SENSOR_STATS_USED
+/**
+ * @brief Publishes the pending statistics of the report which fit into the output queues.
+ *
+ * Once they are delivered the summary follows them and the report is finished.
+ */
+static void continueSensorStatsReport();
+#endif
+
+/**
+ * @brief Returns the period of the sensors loop for its current work.
+ *
+ * TASK_SENSORS_LOOP_TIMER while work is pending, otherwise the time until its next deadline,
+ * at most TASK_SENSORS_LOOP_IDLE_TIMER.
+ *
+ * @return uint32_t Period in milliseconds.
+ */
+static uint32_t getSensorsLoopPeriod();
+
+/**
+ * @brief Moves the sensors loop earlier if the tasks of this wakeup gave it work.
+ *
+ * Published readings and requested DHT11 acquisitions must not wait for the idle deadline.
+ *
+ * @param current_millis Current time in milliseconds.
+ */
+static void wakeSensorsLoop(uint32_t current_millis);
+
 static uint8_t findTaskIndex(uint8_t task_id);
 static size_t getNumOfTasks();
+/* *************************************** */
 
+/* EXPORTED FUNCTIONS */
 void task_initTask()
 {
+  task_heap_init(&task_heap, tasks_config);
 
+  uint32_t current_millis = millis();
+  activateTask(TASK_I2C_ADDR_READ, current_millis);
+  // Sensors need their background processing from the start (DHT11 power up, MQ7 heating)
+  activateTask(TASK_SENSORS_LOOP, current_millis);
+  // Components which failed during setup come online as soon as they answer
+  activateTask(TASK_SUPERVISOR, current_millis);
 }
 
 void task_cyclicTask()
+{
+  if(TASK_NO_TASKS == task_heap.size)
+  {
+    delay(CYCLIC_TASK_DELAY_MS); // Nothing is scheduled, nothing to wait for
+    return;
+  }
+
+  uint32_t current_millis = millis();
+  uint32_t next_deadline = tasks_config[task_heap.entries[TASK_HEAP_ROOT]].next_deadline;
+
+  // Sleep exactly until the earliest deadline instead of polling
+  if(DEADLINE_NOT_REACHED == task_heap_deadlineReached(next_deadline, current_millis))
+  {
+    delay(next_deadline - current_millis);
+    current_millis = millis();
+  }
+
+  // Run every task that is due, ordered by deadline and priority
+  while(TASK_NO_TASKS != task_heap.size &&
+        DEADLINE_REACHED == task_heap_deadlineReached(tasks_config[task_heap.entries[TASK_HEAP_ROOT]].next_deadline, current_millis))
+  {
+    uint8_t task_index = task_heap_pop(&task_heap);
+
+#ifdef TASK_PROFILER_USED
+    uint32_t lateness_ms = millis() - tasks_config[task_index].next_deadline;
+    uint32_t start_micros = micros();
+    bool reschedule = runTask(task_index);
+    recordTaskRun(task_index, lateness_ms, micros() - start_micros);
+#else
+    bool reschedule = runTask(task_index);
+#endif
+
+    if(TASK_SCHEDULED == reschedule)
+    {
+#ifdef TASK_PROFILER_USED
+      if(TASK_HEAP_OVERRUN == task_heap_advanceDeadline(&tasks_config[task_index], millis()))
+      {
+        tasks_config[task_index].profile.overrun_count++;
+      }
+#else
+      (void)task_heap_advanceDeadline(&tasks_config[task_index], millis());
+#endif
+      task_heap_push(&task_heap, task_index);
+    }
+  }
+
+#ifdef TASK_SERIAL_COMMANDS_USED
+  // Commands are polled once per wakeup, so they never cause extra wakeups
+  char command = serial_console_readCommand();
+  if(SERIAL_CONSOLE_NO_COMMAND != command)
+  {
+    handleSerialCommand(command);
+  }
+#endif
+
+#ifdef TASK_PROFILER_USED
+  continueProfileDump();
+#endif
+#ifdef SENSOR_STATS_USED
+  continueSensorStatsReport();
+#endif
+
+  wakeSensorsLoop(millis());
+}
+
+#ifdef TASK_PROFILER_USED
+void task_startProfileDump()
+{
+  task_profile_dump_line = 0u;
+}
+
+void task_resetProfile()
+{
+  size_t num_of_tasks = getNumOfTasks();
+  for (uint8_t index = TASK_FIRST_TASK_INDEX; index < num_of_tasks; index++)
+  {
+    memset(&tasks_config[index].profile, 0, sizeof(tasks_config[index].profile));
+  }
+}
+#endif
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool runTask(uint8_t task_index)
 {
   static i2c_scan_reading_context_ts context_i2c_scan = app_createI2CScanReadingContext();
   static sensor_reading_context_ts context_sensor_reading = app_createNewSensorsReadingContext();
-  static task_state_machine_te current_state = STATE_SCANNING_FOR_I2C_ADDRESSES;
 
-  if(STATE_SCANNING_FOR_I2C_ADDRESSES == current_state)
+  bool reschedule = TASK_SCHEDULED;
+
+  switch(tasks_config[task_index].task_id)
   {
-    if(INTERVAL_PASSED == intervalPassed(TASK_I2C_ADDR_READ))
-    {
+    case TASK_I2C_ADDR_READ:
       if(FINISHED == app_readAllI2CAddressesPeriodic(ALL_OUTPUTS, &context_i2c_scan))
       {
-        current_state = STATE_CYCLIC_SENSOR_AND_TIME_READING;
+        // Scanning is done, switch to cyclic sensor and time reading
+        tasks_config[task_index].is_scheduled = TASK_NOT_SCHEDULED;
+        reschedule = TASK_NOT_SCHEDULED;
+
+        uint32_t current_millis = millis();
+        activateTask(TASK_SENSOR_READ, current_millis);
+        activateTask(TASK_TIME_READ, current_millis);
+      }
+      else
+      {
+        // Probe slices run back to back, found addresses are shown at the normal rate
+        tasks_config[task_index].task_period = (APP_I2C_SCAN_IN_PROGRESS == app_isI2CScanInProgress(&context_i2c_scan)) ?
+                                               TASK_I2C_SCAN_SLICE_TIMER : TASK_I2C_ADDR_READ_TIMER;
       }
+      break;
+
+    case TASK_SENSOR_READ:
+      (void)app_readAllSensorsPeriodic(ALL_OUTPUTS, &context_sensor_reading);
+      break;
+
+    case TASK_TIME_READ:
+      (void)app_readCurrentRtcTime(LCD_DISPLAY | DATA_LOGGER);
+      break;
+
+    case TASK_SENSORS_LOOP:
+      (void)app_runSensorsLoop();
+      // Polled only while work is pending, otherwise the loop sleeps until its next deadline
+      tasks_config[task_index].task_period = getSensorsLoopPeriod();
+      break;
+
+    case TASK_SUPERVISOR:
+      (void)app_superviseComponents();
+      break;
+
+    default:
+      break;
+  }
+
+  return reschedule;
+}
+
+static void activateTask(uint8_t task_id, uint32_t current_millis)
+{
+  uint8_t task_index = findTaskIndex(task_id);
+  if(TASK_INVALID_INDEX != task_index && TASK_NOT_SCHEDULED == tasks_config[task_index].is_scheduled)
+  {
+    tasks_config[task_index].next_deadline = current_millis + tasks_config[task_index].phase_offset;
+    tasks_config[task_index].is_scheduled = TASK_SCHEDULED;
+    if(TASK_SENSORS_LOOP == task_id)
+    {
+      task_heap_track(&task_heap, task_index);
     }
+    task_heap_push(&task_heap, task_index);
+  }
+}
+
+#ifdef TASK_SERIAL_COMMANDS_USED
+static void handleSerialCommand(char command)
+{
+  switch(command)
+  {
+#ifdef TASK_PROFILER_USED
+    case TASK_PROFILER_DUMP_COMMAND:
+      task_startProfileDump();
+      break;
+
+    case TASK_PROFILER_RESET_COMMAND:
+      task_resetProfile();
+      break;
+#endif
+
+#ifdef SERIAL_CONSOLE_MODE_COMMAND_USED
+    case TASK_OUTPUT_MODE_COMMAND:
+      serial_console_toggleOutputMode();
+      break;
+#endif
+
+#ifdef DATA_LOGGER_COMPONENT
+    case TASK_LOG_DUMP_COMMAND:
+      data_logger_startDump();
+      break;
+#endif
+
+#ifdef SENSOR_STATS_USED
+    case TASK_SENSOR_STATS_COMMAND:
+      if(TASK_SENSOR_STATS_REPORT_IDLE == task_sensor_stats_report)
+      {
+        task_sensor_stats_report_context = app_createNewSensorsReadingContext();
+        task_sensor_stats_report = TASK_SENSOR_STATS_REPORT_RUNNING;
+      }
+      break;
+#endif
+
+    default:
+      break; // Unknown commands are ignored
+  }
+}
+#endif
+
+#ifdef TASK_PROFILER_USED
+static void recordTaskRun(uint8_t task_index, uint32_t lateness_ms, uint32_t run_time_us)
+{
+  task_profile_ts *profile = &tasks_config[task_index].profile;
+
+  if(0u == profile->run_count || run_time_us < profile->run_time_min_us)
+  {
+    profile->run_time_min_us = run_time_us;
+  }
+  if(run_time_us > profile->run_time_max_us)
+  {
+    profile->run_time_max_us = run_time_us;
+  }
+  profile->run_time_total_us += run_time_us;
+  profile->run_count++;
+
+  uint8_t bucket = latenessToBucket(lateness_ms);
+  if(TASK_PROFILER_COUNTER_MAX != profile->lateness_histogram[bucket]) // Saturate instead of wrapping around
+  {
+    profile->lateness_histogram[bucket]++;
+  }
+}
+
+static uint8_t latenessToBucket(uint32_t lateness_ms)
+{
+  uint8_t bucket = 0u;
+  // Bucket index is the number of significant bits of the lateness
+  while(0u != lateness_ms && bucket < (TASK_PROFILER_LATENESS_BUCKETS - 1u))
+  {
+    lateness_ms >>= 1;
+    bucket++;
   }
-  else if(STATE_CYCLIC_SENSOR_AND_TIME_READING == current_state)
+  return bucket;
+}
+
+static void continueProfileDump()
+{
+  char line[TASK_PROFILER_LINE_LEN];
+
+  // A line which does not fit is formatted again on a later wakeup, once the ring has drained
+  while(TASK_PROFILER_DUMP_IDLE != task_profile_dump_line)
   {
-    if(INTERVAL_PASSED == intervalPassed(TASK_SENSOR_READ))
+    uint8_t status = formatProfileLine(task_profile_dump_line, line);
+    if(TASK_PROFILER_DUMP_FINISHED == status)
     {
-      (void)app_readAllSensorsPeriodic(ALL_OUTPUTS, &context_sensor_reading);
+      task_profile_dump_line = TASK_PROFILER_DUMP_IDLE;
+      break;
     }
-    if(INTERVAL_PASSED == intervalPassed(TASK_TIME_READ))
+    if(TASK_PROFILER_LINE_READY == status)
     {
-      (void)app_readCurrentRtcTime(LCD_DISPLAY);
+      if(strlen(line) + SERIAL_CONSOLE_LINE_END_LEN > serial_console_getTxFree())
+      {
+        break;
+      }
+      serial_console_printLine(line);
     }
+    task_profile_dump_line++;
   }
-
-  delay(CYCLIC_TASK_DELAY_MS);
 }
 
-static bool intervalPassed(uint8_t task_id)
+static uint8_t formatProfileLine(uint8_t line_index, char *line)
 {
-  uint32_t current_milis = millis();
-  tasks_config_ts current_task;
-  uint8_t task_index = findTaskIndex(task_id);
-  if(TASK_INVALID_INDEX != task_index)
+  const uint8_t num_of_tasks = (uint8_t)getNumOfTasks();
+  const uint8_t serial_tx_line = num_of_tasks;
+  const uint8_t first_output_line = serial_tx_line + 1u;
+  const uint8_t errors_line = first_output_line + (CONTROL_IO_NUM_OF_IDS - OUTPUT_DISPLAY);
+  const uint8_t supervisor_line = errors_line + 1u;
+  uint8_t status = TASK_PROFILER_LINE_READY;
+
+  if(line_index < num_of_tasks)
   {
-    if(current_milis - tasks_config[task_index].previous_millis >= tasks_config[task_index].task_period)
+    const task_profile_ts *profile = &tasks_config[line_index].profile;
+    uint32_t mean_us = 0u;
+    uint32_t min_us = 0u;
+    if(0u != profile->run_count)
     {
-      tasks_config[task_index].previous_millis = current_milis;
-      return INTERVAL_PASSED;
+      mean_us = (uint32_t)(profile->run_time_total_us / profile->run_count);
+      min_us = profile->run_time_min_us;
+    }
+
+    int len = snprintf_P(line, TASK_PROFILER_LINE_LEN, PSTR("Task %u: runs %lu, us min/mean/max %lu/%lu/%lu, overruns %u, late ms:"),
+                         tasks_config[line_index].task_id, (unsigned long)profile->run_count,
+                         (unsigned long)min_us, (unsigned long)mean_us, (unsigned long)profile->run_time_max_us,
+                         profile->overrun_count);
+
+    // Append the lateness histogram, one count per power of two bucket
+    for (uint8_t bucket = 0u; bucket < TASK_PROFILER_LATENESS_BUCKETS && len > 0 && len < TASK_PROFILER_LINE_LEN; bucket++)
+    {
+      len += snprintf_P(line + len, TASK_PROFILER_LINE_LEN - len, PSTR(" %u"), profile->lateness_histogram[bucket]);
+    }
+  }
+  else if(serial_tx_line == line_index)
+  {
+    serial_console_tx_stats_ts tx_stats = serial_console_getTxStats();
+    snprintf_P(line, TASK_PROFILER_LINE_LEN, PSTR("Serial TX: dropped bytes %lu, dropped messages %u, high water %u/%u"),
+               (unsigned long)tx_stats.dropped_bytes, tx_stats.dropped_messages,
+               tx_stats.high_water_mark, SERIAL_CONSOLE_TX_BUFFER_SIZE);
+  }
+  else if(line_index < errors_line)
+  {
+    // One line per output queue, outputs that are not part of the build have none
+    control_io_t output = (control_io_t)(OUTPUT_DISPLAY + (line_index - first_output_line));
+    control_output_queue_stats_ts queue_stats;
+    if(ERROR_CODE_NO_ERROR == control_getOutputQueueStats(output, &queue_stats))
+    {
+      snprintf_P(line, TASK_PROFILER_LINE_LEN, PSTR("Output %u queue: delivered %u, dropped %u, latency ms last/max %u/%u, high water %u/%u"),
+                 output, queue_stats.delivered, queue_stats.dropped, queue_stats.last_latency_ms,
+                 queue_stats.max_latency_ms, queue_stats.high_water_mark, queue_stats.depth);
+    }
+    else
+    {
+      status = TASK_PROFILER_LINE_SKIPPED;
     }
   }
-  return INTERVAL_NOT_PASSED;
+  else if(errors_line == line_index)
+  {
+    error_manager_stats_ts error_stats = error_manager_getStats();
+    snprintf_P(line, TASK_PROFILER_LINE_LEN, PSTR("Errors: occurrences %u, escalated %u, deferred %u, untracked %u"),
+               error_stats.occurrences, error_stats.escalations, error_stats.deferred, error_stats.untracked);
+  }
+  else if(supervisor_line == line_index)
+  {
+    supervisor_stats_ts supervisor_stats = supervisor_getStats();
+    snprintf_P(line, TASK_PROFILER_LINE_LEN, PSTR("Supervisor: attempts %u, recoveries %u"), supervisor_stats.attempts, supervisor_stats.recoveries);
+  }
+  else
+  {
+    status = TASK_PROFILER_DUMP_FINISHED;
+  }
+
+  return status;
+}
+#endif
+
+#ifdef SENSOR_STATS_USED
+static void continueSensorStatsReport()
+{
+  if(TASK_SENSOR_STATS_REPORT_IDLE == task_sensor_stats_report ||
+     NOT_FINISHED == app_readAllSensorStatsAtOnce(SERIAL_CONSOLE, &task_sensor_stats_report_context))
+  {
+    return; // Continued on a later wakeup, once the output queues have drained
+  }
+  task_sensor_stats_report = TASK_SENSOR_STATS_REPORT_IDLE;
+
+  // The statistics are delivered by now, the summary follows them. SRAM taken by the windows, fixed at compile time
+  char line[TASK_SENSOR_STATS_LINE_LEN];
+  snprintf_P(line, sizeof(line), PSTR("Sensor stats: %u channels, %u bytes each, %u/%u bytes"),
+             SENSOR_STATS_NUM_OF_CHANNELS, SENSOR_STATS_CHANNEL_BYTES, SENSOR_STATS_RAM_BYTES, SENSOR_STATS_RAM_BUDGET_BYTES);
+  serial_console_printLine(line);
+}
+#endif
+
+static uint32_t getSensorsLoopPeriod()
+{
+  unsigned long idle_time = app_getSensorsLoopIdleTime();
+#ifdef TASK_PROFILER_USED
+  if(TASK_PROFILER_DUMP_IDLE != task_profile_dump_line)
+  {
+    idle_time = 0u; // The dump is printed on every wakeup, while the transmit ring drains
+  }
+#endif
+#ifdef SENSOR_STATS_USED
+  if(TASK_SENSOR_STATS_REPORT_IDLE != task_sensor_stats_report)
+  {
+    idle_time = 0u; // The report is continued on every wakeup, while the output queues drain
+  }
+#endif
+  uint32_t period = (uint32_t)min(idle_time, (unsigned long)TASK_SENSORS_LOOP_IDLE_TIMER);
+  return max(period, TASK_SENSORS_LOOP_TIMER);
+}
+
+static void wakeSensorsLoop(uint32_t current_millis)
+{
+  if(TASK_HEAP_NO_POSITION == task_heap.tracked_position)
+  {
+    return; // Not activated yet
+  }
+
+  tasks_config_ts *sensors_loop = &tasks_config[task_heap.tracked_index];
+  uint32_t wake_deadline = current_millis + getSensorsLoopPeriod();
+  if(DEADLINE_NOT_REACHED == task_heap_deadlineReached(sensors_loop->next_deadline, wake_deadline))
+  {
+    sensors_loop->next_deadline = wake_deadline;
+    task_heap_moveEarlier(&task_heap, task_heap.tracked_position);
+  }
 }
 
 static uint8_t findTaskIndex(uint8_t task_id)
@@ -68,7 +526,7 @@ static uint8_t findTaskIndex(uint8_t task_id)
   uint8_t index_returned = TASK_INVALID_INDEX;
   size_t num_of_tasks = getNumOfTasks();
 
-  // Loop through all tasks till the right one is found
+  // Loop through all tasks till the right one is found, only used on task activation
   for (uint8_t index = TASK_FIRST_TASK_INDEX; index < num_of_tasks; index++)
   {
     if(task_id == tasks_config[index].task_id)
@@ -89,4 +547,5 @@ static size_t getNumOfTasks()
     num_of_tasks = sizeof(tasks_config) / sizeof(tasks_config[TASK_FIRST_TASK_INDEX]);
   }
   return num_of_tasks;
-}
\ No newline at end of file
+}
+/* *************************************** */
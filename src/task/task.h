@@ -11,40 +11,173 @@
 #define TIME_HOURS(h)   ((h) * MS_PER_HOUR)
 #define TIME_MINS(m)    ((m) * MS_PER_MINUTE)
 #define TIME_SECS(s)    ((s) * MS_PER_SECOND)
+#define TIME_MS(ms)     ((uint32_t)(ms))
 
 #define TASK_CALIBRATING_TIMER     (TIME_SECS(1))
 #define TASK_TIME_READ_TIMER       (TIME_SECS(1))
 #define TASK_SENSOR_READ_TIMER     (TIME_SECS(2))
 #define TASK_I2C_ADDR_READ_TIMER   (TIME_SECS(2))
+/* Period of the sensors loop while it has work pending (DHT11 acquisition, I2C jobs, queued output, dumps) */
+#define TASK_SENSORS_LOOP_TIMER    (TIME_MS(10u))
+/* Longest sleep of the idle sensors loop, bounds the delay of the I2C health check and of error reports */
+#define TASK_SENSORS_LOOP_IDLE_TIMER (TIME_SECS(1))
+/* Period of the supervisor, every run initializes at most one failed component */
+#define TASK_SUPERVISOR_TIMER      (TIME_MS(500u))
+/* Period of the I2C task while the bus scan is probing addresses, one slice per activation */
+#define TASK_I2C_SCAN_SLICE_TIMER  (TIME_MS(20u))
+
+/* Phase offsets of the first activation, relative to the moment the task is activated */
+/* Sensor reads are shifted away from the time reads so both never fall into the same wakeup */
+#define TASK_TIME_READ_PHASE       (TIME_MS(0u))
+#define TASK_SENSOR_READ_PHASE     (TIME_MS(500u))
+#define TASK_I2C_ADDR_READ_PHASE   (TIME_MS(0u))
+#define TASK_SENSORS_LOOP_PHASE    (TIME_MS(0u))
+/* First retry of the components which failed during setup */
+#define TASK_SUPERVISOR_PHASE      (TIME_SECS(1))
+
+/* Task priorities, used only to order tasks that share the same deadline (lower value runs first) */
+#define TASK_PRIORITY_HIGH         (uint8_t)(0u)
+#define TASK_PRIORITY_MEDIUM       (uint8_t)(1u)
+#define TASK_PRIORITY_LOW          (uint8_t)(2u)
 
 #define TASK_CALIBRATING           (0u)
 #define TASK_TIME_READ             (1u)
 #define TASK_SENSOR_READ           (2u)
 #define TASK_I2C_ADDR_READ         (3u)
+#define TASK_SENSORS_LOOP          (4u)
+#define TASK_SUPERVISOR            (5u)
 
+/* Sleep used only when no task is scheduled, otherwise the loop sleeps until the earliest deadline */
 #define CYCLIC_TASK_DELAY_MS       ((uint32_t)50u)
 
 #define TASK_NO_TASKS              (0u)
 #define TASK_FIRST_TASK_INDEX      (0u)
 #define TASK_INVALID_INDEX         (127u)
 
-#define INTERVAL_PASSED            (true)
-#define INTERVAL_NOT_PASSED        (false)
+/* Marks a task that is currently not in the task heap */
+#define TASK_NOT_SCHEDULED         (bool)(false)
+#define TASK_SCHEDULED             (bool)(true)
+
+#define DEADLINE_REACHED           (true)
+#define DEADLINE_NOT_REACHED       (false)
+
+/* Serial console commands are polled only if some feature handles them */
+#if defined(SERIAL_CONSOLE_COMPONENT) && \
+    (defined(TASK_PROFILER_USED) || defined(SERIAL_CONSOLE_MODE_COMMAND_USED) || defined(DATA_LOGGER_COMPONENT) || defined(SENSOR_STATS_USED))
+#define TASK_SERIAL_COMMANDS_USED
+#endif
+
+#ifdef SERIAL_CONSOLE_MODE_COMMAND_USED
+/* Serial console command which switches between text and binary telemetry output */
+#define TASK_OUTPUT_MODE_COMMAND         ('m')
+#endif
+
+#ifdef DATA_LOGGER_COMPONENT
+/* Serial console command which dumps the logged sensor history */
+#define TASK_LOG_DUMP_COMMAND            ('d')
+#endif
+
+#ifdef SENSOR_STATS_USED
+/* Serial console command which prints the rolling statistics of the tracked sensors */
+#define TASK_SENSOR_STATS_COMMAND        ('a')
+/* Size of the buffer for the memory line of the statistics */
+#define TASK_SENSOR_STATS_LINE_LEN       (uint8_t)(60u)
+/* States of the statistics report, it is continued on every wakeup until the summary is printed */
+#define TASK_SENSOR_STATS_REPORT_IDLE    (bool)(false)
+#define TASK_SENSOR_STATS_REPORT_RUNNING (bool)(true)
+#endif
 
-typedef enum
+#ifdef TASK_PROFILER_USED
+/* Number of buckets in the start lateness histogram */
+/* Bucket 0 counts on-time starts, bucket N counts lateness in [2^(N-1), 2^N) ms, the last bucket everything above */
+#define TASK_PROFILER_LATENESS_BUCKETS   (uint8_t)(8u)
+/* Serial console command which dumps the task profiles */
+#define TASK_PROFILER_DUMP_COMMAND       ('p')
+/* Serial console command which resets the task profiles */
+#define TASK_PROFILER_RESET_COMMAND      ('r')
+/* Saturation value of the histogram counters */
+#define TASK_PROFILER_COUNTER_MAX        (uint16_t)(0xFFFFu)
+/* Size of the buffer for one line of the profile dump */
+#define TASK_PROFILER_LINE_LEN           (uint8_t)(100u)
+/* Line index of the profile dump while no dump is in progress */
+#define TASK_PROFILER_DUMP_IDLE          (uint8_t)(0xFFu)
+
+/* Results of formatting one line of the profile dump */
+#define TASK_PROFILER_LINE_READY         (uint8_t)(0u)
+#define TASK_PROFILER_LINE_SKIPPED       (uint8_t)(1u)  // Nothing to print for this index (e.g. an output which is not built)
+#define TASK_PROFILER_DUMP_FINISHED      (uint8_t)(2u)
+
+/**
+ * @brief Execution time and jitter statistics of a single task.
+ *
+ * Run times are measured with micros(), start lateness is measured in milliseconds
+ * relative to the task deadline. An overrun is counted whenever a task finishes
+ * after its next deadline, so at least one activation had to be skipped.
+ */
+typedef struct
 {
-    STATE_SCANNING_FOR_I2C_ADDRESSES,
-    STATE_CYCLIC_SENSOR_AND_TIME_READING
-} task_state_machine_te;
+    uint32_t run_count;                                          // Number of measured runs
+    uint32_t run_time_min_us;                                    // Shortest run time
+    uint32_t run_time_max_us;                                    // Longest run time
+    uint64_t run_time_total_us;                                  // Sum of all run times, used for the mean
+    uint16_t lateness_histogram[TASK_PROFILER_LATENESS_BUCKETS]; // Start lateness histogram
+    uint16_t overrun_count;                                      // Number of runs that missed the next deadline
+} task_profile_ts;
+#endif
 
+/**
+ * @brief Configuration and scheduling state of a single periodic task.
+ *
+ * Tasks are registered with a period, a phase offset and a priority. Active tasks are
+ * kept in a min-heap keyed on `next_deadline`, so the scheduler always knows which task
+ * is due next without scanning the whole table.
+ */
 typedef struct
 {
-    uint32_t previous_millis;
-    uint32_t task_period;
-    uint8_t task_id;
+    uint32_t next_deadline;  // Absolute millis() timestamp of the next activation
+    uint32_t task_period;    // Period between two activations
+    uint32_t phase_offset;   // Delay of the first activation after the task is activated
+    uint8_t priority;        // Tie-breaker for tasks with the same deadline (lower runs first)
+    uint8_t task_id;         // Unique task identifier
+    bool is_scheduled;       // Whether the task is currently in the task heap
+#ifdef TASK_PROFILER_USED
+    task_profile_ts profile; // Execution time and jitter statistics
+#endif
 } tasks_config_ts;
 
+/**
+ * @brief Initializes the task scheduler.
+ *
+ * Activates the tasks of the initial state (I2C address scanning, the sensors
+ * background loop and the supervisor of failed components). Must be called once
+ * from setup(), after control_init(), before the first call to task_cyclicTask().
+ */
 void task_initTask();
+
+/**
+ * @brief Runs one scheduler iteration.
+ *
+ * Sleeps exactly until the earliest task deadline, then runs every task that is due,
+ * ordered by deadline and priority, and reschedules each one by its period.
+ */
 void task_cyclicTask();
 
-#endif
\ No newline at end of file
+#ifdef TASK_PROFILER_USED
+/**
+ * @brief Starts dumping the execution time and jitter statistics of every task on the serial console.
+ *
+ * One line is printed per task with run count, min/mean/max run time, overrun count
+ * and the start lateness histogram, followed by the serial transmit ring statistics,
+ * the delivery statistics of every output queue and the counters of the error manager.
+ * The lines are printed by task_cyclicTask(), each one as soon as the serial transmit
+ * ring has room for it, so none of them is dropped. A running dump starts over.
+ */
+void task_startProfileDump();
+
+/**
+ * @brief Clears the execution time and jitter statistics of every task.
+ */
+void task_resetProfile();
+#endif
+
+#endif
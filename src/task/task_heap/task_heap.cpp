@@ -0,0 +1,142 @@
+#include "task_heap.h"
+
+/* STATIC FUNCTION PROTOTYPES */
+/**
+ * @brief Compares two tasks by deadline, using the priority as a tie-breaker.
+ *
+ * @return bool true if the task with index_a must run before the task with index_b.
+ */
+static bool taskRunsBefore(const task_heap_ts *heap, uint8_t index_a, uint8_t index_b);
+
+/**
+ * @brief Stores a task in a slot of the heap and keeps the slot of the tracked task.
+ *
+ * @param heap Pointer to the heap.
+ * @param position Slot in the heap.
+ * @param task_index Index of the task in the task table.
+ */
+static void placeTask(task_heap_ts *heap, uint8_t position, uint8_t task_index);
+/* *************************************** */
+
+/* EXPORTED FUNCTIONS */
+void task_heap_init(task_heap_ts *heap, const tasks_config_ts *tasks)
+{
+  heap->tasks = tasks;
+  heap->size = TASK_NO_TASKS;
+  heap->tracked_index = TASK_INVALID_INDEX;
+  heap->tracked_position = TASK_HEAP_NO_POSITION;
+}
+
+void task_heap_track(task_heap_ts *heap, uint8_t task_index)
+{
+  heap->tracked_index = task_index;
+  heap->tracked_position = TASK_HEAP_NO_POSITION;
+}
+
+void task_heap_push(task_heap_ts *heap, uint8_t task_index)
+{
+  uint8_t position = heap->size++;
+  placeTask(heap, position, task_index);
+  task_heap_moveEarlier(heap, position);
+}
+
+uint8_t task_heap_pop(task_heap_ts *heap)
+{
+  uint8_t root_task_index = heap->entries[TASK_HEAP_ROOT];
+  placeTask(heap, TASK_HEAP_ROOT, heap->entries[--heap->size]);
+  if(root_task_index == heap->tracked_index)
+  {
+    heap->tracked_position = TASK_HEAP_NO_POSITION;
+  }
+
+  // Sift down until both children run after the moved task
+  uint8_t position = TASK_HEAP_ROOT;
+  while(true)
+  {
+    uint8_t left = 2u * position + 1u;
+    uint8_t right = left + 1u;
+    uint8_t earliest = position;
+
+    if(left < heap->size && taskRunsBefore(heap, heap->entries[left], heap->entries[earliest]))
+    {
+      earliest = left;
+    }
+    if(right < heap->size && taskRunsBefore(heap, heap->entries[right], heap->entries[earliest]))
+    {
+      earliest = right;
+    }
+    if(earliest == position)
+    {
+      break;
+    }
+    uint8_t temp = heap->entries[earliest];
+    placeTask(heap, earliest, heap->entries[position]);
+    placeTask(heap, position, temp);
+    position = earliest;
+  }
+
+  return root_task_index;
+}
+
+void task_heap_moveEarlier(task_heap_ts *heap, uint8_t position)
+{
+  // Sift up until the parent runs before the moved task
+  while(TASK_HEAP_ROOT != position)
+  {
+    uint8_t parent = (position - 1u) / 2u;
+    if(!taskRunsBefore(heap, heap->entries[position], heap->entries[parent]))
+    {
+      break;
+    }
+    uint8_t temp = heap->entries[parent];
+    placeTask(heap, parent, heap->entries[position]);
+    placeTask(heap, position, temp);
+    position = parent;
+  }
+}
+
+bool task_heap_deadlineReached(uint32_t deadline, uint32_t current_millis)
+{
+  // Signed difference keeps the comparison valid across millis() overflow
+  return ((int32_t)(current_millis - deadline) >= 0) ? DEADLINE_REACHED : DEADLINE_NOT_REACHED;
+}
+
+bool task_heap_advanceDeadline(tasks_config_ts *task, uint32_t current_millis)
+{
+  bool status = TASK_HEAP_ON_TIME;
+  uint32_t period = task->task_period;
+  uint32_t next_deadline = task->next_deadline + period;
+
+  if(DEADLINE_REACHED == task_heap_deadlineReached(next_deadline, current_millis))
+  {
+    // The task overran one or more periods, skip the missed activations
+    uint32_t missed_periods = (current_millis - next_deadline) / period + 1u;
+    next_deadline += missed_periods * period;
+    status = TASK_HEAP_OVERRUN;
+  }
+  task->next_deadline = next_deadline;
+
+  return status;
+}
+/* *************************************** */
+
+/* STATIC FUNCTIONS IMPLEMENTATIONS */
+static bool taskRunsBefore(const task_heap_ts *heap, uint8_t index_a, uint8_t index_b)
+{
+  int32_t deadline_difference = (int32_t)(heap->tasks[index_a].next_deadline - heap->tasks[index_b].next_deadline);
+  if(0 != deadline_difference)
+  {
+    return (deadline_difference < 0);
+  }
+  return (heap->tasks[index_a].priority < heap->tasks[index_b].priority);
+}
+
+static void placeTask(task_heap_ts *heap, uint8_t position, uint8_t task_index)
+{
+  heap->entries[position] = task_index;
+  if(task_index == heap->tracked_index)
+  {
+    heap->tracked_position = position;
+  }
+}
+/* *************************************** */
@@ -0,0 +1,105 @@
+#ifndef TASK_HEAP_H
+#define TASK_HEAP_H
+
+#include <Arduino.h>
+#include "../task.h"
+
+/**
+ * @file task_heap.h
+ * @brief Min-heap of the active tasks, keyed on their next deadline.
+ *
+ * The heap holds indices into the task table of the caller (see task_cyclicTask()). Tasks with
+ * the same deadline are ordered by priority. Deadlines are absolute millis() timestamps and are
+ * compared across the millis() overflow.
+ *
+ * One task can be tracked: every move inside the heap updates its slot, so its deadline can be
+ * moved earlier without searching the heap.
+ */
+
+/* Number of tasks the heap can hold, at least the number of tasks in tasks_config[] */
+#define TASK_HEAP_CAPACITY         (uint8_t)(5u)
+/* Index of the root (earliest deadline) in the task heap */
+#define TASK_HEAP_ROOT             (uint8_t)(0u)
+/* Heap slot of a task that is currently not in the task heap */
+#define TASK_HEAP_NO_POSITION      (uint8_t)(0xFFu)
+
+/* Results of task_heap_advanceDeadline() */
+#define TASK_HEAP_ON_TIME          (bool)(false)
+#define TASK_HEAP_OVERRUN          (bool)(true)
+
+/**
+ * Queued tasks, owned by the caller.
+ */
+typedef struct
+{
+  const tasks_config_ts *tasks;         // Task table the entries index into
+  uint8_t entries[TASK_HEAP_CAPACITY];  // Indices into tasks, the root is due first
+  uint8_t size;                         // Number of queued tasks
+  uint8_t tracked_index;                // Task whose slot is kept, TASK_INVALID_INDEX for none
+  uint8_t tracked_position;             // Slot of the tracked task, TASK_HEAP_NO_POSITION while it is not queued
+} task_heap_ts;
+
+/**
+ * @brief Empties a heap and binds it to a task table.
+ *
+ * @param heap Pointer to the heap.
+ * @param tasks The task table, must outlive the heap.
+ */
+void task_heap_init(task_heap_ts *heap, const tasks_config_ts *tasks);
+
+/**
+ * @brief Keeps the heap slot of a task, see task_heap_ts::tracked_position.
+ *
+ * Must be called while the task is not queued.
+ *
+ * @param heap Pointer to the heap.
+ * @param task_index Index of the task in the task table.
+ */
+void task_heap_track(task_heap_ts *heap, uint8_t task_index);
+
+/**
+ * @brief Inserts a task by its next deadline.
+ *
+ * @param heap Pointer to the heap, with less than TASK_HEAP_CAPACITY tasks.
+ * @param task_index Index of the task in the task table.
+ */
+void task_heap_push(task_heap_ts *heap, uint8_t task_index);
+
+/**
+ * @brief Removes and returns the task with the earliest deadline.
+ *
+ * @param heap Pointer to a heap with at least one task.
+ * @return uint8_t Index of the task in the task table.
+ */
+uint8_t task_heap_pop(task_heap_ts *heap);
+
+/**
+ * @brief Restores the order after the deadline of a queued task was moved earlier.
+ *
+ * @param heap Pointer to the heap.
+ * @param position Slot of the task in the heap.
+ */
+void task_heap_moveEarlier(task_heap_ts *heap, uint8_t position);
+
+/**
+ * @brief Checks if the given deadline has been reached, handling millis() overflow.
+ *
+ * @param deadline Absolute deadline in milliseconds.
+ * @param current_millis Current time in milliseconds.
+ * @return bool DEADLINE_REACHED or DEADLINE_NOT_REACHED.
+ */
+bool task_heap_deadlineReached(uint32_t deadline, uint32_t current_millis);
+
+/**
+ * @brief Moves the deadline of a task to its next period that is not in the past.
+ *
+ * Missed activations (e.g. after an overrun) are skipped instead of being run back to back,
+ * and the deadline stays aligned to the original phase so jitter does not accumulate.
+ *
+ * @param task Pointer to the task, which must not be queued.
+ * @param current_millis Current time in milliseconds.
+ * @return bool TASK_HEAP_OVERRUN if activations were skipped, otherwise TASK_HEAP_ON_TIME.
+ */
+bool task_heap_advanceDeadline(tasks_config_ts *task, uint32_t current_millis);
+
+#endif
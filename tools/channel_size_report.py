@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Reports the flash and SRAM used by every configured sensor channel of a build.
+
+Every channel of the sensor registry (src/input/sensors/sensors_interface/sensors_metadata/sensors_catalog.h)
+has its own named strings, sensors_registry_type_<ID> and sensors_registry_unit_<ID>, and one entry in the
+functional catalog, the metadata catalog and the ID lookup table. The sizes are read from the symbol table of
+the build with nm:
+- strings: the two named strings of the channel;
+- tables: the size of the three tables divided by the number of channels;
+- sram: the channel symbols that ended up in .data or .bss, 0 when everything stays in program memory.
+
+The host build (CMakeLists.txt) runs this on every station library it links. The host has no program memory
+and 64 bit pointers, so its table share is larger than on the board and its tables are not in program memory,
+which is why only the channel strings are checked for SRAM. tools/profile_flash_report.py --channels runs it
+with avr-nm on the firmware ELF of each profile.
+
+Usage:
+    channel_size_report.py build/libstation_default.a
+    channel_size_report.py --nm avr-nm arduino_smart_weather_station.ino.elf
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+CHANNEL_PATTERN = re.compile(r"^sensors_registry_(type|unit)_(\w+)$")
+TABLE_SYMBOLS = ["sensors_functional_catalog", "sensors_metadata_catalog", "sensors_metadata_id_to_index"]
+SRAM_TYPES = "dDbB"
+# Defined symbols with a size: address, size, type, name
+SYMBOL_PATTERN = re.compile(r"^[0-9a-fA-F]+ ([0-9a-fA-F]+) (\w) (.+)$")
+
+
+def read_symbols(nm, path):
+    """Returns (name, type, size) of every defined symbol with a size."""
+    result = subprocess.run([nm, "-S", "-C", path], stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        raise RuntimeError(result.stderr)
+
+    symbols = []
+    for line in result.stdout.splitlines():
+        match = SYMBOL_PATTERN.match(line)
+        if match:
+            symbols.append((match.group(3), match.group(2), int(match.group(1), 16)))
+    return symbols
+
+
+def channel_sizes(symbols):
+    """Returns {channel: (string bytes, sram bytes)} and the table bytes of all channels."""
+    channels = {}
+    table_bytes = 0
+    for name, symbol_type, size in symbols:
+        match = CHANNEL_PATTERN.match(name)
+        if match:
+            strings, sram = channels.get(match.group(2), (0, 0))
+            channels[match.group(2)] = (strings + size, sram + (size if symbol_type in SRAM_TYPES else 0))
+        elif name in TABLE_SYMBOLS:
+            table_bytes += size
+    return channels, table_bytes
+
+
+def print_report(channels, table_bytes, output=sys.stdout):
+    """Prints one line per channel and the totals."""
+    if not channels:
+        print("no sensor channels found", file=output)
+        return
+
+    table_share = table_bytes // len(channels)
+    print("{:<24} {:>8} {:>7} {:>6} {:>5}".format("channel", "strings", "tables", "flash", "sram"), file=output)
+    for name in sorted(channels):
+        strings, sram = channels[name]
+        print("{:<24} {:>8} {:>7} {:>6} {:>5}".format(name, strings, table_share, strings + table_share, sram),
+              file=output)
+    total_strings = sum(strings for strings, _ in channels.values())
+    total_sram = sum(sram for _, sram in channels.values())
+    print("{:<24} {:>8} {:>7} {:>6} {:>5}".format("total ({})".format(len(channels)), total_strings, table_bytes,
+                                                  total_strings + table_bytes, total_sram), file=output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("binary", help="ELF file, object file or static library of a build")
+    parser.add_argument("--nm", default="nm", help="nm of the toolchain which built the binary (default: nm)")
+    args = parser.parse_args()
+
+    try:
+        symbols = read_symbols(args.nm, args.binary)
+    except (OSError, RuntimeError) as error:
+        print("{}: {}".format(args.binary, error), file=sys.stderr)
+        return 1
+
+    channels, table_bytes = channel_sizes(symbols)
+    print_report(channels, table_bytes)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""Builds the sketch in several build profiles and reports the flash saved by each one.
+
+A profile is src/project_settings.h with the optional settings (commented out by default to save SRAM) enabled
+and some settings commented out. Components which are commented out are left out of the component graph
+(src/control/control_types.h), so their code is not linked.
+Every profile is built in a temporary copy of the sketch with arduino-cli, the repository is not modified.
+
+Usage:
+    profile_flash_report.py                               (all profiles, Arduino Nano)
+    profile_flash_report.py --fqbn arduino:avr:uno full logger_telemetry
+    profile_flash_report.py --channels default            (also flash and SRAM per sensor channel)
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import channel_size_report
+
+SKETCH_NAME = "arduino_smart_weather_station"
+SETTINGS_PATH = os.path.join("src", "project_settings.h")
+REFERENCE_PROFILE = "full"
+
+# Settings which are commented out in the default src/project_settings.h, every profile starts with them enabled
+OPTIONAL_SETTINGS = ["DATA_LOGGER_COMPONENT", "SENSOR_STATS_USED", "REPORT_FILTER_USED"]
+
+# Settings commented out per profile, the reference profile keeps everything
+PROFILES = {
+    "full": [],
+    "default": OPTIONAL_SETTINGS,
+    "no_display": ["LCD_DISPLAY_COMPONENT"],
+    "no_rtc": ["RTC_COMPONENT"],
+    "no_logger": ["DATA_LOGGER_COMPONENT"],
+    "no_statistics": ["SENSOR_STATS_USED", "REPORT_FILTER_USED"],
+    "logger_telemetry": ["LCD_DISPLAY_COMPONENT", "SENSOR_STATS_USED"],
+    "display_only": ["SERIAL_CONSOLE_COMPONENT", "DATA_LOGGER_COMPONENT", "SERIAL_CONSOLE_MODE_COMMAND_USED",
+                     "SENSOR_STATS_USED", "REPORT_FILTER_USED"],
+}
+
+FLASH_PATTERN = re.compile(r"Sketch uses (\d+) bytes")
+RAM_PATTERN = re.compile(r"Global variables use (\d+) bytes")
+
+
+def enable_settings(settings, names):
+    """Returns the settings text with the commented out #define of every name restored."""
+    for name in names:
+        settings, count = re.subn(r"^// #define {}\b".format(name), "#define " + name, settings, flags=re.MULTILINE)
+        if count == 0:
+            raise ValueError("{} is not commented out in {}".format(name, SETTINGS_PATH))
+    return settings
+
+
+def disable_settings(settings, names):
+    """Returns the settings text with the #define of every name commented out."""
+    for name in names:
+        settings, count = re.subn(r"^#define {}\b".format(name), "// #define " + name, settings, flags=re.MULTILINE)
+        if count == 0:
+            raise ValueError("{} is not defined in {}".format(name, SETTINGS_PATH))
+    return settings
+
+
+def build_profile(repository, fqbn, names, nm=None):
+    """Builds one profile, returns (flash bytes, static RAM bytes, sensor channel sizes or None).
+
+    The sensor channel sizes are read with the given nm from the ELF file, see channel_size_report.py.
+    """
+    with tempfile.TemporaryDirectory() as temp_dir:
+        # arduino-cli needs the sketch folder to be named like the .ino file
+        sketch_dir = os.path.join(temp_dir, SKETCH_NAME)
+        shutil.copytree(repository, sketch_dir, ignore=shutil.ignore_patterns(".git", "tools", "schematics", "*.pdf"))
+
+        settings_file = os.path.join(sketch_dir, SETTINGS_PATH)
+        with open(settings_file) as file:
+            settings = file.read()
+        with open(settings_file, "w") as file:
+            file.write(disable_settings(enable_settings(settings, OPTIONAL_SETTINGS), names))
+
+        output_dir = os.path.join(temp_dir, "build")
+        result = subprocess.run(["arduino-cli", "compile", "--fqbn", fqbn, "--output-dir", output_dir, sketch_dir],
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if result.returncode != 0:
+            raise RuntimeError(result.stdout)
+
+        channels = None
+        if nm is not None:
+            elf_file = os.path.join(output_dir, SKETCH_NAME + ".ino.elf")
+            channels = channel_size_report.channel_sizes(channel_size_report.read_symbols(nm, elf_file))
+
+    flash = FLASH_PATTERN.search(result.stdout)
+    ram = RAM_PATTERN.search(result.stdout)
+    if flash is None or ram is None:
+        raise RuntimeError("Size report not found in the arduino-cli output:\n" + result.stdout)
+    return int(flash.group(1)), int(ram.group(1)), channels
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("profiles", nargs="*", default=list(PROFILES), help="profiles to build (default: all)")
+    parser.add_argument("--fqbn", default="arduino:avr:nano", help="board to build for (default: arduino:avr:nano)")
+    parser.add_argument("--channels", action="store_true", help="also report flash and SRAM per sensor channel")
+    parser.add_argument("--nm", default="avr-nm", help="nm used for --channels (default: avr-nm)")
+    args = parser.parse_args()
+
+    unknown = [name for name in args.profiles if name not in PROFILES]
+    if unknown:
+        parser.error("unknown profiles: " + ", ".join(unknown))
+
+    repository = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    profiles = [REFERENCE_PROFILE] + [name for name in args.profiles if name != REFERENCE_PROFILE]
+
+    print("{:<18} {:>8} {:>8} {:>6}".format("profile", "flash", "saved", "ram"))
+    reference_flash = None
+    channel_reports = []
+    for name in profiles:
+        try:
+            flash, ram, channels = build_profile(repository, args.fqbn, PROFILES[name],
+                                                 args.nm if args.channels else None)
+        except (OSError, RuntimeError, ValueError) as error:
+            print("{:<18} build failed:\n{}".format(name, error), file=sys.stderr)
+            return 1
+        if reference_flash is None:
+            reference_flash = flash
+        print("{:<18} {:>8} {:>8} {:>6}".format(name, flash, reference_flash - flash, ram))
+        if channels is not None:
+            channel_reports.append((name, channels))
+
+    for name, (channels, table_bytes) in channel_reports:
+        print("\nSensor channels of profile {}:".format(name))
+        channel_size_report.print_report(channels, table_bytes)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
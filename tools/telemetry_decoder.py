@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Decodes binary telemetry frames of the serial console into CSV.
+
+Frame format is described in src/output/serial_console/serial_telemetry.h.
+Bytes which do not belong to a frame with a valid CRC (e.g. text lines) are skipped.
+
+Usage:
+    telemetry_decoder.py capture.bin > readings.csv
+    telemetry_decoder.py --port /dev/ttyUSB0 --baud 9600   (needs pyserial)
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+SYNC_BYTE = 0xA5
+FRAME_TYPE_SENSOR = 0x01
+FRAME_TYPE_TIME = 0x02
+HEADER_LEN = 8
+CRC_LEN = 2
+MAX_PAYLOAD_LEN = 7
+NO_VALUE = -2147483648
+MEASUREMENT_TYPE_INDICATION = 1
+
+CSV_COLUMNS = ["sequence", "lost_frames", "timestamp_ms", "type", "sensor_id", "value", "time"]
+
+
+def crc16_ccitt_false(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def decode_payload(frame_type, payload):
+    """Returns (type, sensor_id, value, time) for a known frame type, None otherwise."""
+    if frame_type == FRAME_TYPE_SENSOR and len(payload) == 7:
+        sensor_id, measurement_type, decimals, raw_value = struct.unpack("<BBBi", payload)
+        if raw_value == NO_VALUE:
+            value = ""
+        elif measurement_type == MEASUREMENT_TYPE_INDICATION:
+            value = "yes" if raw_value else "no"
+        else:
+            value = "{:.{}f}".format(raw_value / (10 ** decimals), decimals)
+        return "sensor", sensor_id, value, ""
+    if frame_type == FRAME_TYPE_TIME and len(payload) == 7:
+        year, month, day, hour, mins, secs = struct.unpack("<HBBBBB", payload)
+        time = "{:04d}-{:02d}-{:02d} {:02d}:{:02d}:{:02d}".format(year, month, day, hour, mins, secs)
+        return "time", "", "", time
+    return None
+
+
+class StreamDecoder:
+    """Finds frames in a byte stream which arrives in chunks of any size."""
+
+    def __init__(self):
+        self.buffer = b""
+        self.expected_sequence = None
+
+    def feed(self, data):
+        """Adds received bytes and returns one CSV row per complete valid frame."""
+        self.buffer += data
+        rows = []
+        index = 0
+        while index + HEADER_LEN + CRC_LEN <= len(self.buffer):
+            if self.buffer[index] != SYNC_BYTE:
+                index += 1
+                continue
+            frame_type, payload_len, sequence, timestamp_ms = struct.unpack_from("<BBBI", self.buffer, index + 1)
+            if payload_len > MAX_PAYLOAD_LEN:
+                index += 1
+                continue
+            frame_end = index + HEADER_LEN + payload_len + CRC_LEN
+            if frame_end > len(self.buffer):
+                break  # Rest of the frame has not arrived yet
+            crc_offset = frame_end - CRC_LEN
+            (crc,) = struct.unpack_from("<H", self.buffer, crc_offset)
+            decoded = decode_payload(frame_type, self.buffer[index + HEADER_LEN:crc_offset])
+            if crc != crc16_ccitt_false(self.buffer[index + 1:crc_offset]) or decoded is None:
+                index += 1  # Sync byte was part of other data, search again from the next byte
+                continue
+
+            lost_frames = 0 if self.expected_sequence is None else (sequence - self.expected_sequence) & 0xFF
+            self.expected_sequence = (sequence + 1) & 0xFF
+            rows.append([sequence, lost_frames, timestamp_ms] + list(decoded))
+            index = frame_end
+
+        self.buffer = self.buffer[index:]
+        return rows
+
+
+def read_port(port, baud):
+    import serial  # Only needed for live decoding
+
+    with serial.Serial(port, baud) as connection:
+        while True:
+            yield connection.read(connection.in_waiting or 1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="file with captured serial output, stdin if omitted")
+    parser.add_argument("--port", help="serial port to read live from")
+    parser.add_argument("--baud", type=int, default=9600, help="baud rate of the serial port")
+    args = parser.parse_args()
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(CSV_COLUMNS)
+
+    decoder = StreamDecoder()
+    if args.port:
+        for chunk in read_port(args.port, args.baud):
+            writer.writerows(decoder.feed(chunk))
+            sys.stdout.flush()
+    else:
+        if args.capture:
+            with open(args.capture, "rb") as capture:
+                data = capture.read()
+        else:
+            data = sys.stdin.buffer.read()
+        writer.writerows(decoder.feed(data))
+
+if __name__ == "__main__":
+    main()